@@ -0,0 +1,101 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "core/graph.hpp"
+
+namespace
+{
+
+/**
+ * @brief Resident set size of the process in MiB.
+ */
+double resident_mib()
+{
+    std::ifstream statm{"/proc/self/statm"};
+    std::size_t pages = 0;
+    std::size_t resident = 0;
+    statm >> pages >> resident;
+    return static_cast<double>(resident * sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+// Usage: Allocation [numOfNodes] [numOfEdges] [graph|pool|heap]
+//   graph - builds impl::graph with add_node/add_edge
+//   pool  - creates the node and edge objects in object pools, like impl::graph does
+//   heap  - creates the same node and edge objects one by one with new
+// Run the modes in separate processes to compare build time and resident memory.
+int main(int argc, char* argv[])
+{
+    const std::size_t numOfNodes = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const std::size_t numOfEdges = argc > 2 ? std::stoul(argv[2]) : 1000000;
+    const std::string mode = argc > 3 ? argv[3] : "graph";
+
+    std::vector<std::string> names(numOfNodes);
+    for (std::size_t i = 0; i < numOfNodes; ++i) {
+        names[i] = std::to_string(i);
+    }
+    std::mt19937_64 rng{42};
+    std::uniform_int_distribution<std::size_t> pick(0, numOfNodes - 1);
+    std::vector<std::pair<std::size_t, std::size_t>> edges(numOfEdges);
+    for (auto& e : edges) {
+        e = {pick(rng), pick(rng)};
+    }
+
+    const double rssBefore = resident_mib();
+    const auto start = std::chrono::steady_clock::now();
+    if ("heap" == mode) {
+        std::vector<impl::node*> nodes(numOfNodes);
+        std::vector<impl::edge*> allEdges(numOfEdges);
+        for (std::size_t i = 0; i < numOfNodes; ++i) {
+            nodes[i] = new impl::node(i, names[i]);
+        }
+        for (std::size_t i = 0; i < numOfEdges; ++i) {
+            allEdges[i] = new impl::edge(nodes[edges[i].first], nodes[edges[i].second], 1);
+            nodes[edges[i].first]->add_edge(allEdges[i]);
+        }
+        std::cout << mode << ": " << seconds_since(start) << " s, "
+                  << resident_mib() - rssBefore << " MiB" << std::endl;
+        for (auto* e : allEdges) {
+            delete e;
+        }
+        for (auto* n : nodes) {
+            delete n;
+        }
+    } else if ("pool" == mode) {
+        impl::object_pool<impl::node> nodePool;
+        impl::object_pool<impl::edge> edgePool;
+        std::vector<impl::node*> nodes(numOfNodes);
+        for (std::size_t i = 0; i < numOfNodes; ++i) {
+            nodes[i] = nodePool.create(i, names[i]);
+        }
+        for (const auto& [from, to] : edges) {
+            nodes[from]->add_edge(edgePool.create(nodes[from], nodes[to], 1));
+        }
+        std::cout << mode << ": " << seconds_since(start) << " s, "
+                  << resident_mib() - rssBefore << " MiB" << std::endl;
+    } else {
+        impl::graph g;
+        for (std::size_t i = 0; i < numOfNodes; ++i) {
+            g.add_node(names[i]);
+        }
+        for (const auto& [from, to] : edges) {
+            g.add_edge(names[from], names[to]);
+        }
+        std::cout << mode << ": " << seconds_since(start) << " s, "
+                  << resident_mib() - rssBefore << " MiB" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "core/graph.hpp"
+
+namespace
+{
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief R-MAT edges: every edge picks a quadrant of the adjacency matrix
+ *        scale times, with probabilities a, b, c and 1 - a - b - c.
+ */
+std::vector<std::tuple<std::size_t, std::size_t, int>> rmat_edges(std::size_t scale, std::size_t edgeFactor)
+{
+    constexpr double A = 0.57;
+    constexpr double B = 0.19;
+    constexpr double C = 0.19;
+
+    std::mt19937_64 rng{42};
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::vector<std::tuple<std::size_t, std::size_t, int>> edges(edgeFactor << scale);
+    for (auto& e : edges) {
+        std::size_t from = 0;
+        std::size_t to = 0;
+        for (std::size_t bit = 0; bit < scale; ++bit) {
+            const double p = coin(rng);
+            from = (from << 1) | (p >= A + B ? 1 : 0);
+            to = (to << 1) | ((p >= A && p < A + B) || p >= A + B + C ? 1 : 0);
+        }
+        e = {from, to, 1};
+    }
+    return edges;
+}
+
+}
+
+// Usage: BFS [scale] [edgeFactor] [threads,...]
+// Compares the visitor bfs with the direction-optimizing parallel_bfs on an
+// R-MAT graph of 2^scale nodes and edgeFactor * 2^scale edges.
+int main(int argc, char* argv[])
+{
+    const std::size_t scale = argc > 1 ? std::stoul(argv[1]) : 20;
+    const std::size_t edgeFactor = argc > 2 ? std::stoul(argv[2]) : 16;
+    std::vector<std::size_t> threads;
+    {
+        std::istringstream is{argc > 3 ? argv[3] : "1,4,16,32"};
+        for (std::string token; std::getline(is, token, ',');) {
+            threads.push_back(std::stoul(token));
+        }
+    }
+
+    const impl::graph g = [&]() {
+        const auto edges = rmat_edges(scale, edgeFactor);
+        return impl::graph(edges.begin(), edges.end());
+    }();
+    // The hub of an R-MAT graph is node 0, start from its first neighbor
+    const std::size_t start = g.out_edges(0).empty() ? 0 : (*g.out_edges(0).begin()).to;
+
+    struct level_recorder : impl::default_visitor
+    {
+        impl::visit_result discover(size_type id, size_type depth)
+        {
+            levels[id] = depth;
+            return impl::visit_result::PROCEED;
+        }
+        std::vector<std::size_t>& levels;
+    };
+    std::vector<std::size_t> expected(g.num_of_ids(), impl::graph::INVALID_ID);
+    auto begin = std::chrono::steady_clock::now();
+    (void)g.bfs(start, level_recorder{{}, expected});
+    const double baseline = seconds_since(begin);
+    std::cout << "bfs:                     " << baseline << " s" << std::endl;
+
+    for (const std::size_t numOfThreads : threads) {
+        begin = std::chrono::steady_clock::now();
+        const impl::bfs_result<std::size_t> result = g.parallel_bfs(start, numOfThreads);
+        const double seconds = seconds_since(begin);
+        std::cout << "parallel_bfs (" << numOfThreads << " threads): " << seconds << " s, "
+                  << baseline / seconds << "x" << (result.levels == expected ? "" : ", MISMATCH") << std::endl;
+    }
+
+    return 0;
+}
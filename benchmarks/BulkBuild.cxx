@@ -0,0 +1,64 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "core/graph.hpp"
+
+namespace
+{
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+// Usage: BulkBuild [numOfNodes] [numOfEdges]
+// Compares add_edge in a loop with add_edges for named and id endpoints.
+int main(int argc, char* argv[])
+{
+    const std::size_t numOfNodes = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const std::size_t numOfEdges = argc > 2 ? std::stoul(argv[2]) : 10000000;
+
+    std::vector<std::string> names(numOfNodes);
+    for (std::size_t i = 0; i < numOfNodes; ++i) {
+        names[i] = std::to_string(i);
+    }
+    std::mt19937_64 rng{42};
+    std::uniform_int_distribution<std::size_t> pick(0, numOfNodes - 1);
+    std::uniform_int_distribution<int> weight(1, 100);
+    std::vector<std::tuple<std::size_t, std::size_t, int>> ids(numOfEdges);
+    std::vector<std::tuple<std::string_view, std::string_view, int>> named(numOfEdges);
+    for (std::size_t i = 0; i < numOfEdges; ++i) {
+        const std::size_t from = pick(rng);
+        const std::size_t to = pick(rng);
+        const int cost = weight(rng);
+        ids[i] = {from, to, cost};
+        named[i] = {names[from], names[to], cost};
+    }
+
+    {
+        const auto start = std::chrono::steady_clock::now();
+        impl::graph g;
+        for (const auto& [from, to, cost] : named) {
+            g.add_edge(from, to, cost);
+        }
+        std::cout << "add_edge loop:     " << seconds_since(start) << " s" << std::endl;
+    }
+    {
+        const auto start = std::chrono::steady_clock::now();
+        impl::graph g(named.begin(), named.end());
+        std::cout << "add_edges (names): " << seconds_since(start) << " s" << std::endl;
+    }
+    {
+        const auto start = std::chrono::steady_clock::now();
+        impl::graph g(ids.begin(), ids.end());
+        std::cout << "add_edges (ids):   " << seconds_since(start) << " s" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/graph.hpp"
+
+namespace
+{
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Half of the nodes are sources with an edge into a chain made of the
+ *        other half, so every search from a source reaches the whole chain.
+ */
+impl::unweighted_graph<> many_sources(std::size_t size)
+{
+    const std::size_t sources = size / 2;
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    for (std::size_t i = 0; i < sources; ++i) {
+        edges.emplace_back(i, sources);
+    }
+    for (std::size_t i = sources; i + 1 < size; ++i) {
+        edges.emplace_back(i, i + 1);
+    }
+    return impl::unweighted_graph<>(edges.begin(), edges.end());
+}
+
+/**
+ * @brief Former first pass: a fresh DFS iterator, with its own visited
+ *        marks, for every start not visited yet.
+ */
+std::size_t iterator_candidate(const impl::unweighted_graph<>& g)
+{
+    std::vector<bool> visited(g.num_of_ids(), false);
+    std::size_t candidate = 0;
+    for (std::size_t i = 0; i < g.num_of_ids(); ++i) {
+        if (!visited[i]) {
+            for (auto it = g.begin_DFS(i); it != g.end_DFS(); ++it) {
+                visited[(*it).get_id()] = true;
+            }
+            candidate = i;
+        }
+    }
+    return candidate;
+}
+
+}
+
+// Usage: MotherNodeScaling [maxScale] [maxIteratorScale]
+// Times mother_node on graphs of 2^scale nodes with 2^(scale - 1) sources,
+// the time per node and edge stays flat if it is linear. The former
+// iterator based first pass is quadratic, it only runs up to maxIteratorScale.
+int main(int argc, char* argv[])
+{
+    const std::size_t maxScale = argc > 1 ? std::stoul(argv[1]) : 22;
+    const std::size_t maxIteratorScale = argc > 2 ? std::stoul(argv[2]) : 12;
+
+    for (std::size_t scale = 10; scale <= maxScale; scale += 2) {
+        const impl::unweighted_graph<> g = many_sources(std::size_t{1} << scale);
+        const double work = static_cast<double>(g.size() + g.num_of_edges());
+
+        auto begin = std::chrono::steady_clock::now();
+        const auto* motherNode = g.mother_node();
+        const double seconds = seconds_since(begin);
+        std::cout << "2^" << scale << " nodes: mother_node " << seconds << " s, "
+                  << 1e9 * seconds / work << " ns per node and edge" << (nullptr == motherNode ? "" : ", MISMATCH");
+
+        if (scale <= maxIteratorScale) {
+            begin = std::chrono::steady_clock::now();
+            (void)iterator_candidate(g);
+            std::cout << ", iterator first pass " << seconds_since(begin) << " s";
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "core/graph.hpp"
+
+namespace
+{
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+// Usage: SSSP [numOfNodes] [numOfEdges] [delta] [threads,...]
+// Compares dijkstra with delta-stepping on a random graph with costs 1..100.
+int main(int argc, char* argv[])
+{
+    const std::size_t numOfNodes = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const std::size_t numOfEdges = argc > 2 ? std::stoul(argv[2]) : 10000000;
+    const int delta = argc > 3 ? std::stoi(argv[3]) : 0;
+    std::vector<std::size_t> threads;
+    {
+        std::istringstream is{argc > 4 ? argv[4] : "1,4,16,32"};
+        for (std::string token; std::getline(is, token, ',');) {
+            threads.push_back(std::stoul(token));
+        }
+    }
+
+    impl::csr_graph g;
+    {
+        std::mt19937_64 rng{42};
+        std::uniform_int_distribution<std::size_t> pick(0, numOfNodes - 1);
+        std::uniform_int_distribution<int> weight(1, 100);
+        std::vector<std::tuple<std::size_t, std::size_t, int>> edges(numOfEdges);
+        for (auto& e : edges) {
+            e = {pick(rng), pick(rng), weight(rng)};
+        }
+        g = impl::graph(edges.begin(), edges.end()).freeze();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const std::vector<int> expected = g.dijkstra(0);
+    const double baseline = seconds_since(start);
+    std::cout << "dijkstra:                   " << baseline << " s" << std::endl;
+
+    for (const std::size_t numOfThreads : threads) {
+        start = std::chrono::steady_clock::now();
+        const std::vector<int> dist = g.delta_stepping(0, delta, numOfThreads);
+        const double seconds = seconds_since(start);
+        std::cout << "delta_stepping (" << numOfThreads << " threads): " << seconds << " s, "
+                  << baseline / seconds << "x" << (dist == expected ? "" : ", MISMATCH") << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "core/graph.hpp"
+
+namespace
+{
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Token by token iostream parsing, the way deserialize used to read.
+ */
+impl::graph load_with_iostream(const std::string& fileName)
+{
+    std::ifstream is{fileName};
+    std::size_t size = 0;
+    is >> size;
+    std::vector<std::string> names(size);
+    std::vector<std::tuple<std::size_t, std::size_t, int>> edges;
+    for (std::size_t i = 0; i < size; ++i) {
+        std::size_t degree = 0;
+        is >> names[i] >> degree;
+        for (std::size_t j = 0; j < degree; ++j) {
+            std::size_t to = 0;
+            int cost = 0;
+            is >> to >> cost;
+            edges.emplace_back(i, to, cost);
+        }
+    }
+    return impl::graph(edges.begin(), edges.end());
+}
+
+}
+
+// Usage: TextLoad [numOfNodes] [numOfEdges] [fileName] [numOfThreads]
+// Writes a random graph in the text format and loads it back.
+int main(int argc, char* argv[])
+{
+    const std::size_t numOfNodes = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const std::size_t numOfEdges = argc > 2 ? std::stoul(argv[2]) : 10000000;
+    const std::string fileName = argc > 3 ? argv[3] : "TextLoad.txt";
+    const std::size_t numOfThreads = argc > 4 ? std::stoul(argv[4]) : 0;
+
+    {
+        std::mt19937_64 rng{42};
+        std::uniform_int_distribution<std::size_t> pick(0, numOfNodes - 1);
+        std::uniform_int_distribution<int> weight(1, 100);
+        std::vector<std::tuple<std::size_t, std::size_t, int>> edges(numOfEdges);
+        for (auto& e : edges) {
+            e = {pick(rng), pick(rng), weight(rng)};
+        }
+        impl::graph g(edges.begin(), edges.end());
+        g.serialize(fileName);
+    }
+    const auto fileSize = static_cast<double>(std::ifstream(fileName, std::ios::ate | std::ios::binary).tellg());
+
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const impl::graph g = load_with_iostream(fileName);
+        const double seconds = seconds_since(start);
+        std::cout << "iostream:    " << seconds << " s, "
+                  << fileSize / seconds / (1024.0 * 1024.0) << " MiB/s" << std::endl;
+    }
+    {
+        const auto start = std::chrono::steady_clock::now();
+        impl::graph g;
+        g.deserialize(fileName);
+        const double seconds = seconds_since(start);
+        std::cout << "deserialize: " << seconds << " s, "
+                  << fileSize / seconds / (1024.0 * 1024.0) << " MiB/s" << std::endl;
+    }
+    {
+        const auto start = std::chrono::steady_clock::now();
+        impl::graph g;
+        g.deserialize(fileName, numOfThreads);
+        const double seconds = seconds_since(start);
+        std::cout << "deserialize (" << impl::thread_pool(numOfThreads).size() << " threads): "
+                  << seconds << " s, " << fileSize / seconds / (1024.0 * 1024.0) << " MiB/s" << std::endl;
+    }
+
+    return 0;
+}
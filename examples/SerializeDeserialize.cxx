@@ -23,5 +23,16 @@ int main()
         std::cout << "Graphs are not the same" << std::endl;
     }
 
+    g.serialize_binary("graph.bin");
+    const impl::csr_graph view = impl::csr_graph::map("graph.bin");
+    std::cout << "Mapped " << view.size() << " nodes and " << view.num_of_edges() << " edges" << std::endl;
+    for (impl::csr_graph::size_type i = 0; i < view.size(); ++i) {
+        std::cout << view.get_name(i) << ':';
+        for (const auto [to, cost] : view.out_edges(i)) {
+            std::cout << ' ' << view.get_name(to) << '(' << cost << ')';
+        }
+        std::cout << std::endl;
+    }
+
     return 0;
 }
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace impl
+{
+
+/**
+ * @struct cost_traits
+ * @brief Infinity and path cost addition of an edge cost type.
+ * @details Infinity marks unreachable nodes and absorbs any addition. Floating
+ *          point costs add natively. Integer costs narrower than 64 bits add
+ *          in 64 bits and clamp, 64 bit integers are checked before adding,
+ *          so a sum that does not fit saturates to infinity (or to the lowest
+ *          value for negative costs) instead of wrapping around.
+ */
+template <typename Cost>
+struct cost_traits
+{
+    static_assert(std::is_arithmetic_v<Cost> && !std::is_same_v<Cost, bool>,
+                  "Edge costs must be integer or floating point numbers");
+
+    using cost_type                 = Cost;
+
+    [[nodiscard]] constexpr static Cost infinity() noexcept
+    {
+        if constexpr (std::is_floating_point_v<Cost>) {
+            return std::numeric_limits<Cost>::infinity();
+        } else {
+            return std::numeric_limits<Cost>::max();
+        }
+    }
+
+    [[nodiscard]] constexpr static Cost add(Cost lhs, Cost rhs) noexcept
+    {
+        if constexpr (std::is_floating_point_v<Cost>) {
+            return lhs + rhs;
+        } else {
+            if (infinity() == lhs || infinity() == rhs) {
+                return infinity();
+            }
+            if constexpr (sizeof(Cost) < sizeof(std::int64_t)) {
+                using wide_type = std::conditional_t<std::is_signed_v<Cost>, std::int64_t, std::uint64_t>;
+                const wide_type sum = static_cast<wide_type>(lhs) + static_cast<wide_type>(rhs);
+                if (sum >= static_cast<wide_type>(infinity())) {
+                    return infinity();
+                }
+                if (sum < static_cast<wide_type>(std::numeric_limits<Cost>::lowest())) {
+                    return std::numeric_limits<Cost>::lowest();
+                }
+                return static_cast<Cost>(sum);
+            } else {
+                if (rhs > 0 && lhs > infinity() - rhs) {
+                    return infinity();
+                }
+                if constexpr (std::is_signed_v<Cost>) {
+                    if (rhs < 0 && lhs < std::numeric_limits<Cost>::lowest() - rhs) {
+                        return std::numeric_limits<Cost>::lowest();
+                    }
+                }
+                return lhs + rhs;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Type of the path costs of a graph with the given edge cost type:
+ *        Cost itself, or hop counts of type Id for unweighted (void Cost) graphs.
+ */
+template <typename Cost, typename Id>
+using path_cost_t = std::conditional_t<std::is_void_v<Cost>, Id, Cost>;
+
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "scc_result.hpp"
+#include "shortest_path_tree.hpp"
+#include "thread_pool.hpp"
+#include "traversal_workspace.hpp"
+#include "visitor.hpp"
+#include "widgets.hpp"
+
+namespace impl
+{
+template <typename Cost, typename Id>
+class basic_graph;
+
+/**
+ * @class basic_csr_graph
+ * @brief Immutable compressed sparse row (CSR) snapshot of a graph.
+ * @details Outgoing edges of node i occupy the range [offsets[i], offsets[i + 1])
+ *          of the flat target and cost arrays. Ids are the same as in the
+ *          graph the snapshot was taken from, ids of removed nodes are kept
+ *          but not contained, so the algorithms skip them like the graph
+ *          does. The arrays are either owned by
+ *          the snapshot or are a view of a mapped binary file, copies share them.
+ *          Offsets and targets are stored as Id, costs as Cost. Unweighted
+ *          (void Cost) snapshots have no cost array, their arcs cost 1.
+ */
+template <typename Cost = int, typename Id = std::size_t>
+class basic_csr_graph
+{
+public:
+    using size_type                 = std::size_t;
+    using id_type                   = Id;
+    using cost_type                 = path_cost_t<Cost, Id>;
+    using arc                       = basic_arc<Cost, Id>;
+
+    constexpr static id_type INVALID_ID = std::numeric_limits<id_type>::max();
+    constexpr static bool is_weighted = !std::is_void_v<Cost>;
+
+public:
+    /**
+     * @brief Const iterator of the outgoing edges of a node as (target id, cost) arcs.
+     */
+    class const_arc_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = arc;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const arc*;
+        using reference = arc;
+    public:
+        const_arc_iterator(const id_type* target, const cost_type* cost);
+
+        ~const_arc_iterator() = default;
+
+        const_arc_iterator& operator++();
+        const_arc_iterator operator++(int);
+
+        bool operator==(const const_arc_iterator& other) const;
+        bool operator!=(const const_arc_iterator& other) const;
+        value_type operator*() const;
+
+    private:
+        const id_type* m_target;
+        const cost_type* m_cost;
+    };
+
+    using arc_range = iterator_range<const_arc_iterator>;
+
+public:
+    /**
+     * @brief Construct an empty snapshot.
+     */
+    basic_csr_graph() = default;
+
+    /**
+     * @brief Pack the adjacency of the given graph into flat arrays.
+     */
+    explicit basic_csr_graph(const basic_graph<Cost, Id>& g);
+
+    /**
+     * @brief Map a file written by graph::serialize_binary and view it in place.
+     * @details Nothing is parsed or allocated per node or edge. The header and
+     *          the sizes of the sections are always validated, the offsets and
+     *          targets only when validate is set, which reads every page once.
+     * @param validate check that the offsets do not decrease and every target
+     *        is a node, pass false only for trusted files.
+     * @throw serialization_error if the file is not a compatible binary graph,
+     *        including one written with other id or cost types, or is corrupted.
+     * @throw std::system_error if the file can not be opened or mapped.
+     */
+    [[nodiscard]] static basic_csr_graph map(const std::string& fileName, bool validate = true);
+
+    /**
+     * @brief Return number of nodes in the snapshot.
+     */
+    [[nodiscard]] inline size_type size() const noexcept { return m_numOfNodes; }
+
+    /**
+     * @brief Return the upper bound of the node ids, greater than size() if the
+     *        graph had removed nodes.
+     */
+    [[nodiscard]] inline size_type num_of_ids() const noexcept { return m_size; }
+
+    /**
+     * @brief Return true if the id belongs to a node of the snapshot, false otherwise.
+     */
+    [[nodiscard]] inline bool contains(size_type id) const noexcept
+    {
+        return id < m_size && (nullptr == m_removed || 0 == m_removed[id]);
+    }
+
+    /**
+     * @brief Return number of edges in the snapshot.
+     */
+    [[nodiscard]] inline size_type num_of_edges() const noexcept { return m_numOfEdges; }
+
+    /**
+     * @brief Returns true if the snapshot is empty, false otherwise.
+     */
+    [[nodiscard]] inline bool empty() const noexcept { return 0 == size(); }
+
+    /**
+     * @brief Borrow a traversal workspace reset for num_of_ids() ids, see graph::borrow_workspace.
+     */
+    [[nodiscard]] inline workspace_pool::workspace_ptr borrow_workspace() const { return m_workspaces.borrow(m_size); }
+
+    /**
+     * @brief Return number of outgoing edges of the node.
+     */
+    [[nodiscard]] inline size_type degree(size_type id) const { return m_offsets[id + 1] - m_offsets[id]; }
+
+    /**
+     * @brief Return the outgoing edges of the node as (target id, cost) arcs.
+     */
+    [[nodiscard]] inline arc_range out_edges(size_type id) const;
+
+    /**
+     * @brief Return the name of the node.
+     */
+    [[nodiscard]] inline std::string_view get_name(size_type id) const;
+
+public:
+    ///@{ @name Algorithms
+    /// @brief Same algorithms as in graph, working on node ids.
+    /**
+     * @return id of the mother node if found, otherwise INVALID_ID.
+     */
+    [[nodiscard]] size_type mother_node() const;
+    template <typename Count = size_type>
+    [[nodiscard]] Count num_of_paths(size_type from, size_type to) const;
+    template <typename Count = size_type, typename ForwardIt>
+    [[nodiscard]] std::vector<Count> num_of_paths(size_type from, ForwardIt first, ForwardIt last) const;
+    template <typename Count = size_type>
+    [[nodiscard]] std::vector<Count> num_of_paths_from(size_type from) const;
+    [[nodiscard]] bool is_cyclic() const;
+    template <typename Progress>
+    [[nodiscard]] bool is_cyclic(Progress&& progress, size_type numOfThreads = 0) const;
+    [[nodiscard]] std::vector<size_type> find_cycle() const;
+    [[nodiscard]] std::vector<size_type> topological_order() const;
+    [[nodiscard]] std::vector<std::vector<size_type>> topological_levels(size_type numOfThreads = 0) const;
+    [[nodiscard]] scc_result<id_type> strongly_connected_components() const;
+    [[nodiscard]] scc_result<id_type> parallel_strongly_connected_components(size_type numOfThreads = 0) const;
+    [[nodiscard]] basic_graph<Cost, Id> condensation(const scc_result<id_type>& scc) const;
+    [[nodiscard]] std::vector<cost_type> dijkstra(size_type start) const;
+    [[nodiscard]] cost_type dijkstra(size_type start, size_type target) const;
+    [[nodiscard]] shortest_path_tree<cost_type, id_type> shortest_paths(size_type start, bool withEdges = false) const;
+    [[nodiscard]] std::vector<cost_type> delta_stepping(size_type start, cost_type delta = 0,
+                                                        size_type numOfThreads = 0) const;
+    [[nodiscard]] std::vector<cost_type> delta_stepping(size_type start, cost_type delta, thread_pool& pool) const;
+    [[nodiscard]] bool has_negative_cycle() const;
+    template <typename Visitor>
+    bool bfs(size_type start, Visitor&& visitor) const;
+    template <typename Visitor>
+    bool dfs(size_type start, Visitor&& visitor) const;
+    ///@}
+
+private:
+    std::shared_ptr<const void> m_storage; // keeps the arrays alive
+    size_type m_size = 0;                  // number of ids
+    size_type m_numOfNodes = 0;
+    size_type m_numOfEdges = 0;
+    const id_type* m_offsets = nullptr;
+    const id_type* m_targets = nullptr;
+    const cost_type* m_costs = nullptr;
+    const std::uint64_t* m_nameOffsets = nullptr;
+    const char* m_names = nullptr;
+    const std::uint8_t* m_removed = nullptr; // 1 for removed ids, nullptr if there are none
+    mutable workspace_pool m_workspaces; // not shared by copies
+
+};
+
+using csr_graph = basic_csr_graph<int, std::size_t>;
+
+template <typename Id = std::size_t>
+using unweighted_csr_graph = basic_csr_graph<void, Id>;
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace impl
+{
+
+/**
+ * @class cycle_error
+ * @brief Thrown when an algorithm that needs an acyclic graph runs into a cycle.
+ */
+class cycle_error : public std::runtime_error
+{
+public:
+    cycle_error(const std::string& what, std::size_t node)
+        : std::runtime_error(what)
+        , m_node{node}
+    { }
+
+    /**
+     * @brief Return the id of a node on the cycle.
+     */
+    [[nodiscard]] inline std::size_t node() const noexcept { return m_node; }
+
+private:
+    std::size_t m_node;
+
+};
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace impl
+{
+
+/**
+ * @class edge_index
+ * @brief Open addressing hash index of the edge list of one node.
+ * @details Maps the other endpoint of every edge (the target if ByTarget,
+ *          otherwise the source) to the position of the edge in the list.
+ *          Parallel edges get one slot each. Uses linear probing on the
+ *          address of the endpoint with backward shift deletion.
+ */
+template <typename Edge, bool ByTarget>
+class edge_index
+{
+public:
+    using size_type                 = std::size_t;
+
+    constexpr static size_type NOT_FOUND = std::numeric_limits<size_type>::max();
+
+public:
+    /**
+     * @brief Index the given edge list.
+     */
+    explicit edge_index(const std::vector<Edge*>& edges);
+
+    /**
+     * @brief Return number of indexed edges.
+     */
+    [[nodiscard]] inline size_type size() const noexcept { return m_size; }
+
+    /**
+     * @brief Return position of an edge with the given endpoint, NOT_FOUND if there is none.
+     */
+    [[nodiscard]] size_type find(const void* endpoint) const noexcept;
+
+    /**
+     * @brief Return position of the given edge, NOT_FOUND if it is not indexed.
+     */
+    [[nodiscard]] size_type find(const Edge* e) const noexcept;
+
+    /**
+     * @brief Index the edge at the given position.
+     */
+    void insert(const Edge* e, size_type position);
+
+    /**
+     * @brief Move the indexed edge to another position.
+     */
+    void move(const Edge* e, size_type position) noexcept;
+
+    /**
+     * @brief Remove the edge from the index.
+     */
+    void erase(const Edge* e) noexcept;
+
+private:
+    /**
+     * @brief Slot of the index, free slots have no edge.
+     */
+    struct entry
+    {
+        const Edge* edge;
+        size_type position;
+    };
+
+private:
+    [[nodiscard]] inline static const void* endpoint_of(const Edge* e) noexcept;
+    [[nodiscard]] inline size_type home_of(const void* endpoint) const noexcept;
+    [[nodiscard]] size_type find_slot(const Edge* e) const noexcept;
+    void rehash(size_type capacity);
+
+private:
+    std::vector<entry> m_slots;
+    size_type m_size = 0;
+
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include "impl/_edge_index.hpp"
@@ -1,57 +1,164 @@
 #pragma once
 
 #include <algorithm>
-#include <map>
+#include <iterator>
 #include <queue>
 #include <stack>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
 
 #include <cassert>
 
+#include "cost_traits.hpp"
+#include "cycle_error.hpp"
 #include "widgets.hpp"
+#include "csr_graph.hpp"
+#include "indexed_heap.hpp"
+#include "mapped_file.hpp"
+#include "name_table.hpp"
+#include "object_pool.hpp"
+#include "scc_result.hpp"
+#include "serialization_error.hpp"
+#include "shortest_path_tree.hpp"
+#include "thread_pool.hpp"
+#include "traversal_workspace.hpp"
+#include "visitor.hpp"
 
 namespace impl
 {
 
 /**
- * @class graph
+ * @class basic_graph
  * @brief Class representing a graph data structure.
- * 
- * @todo Add API to take iterators.
+ * @details Cost is the type of the edge weights, an integer or floating point
+ *          type, path costs are added with cost_traits<Cost>. With void Cost
+ *          the graph is unweighted: edges store no cost, every edge costs 1,
+ *          path costs are hop counts of type Id and dijkstra runs as BFS.
+ *          Id is the unsigned type of the node ids, it bounds the number of
+ *          nodes and sets the width of the ids stored by the graph, its
+ *          snapshots and the results of the algorithms.
+ *          impl::graph is basic_graph<int, std::size_t>.
  */
-class graph
+template <typename Cost = int, typename Id = std::size_t>
+class basic_graph
 {
+    static_assert(std::is_unsigned_v<Id>, "Node ids must be an unsigned integer type");
+
 public:
     //using value_type                = ;
     using size_type                 = std::size_t;
+    using id_type                   = Id;
+    using cost_type                 = path_cost_t<Cost, Id>;
+    using node                      = basic_node<Cost, Id>;
+    using edge                      = basic_edge<Cost, Id>;
+    using arc                       = basic_arc<Cost, Id>;
+    using csr_graph                 = basic_csr_graph<Cost, Id>;
 
-private:
-    constexpr static size_type INVALID_ID = std::numeric_limits<size_type>::max();
+    constexpr static id_type INVALID_ID = std::numeric_limits<id_type>::max();
+    constexpr static bool is_weighted = !std::is_void_v<Cost>;
 
 public:
-    using node_iterator = std::vector<node*>::iterator;
-    using const_node_iterator = std::vector<node*>::const_iterator;
-    using neighbor_node_iterator = node::node_iterator;
-    using const_neighbor_node_iterator = node::const_node_iterator;
-    using edge_iterator = std::vector<const edge*>::iterator;
-    using const_edge_iterator = std::vector<const edge*>::const_iterator;
+    /**
+     * @brief Iterator over the nodes of the graph in id order, skipping the
+     *        ids of removed nodes.
+     */
+    template <typename Pointer, typename BaseIterator>
+    class live_node_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Pointer;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Pointer*;
+        using reference = Pointer;
+    public:
+        live_node_iterator(BaseIterator iter, BaseIterator last);
+
+        ~live_node_iterator() = default;
+
+        live_node_iterator& operator++();
+        live_node_iterator operator++(int);
+
+        bool operator==(const live_node_iterator& other) const;
+        bool operator!=(const live_node_iterator& other) const;
+        reference operator*() const;
+
+    private:
+        void skip_removed();
+
+    private:
+        BaseIterator m_iter;
+        BaseIterator m_last;
+    };
+
+    /**
+     * @brief Iterator over all the edges of the graph, node by node.
+     */
+    class const_edge_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = const edge*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const edge* const*;
+        using reference = const edge*;
+    public:
+        const_edge_iterator(typename std::vector<node*>::const_iterator iter, typename std::vector<node*>::const_iterator last);
+
+        ~const_edge_iterator() = default;
+
+        const_edge_iterator& operator++();
+        const_edge_iterator operator++(int);
+
+        bool operator==(const const_edge_iterator& other) const;
+        bool operator!=(const const_edge_iterator& other) const;
+        reference operator*() const;
+
+    private:
+        void skip_empty();
+
+    private:
+        typename std::vector<node*>::const_iterator m_iter;
+        typename std::vector<node*>::const_iterator m_last;
+        size_type m_edge;
+    };
+
+    using node_iterator = live_node_iterator<node*, typename std::vector<node*>::iterator>;
+    using const_node_iterator = live_node_iterator<const node*, typename std::vector<node*>::const_iterator>;
+    using neighbor_node_iterator = typename node::node_iterator;
+    using const_neighbor_node_iterator = typename node::const_node_iterator;
+    using edge_iterator = const_edge_iterator;
+    using arc_range = iterator_range<typename node::const_arc_iterator>;
 
 public:
     /**
      * @brief Construct a new empty graph object that doesn't have any nodes or edges.
      */
-    graph();
+    basic_graph();
 
-    graph(graph&& other);
+    /**
+     * @brief Construct a graph from a range of (from, to) or (from, to, cost) tuples.
+     * @see add_edges
+     */
+    template <typename ForwardIt>
+    basic_graph(ForwardIt first, ForwardIt last);
+
+    basic_graph(basic_graph&& other);
 
     /**
      * @brief Destroy the graph object
      */
-    ~graph();
+    ~basic_graph();
 
+    /**
+     * @brief Remove all the nodes and edges, releasing their memory at once.
+     */
     void clear();
 
     /**
@@ -59,20 +166,38 @@ public:
      */
     [[nodiscard]] inline size_type size() const noexcept;
 
+    /**
+     * @brief Return the upper bound of the node ids, including the ids of
+     *        removed nodes that are not compacted yet.
+     */
+    [[nodiscard]] inline size_type num_of_ids() const noexcept { return m_adjList.size(); }
+
     /**
      * @brief Return number of edges in the graph.
      */
-    [[nodiscard]] inline size_type num_of_edges() const noexcept { return m_edges.size(); }
+    [[nodiscard]] inline size_type num_of_edges() const noexcept { return m_numOfEdges; }
 
     /**
      * @brief Returns true if the graph is empty, false otherwise.
      */
     [[nodiscard]] inline bool empty() const noexcept;
 
+    /**
+     * @brief Borrow a traversal workspace reset for num_of_ids() ids.
+     * @details It goes back to the graph when the last copy of the pointer is
+     *          gone, repeated traversals reuse it without allocating.
+     */
+    [[nodiscard]] inline workspace_pool::workspace_ptr borrow_workspace() const { return m_workspaces.borrow(num_of_ids()); }
+
     /**
      * @brief Return true if the name already maps to a node, false otherwise.
      */
-    [[nodiscard]] inline bool contains(const std::string& name) const;
+    [[nodiscard]] inline bool contains(std::string_view name) const;
+
+    /**
+     * @brief Return true if the id belongs to a node that is not removed, false otherwise.
+     */
+    [[nodiscard]] inline bool contains(size_type id) const noexcept;
 
     /**
      * @brief Create a new node and add it to the graph.
@@ -81,21 +206,34 @@ public:
      * @return value indicates if a node was actually added, true means a new
      *  node was created and added, false means that a node with that name already
      *  exists in this graph, and it was not overwritten.
+     * @throw std::length_error if the ids of id_type are used up.
      */
-    bool add_node(const std::string& name);
+    bool add_node(std::string_view name);
 
     /**
      * @brief Removes the node with the given name
+     * @details Only the edges of the node are touched, in O(degree) with the
+     *          incoming index. The id of the node is left as a hole and the
+     *          ids of the other nodes do not change, the memory of the node
+     *          and its edges is reclaimed by compact().
      * 
      * @return value indicates if the node was actually removed, true means name
      *         maped to a node, and the node was removed, false otherwise.
      */
-    bool remove_node(const std::string& name);
+    bool remove_node(std::string_view name);
+
+    /**
+     * @brief Renumber the nodes to close the holes left by remove_node and
+     *        move the nodes and edges to fresh pools, releasing the old ones.
+     * @details Nodes keep their relative order, so node i gets the id i minus
+     *          the number of removed ids below i. O(V + E).
+     */
+    void compact();
 
     /**
      * @brief Return true if a connection or path exists between from and to nodes.
      */
-    [[nodiscard]] inline bool has_edge(const std::string& from, const std::string& to);
+    [[nodiscard]] inline bool has_edge(std::string_view from, std::string_view to);
 
     /**
      * @brief Create an edge between from and to with the provided weight.
@@ -105,7 +243,22 @@ public:
      * @return true if the edge was added successfully, false if the edge already
      *          exists (nothing happens in this case).
      */
-    bool add_edge(const std::string& from, const std::string& to, edge::Cost_t cost = 1);
+    bool add_edge(std::string_view from, std::string_view to, cost_type cost = 1);
+
+    /**
+     * @brief Add all the edges of a range of (from, to) or (from, to, cost) tuples.
+     * @details Endpoints are either node names or node ids. Missing named nodes
+     *          are created like in add_edge, missing ids create the nodes up to
+     *          the largest id, named after their id. The degrees are counted in
+     *          a first pass, so every adjacency vector is grown only once.
+     *          The cost defaults to 1 for (from, to) tuples. Ids are all
+     *          checked before anything is added.
+     * @throw std::length_error if an id exceeds the range of the id type.
+     * @throw std::invalid_argument if an id belongs to a removed node, or a
+     *        new id is the name of another node.
+     */
+    template <typename ForwardIt>
+    void add_edges(ForwardIt first, ForwardIt last);
 
     /**
      * @brief Removes the edge between from and to nodes.
@@ -113,28 +266,61 @@ public:
      * @return true if the edge existed and was removed successfully, false if
      *         either nodes or the edge was not found.
      */
-    bool remove_edge(const std::string& from, const std::string& to);
+    bool remove_edge(std::string_view from, std::string_view to);
 
-    [[nodiscard]] bool compare(const graph* g) const;
+    /**
+     * @brief Return true if g has the same nodes, names and edges, by id.
+     */
+    [[nodiscard]] bool compare(const basic_graph* g) const;
 
     neighbor_node_iterator begin_neighbors(node* start) { return start->begin_nodes(); };
-    neighbor_node_iterator begin_neighbors(const std::string& name) { return begin_neighbors(get_node(name)); };
+    neighbor_node_iterator begin_neighbors(std::string_view name) { return begin_neighbors(get_node(name)); };
     neighbor_node_iterator end_neighbors(node* start) { return start->end_nodes(); };
-    neighbor_node_iterator end_neighbors(const std::string& name) { return end_neighbors(get_node(name)); };
+    neighbor_node_iterator end_neighbors(std::string_view name) { return end_neighbors(get_node(name)); };
     const_neighbor_node_iterator begin_neighbors(const node* start) const { return start->cbegin_nodes(); };
-    const_neighbor_node_iterator begin_neighbors(const std::string& name) const { return begin_neighbors(get_node(name)); };
+    const_neighbor_node_iterator begin_neighbors(std::string_view name) const { return begin_neighbors(get_node(name)); };
     const_neighbor_node_iterator end_neighbors(const node* start) const { return start->cend_nodes(); };
-    const_neighbor_node_iterator end_neighbors(const std::string& name) const { return end_neighbors(get_node(name)); };
-    const_neighbor_node_iterator cbegin_neighbors(const std::string& name) const { return begin_neighbors(name); };
-    const_neighbor_node_iterator cend_neighbors(const std::string& name) const { return end_neighbors(name); };
+    const_neighbor_node_iterator end_neighbors(std::string_view name) const { return end_neighbors(get_node(name)); };
+    const_neighbor_node_iterator cbegin_neighbors(std::string_view name) const { return begin_neighbors(name); };
+    const_neighbor_node_iterator cend_neighbors(std::string_view name) const { return end_neighbors(name); };
+
+    /**
+     * @brief Iterators over the nodes with an edge to the given node.
+     * @details Empty if the incoming edges are not indexed.
+     */
+    neighbor_node_iterator begin_in_neighbors(node* start) { return start->begin_in_nodes(); };
+    neighbor_node_iterator begin_in_neighbors(std::string_view name) { return begin_in_neighbors(get_node(name)); };
+    neighbor_node_iterator end_in_neighbors(node* start) { return start->end_in_nodes(); };
+    neighbor_node_iterator end_in_neighbors(std::string_view name) { return end_in_neighbors(get_node(name)); };
+    const_neighbor_node_iterator begin_in_neighbors(const node* start) const { return start->begin_in_nodes(); };
+    const_neighbor_node_iterator begin_in_neighbors(std::string_view name) const { return begin_in_neighbors(get_node(name)); };
+    const_neighbor_node_iterator end_in_neighbors(const node* start) const { return start->end_in_nodes(); };
+    const_neighbor_node_iterator end_in_neighbors(std::string_view name) const { return end_in_neighbors(get_node(name)); };
+    const_neighbor_node_iterator cbegin_in_neighbors(std::string_view name) const { return begin_in_neighbors(name); };
+    const_neighbor_node_iterator cend_in_neighbors(std::string_view name) const { return end_in_neighbors(name); };
+
+    /**
+     * @brief Turn the index of incoming edges on or off, it is on by default.
+     * @details While on, every node also lists its incoming edges, kept up to
+     *          date by add_edge, remove_edge and remove_node. Turning it on
+     *          indexes the existing edges in O(V + E), turning it off releases
+     *          the lists. Without the index remove_node scans all the edges
+     *          and shortest_path searches forward only.
+     */
+    void index_incoming_edges(bool enable);
+
+    /**
+     * @brief Returns true if the incoming edges are indexed, false otherwise.
+     */
+    [[nodiscard]] inline bool has_incoming_index() const noexcept { return m_incomingIndex; }
 
     /**
      * @brief Return an iterator that yields the node names (in no particular order).
      */
-    node_iterator begin_nodes() { return m_adjList.begin(); }
-    node_iterator end_nodes() { return m_adjList.end(); }
-    const_node_iterator begin_nodes() const { return m_adjList.cbegin(); }
-    const_node_iterator end_nodes() const { return m_adjList.cend(); }
+    node_iterator begin_nodes() { return node_iterator(m_adjList.begin(), m_adjList.end()); }
+    node_iterator end_nodes() { return node_iterator(m_adjList.end(), m_adjList.end()); }
+    const_node_iterator begin_nodes() const { return const_node_iterator(m_adjList.cbegin(), m_adjList.cend()); }
+    const_node_iterator end_nodes() const { return const_node_iterator(m_adjList.cend(), m_adjList.cend()); }
     const_node_iterator cbegin_nodes() const { return begin_nodes(); }
     const_node_iterator cend_nodes() const { return end_nodes(); }
 
@@ -144,66 +330,303 @@ public:
      */
     //edge_iterator edges() const;
 
+    /**
+     * @brief Return the outgoing edges of the node with the given id as
+     *        (target id, cost) arcs, empty for the id of a removed node.
+     */
+    [[nodiscard]] inline arc_range out_edges(size_type id) const;
+
+    /**
+     * @brief Return number of outgoing edges of the node with the given id, 0 for a removed node.
+     */
+    [[nodiscard]] inline size_type degree(size_type id) const;
+
+    /**
+     * @brief Return the incoming edges of the node with the given id as
+     *        (source id, cost) arcs, empty if they are not indexed.
+     */
+    [[nodiscard]] inline arc_range in_edges(size_type id) const;
+
+    /**
+     * @brief Take an immutable CSR snapshot of the graph.
+     * @details The snapshot keeps the node ids and provides the same algorithms,
+     *          storing one index and one cost per edge in flat arrays.
+     */
+    [[nodiscard]] csr_graph freeze() const;
+
     /**
      * @brief Dumps the graph object to ostream.
      */
     void dump(std::ostream& os) const;
 
     void serialize(const std::string& fileName) const;
+
+    /**
+     * @brief Replace the graph with the one serialized to the file.
+     * @details The whole file is mapped and tokenized in place, numbers are
+     *          parsed with std::from_chars. On error the graph is left empty.
+     * @throw serialization_error with the line of the malformed data.
+     * @throw std::system_error if the file can not be opened.
+     */
     void deserialize(const std::string& fileName);
 
+    /**
+     * @brief Replace the graph with the one serialized to the file, parsing
+     *        it on the given number of threads (0 means all the cores).
+     * @details Requires the layout written by serialize: the number of nodes
+     *          on the first line, then one node with all its edges per line.
+     *          After indexing the newlines, each thread parses whole lines,
+     *          creates their edges in its own pool and fills the adjacency of
+     *          those nodes, the pools are merged at the end.
+     * @throw serialization_error with the line of the malformed data.
+     * @throw std::system_error if the file can not be opened.
+     */
+    void deserialize(const std::string& fileName, size_type numOfThreads);
+
+    /**
+     * @brief Serialize the graph to the versioned binary format.
+     * @details The file can be viewed in place with csr_graph::map.
+     * @throw serialization_error if the file can not be written.
+     */
+    void serialize_binary(const std::string& fileName) const;
+
 public:
     ///@{ @name Algorithms
     /// @brief Algorithms to work with the graph.
     /**
      * @brief What is a Mother Vertex?
      * @details A mother vertex in a graph G = (V,E) is a vertex v such that all
-     *          other vertices in G can be reached by a path from v.
+     *          other vertices in G can be reached by a path from v. Found in
+     *          O(V + E) by one pass of depth first searches sharing their
+     *          visited marks, the last start is checked by a bitset BFS.
      * 
      * @return const pointer to mother node if found, otherwise nullptr.
      */
     [[nodiscard]] const node* mother_node() const;
     /**
      * @brief Count the total number of ways or paths that exist between two vertices in a directed graph.
-     * @details These paths don’t contain a cycle, the simple enough reason is
-     *          that a cycle contains an infinite number of paths and hence they create a problem.
+     * @details Paths end at the first visit of the target. Runs in O(V + E),
+     *          by dynamic programming over the nodes reachable from the
+     *          source in topological order.
+     * @tparam Count type of the count, integer counts are checked for
+     *         overflow, a floating point or big integer type counts further.
+     * @throw cycle_error if a cycle lies on a path, which gives an infinite number of paths.
+     * @throw std::overflow_error if the count does not fit an integer Count.
+     */
+    template <typename Count = size_type>
+    [[nodiscard]] Count num_of_paths(const node* from, const node* to) const;
+    /**
+     * @brief Count the paths from one node to each node of [first, last) at once.
+     * @details One depth first search and one sweep of the nodes reachable
+     *          from the source in topological order count the paths to all of
+     *          them, then the counts of the targets are gathered. Paths go on
+     *          through the targets, so unlike num_of_paths(from, to) a cycle
+     *          through a target gives it an infinite number of paths. Ids
+     *          that are not in the graph count 0.
+     * @return the counts, in the order of the targets.
+     * @throw cycle_error if a cycle lies on a path to one of the targets.
+     * @throw std::overflow_error if the count of a target does not fit an integer Count.
+     */
+    template <typename Count = size_type, typename ForwardIt>
+    [[nodiscard]] std::vector<Count> num_of_paths(size_type from, ForwardIt first, ForwardIt last) const;
+    /**
+     * @brief Count the paths from one node to every node, in the same sweep.
+     * @return the counts indexed by node id, 0 for the nodes not reachable.
+     * @throw cycle_error if a cycle is reachable from the source.
+     * @throw std::overflow_error if a count does not fit an integer Count.
      */
-    [[nodiscard]] size_type num_of_paths(const node* from, const node* to) const;
+    template <typename Count = size_type>
+    [[nodiscard]] std::vector<Count> num_of_paths_from(size_type from) const;
 
     /**
      * @brief Given a directed graph, check whether the graph contains a cycle or not.
+     * @details Iterative depth first search, stack safe on long chains. The
+     *          three colors of the nodes are epoch stamps of one borrowed
+     *          workspace, shared by the searches from all roots.
      */
     [[nodiscard]] bool is_cyclic() const;
+    /**
+     * @brief Same as is_cyclic, with Kahn's algorithm.
+     * @details The in-degrees are counted in parallel, then nodes without
+     *          incoming edges are removed one after another. Nodes left over
+     *          are on or behind a cycle.
+     * @param progress called as progress(removed, total) every
+     *        65536 removed nodes and once at the end.
+     * @param numOfThreads number of threads counting the in-degrees, 0 uses
+     *        all hardware threads.
+     */
+    template <typename Progress>
+    [[nodiscard]] bool is_cyclic(Progress&& progress, size_type numOfThreads = 0) const;
+    /**
+     * @brief Return the ids of a cycle, each node has an edge to the next one
+     *        and the last one to the first one, empty if the graph is acyclic.
+     */
+    [[nodiscard]] std::vector<size_type> find_cycle() const;
+
+    /**
+     * @brief Return the ids of the nodes in topological order, every edge goes
+     *        from a node to a later one.
+     * @details Kahn's algorithm in O(V + E), nodes without incoming edges come
+     *          first, by id.
+     * @throw cycle_error if the graph has a cycle, naming a node of it.
+     */
+    [[nodiscard]] std::vector<size_type> topological_order() const;
+    /**
+     * @brief Group the nodes into levels, each node comes one level after the
+     *        last of its predecessors.
+     * @details The nodes of a level have no path between them, so they can be
+     *          processed concurrently once the levels before are done. Level
+     *          synchronous parallel Kahn's algorithm with atomic in-degrees,
+     *          the ids of a level are sorted.
+     * @param numOfThreads number of threads, 0 uses all hardware threads.
+     * @throw cycle_error if the graph has a cycle, naming a node of it.
+     */
+    [[nodiscard]] std::vector<std::vector<size_type>> topological_levels(size_type numOfThreads = 0) const;
+
+    /**
+     * @brief Strongly connected components, numbered in topological order:
+     *        the edges between components go to higher components.
+     * @details Iterative Tarjan's algorithm in O(V + E), stack safe.
+     */
+    [[nodiscard]] scc_result<id_type> strongly_connected_components() const;
+    /**
+     * @brief Same components found by several threads, for large graphs,
+     *        numbered in no particular order.
+     * @details Trims the nodes that are components on their own, takes the
+     *          component of a high degree pivot by a forward and a backward
+     *          search (FW-BW), then the rest by coloring: every node gets the
+     *          largest id reaching it, the nodes of a color reaching its root
+     *          backward are the component of the root.
+     * @param numOfThreads number of threads, 0 uses all hardware threads.
+     */
+    [[nodiscard]] scc_result<id_type> parallel_strongly_connected_components(size_type numOfThreads = 0) const;
+    /**
+     * @brief Return the condensation, the acyclic graph of the components.
+     * @details Node c, named after c, is component c. Components get one edge
+     *          if any of their nodes do, with the lowest cost. A node u
+     *          reaches v if and only if component(u) reaches component(v),
+     *          the graph has a mother node if and only if the condensation
+     *          does, and it is cyclic if and only if a component has more than
+     *          one node or a node has an edge to itself.
+     */
+    [[nodiscard]] basic_graph condensation(const scc_result<id_type>& scc) const;
 
     /**
      * @brief Given a graph and a source vertex in the graph, find shortest paths
      *        from source to all vertices in the given graph.
      * 
+     * @details Costs must be non-negative. Every node enters the heap once and
+     *          has its key lowered in place, so no stale entries are popped.
+     *
      * @return vector of costs from source to all nodes.
      */
-    [[nodiscard]] std::vector<edge::Cost_t> dijkstra(size_type start) const;
+    [[nodiscard]] std::vector<cost_type> dijkstra(size_type start) const;
+
+    /**
+     * @brief Shortest path cost from source to target, stops as soon as the
+     *        target is settled.
+     *
+     * @return cost of the shortest path, edge::INF_COST if target is not reachable.
+     */
+    [[nodiscard]] cost_type dijkstra(size_type start, size_type target) const;
+
+    /**
+     * @brief Dijkstra that also records the predecessor of every node, in the
+     *        same relaxation loop.
+     * @param withEdges also record which outgoing edge of the predecessor is
+     *        used, as its position in get_edges() of the predecessor.
+     *
+     * @return costs and predecessors, paths are walked with path(target).
+     */
+    [[nodiscard]] shortest_path_tree<cost_type, id_type> shortest_paths(size_type start, bool withEdges = false) const;
+
+    /**
+     * @brief Shortest path between two nodes with bidirectional dijkstra.
+     * @details Searches forward from the source over the outgoing edges and
+     *          backward from the target over the incoming edges, until the
+     *          two searches meet. Without the incoming index only the forward
+     *          search runs. Costs must be non-negative.
+     */
+    [[nodiscard]] shortest_path_result<cost_type, id_type> shortest_path(size_type from, size_type to) const;
+
+    /**
+     * @brief Shortest path between two nodes with A*.
+     * @param heuristic callable as heuristic(id), returning a lower bound of
+     *        the cost from the node to the target. The tighter the bound,
+     *        the fewer nodes are settled.
+     */
+    template <typename Heuristic>
+    [[nodiscard]] shortest_path_result<cost_type, id_type> shortest_path(size_type from, size_type to,
+                                                                            Heuristic&& heuristic) const;
+
+    /**
+     * @brief Parallel delta-stepping version of dijkstra, returns the same costs.
+     * @details Nodes are grouped in buckets of width delta by tentative cost and
+     *          all nodes of the lowest bucket relax their light edges (cost up
+     *          to delta) concurrently until the bucket stays empty, then its
+     *          heavy edges once. Small delta does less redundant work, large
+     *          delta exposes more parallelism. Costs must be non-negative.
+     * @param delta bucket width, 0 picks the largest edge cost divided by the average degree.
+     * @param numOfThreads number of threads, 0 uses all hardware threads.
+     *
+     * @return vector of costs from source to all nodes.
+     */
+    [[nodiscard]] std::vector<cost_type> delta_stepping(size_type start, cost_type delta = 0,
+                                                           size_type numOfThreads = 0) const;
+    /**
+     * @brief Same, on the threads of pool, which repeated searches can share.
+     */
+    [[nodiscard]] std::vector<cost_type> delta_stepping(size_type start, cost_type delta, thread_pool& pool) const;
 
     /**
      * @brief Given a directed graph, check whether the graph contains a negative cycle or not.
      */
     [[nodiscard]] bool has_negative_cycle() const;
-    ///@}
 
-private:
-    ///@{ @name Algorithms Utils
-    bool is_cyclic_util(size_type i, std::vector<bool>& visited, std::vector<bool>& stack) const;
-    ///@}
+    /**
+     * @brief Breadth first search from start, calling the visitor on every
+     *        node and edge it reaches.
+     * @param visitor callbacks as in default_visitor, whose return values
+     *        prune or stop the search.
+     * @return true if the visitor stopped the search, false otherwise.
+     */
+    template <typename Visitor>
+    bool bfs(size_type start, Visitor&& visitor) const;
 
+    /**
+     * @brief Depth first search from start, calling the visitor on every
+     *        node and edge it reaches, see bfs. Also reports back edges.
+     */
+    template <typename Visitor>
+    bool dfs(size_type start, Visitor&& visitor) const;
+
+    /**
+     * @brief Multi-threaded breadth first search returning the level and the
+     *        parent of every node.
+     * @details Direction-optimizing: while the frontier is small its nodes
+     *          claim their unvisited targets (top-down). Once the edges of
+     *          the frontier outnumber the edges left to check by far, every
+     *          unvisited node looks for a parent in the frontier over its
+     *          incoming edges instead (bottom-up), until the frontier shrinks
+     *          again. Without the incoming index all steps are top-down.
+     *          Any parent one level up may be reported.
+     * @param numOfThreads number of threads, 0 uses all hardware threads.
+     */
+    [[nodiscard]] bfs_result<id_type> parallel_bfs(size_type start, size_type numOfThreads = 0) const;
+    ///@}
 
 public:
     /**
      * @class iterator
      * @brief Iterator class to provide DFS and BFS traversal functionality.
+     * @details The visited nodes and the frontier live in a workspace borrowed
+     *          from the graph, copies of the iterator share it, so advancing
+     *          one of them advances the traversal of all (single pass).
      */
     class iterator
     {
     public:
-        using iterator_category = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
         using value_type = node;
         using difference_type = size_t;
         using pointer = node*;
@@ -218,9 +641,12 @@ public:
         };
 
     public:
-        explicit iterator(const graph& g, node* n, iter_type type);
+        explicit iterator(const basic_graph& g, node* n, iter_type type);
         ~iterator() = default;
 
+        /**
+         * @brief Move to the next node, the end iterator stays at the end.
+         */
         iterator& operator++();
         iterator operator++(int);
 
@@ -239,14 +665,14 @@ public:
     private:
         iter_type m_type;
         node* m_node; // nullptr means the end of the graph
-        std::vector<bool> m_visited;
-        std::deque<node*> m_deque;
+        const std::vector<node*>* m_adjList;
+        workspace_pool::workspace_ptr m_workspace; // shared by the copies
     };
 
     class const_iterator
     {
     public:
-        using iterator_category = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
         using value_type = node;
         using difference_type = size_t;
         using pointer = node*;
@@ -261,9 +687,12 @@ public:
         };
 
     public:
-        explicit const_iterator(const graph& g, const node* n, iter_type type);
+        explicit const_iterator(const basic_graph& g, const node* n, iter_type type);
         ~const_iterator() = default;
 
+        /**
+         * @brief Move to the next node, the end iterator stays at the end.
+         */
         const_iterator& operator++();
         const_iterator operator++(int);
 
@@ -282,57 +711,89 @@ public:
     private:
         iter_type m_type;
         const node* m_node; // nullptr means the end of the graph
-        std::vector<bool> m_visited;
-        std::deque<const node*> m_deque;
+        const std::vector<node*>* m_adjList;
+        workspace_pool::workspace_ptr m_workspace; // shared by the copies
     };
 
     [[nodiscard]] iterator begin_BFS(size_type start) { return iterator(*this, get_node(start), iterator::iter_type::BFS); }
-    [[nodiscard]] iterator begin_BFS(const std::string& name) { return iterator(*this, get_node(name), iterator::iter_type::BFS); }
+    [[nodiscard]] iterator begin_BFS(std::string_view name) { return iterator(*this, get_node(name), iterator::iter_type::BFS); }
     [[nodiscard]] iterator end_BFS() { return iterator(*this, nullptr, iterator::iter_type::BFS); }
     [[nodiscard]] iterator begin_DFS(size_type start) { return iterator(*this, get_node(start), iterator::iter_type::DFS); }
-    [[nodiscard]] iterator begin_DFS(const std::string& name) { return iterator(*this, get_node(name), iterator::iter_type::DFS); }
+    [[nodiscard]] iterator begin_DFS(std::string_view name) { return iterator(*this, get_node(name), iterator::iter_type::DFS); }
     [[nodiscard]] iterator end_DFS() { return iterator(*this, nullptr, iterator::iter_type::DFS); }
 
     [[nodiscard]] const_iterator begin_BFS(size_type start) const { return const_iterator(*this, get_node(start), const_iterator::iter_type::BFS); }
-    [[nodiscard]] const_iterator begin_BFS(const std::string& name) const { return const_iterator(*this, get_node(name), const_iterator::iter_type::BFS); }
+    [[nodiscard]] const_iterator begin_BFS(std::string_view name) const { return const_iterator(*this, get_node(name), const_iterator::iter_type::BFS); }
     [[nodiscard]] const_iterator end_BFS() const { return const_iterator(*this, nullptr, const_iterator::iter_type::BFS); }
     [[nodiscard]] const_iterator begin_DFS(size_type start) const { return const_iterator(*this, get_node(start), const_iterator::iter_type::DFS); }
-    [[nodiscard]] const_iterator begin_DFS(const std::string& name) const { return const_iterator(*this, get_node(name), const_iterator::iter_type::DFS); }
+    [[nodiscard]] const_iterator begin_DFS(std::string_view name) const { return const_iterator(*this, get_node(name), const_iterator::iter_type::DFS); }
     [[nodiscard]] const_iterator end_DFS() const { return const_iterator(*this, nullptr, const_iterator::iter_type::DFS); }
 
     [[nodiscard]] const_iterator cbegin_BFS(size_type start) const { return begin_BFS(start); }
-    [[nodiscard]] const_iterator cbegin_BFS(const std::string& name) const { return begin_BFS(name); }
+    [[nodiscard]] const_iterator cbegin_BFS(std::string_view name) const { return begin_BFS(name); }
     [[nodiscard]] const_iterator cend_BFS() const { return end_BFS(); }
     [[nodiscard]] const_iterator cbegin_DFS(size_type start) const { return begin_DFS(start); }
-    [[nodiscard]] const_iterator cbegin_DFS(const std::string& name) const { return begin_DFS(name); }
+    [[nodiscard]] const_iterator cbegin_DFS(std::string_view name) const { return begin_DFS(name); }
     [[nodiscard]] const_iterator cend_DFS() const { return end_DFS(); }
 
-    [[nodiscard]] edge_iterator begin_edges() { return m_edges.begin(); }
-    [[nodiscard]] edge_iterator end_edges() { return m_edges.end(); }
-    [[nodiscard]] const_edge_iterator begin_edges() const { return m_edges.cbegin(); }
-    [[nodiscard]] const_edge_iterator end_edges() const { return m_edges.cend(); }
+    [[nodiscard]] const_edge_iterator begin_edges() const { return const_edge_iterator(m_adjList.cbegin(), m_adjList.cend()); }
+    [[nodiscard]] const_edge_iterator end_edges() const { return const_edge_iterator(m_adjList.cend(), m_adjList.cend()); }
     [[nodiscard]] const_edge_iterator cbegin_edges() const { return begin_edges(); }
     [[nodiscard]] const_edge_iterator cend_edges() const { return end_edges(); }
 
 
-    [[nodiscard]] inline node* get_node(const std::string& name);
-    [[nodiscard]] inline const node* get_node(const std::string& name) const;
+    [[nodiscard]] inline node* get_node(std::string_view name);
+    [[nodiscard]] inline const node* get_node(std::string_view name) const;
 
-private:
-    [[nodiscard]] inline size_type get_node_id(const std::string& name) const;
+    /**
+     * @brief Return the node with the given id, nullptr if there is none or it was removed.
+     */
     [[nodiscard]] inline node* get_node(size_type start);
     [[nodiscard]] inline const node* get_node(size_type start) const;
-    [[nodiscard]] inline node* get_or_create_node(const std::string& name);
-    [[nodiscard]] inline bool add_edge(node* fromNode, node* toNode, edge::Cost_t cost);
-    inline void add_edge(edge* e);
 
 private:
-    std::vector<node*> m_adjList;
-    std::vector<const edge*> m_edges;
-    std::map<std::string, node*> m_nameToNode;
+    [[nodiscard]] inline size_type get_node_id(std::string_view name) const;
+    /**
+     * @throw std::length_error if the name is new and all the ids are taken.
+     */
+    inline void check_free_id(std::string_view name) const;
+    [[nodiscard]] inline node* get_or_create_node(std::string_view name);
+    [[nodiscard]] inline node* create_node(size_type id, std::string_view name);
+    void deserialize(const std::string& fileName, const char* first, const char* last);
+    void deserialize(const std::string& fileName, const char* first, const char* last, thread_pool& pool);
+    [[nodiscard]] inline bool add_edge(node* fromNode, node* toNode, cost_type cost);
+
+    /**
+     * @brief Return the id every node gets by compact(), INVALID_ID for removed ids.
+     */
+    [[nodiscard]] std::vector<id_type> compacted_ids() const;
+
+    /**
+     * @brief Fill the incoming edge lists of all the nodes from their outgoing edges.
+     */
+    void build_incoming_index();
+    /**
+     * @brief Same, with the in-degrees of the ids already counted.
+     */
+    void build_incoming_index(const std::vector<size_type>& inDegrees);
+
+private:
+    std::vector<node*> m_adjList; // nullptr for the ids of removed nodes
+    size_type m_numOfRemoved = 0;
+    size_type m_numOfEdges = 0;
+    name_table m_names;
+    object_pool<node> m_nodePool;
+    object_pool<edge> m_edgePool;
+    bool m_incomingIndex = true;
+    mutable workspace_pool m_workspaces;
 
 };
 
+using graph = basic_graph<int, std::size_t>;
+
+template <typename Id = std::size_t>
+using unweighted_graph = basic_graph<void, Id>;
+
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -340,11 +801,19 @@ private:
 ////////////////////////////////////////////////////////////////////////////////
 #include "impl/_graph_iterator.hpp"
 #include "impl/_graph.hpp"
+#include "impl/_csr_graph.hpp"
+#include "impl/_traversal.hpp"
+#include "impl/_parallel_bfs.hpp"
 #include "impl/_mother_node.hpp"
 #include "impl/_num_of_paths.hpp"
 #include "impl/_is_cyclic.hpp"
+#include "impl/_topological_sort.hpp"
+#include "impl/_scc.hpp"
 #include "impl/_dijkstra.hpp"
+#include "impl/_delta_stepping.hpp"
+#include "impl/_shortest_path.hpp"
 #include "impl/_has_negative_cycle.hpp"
 
 #include "impl/_serialize.hpp"
 #include "impl/_deserialize.hpp"
+#include "impl/_binary_format.hpp"
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace impl
+{
+
+/**
+ * @class indexed_heap
+ * @brief Min d-ary heap of ids in [0, capacity) with decrease-key.
+ * @details Every id is in the heap at most once, the position of each id is
+ *          tracked so that its key can be lowered in place. Keys and ids are
+ *          stored next to each other, a node of the heap has Arity children.
+ */
+template <typename Key, std::size_t Arity = 4>
+class indexed_heap
+{
+    static_assert(Arity >= 2, "indexed_heap needs at least two children per node");
+
+public:
+    using size_type                 = std::size_t;
+    using key_type                  = Key;
+    using value_type                = std::pair<Key, size_type>;
+
+    constexpr static size_type NOT_IN_HEAP = std::numeric_limits<size_type>::max();
+
+public:
+    /**
+     * @brief Construct an empty heap for ids in [0, capacity).
+     */
+    explicit indexed_heap(size_type capacity = 0);
+
+    /**
+     * @brief Returns true if the heap is empty, false otherwise.
+     */
+    [[nodiscard]] inline bool empty() const noexcept { return m_heap.empty(); }
+
+    /**
+     * @brief Return number of ids in the heap.
+     */
+    [[nodiscard]] inline size_type size() const noexcept { return m_heap.size(); }
+
+    /**
+     * @brief Returns true if the id is in the heap, false otherwise.
+     */
+    [[nodiscard]] inline bool contains(size_type id) const { return NOT_IN_HEAP != m_positions[id]; }
+
+    /**
+     * @brief Return the (key, id) pair with the smallest key.
+     */
+    [[nodiscard]] inline const value_type& top() const { return m_heap.front(); }
+
+    /**
+     * @brief Insert the id if it is not in the heap, otherwise lower its key.
+     * @return true if the id was inserted or its key lowered, false if the
+     *         key in the heap is already smaller or equal.
+     */
+    bool push_or_decrease(size_type id, Key key);
+
+    /**
+     * @brief Remove the (key, id) pair with the smallest key.
+     */
+    void pop();
+
+    /**
+     * @brief Remove all the ids, keep the memory.
+     */
+    void clear() noexcept;
+
+private:
+    void sift_up(size_type position);
+    void sift_down(size_type position);
+    void place(size_type position, const value_type& value);
+
+private:
+    std::vector<value_type> m_heap;
+    std::vector<size_type> m_positions;
+
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include "impl/_indexed_heap.hpp"
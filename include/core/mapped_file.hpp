@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GRAPH_HAS_MMAP 1
+#else
+#define GRAPH_HAS_MMAP 0
+#endif
+
+namespace impl
+{
+
+/**
+ * @class mapped_file
+ * @brief Read-only view of a whole file.
+ * @details The file is memory mapped where mmap is available, so its pages are
+ *          only read when touched. Elsewhere the file is read into a buffer.
+ *          The data is aligned to at least 8 bytes.
+ */
+class mapped_file
+{
+public:
+    using size_type                 = std::size_t;
+
+public:
+    /**
+     * @brief Map the file.
+     * @throw std::system_error if the file can not be opened or mapped.
+     */
+    explicit mapped_file(const std::string& fileName);
+
+    /**
+     * @brief Unmap the file.
+     */
+    ~mapped_file();
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    [[nodiscard]] inline const char* data() const noexcept { return m_data; }
+    [[nodiscard]] inline size_type size() const noexcept { return m_size; }
+    [[nodiscard]] inline const char* begin() const noexcept { return m_data; }
+    [[nodiscard]] inline const char* end() const noexcept { return m_data + m_size; }
+
+private:
+    const char* m_data = nullptr;
+    size_type m_size = 0;
+#if !GRAPH_HAS_MMAP
+    std::vector<std::uint64_t> m_buffer;
+#endif
+
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include "impl/_mapped_file.hpp"
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <limits>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "object_pool.hpp"
+
+namespace impl
+{
+
+/**
+ * @class name_table
+ * @brief Interned node names with an open addressing hash index.
+ * @details Every name is copied once into a chunked character pool, so the
+ *          returned views stay valid until clear(). Lookups take a
+ *          std::string_view and never allocate. The index uses linear probing
+ *          with backward shift deletion.
+ */
+class name_table
+{
+public:
+    using size_type                 = std::size_t;
+
+    constexpr static size_type INVALID_ID = std::numeric_limits<size_type>::max();
+
+    /**
+     * @brief Slot of the hash index, free slots have INVALID_ID.
+     */
+    struct entry
+    {
+        std::string_view name;
+        size_type hash;
+        size_type id;
+    };
+
+public:
+    name_table() = default;
+    name_table(name_table&& other) noexcept;
+    name_table& operator=(name_table&& other) noexcept;
+    name_table(const name_table&) = delete;
+    name_table& operator=(const name_table&) = delete;
+
+    /**
+     * @brief Return number of mapped names.
+     */
+    [[nodiscard]] inline size_type size() const noexcept { return m_size; }
+
+    /**
+     * @brief Returns true if no name is mapped, false otherwise.
+     */
+    [[nodiscard]] inline bool empty() const noexcept { return 0 == m_size; }
+
+    /**
+     * @brief Return id mapped to the name, INVALID_ID if the name is not mapped.
+     */
+    [[nodiscard]] inline size_type find(std::string_view name) const noexcept;
+
+    /**
+     * @brief Intern the name and map it to the id, unless it is already mapped.
+     *
+     * @return the entry of the name (valid until the next insertion) and true
+     *         if the name was inserted, false if it was already mapped.
+     */
+    std::pair<const entry*, bool> emplace(std::string_view name, size_type id);
+
+    /**
+     * @brief Change the id of an already mapped name.
+     *
+     * @return true if the name was mapped, false otherwise.
+     */
+    bool assign(std::string_view name, size_type id) noexcept;
+
+    /**
+     * @brief Remove the name from the index.
+     * @details The characters stay in the pool until clear().
+     *
+     * @return true if the name was mapped and removed, false otherwise.
+     */
+    bool erase(std::string_view name) noexcept;
+
+    /**
+     * @brief Prepare the index for count names without rehashing.
+     */
+    void reserve(size_type count);
+
+    /**
+     * @brief Remove all the names and release the pool.
+     */
+    void clear() noexcept;
+
+private:
+    [[nodiscard]] inline static size_type hash_of(std::string_view name) noexcept;
+    [[nodiscard]] inline size_type find_slot(std::string_view name, size_type hash) const noexcept;
+    [[nodiscard]] std::string_view store(std::string_view name);
+    void rehash(size_type capacity);
+
+private:
+    std::vector<entry> m_slots;
+    size_type m_size = 0;
+    object_pool<char> m_chars;
+
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include "impl/_name_table.hpp"
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace impl
+{
+
+/**
+ * @class object_pool
+ * @brief Slab allocator that constructs objects in large chunks.
+ * @details Objects are never freed one by one, all of them are destroyed and
+ *          their memory is released at once by clear() or by the destructor.
+ *          Addresses of created objects stay valid until then.
+ */
+template <typename T>
+class object_pool
+{
+public:
+    using size_type                 = std::size_t;
+    using value_type                = T;
+
+    constexpr static size_type MIN_CHUNK_SIZE = 64;
+    constexpr static size_type MAX_CHUNK_SIZE = 64 * 1024;
+
+public:
+    object_pool() = default;
+    object_pool(object_pool&& other) noexcept;
+    object_pool& operator=(object_pool&& other) noexcept;
+    object_pool(const object_pool&) = delete;
+    object_pool& operator=(const object_pool&) = delete;
+
+    /**
+     * @brief Destroy all the objects and release the memory.
+     */
+    ~object_pool();
+
+    /**
+     * @brief Construct a new object in the pool.
+     */
+    template <typename... Args>
+    [[nodiscard]] T* create(Args&&... args);
+
+    /**
+     * @brief Construct count value initialized objects next to each other.
+     * @return pointer to the first object.
+     */
+    [[nodiscard]] T* create_n(size_type count);
+
+    /**
+     * @brief Make sure the next count objects are created in one chunk.
+     */
+    void reserve(size_type count);
+
+    /**
+     * @brief Take over all the objects of the other pool, leaving it empty.
+     */
+    void splice(object_pool& other);
+
+    /**
+     * @brief Destroy all the objects and release the memory.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Return number of objects created since the last clear.
+     */
+    [[nodiscard]] inline size_type size() const noexcept { return m_size; }
+
+    /**
+     * @brief Return number of objects the allocated chunks can hold.
+     */
+    [[nodiscard]] inline size_type capacity() const noexcept { return m_capacity; }
+
+private:
+    struct chunk
+    {
+        T* data;
+        size_type size;
+        size_type capacity;
+    };
+
+private:
+    [[nodiscard]] size_type next_chunk_size() const noexcept;
+    void add_chunk(size_type capacity);
+
+private:
+    std::vector<chunk> m_chunks;
+    size_type m_size = 0;
+    size_type m_capacity = 0;
+
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include "impl/_object_pool.hpp"
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace impl
+{
+
+/**
+ * @brief Strongly connected components of a graph.
+ * @details Nodes reach each other if and only if they have the same
+ *          component. Component c is node c of the condensation, where
+ *          u reaches v if and only if component(u) reaches component(v).
+ */
+template <typename Id = std::size_t>
+struct scc_result
+{
+    using size_type = std::size_t;
+
+    constexpr static Id INVALID_ID = std::numeric_limits<Id>::max();
+
+    /// component of every node id, INVALID_ID for removed ids
+    std::vector<Id> components;
+    /// number of nodes of every component
+    std::vector<Id> sizes;
+
+    /**
+     * @brief Return number of components.
+     */
+    [[nodiscard]] inline size_type count() const noexcept { return sizes.size(); }
+};
+
+}
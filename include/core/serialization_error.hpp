@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace impl
+{
+
+/**
+ * @class serialization_error
+ * @brief Thrown when a serialized graph can not be read.
+ */
+class serialization_error : public std::runtime_error
+{
+public:
+    explicit serialization_error(const std::string& what)
+        : std::runtime_error(what)
+        , m_line{0}
+    { }
+
+    /**
+     * @brief Error at the given (1 based) line of a text file.
+     */
+    serialization_error(const std::string& fileName, std::size_t line, const std::string& what)
+        : std::runtime_error(fileName + ':' + std::to_string(line) + ": " + what)
+        , m_line{line}
+    { }
+
+    /**
+     * @brief Return the line of the error, 0 if not known.
+     */
+    [[nodiscard]] inline std::size_t line() const noexcept { return m_line; }
+
+private:
+    std::size_t m_line;
+
+};
+
+}
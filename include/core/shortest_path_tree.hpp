@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#include "cost_traits.hpp"
+#include "widgets.hpp"
+
+namespace impl
+{
+
+/**
+ * @brief Shortest path between two nodes.
+ */
+template <typename Cost, typename Id = std::size_t>
+struct shortest_path_result
+{
+    using size_type = std::size_t;
+
+    /// cost of the path, infinity of Cost if the target is not reachable
+    Cost cost = cost_traits<Cost>::infinity();
+    /// ids of the nodes on the path from the source to the target, empty if not reachable
+    std::vector<Id> nodes;
+    /// number of nodes settled by the search
+    size_type settled = 0;
+};
+
+/**
+ * @brief Levels and parents of a breadth first search.
+ */
+template <typename Id = std::size_t>
+struct bfs_result
+{
+    constexpr static Id INVALID_ID = std::numeric_limits<Id>::max();
+
+    /// number of edges from the source, INVALID_ID if not reachable
+    std::vector<Id> levels;
+    /// node that reached the node, INVALID_ID for the source and if not reachable
+    std::vector<Id> parents;
+};
+
+/**
+ * @class shortest_path_tree
+ * @brief Costs and predecessors of single source shortest paths.
+ * @details Node i is reached from predecessor(i), optionally through the
+ *          predecessor_edge(i)-th outgoing edge of the predecessor. Paths are
+ *          walked back from the target lazily, without allocating.
+ */
+template <typename Cost, typename Id = std::size_t>
+class shortest_path_tree
+{
+public:
+    using size_type                 = std::size_t;
+    using id_type                   = Id;
+    using cost_type                 = Cost;
+
+    constexpr static id_type INVALID_ID = std::numeric_limits<id_type>::max();
+    constexpr static cost_type INF_COST = cost_traits<cost_type>::infinity();
+
+public:
+    /**
+     * @brief Iterator over the nodes of a path, from the target back to the source.
+     */
+    class path_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = id_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const id_type*;
+        using reference = id_type;
+    public:
+        path_iterator(const id_type* predecessors, id_type id);
+
+        ~path_iterator() = default;
+
+        path_iterator& operator++();
+        path_iterator operator++(int);
+
+        bool operator==(const path_iterator& other) const;
+        bool operator!=(const path_iterator& other) const;
+        value_type operator*() const;
+
+    private:
+        const id_type* m_predecessors;
+        id_type m_id;
+    };
+
+    using path_range = iterator_range<path_iterator>;
+
+public:
+    /**
+     * @brief Construct a tree of size nodes where only the source is reached.
+     * @param withEdges also record the predecessor edge of every node.
+     */
+    shortest_path_tree(size_type size, size_type source, bool withEdges = false);
+
+    /**
+     * @brief Return number of nodes.
+     */
+    [[nodiscard]] inline size_type size() const noexcept { return m_costs.size(); }
+
+    /**
+     * @brief Return id of the source node.
+     */
+    [[nodiscard]] inline id_type source() const noexcept { return m_source; }
+
+    /**
+     * @brief Return cost of the shortest path to the node, INF_COST if not reached.
+     */
+    [[nodiscard]] inline cost_type cost(size_type id) const { return m_costs[id]; }
+
+    /**
+     * @brief Return costs of the shortest paths to all nodes.
+     */
+    [[nodiscard]] inline const std::vector<cost_type>& costs() const noexcept { return m_costs; }
+
+    /**
+     * @brief Returns true if the node is reached from the source, false otherwise.
+     */
+    [[nodiscard]] inline bool reachable(size_type id) const { return INF_COST != m_costs[id]; }
+
+    /**
+     * @brief Return the node preceding the node on its shortest path,
+     *        INVALID_ID for the source and not reached nodes.
+     */
+    [[nodiscard]] inline id_type predecessor(size_type id) const { return m_predecessors[id]; }
+
+    /**
+     * @brief Returns true if predecessor edges are recorded, false otherwise.
+     */
+    [[nodiscard]] inline bool has_predecessor_edges() const noexcept { return !m_edges.empty(); }
+
+    /**
+     * @brief Return position of the edge to the node among the outgoing edges
+     *        of its predecessor, INVALID_ID if there is none or edges are not recorded.
+     */
+    [[nodiscard]] inline size_type predecessor_edge(size_type id) const
+    {
+        return has_predecessor_edges() ? m_edges[id] : INVALID_ID;
+    }
+
+    /**
+     * @brief Return nodes of the shortest path from the target back to the
+     *        source, empty if the target is not reached.
+     */
+    [[nodiscard]] path_range path(size_type target) const;
+
+    /**
+     * @brief Record that the node is reached through the rank-th edge of from.
+     */
+    inline void relax(size_type id, cost_type cost, size_type from, size_type rank);
+
+private:
+    id_type m_source;
+    std::vector<cost_type> m_costs;
+    std::vector<id_type> m_predecessors;
+    std::vector<size_type> m_edges;
+
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include "impl/_shortest_path_tree.hpp"
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace impl
+{
+
+/**
+ * @class thread_pool
+ * @brief Fixed set of worker threads running one job at a time.
+ * @details The calling thread takes part in every job as worker 0, so a pool
+ *          of one thread runs everything inline without spawning threads.
+ *          The first exception thrown by a worker is rethrown to the caller.
+ */
+class thread_pool
+{
+public:
+    using size_type                 = std::size_t;
+
+public:
+    /**
+     * @brief Start the workers.
+     * @param numOfThreads total number of threads including the caller,
+     *        0 means std::thread::hardware_concurrency().
+     */
+    explicit thread_pool(size_type numOfThreads = 0);
+
+    /**
+     * @brief Stop and join the workers.
+     */
+    ~thread_pool();
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    /**
+     * @brief Return number of threads including the caller.
+     */
+    [[nodiscard]] inline size_type size() const noexcept { return m_threads.size() + 1; }
+
+    /**
+     * @brief Call job(worker) once on every worker and wait for all of them.
+     */
+    template <typename Job>
+    void run(Job&& job);
+
+    /**
+     * @brief Split [0, count) into blocks and call job(first, last, worker)
+     *        for each of them, blocks are handed out dynamically.
+     * @param grain size of the blocks, 0 picks one from count and size().
+     */
+    template <typename Job>
+    void parallel_for(size_type count, Job&& job, size_type grain = 0);
+
+private:
+    void run_job(const std::function<void(size_type)>& job);
+    void worker_loop(size_type worker);
+
+private:
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    const std::function<void(size_type)>* m_job = nullptr;
+    size_type m_generation = 0;
+    size_type m_pending = 0;
+    bool m_stop = false;
+    std::exception_ptr m_error;
+
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include "impl/_thread_pool.hpp"
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace impl
+{
+
+/**
+ * @class traversal_workspace
+ * @brief Visited marks, frontier and DFS path of a graph traversal, reusable without allocation.
+ * @details A node is visited if its stamp is the current epoch, and finished
+ *          if its stamp is the epoch + 1, so reset() forgets all the marks by
+ *          bumping the epoch instead of clearing them. The frontier holds every node at most once per traversal,
+ *          nodes are taken from its front for BFS and from its back for DFS.
+ *          The path is the frame stack of the iterative DFS, its frames hold
+ *          arc iterators of the graph, so it is typed on first use.
+ *          Memory only grows, to the largest graph the workspace was reset for.
+ */
+class traversal_workspace
+{
+public:
+    using size_type                 = std::size_t;
+    using epoch_type                = std::uint32_t;
+
+public:
+    traversal_workspace() = default;
+
+    /**
+     * @brief Start a new traversal of ids in [0, numOfIds): no node is
+     *        visited and the frontier is empty.
+     */
+    inline void reset(size_type numOfIds);
+
+    /**
+     * @brief Mark the id as visited.
+     * @return true if it was not visited before, false otherwise.
+     */
+    inline bool visit(size_type id) noexcept;
+
+    /**
+     * @brief Returns true if the id was visited since the last reset, false otherwise.
+     */
+    [[nodiscard]] inline bool visited(size_type id) const noexcept { return static_cast<epoch_type>(m_stamps[id] - m_epoch) <= 1; }
+
+    /**
+     * @brief Mark the visited id as finished, all of its descendants are done.
+     */
+    inline void finish(size_type id) noexcept { m_stamps[id] = m_epoch + 1; }
+
+    /**
+     * @brief Returns true if the id was finished since the last reset, false otherwise.
+     */
+    [[nodiscard]] inline bool finished(size_type id) const noexcept { return m_epoch + 1 == m_stamps[id]; }
+
+    ///@{ @name Frontier
+    [[nodiscard]] inline bool empty() const noexcept { return m_head == m_frontier.size(); }
+    [[nodiscard]] inline size_type size() const noexcept { return m_frontier.size() - m_head; }
+    inline void push(size_type id) { m_frontier.push_back(id); }
+    [[nodiscard]] inline size_type pop_front() noexcept { return m_frontier[m_head++]; }
+    [[nodiscard]] inline size_type pop_back() noexcept;
+    ///@}
+
+    /**
+     * @brief Return the empty DFS frame stack, its memory is kept between traversals.
+     * @details All the traversals of a graph use the same Frame, another Frame
+     *          replaces the stack.
+     */
+    template <typename Frame>
+    [[nodiscard]] inline std::vector<Frame>& path();
+
+    /**
+     * @brief Return the bytes reserved by the stamps, the frontier and the path.
+     */
+    [[nodiscard]] inline size_type capacity_bytes() const noexcept;
+
+private:
+    struct path_base
+    {
+        virtual ~path_base() = default;
+        [[nodiscard]] virtual size_type capacity_bytes() const noexcept = 0;
+    };
+
+    template <typename Frame>
+    struct typed_path : path_base
+    {
+        [[nodiscard]] size_type capacity_bytes() const noexcept override { return frames.capacity() * sizeof(Frame); }
+
+        std::vector<Frame> frames;
+    };
+
+    template <typename Frame>
+    [[nodiscard]] inline static const void* key_of() noexcept
+    {
+        static const char key = 0;
+        return &key;
+    }
+
+private:
+    std::vector<epoch_type> m_stamps;
+    std::vector<size_type> m_frontier;
+    size_type m_head = 0;
+    epoch_type m_epoch = 0;
+    std::unique_ptr<path_base> m_path;
+    const void* m_pathKey = nullptr;    // key_of the Frame of m_path
+
+};
+
+/**
+ * @class workspace_pool
+ * @brief Traversal workspaces of a graph, lent to iterators and algorithms.
+ * @details A workspace is free again once every copy of the pointer that
+ *          borrowed it is gone, so the same few workspaces serve all the
+ *          traversals that do not overlap. Borrowing is thread safe. Copies
+ *          and moves of the pool are empty, workspaces are never shared
+ *          between graphs.
+ */
+class workspace_pool
+{
+public:
+    using workspace_ptr             = std::shared_ptr<traversal_workspace>;
+
+public:
+    workspace_pool() = default;
+    workspace_pool(const workspace_pool&) noexcept { }
+    workspace_pool& operator=(const workspace_pool&) noexcept { return *this; }
+
+    /**
+     * @brief Return a workspace no one else is using, reset for numOfIds ids.
+     */
+    [[nodiscard]] inline workspace_ptr borrow(std::size_t numOfIds);
+
+private:
+    std::mutex m_mutex;
+    std::vector<workspace_ptr> m_workspaces;
+
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include "impl/_traversal_workspace.hpp"
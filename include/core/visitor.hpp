@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+
+namespace impl
+{
+
+/**
+ * @brief What a traversal does after a visitor callback.
+ */
+enum class visit_result
+{
+    PROCEED,    ///< continue as usual
+    SKIP,       ///< do not expand the discovered node, do not follow the edge
+    STOP        ///< end the traversal
+};
+
+/**
+ * @struct default_visitor
+ * @brief Visitor of graph::bfs and graph::dfs that does nothing and never stops.
+ * @details Visitors derive from it and hide the callbacks they need, the
+ *          traversal calls them directly, so they are inlined. Callbacks get
+ *          node ids, edges are passed as (from, to, cost).
+ *          - discover(id, depth): id is reached for the first time, depth is
+ *            its number of tree edges from the start. SKIP leaves its edges
+ *            unexamined.
+ *          - examine_edge(from, to, cost): every edge of an expanded node.
+ *            SKIP ignores the edge.
+ *          - tree_edge(from, to, cost): the edge is about to discover to.
+ *            SKIP leaves to undiscovered, another edge may still reach it.
+ *          - back_edge(from, to, cost): dfs only, to is an ancestor of from.
+ *          - non_tree_edge(from, to, cost): to is already discovered and, in
+ *            dfs, not an ancestor of from (forward and cross edges).
+ *          - finish(id): all the edges of the expanded node are examined,
+ *            in dfs also all of its descendants are finished.
+ *          STOP ends the traversal from any callback.
+ */
+struct default_visitor
+{
+    using size_type = std::size_t;
+
+    template <typename Cost>
+    constexpr visit_result examine_edge(size_type, size_type, Cost) noexcept { return visit_result::PROCEED; }
+    template <typename Cost>
+    constexpr visit_result tree_edge(size_type, size_type, Cost) noexcept { return visit_result::PROCEED; }
+    template <typename Cost>
+    constexpr visit_result back_edge(size_type, size_type, Cost) noexcept { return visit_result::PROCEED; }
+    template <typename Cost>
+    constexpr visit_result non_tree_edge(size_type, size_type, Cost) noexcept { return visit_result::PROCEED; }
+    constexpr visit_result discover(size_type, size_type) noexcept { return visit_result::PROCEED; }
+    constexpr visit_result finish(size_type) noexcept { return visit_result::PROCEED; }
+};
+
+}
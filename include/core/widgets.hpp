@@ -2,31 +2,108 @@
 
 #include <tuple>
 #include <limits>
+#include <memory>
 
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include <algorithm>
 
+#include "cost_traits.hpp"
+#include "edge_index.hpp"
+
 namespace impl
 {
-class node;
+template <typename Cost, typename Id>
+class basic_node;
+
+/**
+ * @class iterator_range
+ * @brief Pair of iterators usable in range-based for loops.
+ */
+template <typename Iterator>
+class iterator_range
+{
+public:
+    iterator_range(Iterator first, Iterator last)
+        : m_begin{first}
+        , m_end{last}
+    { }
+
+    [[nodiscard]] inline Iterator begin() const { return m_begin; }
+    [[nodiscard]] inline Iterator end() const { return m_end; }
+    [[nodiscard]] inline bool empty() const { return m_begin == m_end; }
+
+private:
+    Iterator m_begin;
+    Iterator m_end;
+
+};
+
+namespace detail
+{
+
+/**
+ * @brief Cost of an edge, stored as Value.
+ */
+template <typename Cost, typename Value>
+class edge_cost
+{
+public:
+    explicit edge_cost(Value cost) noexcept
+        : m_cost{cost}
+    { }
+
+    inline void set_cost(Value cost) noexcept { m_cost = cost; }
+    [[nodiscard]] inline Value get_cost() const noexcept { return m_cost; }
+
+private:
+    Value m_cost;
+};
+
+/**
+ * @brief Edges of unweighted graphs store no cost, every edge costs 1.
+ */
+template <typename Value>
+class edge_cost<void, Value>
+{
+public:
+    explicit edge_cost(Value) noexcept
+    { }
+
+    inline void set_cost(Value) noexcept { }
+    [[nodiscard]] inline Value get_cost() const noexcept { return 1; }
+};
+
+}
 
-class edge
+/**
+ * @class basic_edge
+ * @brief Directed weighted edge between two nodes.
+ * @details With void Cost the edge is unweighted, it only holds its two
+ *          nodes and get_cost() is always 1.
+ */
+template <typename Cost, typename Id>
+class basic_edge : private detail::edge_cost<Cost, path_cost_t<Cost, Id>>
 {
+    using cost_base = detail::edge_cost<Cost, path_cost_t<Cost, Id>>;
+
 public:
-    using Cost_t = int;
-    constexpr static Cost_t INF_COST = std::numeric_limits<Cost_t>::max();
+    using Cost_t = path_cost_t<Cost, Id>;
+    using node = basic_node<Cost, Id>;
+    constexpr static Cost_t INF_COST = cost_traits<Cost_t>::infinity();
+    constexpr static bool is_weighted = !std::is_void_v<Cost>;
 
 public:
-    edge(node* from, node* to, Cost_t cost)
-        : m_from{from}
+    basic_edge(node* from, node* to, Cost_t cost)
+        : cost_base{cost}
+        , m_from{from}
         , m_to{to}
-        , m_cost{cost}
     { }
 
-    ~edge() = default;
+    ~basic_edge() = default;
 
     inline void set_from(node* from) noexcept { m_from = from; }
     inline void set_to(node* to) noexcept { m_to = to; }
@@ -36,76 +113,121 @@ public:
     [[nodiscard]] inline const node* get_to() const noexcept { return m_to; }
     [[nodiscard]] inline node* get_to() noexcept { return m_to; }
 
-    [[nodiscard]] inline size_t get_from_idx() const noexcept;
-    [[nodiscard]] inline size_t get_to_idx() const noexcept;
+    [[nodiscard]] inline Id get_from_idx() const noexcept;
+    [[nodiscard]] inline Id get_to_idx() const noexcept;
 
-    inline void set_cost(Cost_t cost) noexcept { m_cost = cost; }
-    [[nodiscard]] inline Cost_t get_cost() const noexcept { return m_cost; }
+    using cost_base::set_cost;
+    using cost_base::get_cost;
 
-    [[nodiscard]] bool compare(const edge* rhs) const noexcept;
+    [[nodiscard]] bool compare(const basic_edge* rhs) const noexcept;
 
 private:
     node* m_from;
     node* m_to;
-    Cost_t m_cost;
 
 };
 
 /**
- * @class node
+ * @brief Id based view of an outgoing edge: target node id and cost.
+ */
+template <typename Cost, typename Id>
+struct basic_arc
+{
+    Id to;
+    path_cost_t<Cost, Id> cost;
+};
+
+/**
+ * @class basic_node
  * @brief node object of the graph data structure.
+ * @details Edge lists of EDGE_INDEX_THRESHOLD or more edges get a hash index
+ *          by endpoint, so has_edge and the removals stay O(1) on hub nodes.
+ *          Removing from an indexed list moves its last edge into the gap,
+ *          short lists keep their order.
  * @note Supports multigraph
  */
-class node
+template <typename Cost, typename Id>
+class basic_node
 {
 public:
     using size_type = std::size_t;
-    using edge_iterator = std::vector<edge*>::iterator;
-    using const_edge_iterator = std::vector<edge*>::const_iterator;
+    using id_type = Id;
+    using node = basic_node;
+    using edge = basic_edge<Cost, Id>;
+    using arc = basic_arc<Cost, Id>;
+    using edge_iterator = typename std::vector<edge*>::iterator;
+    using const_edge_iterator = typename std::vector<edge*>::const_iterator;
+
+    constexpr static size_type EDGE_INDEX_THRESHOLD = 32;
 
 public:
-    node(size_type id);
+    basic_node(id_type id);
     /**
      * @brief Construct a new node object with the given id and name.
+     * @details The node only references the name, the characters must outlive it.
      */
-    node(size_type id, std::string  name);
+    basic_node(id_type id, std::string_view name);
 
     /**
      * @brief Destroy the node object.
      */
-    ~node();
+    ~basic_node() = default;
 
     size_type degree() const { return m_edges.size(); }
 
     /**
      * @brief Get the id of the node.
      */
-    [[nodiscard]] inline size_type get_id() const { return m_id; };
+    [[nodiscard]] inline id_type get_id() const { return m_id; };
 
     /**
      * @brief Update the id of the node.
      */
-    void set_id(size_type id) { m_id = id; }
+    void set_id(id_type id) { m_id = id; }
 
     /**
      * @brief Get the name of the node.
      */
-    [[nodiscard]] inline const std::string& get_name() const { return m_name; }
+    [[nodiscard]] inline std::string_view get_name() const { return m_name; }
+
+    [[nodiscard]] inline edge* get_edge(size_type idx) { return m_edges[idx]; }
+    [[nodiscard]] inline const edge* get_edge(size_type idx) const { return m_edges[idx]; }
+
+    /**
+     * @brief Add the outgoing edge to the node.
+     * @details The edge is owned by the graph, the node only references it.
+     */
+    inline void add_edge(edge* e);
 
     /**
-     * @brief Update the name of the node.
+     * @brief Reserve space for the given number of outgoing edges.
      */
-    inline void set_name(std::string name) {  m_name = std::move(name); }
+    inline void reserve_edges(size_type count) { m_edges.reserve(count); }
 
-    [[nodiscard]] inline edge* get_edge(size_type idx) { return m_edges[idx]; }
-    [[nodiscard]] inline const edge* get_edge(size_type idx) const { return m_edges[idx]; }
+    /**
+     * @brief Add the incoming edge to the node.
+     */
+    inline void add_in_edge(edge* e);
+
+    /**
+     * @brief Remove the incoming edge from the node.
+     */
+    inline void remove_in_edge(const edge* e);
+
+    /**
+     * @brief Remove the outgoing edge from the node.
+     */
+    inline void remove_out_edge(const edge* e);
 
     /**
-     * @brief Add edge to the destinaion node with the given cost.
-     * 
-     * @return pointer to edge if it was added successfully, otherwise nullptr.
+     * @brief Drop all the incoming edges and release their memory.
      */
-    [[nodiscard]] edge* add_edge(node* to, edge::Cost_t cost = 1);
+    inline void clear_in_edges() { std::vector<edge*>().swap(m_inEdges); m_inEdgeIndex.reset(); }
+
+    /**
+     * @brief Reserve space for the given number of incoming edges.
+     */
+    inline void reserve_in_edges(size_type count) { m_inEdges.reserve(count); }
 
     /**
      * @brief Checks weather the edge exists from the current node to the given.
@@ -113,7 +235,7 @@ public:
     [[nodiscard]] inline bool has_edge(node* to) const;
 
     /**
-     * @brief Removes the edge if exists.
+     * @brief Removes the edge if exists, also from the incoming edges of its target.
      * @return true if the edge was removed, false if does not exist.
      */
     [[nodiscard]] inline bool remove_edge(node* to);
@@ -125,15 +247,17 @@ public:
      */
     void dump(std::ostream &os) const;
 
-    std::vector<edge*>::iterator begin_edges() { return m_edges.begin(); }
-    std::vector<edge*>::iterator end_edges() { return m_edges.end(); }
+    typename std::vector<edge*>::iterator begin_edges() { return m_edges.begin(); }
+    typename std::vector<edge*>::iterator end_edges() { return m_edges.end(); }
 
     const size_type get_num_of_edges() const { return m_edges.size(); }
     const std::vector<edge*>& get_edges() const { return m_edges; }
+    const std::vector<edge*>& get_in_edges() const { return m_inEdges; }
 
 public:
     /**
-     * @brief Iterator class of all the neighboring nodes.
+     * @brief Iterator class of all the neighboring nodes, the targets of the
+     *        outgoing edges or the sources of the incoming edges.
      */
     class node_iterator
     {
@@ -144,7 +268,7 @@ public:
         using pointer = node*;
         using reference = node&;
     public:
-        node_iterator(std::vector<edge*>::iterator iter);
+        node_iterator(typename std::vector<edge*>::iterator iter, bool incoming = false);
 
         ~node_iterator() = default;
 
@@ -158,11 +282,13 @@ public:
         pointer operator*() const;
 
     private:
-        std::vector<edge*>::iterator m_iter;
+        typename std::vector<edge*>::iterator m_iter;
+        bool m_incoming;
     };
 
     /**
-     * @brief Const iterator class of all the neighboring nodes.
+     * @brief Const iterator class of all the neighboring nodes, the targets of
+     *        the outgoing edges or the sources of the incoming edges.
      */
     class const_node_iterator
     {
@@ -175,7 +301,7 @@ public:
         using reference = node&;
         using const_reference = const node&;
     public:
-        const_node_iterator(std::vector<edge*>::const_iterator iter);
+        const_node_iterator(typename std::vector<edge*>::const_iterator iter, bool incoming = false);
 
         ~const_node_iterator() = default;
 
@@ -189,7 +315,37 @@ public:
         const_pointer operator*() const;
 
     private:
-        std::vector<edge*>::const_iterator m_iter;
+        typename std::vector<edge*>::const_iterator m_iter;
+        bool m_incoming;
+    };
+
+    /**
+     * @brief Const iterator of the outgoing edges as (target id, cost) arcs,
+     *        or of the incoming edges as (source id, cost) arcs.
+     */
+    class const_arc_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = arc;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const arc*;
+        using reference = arc;
+    public:
+        const_arc_iterator(typename std::vector<edge*>::const_iterator iter, bool incoming = false);
+
+        ~const_arc_iterator() = default;
+
+        const_arc_iterator& operator++();
+        const_arc_iterator operator++(int);
+
+        bool operator==(const const_arc_iterator& other) const;
+        bool operator!=(const const_arc_iterator& other) const;
+        value_type operator*() const;
+
+    private:
+        typename std::vector<edge*>::const_iterator m_iter;
+        bool m_incoming;
     };
 
     node_iterator begin_nodes() { return node_iterator(m_edges.begin()); }
@@ -201,17 +357,52 @@ public:
     const_node_iterator cbegin_nodes() const { return begin_nodes(); }
     const_node_iterator cend_nodes() const { return end_nodes(); }
 
+    node_iterator begin_in_nodes() { return node_iterator(m_inEdges.begin(), true); }
+    node_iterator end_in_nodes() { return node_iterator(m_inEdges.end(), true); }
+    const_node_iterator begin_in_nodes() const { return const_node_iterator(m_inEdges.cbegin(), true); }
+    const_node_iterator end_in_nodes() const { return const_node_iterator(m_inEdges.cend(), true); }
+
+    const_arc_iterator begin_arcs() const { return const_arc_iterator(m_edges.cbegin()); }
+    const_arc_iterator end_arcs() const { return const_arc_iterator(m_edges.cend()); }
+
+    const_arc_iterator begin_in_arcs() const { return const_arc_iterator(m_inEdges.cbegin(), true); }
+    const_arc_iterator end_in_arcs() const { return const_arc_iterator(m_inEdges.cend(), true); }
+
+private:
+    template <typename, typename>
+    friend class basic_graph;
+
+    /**
+     * @brief Update the name of the node.
+     * @details The node only references the name, so only the graph sets it
+     *          to a name interned in its name table.
+     */
+    inline void set_name(std::string_view name) { m_name = name; }
+
+    /**
+     * @brief Remove the edge at the position of the list, keep the index in sync.
+     */
+    template <typename Index>
+    static void erase_edge(std::vector<edge*>& edges, std::unique_ptr<Index>& index, size_type position);
+
 private:
-    size_type m_id;
-    std::string m_name;
+    id_type m_id;
+    std::string_view m_name;
     std::vector<edge*> m_edges;
+    std::vector<edge*> m_inEdges;
+    std::unique_ptr<edge_index<edge, true>> m_edgeIndex;     // outgoing edges by target
+    std::unique_ptr<edge_index<edge, false>> m_inEdgeIndex;  // incoming edges by source
 
 };
 
+using edge = basic_edge<int, std::size_t>;
+using arc = basic_arc<int, std::size_t>;
+using node = basic_node<int, std::size_t>;
 
 }
 
-std::ostream& operator<<(std::ostream& os, const impl::node* node);
+template <typename Cost, typename Id>
+std::ostream& operator<<(std::ostream& os, const impl::basic_node<Cost, Id>* node);
 
 ////////////////////////////////////////////////////////////////////////////////
 ////  Includes  ////////////////////////////////////////////////////////////////
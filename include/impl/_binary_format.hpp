@@ -0,0 +1,340 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace impl
+{
+
+namespace detail
+{
+
+/**
+ * @brief Header of the binary graph format.
+ * @details The header is followed by these sections, each starting at an
+ *          8 byte aligned offset:
+ *          - uint64 name offsets [numOfNodes + 1]
+ *          - name characters [nameBytes]
+ *          - id edge offsets [numOfNodes + 1]
+ *          - id edge targets [numOfEdges]
+ *          - cost edge costs [numOfEdges]
+ *          Numbers are stored in the byte order of the machine that wrote them.
+ *          Ids take idBytes, costs take costBytes and are integers or floating
+ *          point numbers as told by costKind. Unweighted graphs have no cost
+ *          section, their costBytes is 0.
+ */
+struct binary_header
+{
+    constexpr static char MAGIC[8] = {'G', 'R', 'A', 'P', 'H', 'B', 'I', 'N'};
+    constexpr static std::uint32_t VERSION = 2;
+    constexpr static std::uint32_t ENDIAN_MARK = 0x01020304;
+    /// version 1 headers end before costKind and always have signed integer costs
+    constexpr static std::size_t VERSION_1_SIZE = 48;
+
+    enum cost_kind : std::uint32_t
+    {
+        SIGNED_INTEGER = 0,
+        UNSIGNED_INTEGER = 1,
+        FLOATING_POINT = 2,
+        UNWEIGHTED = 3
+    };
+
+    template <typename Cost>
+    [[nodiscard]] constexpr static std::uint32_t kind_of() noexcept
+    {
+        if constexpr (std::is_void_v<Cost>) {
+            return UNWEIGHTED;
+        } else if constexpr (std::is_floating_point_v<Cost>) {
+            return FLOATING_POINT;
+        } else if constexpr (std::is_signed_v<Cost>) {
+            return SIGNED_INTEGER;
+        } else {
+            return UNSIGNED_INTEGER;
+        }
+    }
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t endianMark;
+    std::uint32_t idBytes;
+    std::uint32_t costBytes;
+    std::uint64_t numOfNodes;
+    std::uint64_t numOfEdges;
+    std::uint64_t nameBytes;
+    std::uint32_t costKind;
+    std::uint32_t reserved;
+};
+static_assert(offsetof(binary_header, costKind) == binary_header::VERSION_1_SIZE,
+              "Version 2 must only append to the version 1 header");
+
+/**
+ * @brief Byte offsets of the sections from the start of the file.
+ * @details The counts come from the header, which may be crafted, so every
+ *          offset is computed with checked arithmetic.
+ * @throw std::overflow_error if an offset does not fit 64 bits.
+ */
+struct binary_layout
+{
+    binary_layout(const binary_header& header, std::uint64_t headerBytes)
+    {
+        const std::uint64_t numOfNodes = add(header.numOfNodes, 1);
+        nameOffsets = align(headerBytes);
+        names = align(add(nameOffsets, mul(numOfNodes, sizeof(std::uint64_t))));
+        offsets = align(add(names, header.nameBytes));
+        targets = align(add(offsets, mul(numOfNodes, header.idBytes)));
+        costs = align(add(targets, mul(header.numOfEdges, header.idBytes)));
+        total = add(costs, mul(header.numOfEdges, header.costBytes));
+    }
+
+    [[nodiscard]] inline static std::uint64_t align(std::uint64_t offset)
+    {
+        return add(offset, 7) & ~std::uint64_t{7};
+    }
+
+    [[nodiscard]] inline static std::uint64_t add(std::uint64_t lhs, std::uint64_t rhs)
+    {
+        if (lhs > std::numeric_limits<std::uint64_t>::max() - rhs) {
+            throw std::overflow_error("Binary section offset does not fit 64 bits");
+        }
+        return lhs + rhs;
+    }
+
+    [[nodiscard]] inline static std::uint64_t mul(std::uint64_t lhs, std::uint64_t rhs)
+    {
+        if (0 != rhs && lhs > std::numeric_limits<std::uint64_t>::max() / rhs) {
+            throw std::overflow_error("Binary section size does not fit 64 bits");
+        }
+        return lhs * rhs;
+    }
+
+    template <typename Cost>
+    [[nodiscard]] constexpr static std::uint32_t cost_bytes() noexcept
+    {
+        if constexpr (std::is_void_v<Cost>) {
+            return 0;
+        } else {
+            return sizeof(Cost);
+        }
+    }
+
+    std::uint64_t nameOffsets;
+    std::uint64_t names;
+    std::uint64_t offsets;
+    std::uint64_t targets;
+    std::uint64_t costs;
+    std::uint64_t total;
+};
+
+/**
+ * @brief Buffered writer of raw values, keeps track of the file offset.
+ */
+class binary_writer
+{
+public:
+    explicit binary_writer(std::ostream& os)
+        : m_os(os)
+    {
+        m_buffer.reserve(BUFFER_SIZE);
+    }
+
+    ~binary_writer()
+    {
+        flush();
+    }
+
+    template <typename T>
+    void put(const T& value)
+    {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        put(bytes, sizeof(T));
+    }
+
+    void put(const char* data, std::size_t size)
+    {
+        if (m_buffer.size() + size > BUFFER_SIZE) {
+            flush();
+        }
+        if (size > BUFFER_SIZE) {
+            m_os.write(data, static_cast<std::streamsize>(size));
+        } else {
+            m_buffer.insert(m_buffer.end(), data, data + size);
+        }
+        m_offset += size;
+    }
+
+    void pad_to(std::uint64_t offset)
+    {
+        assert(offset >= m_offset);
+        while (m_offset < offset) {
+            put('\0');
+        }
+    }
+
+    void flush()
+    {
+        m_os.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+        m_buffer.clear();
+    }
+
+private:
+    constexpr static std::size_t BUFFER_SIZE = 1 << 20;
+
+    std::ostream& m_os;
+    std::vector<char> m_buffer;
+    std::uint64_t m_offset = 0;
+};
+
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::serialize_binary(const std::string& fileName) const
+{
+    detail::binary_header header{};
+    std::memcpy(header.magic, detail::binary_header::MAGIC, sizeof(header.magic));
+    header.version = detail::binary_header::VERSION;
+    header.endianMark = detail::binary_header::ENDIAN_MARK;
+    header.idBytes = sizeof(id_type);
+    header.costBytes = detail::binary_layout::cost_bytes<Cost>();
+    header.costKind = detail::binary_header::kind_of<Cost>();
+    header.numOfNodes = size();
+    header.numOfEdges = 0;
+    header.nameBytes = 0;
+    // Removed ids are skipped, the nodes are written with their compacted ids
+    const iterator_range<const_node_iterator> nodes(begin_nodes(), end_nodes());
+    const std::vector<id_type> ids = compacted_ids();
+    for (const node* n : nodes) {
+        header.numOfEdges += n->degree();
+        header.nameBytes += n->get_name().size();
+    }
+    if (header.numOfEdges >= INVALID_ID) {
+        throw serialization_error("Number of edges exceeds the range of the node id type");
+    }
+    const detail::binary_layout layout(header, sizeof(header));
+
+    std::ofstream os{fileName, std::ios::binary};
+    if (!os) {
+        throw serialization_error("Can't open " + fileName + " for writing");
+    }
+    detail::binary_writer writer(os);
+    writer.put(header);
+
+    writer.pad_to(layout.nameOffsets);
+    std::uint64_t nameOffset = 0;
+    writer.put(nameOffset);
+    for (const node* n : nodes) {
+        nameOffset += n->get_name().size();
+        writer.put(nameOffset);
+    }
+
+    writer.pad_to(layout.names);
+    for (const node* n : nodes) {
+        writer.put(n->get_name().data(), n->get_name().size());
+    }
+
+    writer.pad_to(layout.offsets);
+    id_type offset = 0;
+    writer.put(offset);
+    for (const node* n : nodes) {
+        offset += static_cast<id_type>(n->degree());
+        writer.put(offset);
+    }
+
+    writer.pad_to(layout.targets);
+    for (const node* n : nodes) {
+        for (const edge* e : n->get_edges()) {
+            writer.put(ids[e->get_to_idx()]);
+        }
+    }
+
+    writer.pad_to(layout.costs);
+    if constexpr (is_weighted) {
+        for (const node* n : nodes) {
+            for (const edge* e : n->get_edges()) {
+                writer.put(e->get_cost());
+            }
+        }
+    }
+    writer.flush();
+    os.flush();
+    if (!os) {
+        throw serialization_error("Can't write " + fileName);
+    }
+}
+
+template <typename Cost, typename Id>
+basic_csr_graph<Cost, Id> basic_csr_graph<Cost, Id>::map(const std::string& fileName, bool validate)
+{
+    auto file = std::make_shared<const mapped_file>(fileName);
+
+    detail::binary_header header{};
+    if (file->size() < detail::binary_header::VERSION_1_SIZE) {
+        throw serialization_error(fileName + ": not a binary graph");
+    }
+    std::memcpy(&header, file->data(), std::min<std::size_t>(sizeof(header), file->size()));
+    if (0 != std::memcmp(header.magic, detail::binary_header::MAGIC, sizeof(header.magic))) {
+        throw serialization_error(fileName + ": not a binary graph");
+    }
+    std::uint64_t headerBytes = sizeof(header);
+    if (1 == header.version) {
+        headerBytes = detail::binary_header::VERSION_1_SIZE;
+        header.costKind = detail::binary_header::SIGNED_INTEGER;
+    } else if (detail::binary_header::VERSION != header.version) {
+        throw serialization_error(fileName + ": unsupported version " + std::to_string(header.version));
+    } else if (file->size() < sizeof(header)) {
+        throw serialization_error(fileName + ": truncated file");
+    }
+    if (detail::binary_header::ENDIAN_MARK != header.endianMark) {
+        throw serialization_error(fileName + ": written with a different byte order");
+    }
+    if (sizeof(id_type) != header.idBytes || detail::binary_layout::cost_bytes<Cost>() != header.costBytes
+        || detail::binary_header::kind_of<Cost>() != header.costKind) {
+        throw serialization_error(fileName + ": id or cost type does not match");
+    }
+    const detail::binary_layout layout = [&] {
+        try {
+            return detail::binary_layout(header, headerBytes);
+        } catch (const std::overflow_error&) {
+            throw serialization_error(fileName + ": corrupted section sizes");
+        }
+    }();
+    if (file->size() < layout.total) {
+        throw serialization_error(fileName + ": truncated file");
+    }
+
+    basic_csr_graph g;
+    g.m_size = header.numOfNodes;
+    g.m_numOfNodes = header.numOfNodes;
+    g.m_numOfEdges = header.numOfEdges;
+    g.m_nameOffsets = reinterpret_cast<const std::uint64_t*>(file->data() + layout.nameOffsets);
+    g.m_names = file->data() + layout.names;
+    g.m_offsets = reinterpret_cast<const id_type*>(file->data() + layout.offsets);
+    g.m_targets = reinterpret_cast<const id_type*>(file->data() + layout.targets);
+    if constexpr (is_weighted) {
+        g.m_costs = reinterpret_cast<const cost_type*>(file->data() + layout.costs);
+    }
+    if (g.m_offsets[g.m_size] != g.m_numOfEdges || g.m_nameOffsets[g.m_size] != header.nameBytes) {
+        throw serialization_error(fileName + ": corrupted section sizes");
+    }
+    if (validate) {
+        if (0 != g.m_offsets[0] || 0 != g.m_nameOffsets[0]) {
+            throw serialization_error(fileName + ": corrupted offsets");
+        }
+        for (size_type i = 0; i < g.m_size; ++i) {
+            if (g.m_offsets[i] > g.m_offsets[i + 1] || g.m_nameOffsets[i] > g.m_nameOffsets[i + 1]) {
+                throw serialization_error(fileName + ": corrupted offsets of node " + std::to_string(i));
+            }
+        }
+        for (size_type i = 0; i < g.m_numOfEdges; ++i) {
+            if (g.m_targets[i] >= g.m_size) {
+                throw serialization_error(fileName + ": edge " + std::to_string(i) + " targets missing node "
+                                          + std::to_string(g.m_targets[i]));
+            }
+        }
+    }
+    g.m_storage = std::move(file);
+    return g;
+}
+
+}
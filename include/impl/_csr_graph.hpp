@@ -0,0 +1,147 @@
+#pragma once
+
+namespace impl
+{
+
+////////////////////////////////////////////////////////////////////////////////
+///// basic_csr_graph::const_arc_iterator
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+basic_csr_graph<Cost, Id>::const_arc_iterator::const_arc_iterator(const id_type* target, const cost_type* cost)
+    : m_target(target)
+    , m_cost(cost)
+{ }
+
+template <typename Cost, typename Id>
+typename basic_csr_graph<Cost, Id>::const_arc_iterator& basic_csr_graph<Cost, Id>::const_arc_iterator::operator++()
+{
+    ++m_target;
+    if constexpr (is_weighted) {
+        ++m_cost;
+    }
+    return *this;
+}
+
+template <typename Cost, typename Id>
+typename basic_csr_graph<Cost, Id>::const_arc_iterator basic_csr_graph<Cost, Id>::const_arc_iterator::operator++(int)
+{
+    const_arc_iterator temp{*this};
+    ++*this;
+    return temp;
+}
+
+template <typename Cost, typename Id>
+bool basic_csr_graph<Cost, Id>::const_arc_iterator::operator==(const const_arc_iterator& other) const
+{
+    return m_target == other.m_target;
+}
+
+template <typename Cost, typename Id>
+bool basic_csr_graph<Cost, Id>::const_arc_iterator::operator!=(const const_arc_iterator& other) const
+{
+    return m_target != other.m_target;
+}
+
+template <typename Cost, typename Id>
+typename basic_csr_graph<Cost, Id>::const_arc_iterator::value_type basic_csr_graph<Cost, Id>::const_arc_iterator::operator*() const
+{
+    if constexpr (is_weighted) {
+        return arc{*m_target, *m_cost};
+    } else {
+        return arc{*m_target, 1};
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///// basic_csr_graph
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+basic_csr_graph<Cost, Id>::basic_csr_graph(const basic_graph<Cost, Id>& g)
+{
+    struct arrays
+    {
+        std::vector<id_type> offsets;
+        std::vector<id_type> targets;
+        std::vector<cost_type> costs;
+        std::vector<std::uint64_t> nameOffsets;
+        std::string names;
+        std::vector<std::uint8_t> removed;
+    };
+    if (g.num_of_edges() >= INVALID_ID) {
+        throw std::length_error("Number of edges exceeds the range of the node id type");
+    }
+    auto storage = std::make_shared<arrays>();
+
+    storage->offsets.reserve(g.num_of_ids() + 1);
+    storage->targets.reserve(g.num_of_edges());
+    if constexpr (is_weighted) {
+        storage->costs.reserve(g.num_of_edges());
+    }
+    storage->nameOffsets.reserve(g.num_of_ids() + 1);
+    if (g.size() != g.num_of_ids()) {
+        storage->removed.resize(g.num_of_ids(), 0);
+    }
+
+    storage->offsets.push_back(0);
+    storage->nameOffsets.push_back(0);
+    for (size_type i = 0; i < g.num_of_ids(); ++i) {
+        for (const auto [to, cost] : g.out_edges(i)) {
+            storage->targets.push_back(to);
+            if constexpr (is_weighted) {
+                storage->costs.push_back(cost);
+            }
+        }
+        storage->offsets.push_back(static_cast<id_type>(storage->targets.size()));
+        if (const auto* n = g.get_node(i)) {
+            storage->names += n->get_name();
+        } else if (!storage->removed.empty()) {
+            storage->removed[i] = 1;
+        }
+        storage->nameOffsets.push_back(storage->names.size());
+    }
+
+    m_size = g.num_of_ids();
+    m_numOfNodes = g.size();
+    m_numOfEdges = storage->targets.size();
+    m_offsets = storage->offsets.data();
+    m_targets = storage->targets.data();
+    m_costs = is_weighted ? storage->costs.data() : nullptr;
+    m_nameOffsets = storage->nameOffsets.data();
+    m_names = storage->names.data();
+    m_removed = storage->removed.empty() ? nullptr : storage->removed.data();
+    m_storage = std::move(storage);
+}
+
+template <typename Cost, typename Id>
+inline typename basic_csr_graph<Cost, Id>::arc_range basic_csr_graph<Cost, Id>::out_edges(size_type id) const
+{
+    assert(id < m_size);
+    const size_type first = m_offsets[id];
+    const size_type last = m_offsets[id + 1];
+    if constexpr (is_weighted) {
+        return arc_range(const_arc_iterator(m_targets + first, m_costs + first),
+                         const_arc_iterator(m_targets + last, m_costs + last));
+    } else {
+        return arc_range(const_arc_iterator(m_targets + first, nullptr),
+                         const_arc_iterator(m_targets + last, nullptr));
+    }
+}
+
+template <typename Cost, typename Id>
+inline std::string_view basic_csr_graph<Cost, Id>::get_name(size_type id) const
+{
+    assert(id < m_size);
+    const std::uint64_t first = m_nameOffsets[id];
+    return std::string_view(m_names + first, m_nameOffsets[id + 1] - first);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///// basic_graph
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::csr_graph basic_graph<Cost, Id>::freeze() const
+{
+    return csr_graph(*this);
+}
+
+}
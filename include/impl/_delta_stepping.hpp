@@ -0,0 +1,185 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+
+namespace impl
+{
+
+namespace detail
+{
+
+/**
+ * @brief Pick a bucket width when the caller did not: the largest edge cost
+ *        divided by the average out degree, at least 1.
+ */
+template <typename Graph>
+typename Graph::cost_type default_delta(const Graph& g)
+{
+    using size_type = typename Graph::size_type;
+    using cost_type = typename Graph::cost_type;
+
+    cost_type maxCost = 1;
+    size_type numOfEdges = 0;
+    for (size_type i = 0; i < g.num_of_ids(); ++i) {
+        for (const auto [toId, toCost] : g.out_edges(i)) {
+            maxCost = std::max(maxCost, toCost);
+            ++numOfEdges;
+        }
+    }
+    const size_type avgDegree = std::max<size_type>(1, numOfEdges / std::max<size_type>(1, g.num_of_ids()));
+    return std::max<cost_type>(1, static_cast<cost_type>(maxCost / static_cast<cost_type>(avgDegree)));
+}
+
+/**
+ * @brief Parallel delta-stepping (Meyer and Sanders).
+ * @details Nodes are kept in buckets of width delta by tentative distance.
+ *          The lowest non-empty bucket is the frontier, its nodes relax their
+ *          light edges (cost up to delta) in parallel, improved nodes go to
+ *          the bucket of their new distance in the local buckets of the
+ *          relaxing thread. The same bucket is processed again until it stays
+ *          empty, then the nodes it held relax their heavy edges once, those
+ *          can not reach the bucket again. Distances are lowered with compare
+ *          and swap, entries whose distance dropped below their bucket are
+ *          stale and skipped. The buckets of a thread are a map by index, so
+ *          memory follows the entries, not the largest distance over delta.
+ */
+template <typename Graph>
+std::vector<typename Graph::cost_type> delta_stepping(const Graph& g, typename Graph::size_type start,
+                                                      typename Graph::cost_type delta, thread_pool& pool)
+{
+    using size_type = typename Graph::size_type;
+    using cost_type = typename Graph::cost_type;
+    using bucket = std::vector<size_type>;
+    constexpr cost_type INF_COST = cost_traits<cost_type>::infinity();
+
+    if (delta <= 0) {
+        delta = default_delta(g);
+    }
+    const size_type size = g.num_of_ids();
+    std::vector<std::atomic<cost_type>> dist(size);
+    pool.parallel_for(size, [&dist](size_type first, size_type last, size_type) {
+        for (size_type i = first; i < last; ++i) {
+            dist[i].store(INF_COST, std::memory_order_relaxed);
+        }
+    });
+    dist[start].store(0, std::memory_order_relaxed);
+
+    // Buckets of every thread by index distance / delta
+    std::vector<std::map<size_type, bucket>> buckets(pool.size());
+    auto relax = [&](size_type toId, cost_type totalCost, std::map<size_type, bucket>& local) {
+        cost_type old = dist[toId].load(std::memory_order_relaxed);
+        while (totalCost < old) {
+            if (dist[toId].compare_exchange_weak(old, totalCost, std::memory_order_relaxed)) {
+                local[static_cast<size_type>(totalCost / delta)].push_back(toId);
+                return;
+            }
+        }
+    };
+    auto take_bucket = [&](size_type index, bucket& frontier) {
+        frontier.clear();
+        for (std::map<size_type, bucket>& local : buckets) {
+            const auto it = local.find(index);
+            if (local.end() != it) {
+                frontier.insert(frontier.end(), it->second.begin(), it->second.end());
+                local.erase(it);
+            }
+        }
+    };
+
+    bucket frontier{start};
+    bucket settled;
+    size_type current = 0;
+    while (true) {
+        const cost_type lowerBound = static_cast<cost_type>(current) * delta;
+        settled.clear();
+        while (!frontier.empty()) {
+            pool.parallel_for(frontier.size(), [&](size_type first, size_type last, size_type worker) {
+                for (size_type i = first; i < last; ++i) {
+                    const size_type id = frontier[i];
+                    const cost_type cost = dist[id].load(std::memory_order_relaxed);
+                    if (cost < lowerBound) {
+                        continue;
+                    }
+                    for (const auto [toId, toCost] : g.out_edges(id)) {
+                        assert(toCost >= 0);
+                        if (toCost <= delta) {
+                            relax(toId, cost_traits<cost_type>::add(cost, toCost), buckets[worker]);
+                        }
+                    }
+                }
+            });
+            settled.insert(settled.end(), frontier.begin(), frontier.end());
+            take_bucket(current, frontier);
+        }
+
+        // Heavy edges of the emptied bucket, from the final distances of its nodes
+        std::sort(settled.begin(), settled.end());
+        settled.erase(std::unique(settled.begin(), settled.end()), settled.end());
+        pool.parallel_for(settled.size(), [&](size_type first, size_type last, size_type worker) {
+            for (size_type i = first; i < last; ++i) {
+                const size_type id = settled[i];
+                const cost_type cost = dist[id].load(std::memory_order_relaxed);
+                for (const auto [toId, toCost] : g.out_edges(id)) {
+                    if (toCost > delta) {
+                        relax(toId, cost_traits<cost_type>::add(cost, toCost), buckets[worker]);
+                    }
+                }
+            }
+        });
+
+        // Next frontier is the lowest non-empty bucket of any thread
+        size_type next = std::numeric_limits<size_type>::max();
+        for (const std::map<size_type, bucket>& local : buckets) {
+            if (!local.empty()) {
+                next = std::min(next, local.begin()->first);
+            }
+        }
+        if (std::numeric_limits<size_type>::max() == next) {
+            break;
+        }
+        current = next;
+        take_bucket(current, frontier);
+    }
+
+    std::vector<cost_type> result(size);
+    pool.parallel_for(size, [&](size_type first, size_type last, size_type) {
+        for (size_type i = first; i < last; ++i) {
+            result[i] = dist[i].load(std::memory_order_relaxed);
+        }
+    });
+    return result;
+}
+
+}
+
+template <typename Cost, typename Id>
+std::vector<path_cost_t<Cost, Id>> basic_graph<Cost, Id>::delta_stepping(size_type start, cost_type delta, size_type numOfThreads) const
+{
+    thread_pool pool{numOfThreads};
+    return detail::delta_stepping(*this, start, delta, pool);
+}
+
+template <typename Cost, typename Id>
+std::vector<path_cost_t<Cost, Id>> basic_graph<Cost, Id>::delta_stepping(size_type start, cost_type delta,
+                                                                       thread_pool& pool) const
+{
+    return detail::delta_stepping(*this, start, delta, pool);
+}
+
+template <typename Cost, typename Id>
+std::vector<path_cost_t<Cost, Id>> basic_csr_graph<Cost, Id>::delta_stepping(size_type start, cost_type delta,
+                                                            size_type numOfThreads) const
+{
+    thread_pool pool{numOfThreads};
+    return detail::delta_stepping(*this, start, delta, pool);
+}
+
+template <typename Cost, typename Id>
+std::vector<path_cost_t<Cost, Id>> basic_csr_graph<Cost, Id>::delta_stepping(size_type start, cost_type delta,
+                                                                           thread_pool& pool) const
+{
+    return detail::delta_stepping(*this, start, delta, pool);
+}
+
+}
@@ -1,34 +1,343 @@
 #pragma once
 
+#include <charconv>
+
 namespace impl
 {
 
-void graph::deserialize(const std::string& fileName)
+namespace detail
+{
+
+/**
+ * @brief Whitespace separated token reader over an in-memory text, counting lines.
+ */
+class text_reader
+{
+public:
+    using size_type = std::size_t;
+
+    constexpr static size_type MIN_ITEM_BYTES = 4;
+
+public:
+    text_reader(const std::string& fileName, const char* first, const char* last, size_type line = 1)
+        : m_fileName(fileName)
+        , m_cur(first)
+        , m_end(last)
+        , m_line(line)
+    { }
+
+    /**
+     * @brief Return the next token, empty at the end of the text.
+     */
+    [[nodiscard]] std::string_view token()
+    {
+        skip_spaces();
+        const char* first = m_cur;
+        while (m_cur != m_end && !is_space(*m_cur)) {
+            ++m_cur;
+        }
+        return std::string_view(first, static_cast<size_type>(m_cur - first));
+    }
+
+    /**
+     * @brief Parse the next token as a number.
+     * @throw serialization_error if the token is missing or is not a number.
+     */
+    template <typename T>
+    [[nodiscard]] T number(const char* what)
+    {
+        const std::string_view str = token();
+        T value{};
+        const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+        if (str.empty() || std::errc{} != ec || ptr != str.data() + str.size()) {
+            fail(std::string("expected ") + what + (str.empty() ? std::string(", got end of file")
+                                                                 : ", got '" + std::string(str) + '\''));
+        }
+        return value;
+    }
+
+    /**
+     * @brief Fail unless count items fit in the rest of the text.
+     * @details A node ("a 0" and a separator) and an edge (a separator and
+     *          "1 2") take MIN_ITEM_BYTES at least, checking counts read from
+     *          the text before reserving memory for them.
+     */
+    void check_count(size_type count, const char* what) const
+    {
+        const auto bytes = static_cast<size_type>(m_end - m_cur);
+        if (count > (bytes + 1) / MIN_ITEM_BYTES) {
+            fail(std::to_string(count) + ' ' + what + " do not fit in the " + std::to_string(bytes) + " bytes left");
+        }
+    }
+
+    /**
+     * @brief Return the current position in the text.
+     */
+    [[nodiscard]] inline const char* position() const noexcept { return m_cur; }
+
+    /**
+     * @brief Returns true if only whitespace is left.
+     */
+    [[nodiscard]] bool at_end()
+    {
+        skip_spaces();
+        return m_cur == m_end;
+    }
+
+    [[noreturn]] void fail(const std::string& what) const
+    {
+        throw serialization_error(m_fileName, m_line, what);
+    }
+
+private:
+    [[nodiscard]] inline static bool is_space(char c) noexcept
+    {
+        return ' ' == c || '\n' == c || '\t' == c || '\r' == c || '\v' == c || '\f' == c;
+    }
+
+    void skip_spaces() noexcept
+    {
+        while (m_cur != m_end && is_space(*m_cur)) {
+            if ('\n' == *m_cur) {
+                ++m_line;
+            }
+            ++m_cur;
+        }
+    }
+
+private:
+    const std::string& m_fileName;
+    const char* m_cur;
+    const char* m_end;
+    size_type m_line;
+};
+
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::deserialize(const std::string& fileName)
+{
+    clear();
+    try {
+        const mapped_file file{fileName};
+        deserialize(fileName, file.begin(), file.end());
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::deserialize(const std::string& fileName, const char* first, const char* last)
+{
+    detail::text_reader reader{fileName, first, last};
+
+    const size_type size = reader.number<size_type>("number of nodes");
+    if (size >= INVALID_ID) {
+        reader.fail(std::to_string(size) + " nodes do not fit the node id type");
+    }
+    reader.check_count(size, "nodes");
+
+    // The graph is empty, so the reserved pool places node i at nodes + i and
+    // edge targets need no random lookup in the adjacency list
+    m_adjList.reserve(size);
+    m_nodePool.reserve(size);
+    m_names.reserve(size);
+    for (size_type i = 0; i < size; ++i) {
+        (void)create_node(i, std::string_view{});
+    }
+    node* const nodes = m_adjList.empty() ? nullptr : m_adjList.front();
+    assert(m_adjList.empty() || nodes + (size - 1) == m_adjList.back());
+    for (node* n : m_adjList) {
+        const std::string_view name = reader.token();
+        if (name.empty()) {
+            reader.fail("expected name of node " + std::to_string(n->get_id()) + ", got end of file");
+        }
+        const auto [entry, inserted] = m_names.emplace(name, n->get_id());
+        if (!inserted) {
+            reader.fail("duplicate node name '" + std::string(name) + '\'');
+        }
+        n->set_name(entry->name);
+
+        const size_type degree = reader.number<size_type>("number of edges");
+        reader.check_count(degree, "edges");
+        n->reserve_edges(degree);
+        m_edgePool.reserve(degree);
+        for (size_type j = 0; j < degree; ++j) {
+            const size_type to = reader.number<size_type>("edge target id");
+            if (to >= size) {
+                reader.fail("edge target id " + std::to_string(to) + " is out of range");
+            }
+            const cost_type cost = reader.number<cost_type>("edge cost");
+            n->add_edge(m_edgePool.create(n, nodes + to, cost));
+        }
+        m_numOfEdges += degree;
+    }
+
+    if (!reader.at_end()) {
+        reader.fail("unexpected data after the last node");
+    }
+    // Incoming edges are added once all are read, every list is reserved exactly.
+    // The targets are counted by address, without reading the target nodes.
+    if (m_incomingIndex) {
+        std::vector<size_type> inDegrees(size, 0);
+        for (const node* n : m_adjList) {
+            for (const edge* e : n->get_edges()) {
+                ++inDegrees[static_cast<size_type>(e->get_to() - nodes)];
+            }
+        }
+        build_incoming_index(inDegrees);
+    }
+}
+
+namespace detail
+{
+
+/**
+ * @brief Find the starts of the first count lines of the text in parallel.
+ * @return count + 1 pointers, line i is [lines[i], lines[i + 1]), missing
+ *         lines are empty ranges at the end of the text.
+ */
+inline std::vector<const char*> index_lines(const char* first, const char* last,
+                                            std::size_t count, thread_pool& pool)
+{
+    using size_type = std::size_t;
+
+    const size_type bytes = static_cast<size_type>(last - first);
+    const size_type numOfBlocks = std::max<size_type>(1, std::min(bytes, 4 * pool.size()));
+    const size_type blockSize = (bytes + numOfBlocks - 1) / numOfBlocks;
+    auto block_first = [&](size_type b) { return first + std::min(bytes, b * blockSize); };
+
+    // Count the newlines of every block, then give each block its first line number
+    std::vector<size_type> newlines(numOfBlocks + 1, 0);
+    pool.parallel_for(numOfBlocks, [&](size_type b0, size_type b1, size_type) {
+        for (size_type b = b0; b < b1; ++b) {
+            newlines[b + 1] = static_cast<size_type>(std::count(block_first(b), block_first(b + 1), '\n'));
+        }
+    }, 1);
+    for (size_type b = 0; b < numOfBlocks; ++b) {
+        newlines[b + 1] += newlines[b];
+    }
+
+    std::vector<const char*> lines(count + 1, last);
+    lines[0] = first;
+    pool.parallel_for(numOfBlocks, [&](size_type b0, size_type b1, size_type) {
+        for (size_type b = b0; b < b1; ++b) {
+            size_type line = newlines[b];
+            for (const char* p = block_first(b); p != block_first(b + 1) && line < count; ++p) {
+                if ('\n' == *p) {
+                    lines[++line] = p + 1;
+                }
+            }
+        }
+    }, 1);
+    return lines;
+}
+
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::deserialize(const std::string& fileName, size_type numOfThreads)
 {
     clear();
-    std::ifstream is{fileName};
+    try {
+        const mapped_file file{fileName};
+        thread_pool pool{numOfThreads};
+        deserialize(fileName, file.begin(), file.end(), pool);
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
 
-    size_type size = 0;
-    is >> size;
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::deserialize(const std::string& fileName, const char* first, const char* last,
+                                        thread_pool& pool)
+{
+    const char* firstLineEnd = std::find(first, last, '\n');
+    detail::text_reader header{fileName, first, firstLineEnd};
+    const size_type size = header.number<size_type>("number of nodes");
+    if (size >= INVALID_ID) {
+        header.fail(std::to_string(size) + " nodes do not fit the node id type");
+    }
+    if (!header.at_end()) {
+        header.fail("unexpected data after the number of nodes");
+    }
+    detail::text_reader{fileName, header.position(), last}.check_count(size, "nodes");
+
+    // Line i holds node i, the file line numbers start at 2
+    const char* body = (firstLineEnd == last) ? last : firstLineEnd + 1;
+    const std::vector<const char*> lines = detail::index_lines(body, last, size, pool);
+    auto line_end = [&lines](size_type i) {
+        const char* end = lines[i + 1];
+        return (end != lines[i] && '\n' == end[-1]) ? end - 1 : end;
+    };
 
-    m_adjList.resize(size);
-    for (size_t i = 0; i < m_adjList.size(); ++i) {
-        m_adjList[i] = new node(i);
+    // Names and degrees
+    std::vector<std::string_view> names(size);
+    std::vector<size_type> offsets(size + 1, 0);
+    std::vector<const char*> edgeData(size);
+    pool.parallel_for(size, [&](size_type first, size_type last, size_type) {
+        for (size_type i = first; i < last; ++i) {
+            detail::text_reader reader{fileName, lines[i], line_end(i), i + 2};
+            names[i] = reader.token();
+            if (names[i].empty()) {
+                reader.fail("expected name of node " + std::to_string(i));
+            }
+            offsets[i + 1] = reader.number<size_type>("number of edges");
+            reader.check_count(offsets[i + 1], "edges");
+            edgeData[i] = reader.position();
+        }
+    });
+
+    m_adjList.reserve(size);
+    m_nodePool.reserve(size);
+    m_names.reserve(size);
+    for (size_type i = 0; i < size; ++i) {
+        const auto [entry, inserted] = m_names.emplace(names[i], i);
+        if (!inserted) {
+            throw serialization_error(fileName, i + 2, "duplicate node name '" + std::string(names[i]) + '\'');
+        }
+        (void)create_node(i, entry->name);
+        offsets[i + 1] += offsets[i];
     }
 
-    for (size_t i = 0; i < m_adjList.size(); ++i) {
-        std::string name;
-        is >> name >> size;
-        m_adjList[i]->set_name(std::move(name));
-        for (size_t j = 0; j < size; ++j) {
-            size_type to;
-            edge::Cost_t cost;
-            is >> to >> cost;
-            assert(to >= 0 && to < m_adjList.size());
-            (void)add_edge(m_adjList[i], m_adjList[to], cost);
+    // Edges, every worker creates them in its own pool
+    m_numOfEdges = offsets[size];
+    std::vector<object_pool<edge>> pools(pool.size());
+    pool.parallel_for(size, [&](size_type first, size_type last, size_type worker) {
+        pools[worker].reserve(offsets[last] - offsets[first]);
+        for (size_type i = first; i < last; ++i) {
+            detail::text_reader reader{fileName, edgeData[i], line_end(i), i + 2};
+            node* n = m_adjList[i];
+            const size_type degree = offsets[i + 1] - offsets[i];
+            n->reserve_edges(degree);
+            for (size_type j = 0; j < degree; ++j) {
+                const size_type to = reader.number<size_type>("edge target id");
+                if (to >= size) {
+                    reader.fail("edge target id " + std::to_string(to) + " is out of range");
+                }
+                const cost_type cost = reader.number<cost_type>("edge cost");
+                n->add_edge(pools[worker].create(n, m_adjList[to], cost));
+            }
+            if (!reader.at_end()) {
+                reader.fail("unexpected data after the edges of node " + std::to_string(i));
+            }
         }
+    });
+    for (object_pool<edge>& p : pools) {
+        m_edgePool.splice(p);
+    }
+
+    // Incoming edges, the targets are shared between the workers
+    if (m_incomingIndex) {
+        build_incoming_index();
+    }
+
+    detail::text_reader rest{fileName, lines[size], last, size + 2};
+    if (!rest.at_end()) {
+        rest.fail("unexpected data after the last node");
     }
-    m_adjList.shrink_to_fit();
 }
 
 }
@@ -3,29 +3,168 @@
 namespace impl
 {
 
-std::vector<edge::Cost_t> graph::dijkstra(size_type start) const
+namespace detail
 {
-    std::vector<edge::Cost_t> dist(size(), edge::INF_COST);
-    dist[start] = 0;
 
-    std::priority_queue<std::pair<edge::Cost_t, size_type>> queue;
-    queue.push({0, start});
+/**
+ * @brief Costs of single source shortest paths, without predecessors.
+ */
+template <typename Cost>
+struct cost_recorder
+{
+    using size_type = std::size_t;
+
+    cost_recorder(size_type size, size_type source)
+        : costs(size, cost_traits<Cost>::infinity())
+    {
+        costs[source] = 0;
+    }
+
+    [[nodiscard]] inline Cost cost(size_type id) const { return costs[id]; }
+    inline void relax(size_type id, Cost cost, size_type, size_type) { costs[id] = cost; }
+
+    std::vector<Cost> costs;
+};
+
+/**
+ * @brief Breadth first search visitor that records hop counts (and
+ *        predecessors) of an unweighted graph in a dijkstra result.
+ * @details Every node is relaxed once, from the first node that reaches it,
+ *          the search stops when the target is discovered.
+ */
+template <typename Result, typename Graph>
+struct hop_recorder : default_visitor
+{
+    using cost_type = typename Graph::cost_type;
+
+    hop_recorder(Result& result, size_type target)
+        : result(result)
+        , target(target)
+    { }
+
+    template <typename Cost>
+    inline visit_result examine_edge(size_type id, size_type, Cost) noexcept
+    {
+        rank = (id == from) ? rank + 1 : 0;
+        from = id;
+        return visit_result::PROCEED;
+    }
+
+    template <typename Cost>
+    inline visit_result tree_edge(size_type id, size_type toId, Cost)
+    {
+        result.relax(toId, static_cast<cost_type>(result.cost(id) + 1), id, rank);
+        return visit_result::PROCEED;
+    }
+
+    inline visit_result discover(size_type id, size_type) const noexcept
+    {
+        return id == target ? visit_result::STOP : visit_result::PROCEED;
+    }
+
+    Result& result;
+    size_type target;
+    size_type from = Graph::INVALID_ID;
+    size_type rank = 0;
+};
+
+/**
+ * @brief Dijkstra over an indexed heap, every node is popped at most once.
+ * @details Costs (and predecessors) are written to the result in the
+ *          relaxation loop. Stops as soon as the target is settled, costs of
+ *          the nodes that are not settled by then are upper bounds only.
+ *          Unweighted graphs are searched breadth first with hop_recorder instead.
+ */
+template <typename Graph, typename Result>
+void dijkstra_search(const Graph& g, typename Graph::size_type start, Result& result,
+                     typename Graph::size_type target = Graph::INVALID_ID)
+{
+    using size_type = typename Graph::size_type;
+    using cost_type = typename Graph::cost_type;
+
+    if constexpr (!Graph::is_weighted) {
+        hop_recorder<Result, Graph> visitor(result, target);
+        (void)bfs(g, start, visitor, *g.borrow_workspace());
+        return;
+    }
+
+    indexed_heap<cost_type> queue(g.num_of_ids());
+    queue.push_or_decrease(start, 0);
 
     while (!queue.empty()) {
         const auto [cost, id] = queue.top();
         queue.pop();
+        if (id == target) {
+            break;
+        }
 
-        for (const edge* edge : m_adjList[id]->get_edges()) {
-            const size_type toId = edge->get_to()->get_id();
-            const edge::Cost_t toCost = edge->get_cost();
-            const edge::Cost_t totalCost = cost + toCost;
-            if (totalCost < dist[toId]) {
-                dist[toId] = totalCost;
-                queue.push({totalCost, toId});
+        size_type rank = 0;
+        for (const auto [toId, toCost] : g.out_edges(id)) {
+            const cost_type totalCost = cost_traits<cost_type>::add(cost, toCost);
+            if (totalCost < result.cost(toId)) {
+                result.relax(toId, totalCost, id, rank);
+                queue.push_or_decrease(toId, totalCost);
             }
+            ++rank;
         }
     }
-    return dist;
+}
+
+template <typename Graph>
+std::vector<typename Graph::cost_type> dijkstra(const Graph& g, typename Graph::size_type start,
+                                                typename Graph::size_type target = Graph::INVALID_ID)
+{
+    cost_recorder<typename Graph::cost_type> result(g.num_of_ids(), start);
+    dijkstra_search(g, start, result, target);
+    return std::move(result.costs);
+}
+
+template <typename Graph>
+shortest_path_tree<typename Graph::cost_type, typename Graph::id_type> shortest_paths(const Graph& g,
+                                                                                     typename Graph::size_type start,
+                                                                                     bool withEdges)
+{
+    shortest_path_tree<typename Graph::cost_type, typename Graph::id_type> result(g.num_of_ids(), start, withEdges);
+    dijkstra_search(g, start, result);
+    return result;
+}
+
+}
+
+template <typename Cost, typename Id>
+std::vector<path_cost_t<Cost, Id>> basic_graph<Cost, Id>::dijkstra(size_type start) const
+{
+    return detail::dijkstra(*this, start);
+}
+
+template <typename Cost, typename Id>
+path_cost_t<Cost, Id> basic_graph<Cost, Id>::dijkstra(size_type start, size_type target) const
+{
+    return detail::dijkstra(*this, start, target)[target];
+}
+
+template <typename Cost, typename Id>
+shortest_path_tree<path_cost_t<Cost, Id>, Id> basic_graph<Cost, Id>::shortest_paths(size_type start, bool withEdges) const
+{
+    return detail::shortest_paths(*this, start, withEdges);
+}
+
+template <typename Cost, typename Id>
+std::vector<path_cost_t<Cost, Id>> basic_csr_graph<Cost, Id>::dijkstra(size_type start) const
+{
+    return detail::dijkstra(*this, start);
+}
+
+template <typename Cost, typename Id>
+path_cost_t<Cost, Id> basic_csr_graph<Cost, Id>::dijkstra(size_type start, size_type target) const
+{
+    return detail::dijkstra(*this, start, target)[target];
+}
+
+template <typename Cost, typename Id>
+shortest_path_tree<path_cost_t<Cost, Id>, Id> basic_csr_graph<Cost, Id>::shortest_paths(size_type start, bool withEdges) const
+{
+    return detail::shortest_paths(*this, start, withEdges);
 }
 
 }
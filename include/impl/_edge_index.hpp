@@ -0,0 +1,132 @@
+#pragma once
+
+namespace impl
+{
+
+template <typename Edge, bool ByTarget>
+edge_index<Edge, ByTarget>::edge_index(const std::vector<Edge*>& edges)
+{
+    size_type capacity = 16;
+    while (capacity < edges.size() * 2) {
+        capacity *= 2;
+    }
+    rehash(capacity);
+    for (size_type i = 0; i < edges.size(); ++i) {
+        insert(edges[i], i);
+    }
+}
+
+template <typename Edge, bool ByTarget>
+inline const void* edge_index<Edge, ByTarget>::endpoint_of(const Edge* e) noexcept
+{
+    if constexpr (ByTarget) {
+        return e->get_to();
+    } else {
+        return e->get_from();
+    }
+}
+
+template <typename Edge, bool ByTarget>
+inline typename edge_index<Edge, ByTarget>::size_type edge_index<Edge, ByTarget>::home_of(const void* endpoint) const noexcept
+{
+    // Fibonacci hashing of the address, the low bits are always zero
+    const auto address = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(endpoint));
+    return static_cast<size_type>((address * 0x9E3779B97F4A7C15ull) >> 32) & (m_slots.size() - 1);
+}
+
+template <typename Edge, bool ByTarget>
+typename edge_index<Edge, ByTarget>::size_type edge_index<Edge, ByTarget>::find(const void* endpoint) const noexcept
+{
+    const size_type mask = m_slots.size() - 1;
+    for (size_type i = home_of(endpoint); nullptr != m_slots[i].edge; i = (i + 1) & mask) {
+        if (endpoint == endpoint_of(m_slots[i].edge)) {
+            return m_slots[i].position;
+        }
+    }
+    return NOT_FOUND;
+}
+
+template <typename Edge, bool ByTarget>
+typename edge_index<Edge, ByTarget>::size_type edge_index<Edge, ByTarget>::find(const Edge* e) const noexcept
+{
+    const entry& slot = m_slots[find_slot(e)];
+    return nullptr == slot.edge ? NOT_FOUND : slot.position;
+}
+
+template <typename Edge, bool ByTarget>
+typename edge_index<Edge, ByTarget>::size_type edge_index<Edge, ByTarget>::find_slot(const Edge* e) const noexcept
+{
+    const size_type mask = m_slots.size() - 1;
+    size_type i = home_of(endpoint_of(e));
+    while (nullptr != m_slots[i].edge && e != m_slots[i].edge) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+template <typename Edge, bool ByTarget>
+void edge_index<Edge, ByTarget>::insert(const Edge* e, size_type position)
+{
+    if ((m_size + 1) * 2 > m_slots.size()) {
+        rehash(m_slots.size() * 2);
+    }
+    entry& slot = m_slots[find_slot(e)];
+    if (nullptr == slot.edge) {
+        ++m_size;
+    }
+    slot = entry{e, position};
+}
+
+template <typename Edge, bool ByTarget>
+void edge_index<Edge, ByTarget>::move(const Edge* e, size_type position) noexcept
+{
+    entry& slot = m_slots[find_slot(e)];
+    if (nullptr != slot.edge) {
+        slot.position = position;
+    }
+}
+
+template <typename Edge, bool ByTarget>
+void edge_index<Edge, ByTarget>::erase(const Edge* e) noexcept
+{
+    const size_type mask = m_slots.size() - 1;
+    size_type hole = find_slot(e);
+    if (nullptr == m_slots[hole].edge) {
+        return;
+    }
+
+    // Backward shift: move the following entries of the cluster into the hole,
+    // unless their home slot lies cyclically in (hole, current].
+    for (size_type i = (hole + 1) & mask; nullptr != m_slots[i].edge; i = (i + 1) & mask) {
+        const size_type home = home_of(endpoint_of(m_slots[i].edge));
+        const bool stays = (hole < i) ? (hole < home && home <= i)
+                                      : (hole < home || home <= i);
+        if (!stays) {
+            m_slots[hole] = m_slots[i];
+            hole = i;
+        }
+    }
+    m_slots[hole] = entry{nullptr, 0};
+    --m_size;
+}
+
+template <typename Edge, bool ByTarget>
+void edge_index<Edge, ByTarget>::rehash(size_type capacity)
+{
+    std::vector<entry> old(capacity, entry{nullptr, 0});
+    old.swap(m_slots);
+
+    const size_type mask = capacity - 1;
+    for (const entry& slot : old) {
+        if (nullptr == slot.edge) {
+            continue;
+        }
+        size_type i = home_of(endpoint_of(slot.edge));
+        while (nullptr != m_slots[i].edge) {
+            i = (i + 1) & mask;
+        }
+        m_slots[i] = slot;
+    }
+}
+
+}
@@ -4,153 +4,345 @@ namespace impl
 {
 
 ////////////////////////////////////////////////////////////////////////////////
-///// graph
+///// basic_graph
 ////////////////////////////////////////////////////////////////////////////////
-inline size_t graph::get_node_id(const std::string& name) const
+template <typename Cost, typename Id>
+inline size_t basic_graph<Cost, Id>::get_node_id(std::string_view name) const
 {
-    auto it = m_nameToNode.find(name);
-    if (it != m_nameToNode.end()) {
-        return it->second->get_id();
-    }
-    return INVALID_ID;
+    return m_names.find(name);
 }
 
-inline node* graph::get_node(const std::string& name)
+template <typename Cost, typename Id>
+inline typename basic_graph<Cost, Id>::node* basic_graph<Cost, Id>::get_node(std::string_view name)
 {
-    auto it = m_nameToNode.find(name);
-    if (it != m_nameToNode.end()) {
-        return it->second;
+    const size_type id = m_names.find(name);
+    if (name_table::INVALID_ID == id) {
+        return nullptr;
     }
-    return nullptr;
+    return m_adjList[id];
 }
 
-inline const node* graph::get_node(const std::string& name) const
+template <typename Cost, typename Id>
+inline const typename basic_graph<Cost, Id>::node* basic_graph<Cost, Id>::get_node(std::string_view name) const
 {
-    auto it = m_nameToNode.find(name);
-    if (it != m_nameToNode.end()) {
-        return it->second;
+    const size_type id = m_names.find(name);
+    if (name_table::INVALID_ID == id) {
+        return nullptr;
     }
-    return nullptr;
+    return m_adjList[id];
 }
 
-inline node* graph::get_node(size_t start)
+template <typename Cost, typename Id>
+inline typename basic_graph<Cost, Id>::node* basic_graph<Cost, Id>::get_node(size_t start)
 {
-    if (start >= size()) {
+    if (start >= m_adjList.size()) {
         return nullptr;
     }
     return m_adjList[start];
 }
 
-inline const node* graph::get_node(size_t start) const
+template <typename Cost, typename Id>
+inline const typename basic_graph<Cost, Id>::node* basic_graph<Cost, Id>::get_node(size_t start) const
 {
-    if (start >= size()) {
+    if (start >= m_adjList.size()) {
         return nullptr;
     }
     return m_adjList[start];
 }
 
-inline node* graph::get_or_create_node(const std::string& name)
+template <typename Cost, typename Id>
+inline typename basic_graph<Cost, Id>::arc_range basic_graph<Cost, Id>::out_edges(size_type id) const
+{
+    assert(id < m_adjList.size());
+    const node* n = m_adjList[id];
+    if (nullptr == n) {
+        return arc_range(typename node::const_arc_iterator({}), typename node::const_arc_iterator({}));
+    }
+    return arc_range(n->begin_arcs(), n->end_arcs());
+}
+
+template <typename Cost, typename Id>
+inline typename basic_graph<Cost, Id>::size_type basic_graph<Cost, Id>::degree(size_type id) const
+{
+    assert(id < m_adjList.size());
+    const node* n = m_adjList[id];
+    return nullptr == n ? 0 : n->degree();
+}
+
+template <typename Cost, typename Id>
+inline typename basic_graph<Cost, Id>::arc_range basic_graph<Cost, Id>::in_edges(size_type id) const
 {
-    node* n = get_node(name);
-    if (nullptr != n) {
-        return n;
+    assert(id < m_adjList.size());
+    const node* n = m_adjList[id];
+    if (nullptr == n) {
+        return arc_range(typename node::const_arc_iterator({}), typename node::const_arc_iterator({}));
     }
-    const size_t id = m_adjList.size();
-    n = new node(id, name);
+    return arc_range(n->begin_in_arcs(), n->end_in_arcs());
+}
+
+template <typename Cost, typename Id>
+inline typename basic_graph<Cost, Id>::node* basic_graph<Cost, Id>::get_or_create_node(std::string_view name)
+{
+    check_free_id(name);
+    const auto [entry, inserted] = m_names.emplace(name, m_adjList.size());
+    if (!inserted) {
+        return m_adjList[entry->id];
+    }
+    return create_node(entry->id, entry->name);
+}
+
+template <typename Cost, typename Id>
+inline typename basic_graph<Cost, Id>::node* basic_graph<Cost, Id>::create_node(size_type id, std::string_view name)
+{
+    assert(id == m_adjList.size());
+    assert(id < INVALID_ID);
+    node* n = m_nodePool.create(id, name);
     m_adjList.push_back(n);
-    m_nameToNode.insert({name, n});
     return n;
 }
 
-inline void graph::add_edge(edge* e)
+template <typename Cost, typename Id>
+inline void basic_graph<Cost, Id>::check_free_id(std::string_view name) const
 {
-    m_edges.push_back(e);
+    if (m_adjList.size() >= INVALID_ID && !contains(name)) {
+        throw std::length_error("Number of nodes exceeds the range of the node id type");
+    }
 }
 
-bool graph::add_edge(node* fromNode, node* toNode, edge::Cost_t cost)
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::add_edge(node* fromNode, node* toNode, cost_type cost)
 {
-    edge* e = fromNode->add_edge(toNode, cost);
-    if (e == nullptr) {
-        return false;
+    edge* e = m_edgePool.create(fromNode, toNode, cost);
+    fromNode->add_edge(e);
+    if (m_incomingIndex) {
+        toNode->add_in_edge(e);
     }
-
-    add_edge(e);
+    ++m_numOfEdges;
     return true;
 }
 
-graph::graph()
+template <typename Cost, typename Id>
+basic_graph<Cost, Id>::basic_graph()
     : m_adjList{}
-    , m_edges{}
-    , m_nameToNode{}
+    , m_numOfRemoved{0}
+    , m_numOfEdges{0}
+    , m_names{}
+    , m_nodePool{}
+    , m_edgePool{}
+    , m_incomingIndex{true}
 { }
 
-graph::graph(graph&& other)
+template <typename Cost, typename Id>
+basic_graph<Cost, Id>::basic_graph(basic_graph&& other)
     : m_adjList(std::move(other.m_adjList))
-    , m_nameToNode(std::move(other.m_nameToNode))
+    , m_numOfRemoved(other.m_numOfRemoved)
+    , m_numOfEdges(other.m_numOfEdges)
+    , m_names(std::move(other.m_names))
+    , m_nodePool(std::move(other.m_nodePool))
+    , m_edgePool(std::move(other.m_edgePool))
+    , m_incomingIndex(other.m_incomingIndex)
 {
     other.m_adjList.clear();
-    other.m_nameToNode.clear();
+    other.m_numOfRemoved = 0;
+    other.m_numOfEdges = 0;
 }
 
-graph::~graph()
+template <typename Cost, typename Id>
+basic_graph<Cost, Id>::~basic_graph()
 {
     clear();
 }
 
-void graph::clear()
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::clear()
 {
-    m_nameToNode.clear();
-    std::destroy(m_adjList.begin(), m_adjList.end());
+    m_names.clear();
     m_adjList.clear();
+    m_numOfRemoved = 0;
+    m_numOfEdges = 0;
+    m_edgePool.clear();
+    m_nodePool.clear();
 }
 
-inline size_t graph::size() const noexcept
+template <typename Cost, typename Id>
+inline size_t basic_graph<Cost, Id>::size() const noexcept
 {
-    return m_adjList.size();
+    return m_adjList.size() - m_numOfRemoved;
 }
 
-inline bool graph::empty() const noexcept
+template <typename Cost, typename Id>
+inline bool basic_graph<Cost, Id>::empty() const noexcept
 {
     return 0 == size();
 }
 
-inline bool graph::contains(const std::string& name) const
+template <typename Cost, typename Id>
+inline bool basic_graph<Cost, Id>::contains(std::string_view name) const
+{
+    return name_table::INVALID_ID != m_names.find(name);
+}
+
+template <typename Cost, typename Id>
+inline bool basic_graph<Cost, Id>::contains(size_type id) const noexcept
 {
-    return (m_nameToNode.find(name) != m_nameToNode.end());
+    return id < m_adjList.size() && nullptr != m_adjList[id];
 }
 
-bool graph::add_node(const std::string& name)
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::add_node(std::string_view name)
 {
-    if (contains(name)) {
+    check_free_id(name);
+    const auto [entry, inserted] = m_names.emplace(name, m_adjList.size());
+    if (!inserted) {
         return false;
     }
-    const size_t id = m_adjList.size();
-    node* n = new node(id, name);
-    m_adjList.push_back(n);
-    m_nameToNode.insert({name, n});
+    (void)create_node(entry->id, entry->name);
     return true;
 }
 
-bool graph::remove_node(const std::string& name)
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::remove_node(std::string_view name)
 {
-    // Not implemented yet
     node* node = get_node(name);
     if (nullptr == node) {
         return false;
     }
 
-    size_t id = node->get_id();
+    (void)m_names.erase(name);
 
-    auto iter = m_adjList.erase(m_adjList.begin() + id);
-    for (; iter != m_adjList.end(); ++iter, ++id) {
-        (*iter)->set_id(id);
-        (void)(*iter)->remove_edge(node);
+    // Outgoing edges leave the incoming lists of their targets
+    for (edge* e : node->get_edges()) {
+        e->get_to()->remove_in_edge(e);
+    }
+    m_numOfEdges -= node->degree();
+    // Incoming edges leave the outgoing lists of their sources
+    if (m_incomingIndex) {
+        for (edge* e : node->get_in_edges()) {
+            if (e->get_from() != node) {
+                e->get_from()->remove_out_edge(e);
+                --m_numOfEdges;
+            }
+        }
+    } else {
+        for (auto* n : m_adjList) {
+            while (nullptr != n && n != node && n->remove_edge(node)) {
+                --m_numOfEdges;
+            }
+        }
     }
 
+    // The slot stays as a hole, the node and its edges stay in the pools until compact
+    m_adjList[node->get_id()] = nullptr;
+    ++m_numOfRemoved;
     return true;
 }
 
-inline bool graph::has_edge(const std::string& from, const std::string& to)
+template <typename Cost, typename Id>
+std::vector<typename basic_graph<Cost, Id>::id_type> basic_graph<Cost, Id>::compacted_ids() const
+{
+    std::vector<id_type> ids(m_adjList.size(), INVALID_ID);
+    id_type next = 0;
+    for (size_type id = 0; id < m_adjList.size(); ++id) {
+        if (nullptr != m_adjList[id]) {
+            ids[id] = next++;
+        }
+    }
+    return ids;
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::compact()
+{
+    std::vector<node*> adjList;
+    name_table names;
+    object_pool<node> nodePool;
+    object_pool<edge> edgePool;
+    adjList.reserve(size());
+    names.reserve(size());
+    nodePool.reserve(size());
+    edgePool.reserve(m_numOfEdges);
+
+    for (const node* n : m_adjList) {
+        if (nullptr != n) {
+            const auto [entry, inserted] = names.emplace(n->get_name(), adjList.size());
+            assert(inserted);
+            adjList.push_back(nodePool.create(adjList.size(), entry->name));
+        }
+    }
+    const std::vector<id_type> ids = compacted_ids();
+    for (const node* n : m_adjList) {
+        if (nullptr == n) {
+            continue;
+        }
+        node* from = adjList[ids[n->get_id()]];
+        from->reserve_edges(n->degree());
+        for (const edge* e : n->get_edges()) {
+            from->add_edge(edgePool.create(from, adjList[ids[e->get_to_idx()]], e->get_cost()));
+        }
+    }
+
+    m_adjList = std::move(adjList);
+    m_names = std::move(names);
+    m_nodePool = std::move(nodePool);
+    m_edgePool = std::move(edgePool);
+    m_numOfRemoved = 0;
+    if (m_incomingIndex) {
+        build_incoming_index();
+    }
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::index_incoming_edges(bool enable)
+{
+    if (enable == m_incomingIndex) {
+        return;
+    }
+    m_incomingIndex = enable;
+    if (!enable) {
+        for (node* n : m_adjList) {
+            if (nullptr != n) {
+                n->clear_in_edges();
+            }
+        }
+        return;
+    }
+    build_incoming_index();
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::build_incoming_index()
+{
+    std::vector<size_type> inDegrees(m_adjList.size(), 0);
+    for (const node* n : m_adjList) {
+        if (nullptr != n) {
+            for (const edge* e : n->get_edges()) {
+                ++inDegrees[e->get_to_idx()];
+            }
+        }
+    }
+    build_incoming_index(inDegrees);
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::build_incoming_index(const std::vector<size_type>& inDegrees)
+{
+    assert(inDegrees.size() == m_adjList.size());
+    for (size_type i = 0; i < m_adjList.size(); ++i) {
+        if (nullptr != m_adjList[i]) {
+            m_adjList[i]->reserve_in_edges(inDegrees[i]);
+        }
+    }
+    for (node* n : m_adjList) {
+        if (nullptr != n) {
+            for (edge* e : n->get_edges()) {
+                e->get_to()->add_in_edge(e);
+            }
+        }
+    }
+}
+
+template <typename Cost, typename Id>
+inline bool basic_graph<Cost, Id>::has_edge(std::string_view from, std::string_view to)
 {
     node* fromNode = get_node(from);
     node* toNode = get_node(to);
@@ -162,7 +354,8 @@ inline bool graph::has_edge(const std::string& from, const std::string& to)
     return fromNode->has_edge(toNode);
 }
 
-bool graph::add_edge(const std::string& from, const std::string& to, edge::Cost_t cost)
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::add_edge(std::string_view from, std::string_view to, cost_type cost)
 {
     node* fromNode = get_or_create_node(from);
     node* toNode = get_or_create_node(to);
@@ -170,15 +363,135 @@ bool graph::add_edge(const std::string& from, const std::string& to, edge::Cost_
     return add_edge(fromNode, toNode, cost);
 }
 
-bool graph::remove_edge(const std::string& from, const std::string& to)
+template <typename Cost, typename Id>
+template <typename ForwardIt>
+basic_graph<Cost, Id>::basic_graph(ForwardIt first, ForwardIt last)
+    : basic_graph()
+{
+    add_edges(first, last);
+}
+
+template <typename Cost, typename Id>
+template <typename ForwardIt>
+void basic_graph<Cost, Id>::add_edges(ForwardIt first, ForwardIt last)
+{
+    using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+    using end_type = std::decay_t<std::tuple_element_t<0, value_type>>;
+    constexpr bool isNamed = std::is_convertible_v<const end_type&, std::string_view>;
+    constexpr bool hasCost = std::tuple_size_v<value_type> > 2;
+    static_assert(isNamed || std::is_integral_v<end_type>, "Endpoints must be names or ids");
+
+    // First pass: resolve the endpoints and count the new edges per node
+    std::vector<size_type> degrees(num_of_ids(), 0);
+    std::vector<size_type> inDegrees(num_of_ids(), 0);
+    std::vector<node*> ends;
+    size_type numOfEdges = 0;
+    if constexpr (isNamed) {
+        using category = typename std::iterator_traits<ForwardIt>::iterator_category;
+        if constexpr (std::is_base_of_v<std::random_access_iterator_tag, category>) {
+            ends.reserve(2 * static_cast<size_type>(last - first));
+        }
+        // Edge lists are usually grouped by source, so the previous source is reused
+        node* fromNode = nullptr;
+        for (auto it = first; it != last; ++it, ++numOfEdges) {
+            const std::string_view from = std::get<0>(*it);
+            if (nullptr == fromNode || fromNode->get_name() != from) {
+                fromNode = get_or_create_node(from);
+            }
+            node* toNode = get_or_create_node(std::get<1>(*it));
+            ends.push_back(fromNode);
+            ends.push_back(toNode);
+            if (degrees.size() < num_of_ids()) {
+                degrees.resize(num_of_ids(), 0);
+                inDegrees.resize(num_of_ids(), 0);
+            }
+            ++degrees[fromNode->get_id()];
+            ++inDegrees[toNode->get_id()];
+        }
+    } else {
+        for (auto it = first; it != last; ++it, ++numOfEdges) {
+            const auto from = static_cast<size_type>(std::get<0>(*it));
+            const auto to = static_cast<size_type>(std::get<1>(*it));
+            if (std::max(from, to) >= INVALID_ID) {
+                throw std::length_error("Node id " + std::to_string(std::max(from, to))
+                                        + " exceeds the range of the node id type");
+            }
+            for (const size_type id : {from, to}) {
+                if (id < num_of_ids() && !contains(id)) {
+                    throw std::invalid_argument("Node id " + std::to_string(id) + " belongs to a removed node");
+                }
+            }
+            if (degrees.size() <= std::max(from, to)) {
+                degrees.resize(std::max(from, to) + 1, 0);
+                inDegrees.resize(std::max(from, to) + 1, 0);
+            }
+            ++degrees[from];
+            ++inDegrees[to];
+        }
+        for (size_type id = num_of_ids(); id < degrees.size(); ++id) {
+            const size_type other = m_names.find(std::to_string(id));
+            if (name_table::INVALID_ID != other) {
+                throw std::invalid_argument("Node id " + std::to_string(id) + " can not be named after its id, node "
+                                            + std::to_string(other) + " has that name");
+            }
+        }
+        m_names.reserve(degrees.size());
+        for (size_type id = num_of_ids(); id < degrees.size(); ++id) {
+            (void)create_node(id, m_names.emplace(std::to_string(id), id).first->name);
+        }
+    }
+
+    // Reserve everything exactly once
+    for (size_type id = 0; id < degrees.size(); ++id) {
+        if (0 != degrees[id]) {
+            m_adjList[id]->reserve_edges(m_adjList[id]->degree() + degrees[id]);
+        }
+        if (m_incomingIndex && 0 != inDegrees[id]) {
+            m_adjList[id]->reserve_in_edges(m_adjList[id]->get_in_edges().size() + inDegrees[id]);
+        }
+    }
+    m_edgePool.reserve(numOfEdges);
+
+    // Second pass: create the edges
+    size_type i = 0;
+    for (auto it = first; it != last; ++it, ++i) {
+        node* fromNode = nullptr;
+        node* toNode = nullptr;
+        if constexpr (isNamed) {
+            fromNode = ends[2 * i];
+            toNode = ends[2 * i + 1];
+        } else {
+            fromNode = m_adjList[static_cast<size_type>(std::get<0>(*it))];
+            toNode = m_adjList[static_cast<size_type>(std::get<1>(*it))];
+            assert(nullptr != fromNode && nullptr != toNode);
+        }
+        cost_type cost = 1;
+        if constexpr (hasCost) {
+            cost = static_cast<cost_type>(std::get<2>(*it));
+        }
+        (void)add_edge(fromNode, toNode, cost);
+    }
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::remove_edge(std::string_view from, std::string_view to)
 {
     node* fromNode = get_node(from);
     node* toNode = get_node(to);
 
-    return fromNode->remove_edge(toNode);
+    if (nullptr == fromNode || nullptr == toNode) {
+        return false;
+    }
+
+    if (!fromNode->remove_edge(toNode)) {
+        return false;
+    }
+    --m_numOfEdges;
+    return true;
 }
 
-bool graph::compare(const graph* g) const
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::compare(const basic_graph* g) const
 {
     if (size() != g->size()) {
         return false;
@@ -186,20 +499,26 @@ bool graph::compare(const graph* g) const
     if (num_of_edges() != g->num_of_edges()) {
         return false;
     }
-    for (size_type i = 0; i < size(); ++i) {
+    for (size_type i = 0; i < std::max(num_of_ids(), g->num_of_ids()); ++i) {
         const node* lhs = get_node(i);
-        const node* rhs = get_node(i);
-        if (!lhs->compare(rhs)) {
+        const node* rhs = g->get_node(i);
+        if ((nullptr == lhs) != (nullptr == rhs)) {
+            return false;
+        }
+        if (nullptr != lhs && !lhs->compare(rhs)) {
             return false;
         }
     }
     return true;
 }
 
-void graph::dump(std::ostream& os) const
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::dump(std::ostream& os) const
 {
     for (const auto* node : m_adjList) {
-        node->dump(os);
+        if (nullptr != node) {
+            node->dump(os);
+        }
     }
 }
 
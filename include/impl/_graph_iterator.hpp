@@ -4,139 +4,272 @@ namespace impl
 {
 
 ////////////////////////////////////////////////////////////////////////////////
-///// graph::iterator
+///// basic_graph::live_node_iterator
 ////////////////////////////////////////////////////////////////////////////////
-graph::iterator::iterator(const graph& g, node* n, iter_type type)
+template <typename Cost, typename Id>
+template <typename Pointer, typename BaseIterator>
+basic_graph<Cost, Id>::live_node_iterator<Pointer, BaseIterator>::live_node_iterator(BaseIterator iter, BaseIterator last)
+    : m_iter(iter)
+    , m_last(last)
+{
+    skip_removed();
+}
+
+template <typename Cost, typename Id>
+template <typename Pointer, typename BaseIterator>
+typename basic_graph<Cost, Id>::template live_node_iterator<Pointer, BaseIterator>& basic_graph<Cost, Id>::live_node_iterator<Pointer, BaseIterator>::operator++()
+{
+    ++m_iter;
+    skip_removed();
+    return *this;
+}
+
+template <typename Cost, typename Id>
+template <typename Pointer, typename BaseIterator>
+typename basic_graph<Cost, Id>::template live_node_iterator<Pointer, BaseIterator> basic_graph<Cost, Id>::live_node_iterator<Pointer, BaseIterator>::operator++(int)
+{
+    live_node_iterator temp{*this};
+    ++*this;
+    return temp;
+}
+
+template <typename Cost, typename Id>
+template <typename Pointer, typename BaseIterator>
+bool basic_graph<Cost, Id>::live_node_iterator<Pointer, BaseIterator>::operator==(const live_node_iterator& other) const
+{
+    return m_iter == other.m_iter;
+}
+
+template <typename Cost, typename Id>
+template <typename Pointer, typename BaseIterator>
+bool basic_graph<Cost, Id>::live_node_iterator<Pointer, BaseIterator>::operator!=(const live_node_iterator& other) const
+{
+    return m_iter != other.m_iter;
+}
+
+template <typename Cost, typename Id>
+template <typename Pointer, typename BaseIterator>
+typename basic_graph<Cost, Id>::template live_node_iterator<Pointer, BaseIterator>::reference
+basic_graph<Cost, Id>::live_node_iterator<Pointer, BaseIterator>::operator*() const
+{
+    return *m_iter;
+}
+
+template <typename Cost, typename Id>
+template <typename Pointer, typename BaseIterator>
+void basic_graph<Cost, Id>::live_node_iterator<Pointer, BaseIterator>::skip_removed()
+{
+    while (m_iter != m_last && nullptr == *m_iter) {
+        ++m_iter;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///// basic_graph::const_edge_iterator
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+basic_graph<Cost, Id>::const_edge_iterator::const_edge_iterator(typename std::vector<node*>::const_iterator iter,
+                                                                typename std::vector<node*>::const_iterator last)
+    : m_iter(iter)
+    , m_last(last)
+    , m_edge(0)
+{
+    skip_empty();
+}
+
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::const_edge_iterator& basic_graph<Cost, Id>::const_edge_iterator::operator++()
+{
+    ++m_edge;
+    skip_empty();
+    return *this;
+}
+
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::const_edge_iterator basic_graph<Cost, Id>::const_edge_iterator::operator++(int)
+{
+    const_edge_iterator temp{*this};
+    ++*this;
+    return temp;
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::const_edge_iterator::operator==(const const_edge_iterator& other) const
+{
+    return m_iter == other.m_iter && m_edge == other.m_edge;
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::const_edge_iterator::operator!=(const const_edge_iterator& other) const
+{
+    return !(*this == other);
+}
+
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::const_edge_iterator::reference basic_graph<Cost, Id>::const_edge_iterator::operator*() const
+{
+    return (*m_iter)->get_edge(m_edge);
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::const_edge_iterator::skip_empty()
+{
+    while (m_iter != m_last && (nullptr == *m_iter || m_edge == (*m_iter)->degree())) {
+        ++m_iter;
+        m_edge = 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///// basic_graph::iterator
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+basic_graph<Cost, Id>::iterator::iterator(const basic_graph& g, node* n, iter_type type)
     : m_type(type)
     , m_node(n)
-    , m_visited(g.size(), false)
-    , m_deque()
+    , m_adjList(&g.m_adjList)
+    , m_workspace()
 {
     if (nullptr != m_node) {
-        m_visited[m_node->get_id()] = true;
+        m_workspace = g.borrow_workspace();
+        m_workspace->visit(m_node->get_id());
         collect_nodes();
     }
 }
 
-graph::iterator& graph::iterator::operator++()
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::iterator& basic_graph<Cost, Id>::iterator::operator++()
 {
-    if (m_deque.empty()) {
+    // The end iterator has no workspace, incrementing it stays at the end
+    if (nullptr == m_workspace) {
+        return *this;
+    }
+    if (m_workspace->empty()) {
         m_node = nullptr;
+        m_workspace.reset();
         return *this;
     }
 
     if (iter_type::BFS == m_type) {
-        m_node = m_deque.front();
-        m_deque.pop_front();
+        m_node = (*m_adjList)[m_workspace->pop_front()];
     } else {
-        m_node = m_deque.back();
-        m_deque.pop_back();
+        m_node = (*m_adjList)[m_workspace->pop_back()];
     }
     collect_nodes();
 
     return *this;
 }
 
-graph::iterator graph::iterator::operator++(int)
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::iterator basic_graph<Cost, Id>::iterator::operator++(int)
 {
     iterator tmp = *this;
     ++*this;
     return tmp;
 }
 
-bool graph::iterator::operator==(const iterator& other) const
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::iterator::operator==(const iterator& other) const
 {
     return (m_type == other.m_type && m_node == other.m_node);
 }
 
-bool graph::iterator::operator!=(const iterator& other) const
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::iterator::operator!=(const iterator& other) const
 {
     return !(other == *this);
 }
 
-graph::iterator::reference graph::iterator::operator*() const
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::iterator::reference basic_graph<Cost, Id>::iterator::operator*() const
 {
     return *m_node;
 }
 
-void graph::iterator::collect_nodes()
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::iterator::collect_nodes()
 {
     assert(nullptr != m_node);
-    //for (auto* edge : m_node->get_edges()) {
-    for (auto it = m_node->begin_nodes(); it != m_node->end_nodes(); ++it) {
-        node* to = *it;
-        const graph::size_type id = to->get_id();
-        if (!m_visited[id]) {
-            m_visited[id] = true;
-            m_deque.push_back(to);
+    for (const edge* e : m_node->get_edges()) {
+        const size_type id = e->get_to_idx();
+        if (m_workspace->visit(id)) {
+            m_workspace->push(id);
         }
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-graph::const_iterator::const_iterator(const graph& g, const node* n, iter_type type)
+template <typename Cost, typename Id>
+basic_graph<Cost, Id>::const_iterator::const_iterator(const basic_graph& g, const node* n, iter_type type)
     : m_type(type)
     , m_node(n)
-    , m_visited(g.size(), false)
-    , m_deque()
+    , m_adjList(&g.m_adjList)
+    , m_workspace()
 {
     if (nullptr != m_node) {
-        m_visited[m_node->get_id()] = true;
+        m_workspace = g.borrow_workspace();
+        m_workspace->visit(m_node->get_id());
         collect_nodes();
     }
 }
 
-graph::const_iterator& graph::const_iterator::operator++()
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::const_iterator& basic_graph<Cost, Id>::const_iterator::operator++()
 {
-    if (m_deque.empty()) {
+    // The end iterator has no workspace, incrementing it stays at the end
+    if (nullptr == m_workspace) {
+        return *this;
+    }
+    if (m_workspace->empty()) {
         m_node = nullptr;
+        m_workspace.reset();
         return *this;
     }
 
     if (iter_type::BFS == m_type) {
-        m_node = m_deque.front();
-        m_deque.pop_front();
+        m_node = (*m_adjList)[m_workspace->pop_front()];
     } else {
-        m_node = m_deque.back();
-        m_deque.pop_back();
+        m_node = (*m_adjList)[m_workspace->pop_back()];
     }
     collect_nodes();
 
     return *this;
 }
 
-graph::const_iterator graph::const_iterator::operator++(int)
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::const_iterator basic_graph<Cost, Id>::const_iterator::operator++(int)
 {
     const_iterator tmp = *this;
     ++*this;
     return tmp;
 }
 
-bool graph::const_iterator::operator==(const const_iterator& other) const
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::const_iterator::operator==(const const_iterator& other) const
 {
     return (m_type == other.m_type && m_node == other.m_node);
 }
 
-bool graph::const_iterator::operator!=(const const_iterator& other) const
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::const_iterator::operator!=(const const_iterator& other) const
 {
     return !(other == *this);
 }
 
-graph::const_iterator::const_reference graph::const_iterator::operator*() const
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::const_iterator::const_reference basic_graph<Cost, Id>::const_iterator::operator*() const
 {
     return *m_node;
 }
 
-void graph::const_iterator::collect_nodes()
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::const_iterator::collect_nodes()
 {
     assert(nullptr != m_node);
-    //for (auto* edge : m_node->get_edges()) {
-    for (auto it = m_node->begin_nodes(); it != m_node->end_nodes(); ++it) {
-        const node* to = *it;
-        const graph::size_type id = to->get_id();
-        if (!m_visited[id]) {
-            m_visited[id] = true;
-            m_deque.push_back(to);
+    for (const edge* e : m_node->get_edges()) {
+        const size_type id = e->get_to_idx();
+        if (m_workspace->visit(id)) {
+            m_workspace->push(id);
         }
     }
 }
@@ -3,28 +3,45 @@
 namespace impl
 {
 
-bool graph::has_negative_cycle() const
+namespace detail
 {
-    assert(!empty());
-    std::vector<edge::Cost_t> dist(size(), edge::INF_COST);
+
+template <typename Graph>
+bool has_negative_cycle(const Graph& g)
+{
+    using size_type = typename Graph::size_type;
+    using cost_type = typename Graph::cost_type;
+    using traits = cost_traits<cost_type>;
+    constexpr cost_type INF_COST = traits::infinity();
+
+    assert(!g.empty());
+    if constexpr (!Graph::is_weighted) {
+        return false;
+    }
+    std::vector<cost_type> dist(g.num_of_ids(), INF_COST);
     dist[0] = 0;
-    for (size_type i = 1; i < size(); ++i) {
-        for (auto it = cbegin_edges(); it != cend_edges(); ++it) {
-            size_type fromIdx = (*it)->get_from_idx();
-            size_type toIdx = (*it)->get_to_idx();
-            edge::Cost_t cost = (*it)->get_cost();
-            if (dist[fromIdx] != edge::INF_COST && dist[fromIdx] + cost < dist[toIdx]) {
-                dist[toIdx] = dist[fromIdx] + cost;
+    for (size_type i = 1; i < g.num_of_ids(); ++i) {
+        for (size_type fromIdx = 0; fromIdx < g.num_of_ids(); ++fromIdx) {
+            if (dist[fromIdx] == INF_COST) {
+                continue;
+            }
+            for (const auto [toIdx, cost] : g.out_edges(fromIdx)) {
+                const cost_type totalCost = traits::add(dist[fromIdx], cost);
+                if (totalCost < dist[toIdx]) {
+                    dist[toIdx] = totalCost;
+                }
             }
         }
     }
 
-    for (auto it = cbegin_edges(); it != cend_edges(); ++it) {
-        size_type fromIdx = (*it)->get_from_idx();
-        size_type toIdx = (*it)->get_to_idx();
-        edge::Cost_t cost = (*it)->get_cost();
-        if (dist[fromIdx] != edge::INF_COST && dist[fromIdx] + cost < dist[toIdx]) {
-            return true;
+    for (size_type fromIdx = 0; fromIdx < g.num_of_ids(); ++fromIdx) {
+        if (dist[fromIdx] == INF_COST) {
+            continue;
+        }
+        for (const auto [toIdx, cost] : g.out_edges(fromIdx)) {
+            if (traits::add(dist[fromIdx], cost) < dist[toIdx]) {
+                return true;
+            }
         }
     }
 
@@ -32,3 +49,17 @@ bool graph::has_negative_cycle() const
 }
 
 }
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::has_negative_cycle() const
+{
+    return detail::has_negative_cycle(*this);
+}
+
+template <typename Cost, typename Id>
+bool basic_csr_graph<Cost, Id>::has_negative_cycle() const
+{
+    return detail::has_negative_cycle(*this);
+}
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+namespace impl
+{
+
+template <typename Key, std::size_t Arity>
+indexed_heap<Key, Arity>::indexed_heap(size_type capacity)
+    : m_positions(capacity, NOT_IN_HEAP)
+{ }
+
+template <typename Key, std::size_t Arity>
+bool indexed_heap<Key, Arity>::push_or_decrease(size_type id, Key key)
+{
+    size_type position = m_positions[id];
+    if (NOT_IN_HEAP == position) {
+        position = m_heap.size();
+        m_heap.emplace_back(key, id);
+        m_positions[id] = position;
+    } else if (key < m_heap[position].first) {
+        m_heap[position].first = key;
+    } else {
+        return false;
+    }
+    sift_up(position);
+    return true;
+}
+
+template <typename Key, std::size_t Arity>
+void indexed_heap<Key, Arity>::pop()
+{
+    m_positions[m_heap.front().second] = NOT_IN_HEAP;
+    const value_type last = m_heap.back();
+    m_heap.pop_back();
+    if (!m_heap.empty()) {
+        place(0, last);
+        sift_down(0);
+    }
+}
+
+template <typename Key, std::size_t Arity>
+void indexed_heap<Key, Arity>::clear() noexcept
+{
+    for (const value_type& value : m_heap) {
+        m_positions[value.second] = NOT_IN_HEAP;
+    }
+    m_heap.clear();
+}
+
+template <typename Key, std::size_t Arity>
+void indexed_heap<Key, Arity>::sift_up(size_type position)
+{
+    const value_type value = m_heap[position];
+    while (position > 0) {
+        const size_type parent = (position - 1) / Arity;
+        if (!(value.first < m_heap[parent].first)) {
+            break;
+        }
+        place(position, m_heap[parent]);
+        position = parent;
+    }
+    place(position, value);
+}
+
+template <typename Key, std::size_t Arity>
+void indexed_heap<Key, Arity>::sift_down(size_type position)
+{
+    const value_type value = m_heap[position];
+    const size_type size = m_heap.size();
+    for (;;) {
+        const size_type first = position * Arity + 1;
+        if (first >= size) {
+            break;
+        }
+        const size_type last = std::min(first + Arity, size);
+        size_type best = first;
+        for (size_type child = first + 1; child < last; ++child) {
+            if (m_heap[child].first < m_heap[best].first) {
+                best = child;
+            }
+        }
+        if (!(m_heap[best].first < value.first)) {
+            break;
+        }
+        place(position, m_heap[best]);
+        position = best;
+    }
+    place(position, value);
+}
+
+template <typename Key, std::size_t Arity>
+void indexed_heap<Key, Arity>::place(size_type position, const value_type& value)
+{
+    m_heap[position] = value;
+    m_positions[value.second] = position;
+}
+
+}
@@ -1,37 +1,193 @@
 #pragma once
 
+#include <atomic>
+
 namespace impl
 {
-bool graph::is_cyclic_util(size_type i, std::vector<bool>& visited, std::vector<bool>& stack) const
-{
-    if (!visited[i]) {
-        visited[i] = true;
-        stack[i] = true;
-        for(auto it = m_adjList[i]->begin_nodes(); it !=  m_adjList[i]->end_nodes(); ++it) {
-            const size_type id = (*it)->get_id();
-            if ( !visited[id] && is_cyclic_util(id, visited, stack)) {
-                return true;
-            } else if (stack[id]) {
-                return true;
-            }
+
+namespace detail
+{
+
+/**
+ * @brief Depth first search that stops at the first back edge.
+ */
+struct cycle_finder : default_visitor
+{
+    template <typename Cost>
+    constexpr visit_result back_edge(size_type, size_type, Cost) noexcept { return visit_result::STOP; }
+};
+
+template <typename Graph>
+bool is_cyclic(const Graph& g)
+{
+    using size_type = typename Graph::size_type;
+
+    const workspace_pool::workspace_ptr workspace = g.borrow_workspace();
+    cycle_finder visitor;
+    for (size_type i = 0; i < g.num_of_ids(); ++i) {
+        if (g.contains(i) && dfs(g, i, visitor, *workspace)) {
+            return true;
         }
     }
-    stack[i] = false;
+
     return false;
 }
 
-bool graph::is_cyclic() const
+/**
+ * @brief Depth first search that stops at the first back edge and keeps the
+ *        path from the root, so the cycle closed by the back edge is known.
+ */
+struct cycle_recorder : default_visitor
 {
-    std::vector<bool> visited(size(), false);
-    std::vector<bool> stack(size(), false);
+    inline visit_result discover(size_type id, size_type)
+    {
+        path.push_back(id);
+        return visit_result::PROCEED;
+    }
 
-    for (size_type i = 0; i < size(); ++i) {
-        if (is_cyclic_util(i, visited, stack)) {
-            return true;
+    template <typename Cost>
+    inline visit_result back_edge(size_type, size_type toId, Cost)
+    {
+        const auto it = std::find(path.rbegin(), path.rend(), toId);
+        cycle.assign(std::prev(it.base()), path.end());
+        return visit_result::STOP;
+    }
+
+    inline visit_result finish(size_type)
+    {
+        path.pop_back();
+        return visit_result::PROCEED;
+    }
+
+    std::vector<size_type> path;
+    std::vector<size_type> cycle;
+};
+
+template <typename Graph>
+std::vector<typename Graph::size_type> find_cycle(const Graph& g)
+{
+    using size_type = typename Graph::size_type;
+
+    const workspace_pool::workspace_ptr workspace = g.borrow_workspace();
+    cycle_recorder visitor;
+    for (size_type i = 0; i < g.num_of_ids(); ++i) {
+        if (g.contains(i) && dfs(g, i, visitor, *workspace)) {
+            break;
         }
     }
 
-    return false;
+    return std::move(visitor.cycle);
+}
+
+/**
+ * @brief Count the incoming edges of every node, each thread takes a block of
+ *        nodes and increments the counters of their targets.
+ * @details Counters are size_type, parallel edges can give a node more
+ *          incoming edges than the id type holds.
+ */
+template <typename Graph>
+std::vector<std::atomic<typename Graph::size_type>> in_degrees(const Graph& g, thread_pool& pool)
+{
+    using size_type = typename Graph::size_type;
+
+    std::vector<std::atomic<size_type>> degrees(g.num_of_ids());
+    pool.parallel_for(degrees.size(), [&](size_type first, size_type last, size_type) {
+        for (size_type i = first; i < last; ++i) {
+            degrees[i].store(0, std::memory_order_relaxed);
+        }
+    });
+    pool.parallel_for(g.num_of_ids(), [&](size_type first, size_type last, size_type) {
+        for (size_type i = first; i < last; ++i) {
+            if (!g.contains(i)) {
+                continue;
+            }
+            for (const auto [toId, toCost] : g.out_edges(i)) {
+                degrees[toId].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    });
+    return degrees;
+}
+
+/**
+ * @brief Kahn's algorithm: remove the nodes without incoming edges until none
+ *        is left, in the order they are removed. The nodes on or behind a
+ *        cycle are never removed, so the order is short of them.
+ */
+template <typename Graph, typename Progress>
+std::vector<typename Graph::size_type> kahn_order(const Graph& g, Progress& progress, thread_pool& pool)
+{
+    using size_type = typename Graph::size_type;
+    constexpr size_type PROGRESS_STEP = size_type{1} << 16;
+
+    std::vector<std::atomic<size_type>> degrees = in_degrees(g, pool);
+    std::vector<size_type> order;
+    order.reserve(g.size());
+    for (size_type i = 0; i < g.num_of_ids(); ++i) {
+        if (g.contains(i) && 0 == degrees[i].load(std::memory_order_relaxed)) {
+            order.push_back(i);
+        }
+    }
+
+    // The order is the queue, nodes before head are removed
+    for (size_type head = 0; head < order.size(); ++head) {
+        for (const auto [toId, toCost] : g.out_edges(order[head])) {
+            std::atomic<size_type>& degree = degrees[toId];
+            const size_type left = degree.load(std::memory_order_relaxed) - 1;
+            degree.store(left, std::memory_order_relaxed);
+            if (0 == left) {
+                order.push_back(toId);
+            }
+        }
+        if (0 == (head + 1) % PROGRESS_STEP) {
+            progress(head + 1, g.size());
+        }
+    }
+    progress(order.size(), g.size());
+
+    return order;
+}
+
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::is_cyclic() const
+{
+    return detail::is_cyclic(*this);
+}
+
+template <typename Cost, typename Id>
+bool basic_csr_graph<Cost, Id>::is_cyclic() const
+{
+    return detail::is_cyclic(*this);
+}
+
+template <typename Cost, typename Id>
+template <typename Progress>
+bool basic_graph<Cost, Id>::is_cyclic(Progress&& progress, size_type numOfThreads) const
+{
+    thread_pool pool{numOfThreads};
+    return detail::kahn_order(*this, progress, pool).size() != size();
+}
+
+template <typename Cost, typename Id>
+template <typename Progress>
+bool basic_csr_graph<Cost, Id>::is_cyclic(Progress&& progress, size_type numOfThreads) const
+{
+    thread_pool pool{numOfThreads};
+    return detail::kahn_order(*this, progress, pool).size() != size();
+}
+
+template <typename Cost, typename Id>
+std::vector<typename basic_graph<Cost, Id>::size_type> basic_graph<Cost, Id>::find_cycle() const
+{
+    return detail::find_cycle(*this);
+}
+
+template <typename Cost, typename Id>
+std::vector<typename basic_csr_graph<Cost, Id>::size_type> basic_csr_graph<Cost, Id>::find_cycle() const
+{
+    return detail::find_cycle(*this);
 }
 
 }
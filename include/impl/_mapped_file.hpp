@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cerrno>
+#include <system_error>
+
+#if GRAPH_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace impl
+{
+
+#if GRAPH_HAS_MMAP
+
+inline mapped_file::mapped_file(const std::string& fileName)
+{
+    const int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (-1 == fd) {
+        throw std::system_error(errno, std::generic_category(), "Can't open " + fileName);
+    }
+
+    struct stat st{};
+    if (-1 == ::fstat(fd, &st)) {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "Can't stat " + fileName);
+    }
+
+    m_size = static_cast<size_type>(st.st_size);
+    if (0 != m_size) {
+        void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (MAP_FAILED == data) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "Can't map " + fileName);
+        }
+        m_data = static_cast<const char*>(data);
+    }
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+}
+
+inline mapped_file::~mapped_file()
+{
+    if (nullptr != m_data) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+#else
+
+inline mapped_file::mapped_file(const std::string& fileName)
+{
+    std::ifstream is{fileName, std::ios::binary | std::ios::ate};
+    if (!is) {
+        throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory), "Can't open " + fileName);
+    }
+    m_size = static_cast<size_type>(is.tellg());
+    m_buffer.resize((m_size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+    is.seekg(0);
+    is.read(reinterpret_cast<char*>(m_buffer.data()), static_cast<std::streamsize>(m_size));
+    m_data = reinterpret_cast<const char*>(m_buffer.data());
+}
+
+inline mapped_file::~mapped_file() = default;
+
+#endif
+
+}
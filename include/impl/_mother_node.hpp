@@ -3,31 +3,87 @@
 namespace impl
 {
 
-const node* graph::mother_node() const
+namespace detail
 {
-    const size_type numOfNodes = size();
 
-    std::vector<bool> visited(numOfNodes, false);
-    auto util = [&visited](auto& node) { visited[node.get_id()] = true; };
+/**
+ * @brief Return true if every node is reachable from start.
+ * @details Breadth first search marking the nodes in a bitset, one bit per
+ *          id instead of a stamp per id, and counting them, so it ends as
+ *          soon as all nodes are reached.
+ */
+template <typename Graph>
+bool reaches_all(const Graph& g, typename Graph::size_type start)
+{
+    using size_type = typename Graph::size_type;
+    using id_type = typename Graph::id_type;
+    using word_type = std::uint64_t;
+    constexpr size_type WORD_BITS = 64;
 
-    size_t motherNode = 0;
-    for (size_t i = 0; i < numOfNodes; ++i) {
-        if (!visited[i]) {
-            std::for_each(this->begin_DFS(i), this->end_DFS(), util);
-            motherNode = i;
+    std::vector<word_type> reached((g.num_of_ids() + WORD_BITS - 1) / WORD_BITS, 0);
+    std::vector<id_type> queue{static_cast<id_type>(start)};
+    reached[start / WORD_BITS] |= word_type{1} << (start % WORD_BITS);
+    for (size_type head = 0; head < queue.size() && queue.size() < g.size(); ++head) {
+        for (const auto [toId, toCost] : g.out_edges(queue[head])) {
+            word_type& word = reached[toId / WORD_BITS];
+            const word_type bit = word_type{1} << (toId % WORD_BITS);
+            if (0 == (word & bit)) {
+                word |= bit;
+                queue.push_back(toId);
+            }
         }
     }
 
-    std::fill(visited.begin(), visited.end(), false);
-    std::for_each(this->begin_DFS(motherNode), this->end_DFS(), util);
+    return queue.size() == g.size();
+}
+
+/**
+ * @brief Return the mother node, or INVALID_ID if there is none.
+ * @details One pass of depth first searches from every node not visited yet
+ *          shares the visited marks, so every node and edge is seen once.
+ *          The last start is the only candidate: the nodes before it do not
+ *          reach it. It is then verified with reaches_all. O(V + E).
+ */
+template <typename Graph>
+typename Graph::size_type mother_node(const Graph& g)
+{
+    using size_type = typename Graph::size_type;
 
-    for (size_t i = 0; i < numOfNodes; ++i) {
-        if (!visited[i]) {
-            return nullptr;
+    const size_type numOfIds = g.num_of_ids();
+    if (0 == g.size()) {
+        return Graph::INVALID_ID;
+    }
+
+    const workspace_pool::workspace_ptr workspace = g.borrow_workspace();
+    default_visitor visitor;
+
+    // Ids of removed nodes are never candidates and never need to be reached
+    size_type motherNode = 0;
+    for (size_type i = 0; i < numOfIds; ++i) {
+        if (g.contains(i) && !workspace->visited(i)) {
+            dfs(g, i, visitor, *workspace);
+            motherNode = i;
         }
     }
 
+    return reaches_all(g, motherNode) ? motherNode : Graph::INVALID_ID;
+}
+}
+
+template <typename Cost, typename Id>
+const typename basic_graph<Cost, Id>::node* basic_graph<Cost, Id>::mother_node() const
+{
+    const size_type motherNode = detail::mother_node(*this);
+    if (INVALID_ID == motherNode) {
+        return nullptr;
+    }
     return get_node(motherNode);
 }
 
+template <typename Cost, typename Id>
+typename basic_csr_graph<Cost, Id>::size_type basic_csr_graph<Cost, Id>::mother_node() const
+{
+    return detail::mother_node(*this);
+}
+
 }
@@ -0,0 +1,154 @@
+#pragma once
+
+namespace impl
+{
+
+inline name_table::name_table(name_table&& other) noexcept
+    : m_slots(std::move(other.m_slots))
+    , m_size(other.m_size)
+    , m_chars(std::move(other.m_chars))
+{
+    other.m_slots.clear();
+    other.m_size = 0;
+}
+
+inline name_table& name_table::operator=(name_table&& other) noexcept
+{
+    if (this != &other) {
+        m_slots = std::move(other.m_slots);
+        m_size = other.m_size;
+        m_chars = std::move(other.m_chars);
+        other.m_slots.clear();
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+inline name_table::size_type name_table::hash_of(std::string_view name) noexcept
+{
+    return std::hash<std::string_view>{}(name);
+}
+
+inline name_table::size_type name_table::find_slot(std::string_view name, size_type hash) const noexcept
+{
+    const size_type mask = m_slots.size() - 1;
+    for (size_type i = hash & mask; ; i = (i + 1) & mask) {
+        const entry& e = m_slots[i];
+        if (INVALID_ID == e.id || (hash == e.hash && name == e.name)) {
+            return i;
+        }
+    }
+}
+
+inline name_table::size_type name_table::find(std::string_view name) const noexcept
+{
+    if (m_slots.empty()) {
+        return INVALID_ID;
+    }
+    return m_slots[find_slot(name, hash_of(name))].id;
+}
+
+inline std::pair<const name_table::entry*, bool> name_table::emplace(std::string_view name, size_type id)
+{
+    assert(INVALID_ID != id);
+    if ((m_size + 1) * 2 > m_slots.size()) {
+        rehash(std::max<size_type>(16, m_slots.size() * 2));
+    }
+
+    const size_type hash = hash_of(name);
+    entry& e = m_slots[find_slot(name, hash)];
+    if (INVALID_ID != e.id) {
+        return {&e, false};
+    }
+    e = entry{store(name), hash, id};
+    ++m_size;
+    return {&e, true};
+}
+
+inline bool name_table::assign(std::string_view name, size_type id) noexcept
+{
+    if (m_slots.empty()) {
+        return false;
+    }
+    entry& e = m_slots[find_slot(name, hash_of(name))];
+    if (INVALID_ID == e.id) {
+        return false;
+    }
+    e.id = id;
+    return true;
+}
+
+inline bool name_table::erase(std::string_view name) noexcept
+{
+    if (m_slots.empty()) {
+        return false;
+    }
+    const size_type mask = m_slots.size() - 1;
+    size_type hole = find_slot(name, hash_of(name));
+    if (INVALID_ID == m_slots[hole].id) {
+        return false;
+    }
+
+    // Backward shift: move the following entries of the cluster into the hole,
+    // unless their home slot lies cyclically in (hole, current].
+    for (size_type i = (hole + 1) & mask; INVALID_ID != m_slots[i].id; i = (i + 1) & mask) {
+        const size_type home = m_slots[i].hash & mask;
+        const bool stays = (hole < i) ? (hole < home && home <= i)
+                                      : (hole < home || home <= i);
+        if (!stays) {
+            m_slots[hole] = m_slots[i];
+            hole = i;
+        }
+    }
+    m_slots[hole] = entry{{}, 0, INVALID_ID};
+    --m_size;
+    return true;
+}
+
+inline void name_table::reserve(size_type count)
+{
+    size_type capacity = 16;
+    while (capacity < count * 2) {
+        capacity *= 2;
+    }
+    if (capacity > m_slots.size()) {
+        rehash(capacity);
+    }
+}
+
+inline void name_table::clear() noexcept
+{
+    std::vector<entry>().swap(m_slots);
+    m_size = 0;
+    m_chars.clear();
+}
+
+inline std::string_view name_table::store(std::string_view name)
+{
+    if (name.empty()) {
+        return {};
+    }
+    char* data = m_chars.create_n(name.size());
+    std::copy(name.begin(), name.end(), data);
+    return {data, name.size()};
+}
+
+inline void name_table::rehash(size_type capacity)
+{
+    std::vector<entry> old(capacity, entry{{}, 0, INVALID_ID});
+    old.swap(m_slots);
+
+    const size_type mask = capacity - 1;
+    for (const entry& e : old) {
+        if (INVALID_ID == e.id) {
+            continue;
+        }
+        size_type i = e.hash & mask;
+        while (INVALID_ID != m_slots[i].id) {
+            i = (i + 1) & mask;
+        }
+        m_slots[i] = e;
+    }
+}
+
+}
@@ -3,17 +3,21 @@
 namespace impl
 {
 
-node::node_iterator::node_iterator(std::vector<edge*>::iterator iter)
+template <typename Cost, typename Id>
+basic_node<Cost, Id>::node_iterator::node_iterator(typename std::vector<edge*>::iterator iter, bool incoming)
     : m_iter(iter)
+    , m_incoming(incoming)
 { }
 
-node::node_iterator& node::node_iterator::operator++()
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::node_iterator& basic_node<Cost, Id>::node_iterator::operator++()
 {
     ++m_iter;
     return *this;
 }
 
-node::node_iterator node::node_iterator::operator++(int)
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::node_iterator basic_node<Cost, Id>::node_iterator::operator++(int)
 {
     node_iterator temp{*this};
     ++m_iter;
@@ -22,35 +26,42 @@ node::node_iterator node::node_iterator::operator++(int)
 
 //! NOTE: if iter_types are the same, and if nodes they point to
 //        are the same, they are equal
-bool node::node_iterator::operator==(const node_iterator& other) const
+template <typename Cost, typename Id>
+bool basic_node<Cost, Id>::node_iterator::operator==(const node_iterator& other) const
 {
     return m_iter == other.m_iter;
 }
 
-bool node::node_iterator::operator!=(const node_iterator& other) const
+template <typename Cost, typename Id>
+bool basic_node<Cost, Id>::node_iterator::operator!=(const node_iterator& other) const
 {
     return m_iter != other.m_iter;
 }
 
-node::node_iterator::pointer node::node_iterator::operator*() const
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::node_iterator::pointer basic_node<Cost, Id>::node_iterator::operator*() const
 {
-    return (*m_iter)->get_to();
+    return m_incoming ? (*m_iter)->get_from() : (*m_iter)->get_to();
 }
 
 ///////////////////////////////
 
 
-node::const_node_iterator::const_node_iterator(std::vector<edge*>::const_iterator iter)
+template <typename Cost, typename Id>
+basic_node<Cost, Id>::const_node_iterator::const_node_iterator(typename std::vector<edge*>::const_iterator iter, bool incoming)
     : m_iter(iter)
+    , m_incoming(incoming)
 { }
 
-node::const_node_iterator& node::const_node_iterator::operator++()
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::const_node_iterator& basic_node<Cost, Id>::const_node_iterator::operator++()
 {
     ++m_iter;
     return *this;
 }
 
-node::const_node_iterator node::const_node_iterator::operator++(int)
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::const_node_iterator basic_node<Cost, Id>::const_node_iterator::operator++(int)
 {
     const_node_iterator temp{*this};
     ++m_iter;
@@ -59,19 +70,66 @@ node::const_node_iterator node::const_node_iterator::operator++(int)
 
 //! NOTE: if iter_types are the same, and if nodes they point to
 //        are the same, they are equal
-bool node::const_node_iterator::operator==(const const_node_iterator& other) const
+template <typename Cost, typename Id>
+bool basic_node<Cost, Id>::const_node_iterator::operator==(const const_node_iterator& other) const
 {
     return m_iter == other.m_iter;
 }
 
-bool node::const_node_iterator::operator!=(const const_node_iterator& other) const
+template <typename Cost, typename Id>
+bool basic_node<Cost, Id>::const_node_iterator::operator!=(const const_node_iterator& other) const
 {
     return m_iter != other.m_iter;
 }
 
-node::const_node_iterator::const_pointer node::const_node_iterator::operator*() const
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::const_node_iterator::const_pointer basic_node<Cost, Id>::const_node_iterator::operator*() const
 {
-    return (*m_iter)->get_to();
+    const edge* e = *m_iter;
+    return m_incoming ? e->get_from() : e->get_to();
+}
+
+///////////////////////////////
+
+
+template <typename Cost, typename Id>
+basic_node<Cost, Id>::const_arc_iterator::const_arc_iterator(typename std::vector<edge*>::const_iterator iter, bool incoming)
+    : m_iter(iter)
+    , m_incoming(incoming)
+{ }
+
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::const_arc_iterator& basic_node<Cost, Id>::const_arc_iterator::operator++()
+{
+    ++m_iter;
+    return *this;
+}
+
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::const_arc_iterator basic_node<Cost, Id>::const_arc_iterator::operator++(int)
+{
+    const_arc_iterator temp{*this};
+    ++m_iter;
+    return temp;
+}
+
+template <typename Cost, typename Id>
+bool basic_node<Cost, Id>::const_arc_iterator::operator==(const const_arc_iterator& other) const
+{
+    return m_iter == other.m_iter;
+}
+
+template <typename Cost, typename Id>
+bool basic_node<Cost, Id>::const_arc_iterator::operator!=(const const_arc_iterator& other) const
+{
+    return m_iter != other.m_iter;
+}
+
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::const_arc_iterator::value_type basic_node<Cost, Id>::const_arc_iterator::operator*() const
+{
+    const edge* e = *m_iter;
+    return arc{m_incoming ? e->get_from_idx() : e->get_to_idx(), e->get_cost()};
 }
 
 }
@@ -3,32 +3,288 @@
 namespace impl
 {
 
-graph::size_type graph::num_of_paths(const node* from, const node* to) const
+namespace detail
 {
-    if (nullptr == from || nullptr == to) {
-        return 0;
+
+/**
+ * @brief sum += value unless the sum does not fit an integer Count.
+ * @return false if the sum does not fit, sum is left unchanged then.
+ */
+template <typename Count>
+[[nodiscard]] inline bool try_add_count(Count& sum, const Count& value)
+{
+    if constexpr (std::is_integral_v<Count>) {
+        if (value > std::numeric_limits<Count>::max() - sum) {
+            return false;
+        }
+    }
+    sum += value;
+    return true;
+}
+
+/**
+ * @brief sum += value, throwing instead of wrapping around for integer counts.
+ * @throw std::overflow_error if the sum does not fit an integer Count.
+ */
+template <typename Count>
+inline void add_count(Count& sum, const Count& value)
+{
+    if (!try_add_count(sum, value)) {
+        throw std::overflow_error("Number of paths does not fit the count type");
+    }
+}
+
+/**
+ * @brief Depth first search visitor counting the paths to target in post-order.
+ * @details A node is finished after all of its successors, so the number of
+ *          paths from it is the sum over its finished successors, the
+ *          target counts 1 and is not expanded. Successors that are not
+ *          finished are ancestors (back edges), their cycle goes on forever
+ *          if the ancestor turns out to reach the target.
+ */
+template <typename Graph, typename Count>
+struct path_counter : default_visitor
+{
+    path_counter(const Graph& g, size_type target, const traversal_workspace& workspace)
+        : g(g)
+        , target(target)
+        , workspace(workspace)
+        , counts(g.num_of_ids(), Count{0})
+        , onCycle(g.num_of_ids(), false)
+    { }
+
+    inline visit_result discover(size_type id, size_type)
+    {
+        if (id == target) {
+            counts[id] = Count{1};
+            return visit_result::SKIP;
+        }
+        return visit_result::PROCEED;
+    }
+
+    template <typename Cost>
+    inline visit_result back_edge(size_type, size_type toId, Cost)
+    {
+        onCycle[toId] = true;
+        return visit_result::PROCEED;
+    }
+
+    inline visit_result finish(size_type id)
+    {
+        Count& count = counts[id];
+        for (const auto [toId, toCost] : g.out_edges(id)) {
+            if (workspace.finished(toId)) {
+                add_count(count, counts[toId]);
+            }
+        }
+        if (onCycle[id] && Count{0} != count) {
+            throw cycle_error("Infinite number of paths, node " + std::to_string(id)
+                              + " is on a cycle that reaches the target", id);
+        }
+        return visit_result::PROCEED;
+    }
+
+    const Graph& g;
+    size_type target;
+    const traversal_workspace& workspace;
+    std::vector<Count> counts;
+    std::vector<bool> onCycle;
+};
+
+/**
+ * @brief Count the paths from one node to another in O(V + E).
+ * @details Dynamic programming over the nodes reachable from the source, in
+ *          the topological order given by a depth first search.
+ */
+template <typename Count, typename Graph>
+Count num_of_paths(const Graph& g, typename Graph::size_type from, typename Graph::size_type to)
+{
+    const workspace_pool::workspace_ptr workspace = g.borrow_workspace();
+    path_counter<Graph, Count> visitor(g, to, *workspace);
+    (void)dfs(g, from, visitor, *workspace);
+    return visitor.counts[from];
+}
+
+/**
+ * @brief Depth first search visitor recording the reachable nodes in
+ *        post-order and the targets of back edges.
+ */
+struct post_order_recorder : default_visitor
+{
+    explicit post_order_recorder(size_type size)
+        : onCycle(size, false)
+    { }
+
+    template <typename Cost>
+    inline visit_result back_edge(size_type, size_type toId, Cost)
+    {
+        onCycle[toId] = true;
+        return visit_result::PROCEED;
     }
 
-    size_type numOfPaths = 0;
+    inline visit_result finish(size_type id)
+    {
+        order.push_back(id);
+        return visit_result::PROCEED;
+    }
 
-    std::queue<const node*> queue;
-    queue.push(from);
+    std::vector<size_type> order;
+    std::vector<bool> onCycle;
+};
 
-    while (!queue.empty()) {
-        const node* current = queue.front();
-        queue.pop();
+/**
+ * @brief Number of paths from one node to every node, in one sweep.
+ * @details Nodes reachable from the source are swept in topological order
+ *          (reverse post-order of a depth first search), every node adds its
+ *          count to its successors. A node reachable from a cycle has an
+ *          infinite count, it remembers a node of the cycle instead. Sums
+ *          that do not fit an integer Count are flagged, so that only the
+ *          counts asked for throw.
+ */
+template <typename Count, typename Graph>
+class path_count_table
+{
+public:
+    using size_type = typename Graph::size_type;
 
-        if (current == to) {
-            ++numOfPaths;
-            continue;
+public:
+    path_count_table(const Graph& g, size_type from)
+        : m_counts(g.num_of_ids(), Count{0})
+        , m_cycleNodes(g.num_of_ids(), Graph::INVALID_ID)
+        , m_overflow(g.num_of_ids(), false)
+    {
+        post_order_recorder visitor(g.num_of_ids());
+        (void)dfs(g, from, visitor, *g.borrow_workspace());
+
+        m_counts[from] = Count{1};
+        for (auto it = visitor.order.rbegin(); it != visitor.order.rend(); ++it) {
+            const size_type id = *it;
+            if (visitor.onCycle[id] && Graph::INVALID_ID == m_cycleNodes[id]) {
+                m_cycleNodes[id] = id;
+            }
+            for (const auto [toId, toCost] : g.out_edges(id)) {
+                if (Graph::INVALID_ID != m_cycleNodes[id]) {
+                    if (Graph::INVALID_ID == m_cycleNodes[toId]) {
+                        m_cycleNodes[toId] = m_cycleNodes[id];
+                    }
+                } else if (m_overflow[id] || !try_add_count(m_counts[toId], m_counts[id])) {
+                    m_overflow[toId] = true;
+                }
+            }
         }
+    }
+
+    /**
+     * @throw cycle_error if a cycle lies on a path to the node.
+     * @throw std::overflow_error if the count does not fit an integer Count.
+     */
+    [[nodiscard]] Count count(size_type id) const
+    {
+        if (Graph::INVALID_ID != m_cycleNodes[id]) {
+            throw cycle_error("Infinite number of paths, node " + std::to_string(m_cycleNodes[id])
+                              + " is on a cycle that reaches node " + std::to_string(id), m_cycleNodes[id]);
+        }
+        if (m_overflow[id]) {
+            throw std::overflow_error("Number of paths does not fit the count type");
+        }
+        return m_counts[id];
+    }
 
-        for (auto nodeIter = current->cbegin_nodes(); nodeIter != current->cend_nodes(); ++nodeIter) {
-            queue.push(*nodeIter);
+    /**
+     * @brief Return the counts of all the nodes, checked as count(id).
+     */
+    [[nodiscard]] std::vector<Count> release()
+    {
+        for (size_type id = 0; id < m_counts.size(); ++id) {
+            (void)count(id);
         }
+        return std::move(m_counts);
     }
 
-    return numOfPaths;
+private:
+    std::vector<Count> m_counts;
+    std::vector<size_type> m_cycleNodes;
+    std::vector<bool> m_overflow;
+
+};
+
+template <typename Count, typename Graph, typename ForwardIt>
+std::vector<Count> num_of_paths(const Graph& g, typename Graph::size_type from, ForwardIt first, ForwardIt last)
+{
+    std::vector<Count> result;
+    result.reserve(static_cast<std::size_t>(std::distance(first, last)));
+    if (!g.contains(from)) {
+        result.resize(result.capacity(), Count{0});
+        return result;
+    }
+
+    const path_count_table<Count, Graph> table(g, from);
+    for (; first != last; ++first) {
+        const auto to = *first;
+        result.push_back(g.contains(to) ? table.count(to) : Count{0});
+    }
+    return result;
+}
+
+template <typename Count, typename Graph>
+std::vector<Count> num_of_paths_from(const Graph& g, typename Graph::size_type from)
+{
+    if (!g.contains(from)) {
+        return std::vector<Count>(g.num_of_ids(), Count{0});
+    }
+    return path_count_table<Count, Graph>(g, from).release();
+}
+
+}
+
+template <typename Cost, typename Id>
+template <typename Count>
+Count basic_graph<Cost, Id>::num_of_paths(const node* from, const node* to) const
+{
+    if (nullptr == from || nullptr == to) {
+        return Count{0};
+    }
+
+    return detail::num_of_paths<Count>(*this, from->get_id(), to->get_id());
+}
+
+template <typename Cost, typename Id>
+template <typename Count>
+Count basic_csr_graph<Cost, Id>::num_of_paths(size_type from, size_type to) const
+{
+    if (!contains(from) || !contains(to)) {
+        return Count{0};
+    }
+
+    return detail::num_of_paths<Count>(*this, from, to);
+}
+
+template <typename Cost, typename Id>
+template <typename Count, typename ForwardIt>
+std::vector<Count> basic_graph<Cost, Id>::num_of_paths(size_type from, ForwardIt first, ForwardIt last) const
+{
+    return detail::num_of_paths<Count>(*this, from, first, last);
+}
+
+template <typename Cost, typename Id>
+template <typename Count>
+std::vector<Count> basic_graph<Cost, Id>::num_of_paths_from(size_type from) const
+{
+    return detail::num_of_paths_from<Count>(*this, from);
+}
+
+template <typename Cost, typename Id>
+template <typename Count, typename ForwardIt>
+std::vector<Count> basic_csr_graph<Cost, Id>::num_of_paths(size_type from, ForwardIt first, ForwardIt last) const
+{
+    return detail::num_of_paths<Count>(*this, from, first, last);
+}
+
+template <typename Cost, typename Id>
+template <typename Count>
+std::vector<Count> basic_csr_graph<Cost, Id>::num_of_paths_from(size_type from) const
+{
+    return detail::num_of_paths_from<Count>(*this, from);
 }
 
 }
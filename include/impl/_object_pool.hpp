@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+
+namespace impl
+{
+
+template <typename T>
+object_pool<T>::object_pool(object_pool&& other) noexcept
+    : m_chunks(std::move(other.m_chunks))
+    , m_size(other.m_size)
+    , m_capacity(other.m_capacity)
+{
+    other.m_chunks.clear();
+    other.m_size = 0;
+    other.m_capacity = 0;
+}
+
+template <typename T>
+object_pool<T>& object_pool<T>::operator=(object_pool&& other) noexcept
+{
+    if (this != &other) {
+        clear();
+        m_chunks = std::move(other.m_chunks);
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+        other.m_chunks.clear();
+        other.m_size = 0;
+        other.m_capacity = 0;
+    }
+    return *this;
+}
+
+template <typename T>
+object_pool<T>::~object_pool()
+{
+    clear();
+}
+
+template <typename T>
+template <typename... Args>
+T* object_pool<T>::create(Args&&... args)
+{
+    if (m_chunks.empty() || m_chunks.back().size == m_chunks.back().capacity) {
+        // Grow geometrically, so that small graphs stay small
+        add_chunk(next_chunk_size());
+    }
+    chunk& c = m_chunks.back();
+    T* object = ::new (static_cast<void*>(c.data + c.size)) T(std::forward<Args>(args)...);
+    ++c.size;
+    ++m_size;
+    return object;
+}
+
+template <typename T>
+T* object_pool<T>::create_n(size_type count)
+{
+    reserve(count);
+    chunk& c = m_chunks.back();
+    T* first = c.data + c.size;
+    std::uninitialized_value_construct_n(first, count);
+    c.size += count;
+    m_size += count;
+    return first;
+}
+
+template <typename T>
+void object_pool<T>::reserve(size_type count)
+{
+    if (!m_chunks.empty() && m_chunks.back().capacity - m_chunks.back().size >= count) {
+        return;
+    }
+    add_chunk(std::max(count, next_chunk_size()));
+}
+
+template <typename T>
+void object_pool<T>::splice(object_pool& other)
+{
+    if (this == &other) {
+        return;
+    }
+    // Keep the chunk with free space at the back, so that it is used first
+    m_chunks.insert(m_chunks.end() - (m_chunks.empty() ? 0 : 1), other.m_chunks.begin(), other.m_chunks.end());
+    m_size += other.m_size;
+    m_capacity += other.m_capacity;
+    other.m_chunks.clear();
+    other.m_size = 0;
+    other.m_capacity = 0;
+}
+
+template <typename T>
+void object_pool<T>::clear() noexcept
+{
+    std::allocator<T> allocator;
+    for (chunk& c : m_chunks) {
+        std::destroy(c.data, c.data + c.size);
+        allocator.deallocate(c.data, c.capacity);
+    }
+    m_chunks.clear();
+    m_size = 0;
+    m_capacity = 0;
+}
+
+template <typename T>
+typename object_pool<T>::size_type object_pool<T>::next_chunk_size() const noexcept
+{
+    return std::clamp(m_capacity, MIN_CHUNK_SIZE, MAX_CHUNK_SIZE);
+}
+
+template <typename T>
+void object_pool<T>::add_chunk(size_type capacity)
+{
+    // The storage is owned until the chunk list took it, a failed push_back does not leak it
+    auto deallocate = [capacity](T* data) { std::allocator<T>().deallocate(data, capacity); };
+    std::unique_ptr<T, decltype(deallocate)> data(std::allocator<T>().allocate(capacity), deallocate);
+    m_chunks.push_back(chunk{data.get(), 0, capacity});
+    data.release();
+    m_capacity += capacity;
+}
+
+}
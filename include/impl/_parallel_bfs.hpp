@@ -0,0 +1,233 @@
+#pragma once
+
+#include <atomic>
+
+namespace impl
+{
+
+namespace detail
+{
+
+/**
+ * @brief Fixed size bitmap whose bits can be set by several threads at once.
+ */
+class atomic_bitmap
+{
+public:
+    using size_type = std::size_t;
+    using word_type = std::uint64_t;
+
+    constexpr static size_type WORD_BITS = 64;
+
+public:
+    explicit atomic_bitmap(size_type size)
+        : m_words((size + WORD_BITS - 1) / WORD_BITS)
+    {
+        clear();
+    }
+
+    [[nodiscard]] inline size_type num_of_words() const noexcept { return m_words.size(); }
+
+    [[nodiscard]] inline bool test(size_type i) const noexcept
+    {
+        return 0 != (m_words[i / WORD_BITS].load(std::memory_order_relaxed) & mask(i));
+    }
+
+    /**
+     * @return true if the bit was not set before, false otherwise.
+     */
+    inline bool set(size_type i) noexcept
+    {
+        return 0 == (m_words[i / WORD_BITS].fetch_or(mask(i), std::memory_order_relaxed) & mask(i));
+    }
+
+    inline word_type word(size_type w) const noexcept { return m_words[w].load(std::memory_order_relaxed); }
+    inline void or_word(size_type w, word_type bits) noexcept { m_words[w].fetch_or(bits, std::memory_order_relaxed); }
+
+    void clear() noexcept
+    {
+        for (std::atomic<word_type>& w : m_words) {
+            w.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void swap(atomic_bitmap& other) noexcept { m_words.swap(other.m_words); }
+
+private:
+    [[nodiscard]] inline static word_type mask(size_type i) noexcept { return word_type{1} << (i % WORD_BITS); }
+
+private:
+    std::vector<std::atomic<word_type>> m_words;
+
+};
+
+/**
+ * @brief Direction-optimizing parallel breadth first search (Beamer et al.).
+ * @details The frontier is a list of ids while the search runs top-down and a
+ *          bitmap while it runs bottom-up. Top-down steps claim nodes in the
+ *          visited bitmap with an atomic or, bottom-up steps give every
+ *          unvisited node to one thread, so levels and parents are written
+ *          by a single thread each. Both directions sum the out-degrees of
+ *          the nodes they add to the frontier and take them off the edges left
+ *          to check. The search turns bottom-up when the edges of the frontier
+ *          exceed 1 / ALPHA of the edges left to check, and back top-down
+ *          when the frontier stops growing and has less than 1 / BETA of the
+ *          nodes.
+ */
+template <typename Graph>
+bfs_result<typename Graph::id_type> parallel_bfs(const Graph& g, typename Graph::size_type start,
+                                                  bool bottomUp, thread_pool& pool)
+{
+    using size_type = typename Graph::size_type;
+    using id_type = typename Graph::id_type;
+    using frontier = std::vector<id_type>;
+    constexpr id_type INVALID_ID = bfs_result<id_type>::INVALID_ID;
+    constexpr size_type ALPHA = 15;
+    constexpr size_type BETA = 18;
+
+    const size_type size = g.num_of_ids();
+    bfs_result<id_type> result;
+    result.levels.assign(size, INVALID_ID);
+    result.parents.assign(size, INVALID_ID);
+    if (!g.contains(start)) {
+        return result;
+    }
+
+    atomic_bitmap visited(size);
+    std::vector<frontier> locals(pool.size());
+    std::vector<size_type> scouts(pool.size());
+    auto take_scout = [&]() {
+        size_type scout = 0;
+        for (size_type& count : scouts) {
+            scout += count;
+            count = 0;
+        }
+        return scout;
+    };
+    auto gather = [&](frontier& queue) {
+        queue.clear();
+        for (frontier& local : locals) {
+            queue.insert(queue.end(), local.begin(), local.end());
+            local.clear();
+        }
+        return take_scout();
+    };
+
+    // Claim the unvisited targets of the frontier nodes
+    auto top_down_step = [&](const frontier& queue, id_type level) {
+        pool.parallel_for(queue.size(), [&](size_type first, size_type last, size_type worker) {
+            frontier& local = locals[worker];
+            size_type scout = 0;
+            for (size_type i = first; i < last; ++i) {
+                const id_type id = queue[i];
+                for (const auto [toId, toCost] : g.out_edges(id)) {
+                    if (!visited.test(toId) && visited.set(toId)) {
+                        result.parents[toId] = id;
+                        result.levels[toId] = level;
+                        local.push_back(toId);
+                        scout += g.degree(toId);
+                    }
+                }
+            }
+            scouts[worker] += scout;
+        });
+    };
+
+    // Every unvisited node looks for a parent in the frontier
+    auto bottom_up_step = [&](const atomic_bitmap& current, atomic_bitmap& next, id_type level) {
+        std::vector<size_type> awake(pool.size(), 0);
+        pool.parallel_for(current.num_of_words(), [&](size_type first, size_type last, size_type worker) {
+            size_type scout = 0;
+            for (size_type w = first; w < last; ++w) {
+                std::uint64_t found = 0;
+                const std::uint64_t seen = visited.word(w);
+                for (size_type bit = 0; bit < atomic_bitmap::WORD_BITS; ++bit) {
+                    const size_type id = w * atomic_bitmap::WORD_BITS + bit;
+                    if (id >= size) {
+                        break;
+                    }
+                    if (0 != (seen & (std::uint64_t{1} << bit))) {
+                        continue;
+                    }
+                    for (const auto [fromId, fromCost] : g.in_edges(id)) {
+                        if (current.test(fromId)) {
+                            result.parents[id] = fromId;
+                            result.levels[id] = level;
+                            found |= std::uint64_t{1} << bit;
+                            ++awake[worker];
+                            scout += g.degree(id);
+                            break;
+                        }
+                    }
+                }
+                if (0 != found) {
+                    next.or_word(w, found);
+                    visited.or_word(w, found);
+                }
+            }
+            scouts[worker] += scout;
+        }, 64);
+        size_type total = 0;
+        for (const size_type count : awake) {
+            total += count;
+        }
+        return total;
+    };
+
+    visited.set(start);
+    result.levels[start] = 0;
+    frontier queue{static_cast<id_type>(start)};
+    size_type scout = g.degree(start);
+    size_type edgesToCheck = g.num_of_edges();
+    id_type level = 0;
+
+    while (!queue.empty()) {
+        if (bottomUp && scout > edgesToCheck / ALPHA) {
+            atomic_bitmap current(size);
+            atomic_bitmap next(size);
+            for (const id_type id : queue) {
+                current.set(id);
+            }
+            size_type awake = queue.size();
+            size_type oldAwake = 0;
+            do {
+                edgesToCheck -= std::min(edgesToCheck, scout);
+                oldAwake = awake;
+                awake = bottom_up_step(current, next, ++level);
+                scout = take_scout();
+                current.swap(next);
+                next.clear();
+            } while (awake > 0 && (awake >= oldAwake || awake > size / BETA));
+
+            // Back to a list of the frontier nodes
+            pool.parallel_for(current.num_of_words(), [&](size_type first, size_type last, size_type worker) {
+                for (size_type w = first; w < last; ++w) {
+                    const std::uint64_t bits = current.word(w);
+                    for (size_type bit = 0; 0 != bits && bit < atomic_bitmap::WORD_BITS; ++bit) {
+                        if (0 != (bits & (std::uint64_t{1} << bit))) {
+                            locals[worker].push_back(static_cast<id_type>(w * atomic_bitmap::WORD_BITS + bit));
+                        }
+                    }
+                }
+            }, 64);
+            gather(queue);
+        } else {
+            edgesToCheck -= std::min(edgesToCheck, scout);
+            top_down_step(queue, ++level);
+            scout = gather(queue);
+        }
+    }
+
+    return result;
+}
+
+}
+
+template <typename Cost, typename Id>
+bfs_result<Id> basic_graph<Cost, Id>::parallel_bfs(size_type start, size_type numOfThreads) const
+{
+    thread_pool pool{numOfThreads};
+    return detail::parallel_bfs(*this, start, m_incomingIndex, pool);
+}
+
+}
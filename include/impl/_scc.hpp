@@ -0,0 +1,388 @@
+#pragma once
+
+#include <atomic>
+
+namespace impl
+{
+
+namespace detail
+{
+
+/**
+ * @brief Tarjan's algorithm, iterative.
+ * @details The path from the root is a stack of (node, next edge) frames.
+ *          Every node gets a discovery index and the lowest index it reaches
+ *          over nodes still on the component stack, a node whose low index
+ *          is its own closes a component. Components close sinks first, so
+ *          they are numbered backwards to be in topological order.
+ */
+template <typename Graph>
+scc_result<typename Graph::id_type> tarjan(const Graph& g)
+{
+    using size_type = typename Graph::size_type;
+    using id_type = typename Graph::id_type;
+    using arc_iterator = decltype(g.out_edges(0).begin());
+    constexpr id_type INVALID_ID = scc_result<id_type>::INVALID_ID;
+
+    struct frame
+    {
+        size_type id;
+        arc_iterator next;
+        arc_iterator last;
+    };
+
+    const size_type size = g.num_of_ids();
+    scc_result<id_type> result;
+    result.components.assign(size, INVALID_ID);
+    std::vector<id_type> index(size, INVALID_ID);
+    std::vector<id_type> low(size, INVALID_ID);
+    std::vector<id_type> stack;
+    std::vector<frame> path;
+    id_type counter = 0;
+
+    auto discover = [&](size_type id) {
+        index[id] = low[id] = counter++;
+        stack.push_back(static_cast<id_type>(id));
+        const auto edges = g.out_edges(id);
+        path.push_back(frame{id, edges.begin(), edges.end()});
+    };
+
+    for (size_type root = 0; root < size; ++root) {
+        if (!g.contains(root) || INVALID_ID != index[root]) {
+            continue;
+        }
+        discover(root);
+        while (!path.empty()) {
+            frame& top = path.back();
+            if (top.next != top.last) {
+                const size_type id = top.id;
+                const size_type toId = (*top.next).to;
+                ++top.next;
+                if (INVALID_ID == index[toId]) {
+                    discover(toId);
+                } else if (INVALID_ID == result.components[toId]) {
+                    // Visited without a component: still on the stack
+                    low[id] = std::min(low[id], index[toId]);
+                }
+                continue;
+            }
+
+            const size_type id = top.id;
+            path.pop_back();
+            if (!path.empty()) {
+                low[path.back().id] = std::min(low[path.back().id], low[id]);
+            }
+            if (low[id] == index[id]) {
+                const auto component = static_cast<id_type>(result.sizes.size());
+                id_type count = 0;
+                id_type member = INVALID_ID;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    result.components[member] = component;
+                    ++count;
+                } while (member != id);
+                result.sizes.push_back(count);
+            }
+        }
+    }
+
+    const auto last = static_cast<id_type>(result.sizes.size() - 1);
+    for (id_type& component : result.components) {
+        if (INVALID_ID != component) {
+            component = last - component;
+        }
+    }
+    std::reverse(result.sizes.begin(), result.sizes.end());
+    return result;
+}
+
+/**
+ * @brief Parallel strongly connected components: trim, forward-backward and coloring.
+ * @details The incoming edges are built as CSR arrays first. Each round
+ *          trims the remaining nodes without incoming or outgoing edges
+ *          among the remaining nodes, they are components on their own.
+ *          The first round then takes the component of a pivot of high
+ *          degree, usually the giant one, as the nodes both reachable from
+ *          it and reaching it, with two parallel breadth first searches.
+ *          The later rounds color every node with the largest id that
+ *          reaches it. A node keeping its own color is a root, its color
+ *          class holds its component, the nodes that reach it backward
+ *          within the class, each root is searched by one thread.
+ */
+template <typename Graph>
+scc_result<typename Graph::id_type> parallel_scc(const Graph& g, thread_pool& pool)
+{
+    using size_type = typename Graph::size_type;
+    using id_type = typename Graph::id_type;
+    using frontier = std::vector<id_type>;
+    constexpr id_type INVALID_ID = scc_result<id_type>::INVALID_ID;
+
+    const size_type size = g.num_of_ids();
+
+    // Incoming edges, the in-degree counters become the insert positions
+    std::vector<std::atomic<size_type>> cursors = in_degrees(g, pool);
+    std::vector<size_type> offsets(size + 1, 0);
+    for (size_type i = 0; i < size; ++i) {
+        offsets[i + 1] = offsets[i] + cursors[i].load(std::memory_order_relaxed);
+        cursors[i].store(offsets[i], std::memory_order_relaxed);
+    }
+    std::vector<id_type> sources(offsets[size]);
+    pool.parallel_for(size, [&](size_type first, size_type last, size_type) {
+        for (size_type i = first; i < last; ++i) {
+            if (!g.contains(i)) {
+                continue;
+            }
+            for (const auto [toId, toCost] : g.out_edges(i)) {
+                sources[cursors[toId].fetch_add(1, std::memory_order_relaxed)] = static_cast<id_type>(i);
+            }
+        }
+    });
+
+    auto for_each_out = [&](size_type id, auto&& f) {
+        for (const auto [toId, toCost] : g.out_edges(id)) {
+            f(static_cast<size_type>(toId));
+        }
+    };
+    auto for_each_in = [&](size_type id, auto&& f) {
+        for (size_type i = offsets[id]; i < offsets[id + 1]; ++i) {
+            f(static_cast<size_type>(sources[i]));
+        }
+    };
+
+    std::vector<std::atomic<id_type>> components(size);
+    std::atomic<id_type> numOfComponents{0};
+    frontier remaining;
+    for (size_type i = 0; i < size; ++i) {
+        components[i].store(INVALID_ID, std::memory_order_relaxed);
+        if (g.contains(i)) {
+            remaining.push_back(static_cast<id_type>(i));
+        }
+    }
+    auto alive = [&](size_type id) { return INVALID_ID == components[id].load(std::memory_order_relaxed); };
+    auto new_component = [&]() { return numOfComponents.fetch_add(1, std::memory_order_relaxed); };
+    auto compact = [&]() {
+        remaining.erase(std::remove_if(remaining.begin(), remaining.end(), [&](id_type id) { return !alive(id); }),
+                        remaining.end());
+    };
+
+    // A node trimmed at the same time as its neighbor is alone in its
+    // component, so seeing the neighbor either way is right
+    auto trim = [&]() {
+        pool.parallel_for(remaining.size(), [&](size_type first, size_type last, size_type) {
+            for (size_type i = first; i < last; ++i) {
+                const size_type id = remaining[i];
+                bool in = false;
+                bool out = false;
+                for_each_in(id, [&](size_type from) { in = in || (from != id && alive(from)); });
+                for_each_out(id, [&](size_type to) { out = out || (to != id && alive(to)); });
+                if (!in || !out) {
+                    components[id].store(new_component(), std::memory_order_relaxed);
+                }
+            }
+        });
+        compact();
+    };
+
+    std::vector<frontier> locals(pool.size());
+    auto reach = [&](size_type pivot, auto&& expand, atomic_bitmap& seen) {
+        seen.set(pivot);
+        frontier queue{static_cast<id_type>(pivot)};
+        while (!queue.empty()) {
+            pool.parallel_for(queue.size(), [&](size_type first, size_type last, size_type worker) {
+                for (size_type i = first; i < last; ++i) {
+                    expand(queue[i], [&](size_type to) {
+                        if (alive(to) && !seen.test(to) && seen.set(to)) {
+                            locals[worker].push_back(static_cast<id_type>(to));
+                        }
+                    });
+                }
+            });
+            queue.clear();
+            for (frontier& local : locals) {
+                queue.insert(queue.end(), local.begin(), local.end());
+                local.clear();
+            }
+        }
+    };
+
+    trim();
+    if (!remaining.empty()) {
+        size_type pivot = remaining.front();
+        size_type best = 0;
+        for (const id_type id : remaining) {
+            const size_type degree = (offsets[id + 1] - offsets[id]) * g.degree(id);
+            if (degree > best) {
+                best = degree;
+                pivot = id;
+            }
+        }
+        atomic_bitmap forward(size);
+        atomic_bitmap backward(size);
+        reach(pivot, for_each_out, forward);
+        reach(pivot, for_each_in, backward);
+        const id_type component = new_component();
+        pool.parallel_for(remaining.size(), [&](size_type first, size_type last, size_type) {
+            for (size_type i = first; i < last; ++i) {
+                if (forward.test(remaining[i]) && backward.test(remaining[i])) {
+                    components[remaining[i]].store(component, std::memory_order_relaxed);
+                }
+            }
+        });
+        compact();
+    }
+
+    std::vector<std::atomic<id_type>> colors(size);
+    for (trim(); !remaining.empty(); trim()) {
+        pool.parallel_for(remaining.size(), [&](size_type first, size_type last, size_type) {
+            for (size_type i = first; i < last; ++i) {
+                colors[remaining[i]].store(remaining[i], std::memory_order_relaxed);
+            }
+        });
+
+        // Push the largest colors forward until none changes
+        for (std::atomic<bool> changed{true}; changed.exchange(false);) {
+            pool.parallel_for(remaining.size(), [&](size_type first, size_type last, size_type) {
+                bool local = false;
+                for (size_type i = first; i < last; ++i) {
+                    const id_type color = colors[remaining[i]].load(std::memory_order_relaxed);
+                    for_each_out(remaining[i], [&](size_type to) {
+                        if (!alive(to)) {
+                            return;
+                        }
+                        id_type current = colors[to].load(std::memory_order_relaxed);
+                        while (current < color) {
+                            if (colors[to].compare_exchange_weak(current, color, std::memory_order_relaxed)) {
+                                local = true;
+                                break;
+                            }
+                        }
+                    });
+                }
+                if (local) {
+                    changed.store(true, std::memory_order_relaxed);
+                }
+            });
+        }
+
+        frontier roots;
+        for (const id_type id : remaining) {
+            if (id == colors[id].load(std::memory_order_relaxed)) {
+                roots.push_back(id);
+            }
+        }
+        pool.parallel_for(roots.size(), [&](size_type first, size_type last, size_type) {
+            frontier stack;
+            for (size_type i = first; i < last; ++i) {
+                const id_type root = roots[i];
+                const id_type component = new_component();
+                components[root].store(component, std::memory_order_relaxed);
+                stack.push_back(root);
+                while (!stack.empty()) {
+                    const id_type id = stack.back();
+                    stack.pop_back();
+                    for_each_in(id, [&](size_type from) {
+                        if (root == colors[from].load(std::memory_order_relaxed) && alive(from)) {
+                            components[from].store(component, std::memory_order_relaxed);
+                            stack.push_back(static_cast<id_type>(from));
+                        }
+                    });
+                }
+            }
+        }, 1);
+        compact();
+    }
+
+    scc_result<id_type> result;
+    result.components.resize(size);
+    result.sizes.assign(numOfComponents.load(), 0);
+    for (size_type i = 0; i < size; ++i) {
+        result.components[i] = components[i].load(std::memory_order_relaxed);
+        if (INVALID_ID != result.components[i]) {
+            ++result.sizes[result.components[i]];
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Graph of the components, node c named after component c, with the
+ *        cheapest edge between every two components that have edges.
+ */
+template <typename Cost, typename Id, typename Graph>
+basic_graph<Cost, Id> condensation(const Graph& g, const scc_result<Id>& scc)
+{
+    using size_type = typename Graph::size_type;
+    using edge_type = std::conditional_t<basic_graph<Cost, Id>::is_weighted,
+                                         std::tuple<size_type, size_type, typename Graph::cost_type>,
+                                         std::tuple<size_type, size_type>>;
+
+    std::vector<edge_type> edges;
+    for (size_type i = 0; i < g.num_of_ids(); ++i) {
+        if (!g.contains(i)) {
+            continue;
+        }
+        for (const auto [toId, toCost] : g.out_edges(i)) {
+            if (scc.components[i] != scc.components[toId]) {
+                if constexpr (basic_graph<Cost, Id>::is_weighted) {
+                    edges.emplace_back(scc.components[i], scc.components[toId], toCost);
+                } else {
+                    edges.emplace_back(scc.components[i], scc.components[toId]);
+                }
+            }
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end(), [](const edge_type& lhs, const edge_type& rhs) {
+        return std::get<0>(lhs) == std::get<0>(rhs) && std::get<1>(lhs) == std::get<1>(rhs);
+    }), edges.end());
+
+    basic_graph<Cost, Id> result;
+    for (size_type c = 0; c < scc.count(); ++c) {
+        result.add_node(std::to_string(c));
+    }
+    result.add_edges(edges.begin(), edges.end());
+    return result;
+}
+
+}
+
+template <typename Cost, typename Id>
+scc_result<Id> basic_graph<Cost, Id>::strongly_connected_components() const
+{
+    return detail::tarjan(*this);
+}
+
+template <typename Cost, typename Id>
+scc_result<Id> basic_graph<Cost, Id>::parallel_strongly_connected_components(size_type numOfThreads) const
+{
+    thread_pool pool{numOfThreads};
+    return detail::parallel_scc(*this, pool);
+}
+
+template <typename Cost, typename Id>
+basic_graph<Cost, Id> basic_graph<Cost, Id>::condensation(const scc_result<Id>& scc) const
+{
+    return detail::condensation<Cost, Id>(*this, scc);
+}
+
+template <typename Cost, typename Id>
+scc_result<Id> basic_csr_graph<Cost, Id>::strongly_connected_components() const
+{
+    return detail::tarjan(*this);
+}
+
+template <typename Cost, typename Id>
+scc_result<Id> basic_csr_graph<Cost, Id>::parallel_strongly_connected_components(size_type numOfThreads) const
+{
+    thread_pool pool{numOfThreads};
+    return detail::parallel_scc(*this, pool);
+}
+
+template <typename Cost, typename Id>
+basic_graph<Cost, Id> basic_csr_graph<Cost, Id>::condensation(const scc_result<Id>& scc) const
+{
+    return detail::condensation<Cost, Id>(*this, scc);
+}
+
+}
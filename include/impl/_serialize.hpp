@@ -1,16 +1,42 @@
 #pragma once
 
+#include <charconv>
+
 namespace impl
 {
 
-void graph::serialize(const std::string& fileName) const
+namespace detail
+{
+
+/**
+ * @brief Write the shortest text that parses back to the same number.
+ */
+template <typename T>
+void write_number(std::ostream& os, T value)
+{
+    char buffer[64];
+    const auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    assert(std::errc{} == ec);
+    os.write(buffer, ptr - buffer);
+}
+
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::serialize(const std::string& fileName) const
 {
     std::ofstream os{fileName};
+    // Removed ids are skipped, the nodes are written with their compacted ids
+    const std::vector<id_type> ids = compacted_ids();
     os << size() << '\n';
-    for (const node* n : m_adjList) {
+    for (auto it = begin_nodes(); it != end_nodes(); ++it) {
+        const node* n = *it;
         os << n->get_name() << ' ' << n->get_num_of_edges() << ' ';
         for (const edge* e : n->get_edges()) {
-            os << e->get_to()->get_id() << ' ' << e->get_cost() << ' ';
+            detail::write_number(os, ids[e->get_to_idx()]);
+            os << ' ';
+            detail::write_number(os, e->get_cost());
+            os << ' ';
         }
         os << '\n';
     }
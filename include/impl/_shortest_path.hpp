@@ -0,0 +1,205 @@
+#pragma once
+
+namespace impl
+{
+
+namespace detail
+{
+
+/**
+ * @brief Graph with all its edges reversed, the out_edges are the in_edges
+ *        of the underlying graph.
+ */
+template <typename Graph>
+class reversed_view
+{
+public:
+    using size_type = typename Graph::size_type;
+    using id_type = typename Graph::id_type;
+    using cost_type = typename Graph::cost_type;
+
+    constexpr static id_type INVALID_ID = Graph::INVALID_ID;
+
+public:
+    explicit reversed_view(const Graph& g)
+        : m_graph(g)
+    { }
+
+    [[nodiscard]] inline size_type num_of_ids() const noexcept { return m_graph.num_of_ids(); }
+    [[nodiscard]] inline auto out_edges(size_type id) const { return m_graph.in_edges(id); }
+
+private:
+    const Graph& m_graph;
+};
+
+/**
+ * @brief Bidirectional dijkstra, a forward search from the source and a
+ *        backward search from the target over the incoming edges.
+ * @details The side with the smaller top key is expanded. Every relaxed edge
+ *          that reaches a node labeled by the other side is a candidate path,
+ *          the search stops once the two top keys together can not beat the
+ *          best candidate.
+ */
+template <typename Graph>
+shortest_path_result<typename Graph::cost_type, typename Graph::id_type>
+bidirectional_dijkstra(const Graph& g, typename Graph::size_type from, typename Graph::size_type to)
+{
+    using size_type = typename Graph::size_type;
+    using id_type = typename Graph::id_type;
+    using cost_type = typename Graph::cost_type;
+    using traits = cost_traits<cost_type>;
+    constexpr cost_type INF_COST = traits::infinity();
+    constexpr id_type INVALID_ID = Graph::INVALID_ID;
+
+    shortest_path_result<cost_type, id_type> result;
+    if (from == to) {
+        result.cost = 0;
+        result.nodes.push_back(static_cast<id_type>(from));
+        result.settled = 1;
+        return result;
+    }
+
+    struct side
+    {
+        explicit side(size_type size)
+            : dist(size, cost_traits<cost_type>::infinity())
+            , pred(size, Graph::INVALID_ID)
+            , queue(size)
+        { }
+
+        std::vector<cost_type> dist;
+        std::vector<id_type> pred;
+        indexed_heap<cost_type> queue;
+    };
+    side forward(g.num_of_ids());
+    side backward(g.num_of_ids());
+    forward.dist[from] = 0;
+    forward.queue.push_or_decrease(from, 0);
+    backward.dist[to] = 0;
+    backward.queue.push_or_decrease(to, 0);
+
+    // Best path found so far goes through the edge meetFrom -> meetTo
+    cost_type best = INF_COST;
+    id_type meetFrom = INVALID_ID;
+    id_type meetTo = INVALID_ID;
+
+    auto expand = [&](const auto& adjacency, side& self, const side& other, bool isForward) {
+        const auto [cost, id] = self.queue.top();
+        self.queue.pop();
+        ++result.settled;
+        for (const auto [toId, toCost] : adjacency.out_edges(id)) {
+            const cost_type totalCost = traits::add(cost, toCost);
+            if (totalCost < self.dist[toId]) {
+                self.dist[toId] = totalCost;
+                self.pred[toId] = static_cast<id_type>(id);
+                self.queue.push_or_decrease(toId, totalCost);
+            }
+            if (INF_COST != other.dist[toId] && traits::add(totalCost, other.dist[toId]) < best) {
+                best = traits::add(totalCost, other.dist[toId]);
+                meetFrom = static_cast<id_type>(isForward ? id : toId);
+                meetTo = static_cast<id_type>(isForward ? toId : id);
+            }
+        }
+    };
+
+    const reversed_view<Graph> reversed(g);
+    while (!forward.queue.empty() && !backward.queue.empty()) {
+        const cost_type forwardTop = forward.queue.top().first;
+        const cost_type backwardTop = backward.queue.top().first;
+        if (INF_COST != best && traits::add(forwardTop, backwardTop) >= best) {
+            break;
+        }
+        if (forwardTop <= backwardTop) {
+            expand(g, forward, backward, true);
+        } else {
+            expand(reversed, backward, forward, false);
+        }
+    }
+
+    if (INF_COST == best) {
+        return result;
+    }
+    result.cost = best;
+    for (id_type id = meetFrom; INVALID_ID != id; id = forward.pred[id]) {
+        result.nodes.push_back(id);
+    }
+    std::reverse(result.nodes.begin(), result.nodes.end());
+    for (id_type id = meetTo; INVALID_ID != id; id = backward.pred[id]) {
+        result.nodes.push_back(id);
+    }
+    return result;
+}
+
+/**
+ * @brief A* search guided by a lower bound of the remaining cost.
+ * @details Nodes are popped by cost + heuristic(id). A node reached again
+ *          with a lower cost is pushed again, so an admissible heuristic is
+ *          enough, a consistent one settles every node at most once.
+ */
+template <typename Graph, typename Heuristic>
+shortest_path_result<typename Graph::cost_type, typename Graph::id_type>
+astar(const Graph& g, typename Graph::size_type from, typename Graph::size_type to, Heuristic&& heuristic)
+{
+    using size_type = typename Graph::size_type;
+    using id_type = typename Graph::id_type;
+    using cost_type = typename Graph::cost_type;
+    using traits = cost_traits<cost_type>;
+    constexpr cost_type INF_COST = traits::infinity();
+    constexpr id_type INVALID_ID = Graph::INVALID_ID;
+
+    shortest_path_result<cost_type, id_type> result;
+    std::vector<cost_type> dist(g.num_of_ids(), INF_COST);
+    std::vector<id_type> pred(g.num_of_ids(), INVALID_ID);
+    indexed_heap<cost_type> queue(g.num_of_ids());
+    dist[from] = 0;
+    queue.push_or_decrease(from, static_cast<cost_type>(heuristic(from)));
+
+    while (!queue.empty()) {
+        const size_type id = queue.top().second;
+        queue.pop();
+        ++result.settled;
+        if (id == to) {
+            break;
+        }
+
+        for (const auto [toId, toCost] : g.out_edges(id)) {
+            const cost_type totalCost = traits::add(dist[id], toCost);
+            if (totalCost < dist[toId]) {
+                dist[toId] = totalCost;
+                pred[toId] = static_cast<id_type>(id);
+                queue.push_or_decrease(toId, traits::add(totalCost, static_cast<cost_type>(heuristic(toId))));
+            }
+        }
+    }
+
+    if (INF_COST == dist[to]) {
+        return result;
+    }
+    result.cost = dist[to];
+    for (id_type id = static_cast<id_type>(to); INVALID_ID != id; id = pred[id]) {
+        result.nodes.push_back(id);
+    }
+    std::reverse(result.nodes.begin(), result.nodes.end());
+    return result;
+}
+
+}
+
+template <typename Cost, typename Id>
+shortest_path_result<path_cost_t<Cost, Id>, Id> basic_graph<Cost, Id>::shortest_path(size_type from, size_type to) const
+{
+    if (!m_incomingIndex) {
+        return detail::astar(*this, from, to, [](size_type) { return cost_type{0}; });
+    }
+    return detail::bidirectional_dijkstra(*this, from, to);
+}
+
+template <typename Cost, typename Id>
+template <typename Heuristic>
+shortest_path_result<path_cost_t<Cost, Id>, Id> basic_graph<Cost, Id>::shortest_path(size_type from, size_type to,
+                                                                    Heuristic&& heuristic) const
+{
+    return detail::astar(*this, from, to, std::forward<Heuristic>(heuristic));
+}
+
+}
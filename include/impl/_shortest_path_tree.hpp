@@ -0,0 +1,79 @@
+#pragma once
+
+namespace impl
+{
+
+////////////////////////////////////////////////////////////////////////////////
+///// shortest_path_tree::path_iterator
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+shortest_path_tree<Cost, Id>::path_iterator::path_iterator(const id_type* predecessors, id_type id)
+    : m_predecessors(predecessors)
+    , m_id(id)
+{ }
+
+template <typename Cost, typename Id>
+typename shortest_path_tree<Cost, Id>::path_iterator& shortest_path_tree<Cost, Id>::path_iterator::operator++()
+{
+    m_id = m_predecessors[m_id];
+    return *this;
+}
+
+template <typename Cost, typename Id>
+typename shortest_path_tree<Cost, Id>::path_iterator shortest_path_tree<Cost, Id>::path_iterator::operator++(int)
+{
+    path_iterator temp{*this};
+    ++*this;
+    return temp;
+}
+
+template <typename Cost, typename Id>
+bool shortest_path_tree<Cost, Id>::path_iterator::operator==(const path_iterator& other) const
+{
+    return m_id == other.m_id;
+}
+
+template <typename Cost, typename Id>
+bool shortest_path_tree<Cost, Id>::path_iterator::operator!=(const path_iterator& other) const
+{
+    return m_id != other.m_id;
+}
+
+template <typename Cost, typename Id>
+typename shortest_path_tree<Cost, Id>::path_iterator::value_type shortest_path_tree<Cost, Id>::path_iterator::operator*() const
+{
+    return m_id;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///// shortest_path_tree
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+shortest_path_tree<Cost, Id>::shortest_path_tree(size_type size, size_type source, bool withEdges)
+    : m_source(source)
+    , m_costs(size, INF_COST)
+    , m_predecessors(size, INVALID_ID)
+    , m_edges(withEdges ? size : 0, INVALID_ID)
+{
+    m_costs[source] = 0;
+}
+
+template <typename Cost, typename Id>
+typename shortest_path_tree<Cost, Id>::path_range shortest_path_tree<Cost, Id>::path(size_type target) const
+{
+    const id_type first = reachable(target) ? static_cast<id_type>(target) : INVALID_ID;
+    return path_range(path_iterator(m_predecessors.data(), first),
+                      path_iterator(m_predecessors.data(), INVALID_ID));
+}
+
+template <typename Cost, typename Id>
+inline void shortest_path_tree<Cost, Id>::relax(size_type id, cost_type cost, size_type from, size_type rank)
+{
+    m_costs[id] = cost;
+    m_predecessors[id] = static_cast<id_type>(from);
+    if (has_predecessor_edges()) {
+        m_edges[id] = rank;
+    }
+}
+
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+
+namespace impl
+{
+
+inline thread_pool::thread_pool(size_type numOfThreads)
+{
+    if (0 == numOfThreads) {
+        numOfThreads = std::max<size_type>(1, std::thread::hardware_concurrency());
+    }
+    m_threads.reserve(numOfThreads - 1);
+    for (size_type worker = 1; worker < numOfThreads; ++worker) {
+        m_threads.emplace_back(&thread_pool::worker_loop, this, worker);
+    }
+}
+
+inline thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_start.notify_all();
+    for (std::thread& t : m_threads) {
+        t.join();
+    }
+}
+
+template <typename Job>
+void thread_pool::run(Job&& job)
+{
+    const std::function<void(size_type)> f = [&job](size_type worker) { job(worker); };
+    run_job(f);
+}
+
+template <typename Job>
+void thread_pool::parallel_for(size_type count, Job&& job, size_type grain)
+{
+    if (0 == count) {
+        return;
+    }
+    if (0 == grain) {
+        // A few blocks per thread balance the load without much contention
+        grain = std::max<size_type>(1, count / (8 * size()));
+    }
+    if (1 == size() || count <= grain) {
+        job(size_type{0}, count, size_type{0});
+        return;
+    }
+
+    std::atomic<size_type> next{0};
+    run([&](size_type worker) {
+        for (;;) {
+            const size_type first = next.fetch_add(grain, std::memory_order_relaxed);
+            if (first >= count) {
+                break;
+            }
+            job(first, std::min(first + grain, count), worker);
+        }
+    });
+}
+
+inline void thread_pool::run_job(const std::function<void(size_type)>& job)
+{
+    if (m_threads.empty()) {
+        job(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_pending = m_threads.size();
+        m_error = nullptr;
+        ++m_generation;
+    }
+    m_start.notify_all();
+
+    std::exception_ptr error;
+    try {
+        job(0);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return 0 == m_pending; });
+    m_job = nullptr;
+    if (nullptr == error) {
+        error = m_error;
+    }
+    lock.unlock();
+
+    if (nullptr != error) {
+        std::rethrow_exception(error);
+    }
+}
+
+inline void thread_pool::worker_loop(size_type worker)
+{
+    size_type generation = 0;
+    for (;;) {
+        const std::function<void(size_type)>* job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start.wait(lock, [&] { return m_stop || generation != m_generation; });
+            if (m_stop) {
+                return;
+            }
+            generation = m_generation;
+            job = m_job;
+        }
+
+        std::exception_ptr error;
+        try {
+            (*job)(worker);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (nullptr != error && nullptr == m_error) {
+                m_error = error;
+            }
+            --m_pending;
+        }
+        m_done.notify_one();
+    }
+}
+
+}
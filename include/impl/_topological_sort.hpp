@@ -0,0 +1,121 @@
+#pragma once
+
+namespace impl
+{
+
+namespace detail
+{
+
+/**
+ * @brief Throw a cycle_error naming a node of a cycle found by find_cycle.
+ * @details Kahn's algorithm left nodes over, so the depth first search must
+ *          find a cycle, the error names no node if it does not.
+ */
+template <typename Graph>
+[[noreturn]] void throw_cycle_error(const Graph& g)
+{
+    const std::vector<typename Graph::size_type> cycle = find_cycle(g);
+    assert(!cycle.empty() && "Kahn's algorithm and the depth first search disagree on the cycle");
+    if (cycle.empty()) {
+        throw cycle_error("No topological order, the graph has a cycle", Graph::INVALID_ID);
+    }
+    throw cycle_error("No topological order, node " + std::to_string(cycle.front()) + " is on a cycle",
+                      cycle.front());
+}
+
+template <typename Graph>
+std::vector<typename Graph::size_type> topological_order(const Graph& g)
+{
+    thread_pool pool{1};
+    auto ignore = [](typename Graph::size_type, typename Graph::size_type) { };
+    std::vector<typename Graph::size_type> order = kahn_order(g, ignore, pool);
+    if (order.size() != g.size()) {
+        throw_cycle_error(g);
+    }
+    return order;
+}
+
+/**
+ * @brief Level synchronous parallel Kahn's algorithm.
+ * @details The frontier holds the nodes whose in-degree dropped to 0, the
+ *          threads split it and decrement the atomic in-degrees of the
+ *          targets, the thread that takes a counter to 0 owns the node for
+ *          the next level. The end of parallel_for orders the levels, so the
+ *          counters need no stronger ordering than relaxed.
+ */
+template <typename Graph>
+std::vector<std::vector<typename Graph::size_type>> topological_levels(const Graph& g, thread_pool& pool)
+{
+    using size_type = typename Graph::size_type;
+    using frontier = std::vector<size_type>;
+
+    std::vector<std::atomic<size_type>> degrees = in_degrees(g, pool);
+    frontier queue;
+    for (size_type i = 0; i < g.num_of_ids(); ++i) {
+        if (g.contains(i) && 0 == degrees[i].load(std::memory_order_relaxed)) {
+            queue.push_back(i);
+        }
+    }
+
+    std::vector<frontier> levels;
+    std::vector<frontier> locals(pool.size());
+    size_type placed = 0;
+    while (!queue.empty()) {
+        pool.parallel_for(queue.size(), [&](size_type first, size_type last, size_type worker) {
+            frontier& local = locals[worker];
+            for (size_type i = first; i < last; ++i) {
+                for (const auto [toId, toCost] : g.out_edges(queue[i])) {
+                    if (1 == degrees[toId].fetch_sub(1, std::memory_order_relaxed)) {
+                        local.push_back(toId);
+                    }
+                }
+            }
+        });
+        placed += queue.size();
+        levels.push_back(std::move(queue));
+
+        queue = frontier{};
+        for (frontier& local : locals) {
+            queue.insert(queue.end(), local.begin(), local.end());
+            local.clear();
+        }
+        std::sort(queue.begin(), queue.end());
+    }
+
+    if (placed != g.size()) {
+        throw_cycle_error(g);
+    }
+    return levels;
+}
+
+}
+
+template <typename Cost, typename Id>
+std::vector<typename basic_graph<Cost, Id>::size_type> basic_graph<Cost, Id>::topological_order() const
+{
+    return detail::topological_order(*this);
+}
+
+template <typename Cost, typename Id>
+std::vector<std::vector<typename basic_graph<Cost, Id>::size_type>>
+basic_graph<Cost, Id>::topological_levels(size_type numOfThreads) const
+{
+    thread_pool pool{numOfThreads};
+    return detail::topological_levels(*this, pool);
+}
+
+template <typename Cost, typename Id>
+std::vector<typename basic_csr_graph<Cost, Id>::size_type> basic_csr_graph<Cost, Id>::topological_order() const
+{
+    return detail::topological_order(*this);
+}
+
+template <typename Cost, typename Id>
+std::vector<std::vector<typename basic_csr_graph<Cost, Id>::size_type>>
+basic_csr_graph<Cost, Id>::topological_levels(size_type numOfThreads) const
+{
+    thread_pool pool{numOfThreads};
+    return detail::topological_levels(*this, pool);
+}
+
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+namespace impl
+{
+
+namespace detail
+{
+
+/**
+ * @brief Breadth first search from start with the visitor callbacks.
+ * @details Nodes already visited in the workspace are treated as discovered,
+ *          so several searches can share one reset of the workspace. The
+ *          frontier is processed level by level to know the depth.
+ * @return true if the visitor stopped the search, false otherwise.
+ */
+template <typename Graph, typename Visitor>
+bool bfs(const Graph& g, typename Graph::size_type start, Visitor& visitor, traversal_workspace& workspace)
+{
+    using size_type = typename Graph::size_type;
+
+    if (!workspace.visit(start)) {
+        return false;
+    }
+    switch (visitor.discover(start, 0)) {
+    case visit_result::STOP: return true;
+    case visit_result::SKIP: return false;
+    case visit_result::PROCEED: workspace.push(start); break;
+    }
+
+    for (size_type depth = 1; !workspace.empty(); ++depth) {
+        for (size_type pending = workspace.size(); pending > 0; --pending) {
+            const size_type id = workspace.pop_front();
+            for (const auto [toId, toCost] : g.out_edges(id)) {
+                const visit_result examined = visitor.examine_edge(id, toId, toCost);
+                if (visit_result::STOP == examined) {
+                    return true;
+                }
+                if (visit_result::SKIP == examined) {
+                    continue;
+                }
+                if (workspace.visited(toId)) {
+                    if (visit_result::STOP == visitor.non_tree_edge(id, toId, toCost)) {
+                        return true;
+                    }
+                    continue;
+                }
+                const visit_result tree = visitor.tree_edge(id, toId, toCost);
+                if (visit_result::STOP == tree) {
+                    return true;
+                }
+                if (visit_result::SKIP == tree) {
+                    continue;
+                }
+                workspace.visit(toId);
+                const visit_result discovered = visitor.discover(toId, depth);
+                if (visit_result::STOP == discovered) {
+                    return true;
+                }
+                if (visit_result::PROCEED == discovered) {
+                    workspace.push(toId);
+                }
+            }
+            if (visit_result::STOP == visitor.finish(id)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Node on the depth first search path and its remaining outgoing edges.
+ * @details Depends on the graph type only, so every search of a graph shares
+ *          the frame stack of the workspace.
+ */
+template <typename Graph>
+struct dfs_frame
+{
+    using arc_iterator = decltype(std::declval<const Graph&>().out_edges(0).begin());
+
+    typename Graph::size_type id;
+    arc_iterator next;
+    arc_iterator last;
+};
+
+/**
+ * @brief Depth first search from start with the visitor callbacks.
+ * @details Iterative, the path from start to the current node is a stack of
+ *          (node, next edge) frames kept in the workspace, so repeated
+ *          searches do not allocate. Nodes on the path are visited, the
+ *          others are finished, which tells back edges from the other non
+ *          tree edges. Nodes already visited in the workspace are treated as
+ *          discovered, so several searches can share one reset of the workspace.
+ * @return true if the visitor stopped the search, false otherwise.
+ */
+template <typename Graph, typename Visitor>
+bool dfs(const Graph& g, typename Graph::size_type start, Visitor& visitor, traversal_workspace& workspace)
+{
+    using size_type = typename Graph::size_type;
+    using frame = dfs_frame<Graph>;
+
+    if (!workspace.visit(start)) {
+        return false;
+    }
+    switch (visitor.discover(start, 0)) {
+    case visit_result::STOP: return true;
+    case visit_result::SKIP: workspace.finish(start); return false;
+    case visit_result::PROCEED: break;
+    }
+
+    std::vector<frame>& path = workspace.template path<frame>();
+    path.push_back(frame{start, g.out_edges(start).begin(), g.out_edges(start).end()});
+    while (!path.empty()) {
+        frame& top = path.back();
+        if (top.next == top.last) {
+            const size_type id = top.id;
+            path.pop_back();
+            workspace.finish(id);
+            if (visit_result::STOP == visitor.finish(id)) {
+                return true;
+            }
+            continue;
+        }
+
+        const size_type id = top.id;
+        const auto [toId, toCost] = *top.next;
+        ++top.next;
+
+        const visit_result examined = visitor.examine_edge(id, toId, toCost);
+        if (visit_result::STOP == examined) {
+            return true;
+        }
+        if (visit_result::SKIP == examined) {
+            continue;
+        }
+        if (workspace.visited(toId)) {
+            const visit_result result = workspace.finished(toId) ? visitor.non_tree_edge(id, toId, toCost)
+                                                                 : visitor.back_edge(id, toId, toCost);
+            if (visit_result::STOP == result) {
+                return true;
+            }
+            continue;
+        }
+        const visit_result tree = visitor.tree_edge(id, toId, toCost);
+        if (visit_result::STOP == tree) {
+            return true;
+        }
+        if (visit_result::SKIP == tree) {
+            continue;
+        }
+        workspace.visit(toId);
+        const visit_result discovered = visitor.discover(toId, path.size());
+        if (visit_result::STOP == discovered) {
+            return true;
+        }
+        if (visit_result::SKIP == discovered) {
+            workspace.finish(toId);
+            continue;
+        }
+        const auto edges = g.out_edges(toId);
+        path.push_back(frame{static_cast<size_type>(toId), edges.begin(), edges.end()});
+    }
+    return false;
+}
+
+}
+
+template <typename Cost, typename Id>
+template <typename Visitor>
+bool basic_graph<Cost, Id>::bfs(size_type start, Visitor&& visitor) const
+{
+    if (!contains(start)) {
+        return false;
+    }
+    const workspace_pool::workspace_ptr workspace = borrow_workspace();
+    return detail::bfs(*this, start, visitor, *workspace);
+}
+
+template <typename Cost, typename Id>
+template <typename Visitor>
+bool basic_graph<Cost, Id>::dfs(size_type start, Visitor&& visitor) const
+{
+    if (!contains(start)) {
+        return false;
+    }
+    const workspace_pool::workspace_ptr workspace = borrow_workspace();
+    return detail::dfs(*this, start, visitor, *workspace);
+}
+
+template <typename Cost, typename Id>
+template <typename Visitor>
+bool basic_csr_graph<Cost, Id>::bfs(size_type start, Visitor&& visitor) const
+{
+    if (!contains(start)) {
+        return false;
+    }
+    const workspace_pool::workspace_ptr workspace = borrow_workspace();
+    return detail::bfs(*this, start, visitor, *workspace);
+}
+
+template <typename Cost, typename Id>
+template <typename Visitor>
+bool basic_csr_graph<Cost, Id>::dfs(size_type start, Visitor&& visitor) const
+{
+    if (!contains(start)) {
+        return false;
+    }
+    const workspace_pool::workspace_ptr workspace = borrow_workspace();
+    return detail::dfs(*this, start, visitor, *workspace);
+}
+
+}
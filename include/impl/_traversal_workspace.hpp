@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+
+namespace impl
+{
+
+////////////////////////////////////////////////////////////////////////////////
+///// traversal_workspace
+////////////////////////////////////////////////////////////////////////////////
+inline void traversal_workspace::reset(size_type numOfIds)
+{
+    if (m_stamps.size() < numOfIds) {
+        m_stamps.resize(numOfIds, 0);
+        m_frontier.reserve(numOfIds);
+    }
+    // Every traversal takes two stamps, visited and finished
+    m_epoch += 2;
+    if (0 == m_epoch) {
+        // Stamps of the previous traversals would look current again
+        std::fill(m_stamps.begin(), m_stamps.end(), 0);
+        m_epoch = 2;
+    }
+    m_frontier.clear();
+    m_head = 0;
+}
+
+inline bool traversal_workspace::visit(size_type id) noexcept
+{
+    if (visited(id)) {
+        return false;
+    }
+    m_stamps[id] = m_epoch;
+    return true;
+}
+
+inline traversal_workspace::size_type traversal_workspace::pop_back() noexcept
+{
+    const size_type id = m_frontier.back();
+    m_frontier.pop_back();
+    return id;
+}
+
+template <typename Frame>
+inline std::vector<Frame>& traversal_workspace::path()
+{
+    if (key_of<Frame>() != m_pathKey) {
+        m_path = std::make_unique<typed_path<Frame>>();
+        m_pathKey = key_of<Frame>();
+    }
+    std::vector<Frame>& frames = static_cast<typed_path<Frame>&>(*m_path).frames;
+    frames.clear();
+    return frames;
+}
+
+inline traversal_workspace::size_type traversal_workspace::capacity_bytes() const noexcept
+{
+    return m_stamps.capacity() * sizeof(epoch_type) + m_frontier.capacity() * sizeof(size_type)
+        + (m_path ? m_path->capacity_bytes() : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///// workspace_pool
+////////////////////////////////////////////////////////////////////////////////
+inline workspace_pool::workspace_ptr workspace_pool::borrow(std::size_t numOfIds)
+{
+    workspace_ptr workspace;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const workspace_ptr& candidate : m_workspaces) {
+            // Only the pool holds it, and only the pool hands out new copies
+            if (1 == candidate.use_count()) {
+                workspace = candidate;
+                break;
+            }
+        }
+        if (!workspace) {
+            workspace = std::make_shared<traversal_workspace>();
+            m_workspaces.push_back(workspace);
+        }
+    }
+    // Pairs with the release of the last borrower dropping its copy
+    std::atomic_thread_fence(std::memory_order_acquire);
+    workspace->reset(numOfIds);
+    return workspace;
+}
+
+}
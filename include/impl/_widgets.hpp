@@ -3,40 +3,46 @@
 namespace impl
 {
 
-inline size_t edge::get_from_idx() const noexcept
+template <typename Cost, typename Id>
+inline Id basic_edge<Cost, Id>::get_from_idx() const noexcept
 {
     return m_from->get_id();
 }
 
-inline size_t edge::get_to_idx() const noexcept
+template <typename Cost, typename Id>
+inline Id basic_edge<Cost, Id>::get_to_idx() const noexcept
 {
     return m_to->get_id();
 }
 
 
-bool edge::compare(const edge* e) const noexcept
+template <typename Cost, typename Id>
+bool basic_edge<Cost, Id>::compare(const basic_edge* e) const noexcept
 {
     assert(nullptr != e);
-    return (m_from == e->m_from && m_to == e->m_to && m_cost == e->m_cost);
+    // By id, so that edges of different graphs compare
+    return (m_from->get_id() == e->m_from->get_id() && m_to->get_id() == e->m_to->get_id()
+            && get_cost() == e->get_cost());
 }
 
 
-node::node(size_type id)
+template <typename Cost, typename Id>
+basic_node<Cost, Id>::basic_node(id_type id)
     : m_id(id)
 { }
 
-node::node(size_type id, std::string name)
+template <typename Cost, typename Id>
+basic_node<Cost, Id>::basic_node(id_type id, std::string_view name)
     : m_id(id)
-    , m_name(std::move(name))
+    , m_name(name)
 { }
 
-node::~node()
-{
-    std::destroy(m_edges.begin(), m_edges.end());
-}
-
-inline bool node::has_edge(node* to) const
+template <typename Cost, typename Id>
+inline bool basic_node<Cost, Id>::has_edge(node* to) const
 {
+    if (m_edgeIndex) {
+        return edge_index<edge, true>::NOT_FOUND != m_edgeIndex->find(to);
+    }
     for (const edge* edge : m_edges) {
         if (to == edge->get_to()) {
             return true;
@@ -45,32 +51,110 @@ inline bool node::has_edge(node* to) const
     return false;
 }
 
-edge* node::add_edge(node* to, edge::Cost_t cost)
+template <typename Cost, typename Id>
+inline void basic_node<Cost, Id>::add_edge(edge* e)
 {
-    // if (std::find(m_edges.begin(), m_edges.end(), edge) != m_edges.end()) {
-    //     return false;
-    // }
+    assert(this == e->get_from());
     // (from, to) can repeat - supports multigraph (not sure if I need this)
-    edge* e = new edge(this, to, cost);
     m_edges.push_back(e);
-    return e;
+    if (m_edgeIndex) {
+        m_edgeIndex->insert(e, m_edges.size() - 1);
+    } else if (m_edges.size() >= EDGE_INDEX_THRESHOLD) {
+        m_edgeIndex = std::make_unique<edge_index<edge, true>>(m_edges);
+    }
 }
 
-bool node::remove_edge(node* to)
+template <typename Cost, typename Id>
+inline void basic_node<Cost, Id>::add_in_edge(edge* e)
 {
-    for (auto it = m_edges.begin(); it != m_edges.end(); ++it) {
-        if (to == (*it)->get_to()) {
-            m_edges.erase(it);
-            return true;
+    assert(this == e->get_to());
+    m_inEdges.push_back(e);
+    if (m_inEdgeIndex) {
+        m_inEdgeIndex->insert(e, m_inEdges.size() - 1);
+    } else if (m_inEdges.size() >= EDGE_INDEX_THRESHOLD) {
+        m_inEdgeIndex = std::make_unique<edge_index<edge, false>>(m_inEdges);
+    }
+}
+
+template <typename Cost, typename Id>
+template <typename Index>
+void basic_node<Cost, Id>::erase_edge(std::vector<edge*>& edges, std::unique_ptr<Index>& index, size_type position)
+{
+    if (!index) {
+        edges.erase(edges.begin() + static_cast<std::ptrdiff_t>(position));
+        return;
+    }
+    index->erase(edges[position]);
+    if (position + 1 != edges.size()) {
+        edges[position] = edges.back();
+        index->move(edges[position], position);
+    }
+    edges.pop_back();
+    // Hysteresis, so that a degree around the threshold does not rebuild every time
+    if (edges.size() < EDGE_INDEX_THRESHOLD / 4) {
+        index.reset();
+    }
+}
+
+template <typename Cost, typename Id>
+inline void basic_node<Cost, Id>::remove_in_edge(const edge* e)
+{
+    if (m_inEdgeIndex) {
+        const size_type position = m_inEdgeIndex->find(e);
+        if (edge_index<edge, false>::NOT_FOUND != position) {
+            erase_edge(m_inEdges, m_inEdgeIndex, position);
         }
+        return;
     }
-    return false;
+    auto it = std::find(m_inEdges.begin(), m_inEdges.end(), e);
+    if (it != m_inEdges.end()) {
+        m_inEdges.erase(it);
+    }
+}
+
+template <typename Cost, typename Id>
+inline void basic_node<Cost, Id>::remove_out_edge(const edge* e)
+{
+    if (m_edgeIndex) {
+        const size_type position = m_edgeIndex->find(e);
+        if (edge_index<edge, true>::NOT_FOUND != position) {
+            erase_edge(m_edges, m_edgeIndex, position);
+        }
+        return;
+    }
+    auto it = std::find(m_edges.begin(), m_edges.end(), e);
+    if (it != m_edges.end()) {
+        m_edges.erase(it);
+    }
+}
+
+template <typename Cost, typename Id>
+bool basic_node<Cost, Id>::remove_edge(node* to)
+{
+    size_type position = m_edges.size();
+    if (m_edgeIndex) {
+        position = std::min(position, m_edgeIndex->find(to));
+    } else {
+        for (size_type i = 0; i < m_edges.size(); ++i) {
+            if (to == m_edges[i]->get_to()) {
+                position = i;
+                break;
+            }
+        }
+    }
+    if (position == m_edges.size()) {
+        return false;
+    }
+    to->remove_in_edge(m_edges[position]);
+    erase_edge(m_edges, m_edgeIndex, position);
+    return true;
 }
 
-bool node::compare(const node* n) const
+template <typename Cost, typename Id>
+bool basic_node<Cost, Id>::compare(const node* n) const
 {
     assert(nullptr != n);
-    if (degree() != n->degree()) {
+    if (get_name() != n->get_name() || degree() != n->degree()) {
         return false;
     }
     for (size_type i = 0; i < degree(); ++i) {
@@ -83,7 +167,8 @@ bool node::compare(const node* n) const
     return true;
 }
 
-void node::dump(std::ostream &os) const
+template <typename Cost, typename Id>
+void basic_node<Cost, Id>::dump(std::ostream &os) const
 {
     os << this << ":" << std::endl;
     for (auto& edge : m_edges) {
@@ -94,7 +179,8 @@ void node::dump(std::ostream &os) const
 
 }
 
-std::ostream& operator<<(std::ostream& os, const impl::node* node)
+template <typename Cost, typename Id>
+std::ostream& operator<<(std::ostream& os, const impl::basic_node<Cost, Id>* node)
 {
     if (nullptr == node) {
         os << "'nullptr'";
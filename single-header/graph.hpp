@@ -1,43 +1,445 @@
 #pragma once
 
 #include <algorithm>
-#include <map>
+#include <iterator>
 #include <queue>
 #include <stack>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
 
 #include <cassert>
 
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace impl
+{
+
+/**
+ * @struct cost_traits
+ * @brief Infinity and path cost addition of an edge cost type.
+ * @details Infinity marks unreachable nodes and absorbs any addition. Floating
+ *          point costs add natively. Integer costs narrower than 64 bits add
+ *          in 64 bits and clamp, 64 bit integers are checked before adding,
+ *          so a sum that does not fit saturates to infinity (or to the lowest
+ *          value for negative costs) instead of wrapping around.
+ */
+template <typename Cost>
+struct cost_traits
+{
+    static_assert(std::is_arithmetic_v<Cost> && !std::is_same_v<Cost, bool>,
+                  "Edge costs must be integer or floating point numbers");
+
+    using cost_type                 = Cost;
+
+    [[nodiscard]] constexpr static Cost infinity() noexcept
+    {
+        if constexpr (std::is_floating_point_v<Cost>) {
+            return std::numeric_limits<Cost>::infinity();
+        } else {
+            return std::numeric_limits<Cost>::max();
+        }
+    }
+
+    [[nodiscard]] constexpr static Cost add(Cost lhs, Cost rhs) noexcept
+    {
+        if constexpr (std::is_floating_point_v<Cost>) {
+            return lhs + rhs;
+        } else {
+            if (infinity() == lhs || infinity() == rhs) {
+                return infinity();
+            }
+            if constexpr (sizeof(Cost) < sizeof(std::int64_t)) {
+                using wide_type = std::conditional_t<std::is_signed_v<Cost>, std::int64_t, std::uint64_t>;
+                const wide_type sum = static_cast<wide_type>(lhs) + static_cast<wide_type>(rhs);
+                if (sum >= static_cast<wide_type>(infinity())) {
+                    return infinity();
+                }
+                if (sum < static_cast<wide_type>(std::numeric_limits<Cost>::lowest())) {
+                    return std::numeric_limits<Cost>::lowest();
+                }
+                return static_cast<Cost>(sum);
+            } else {
+                if (rhs > 0 && lhs > infinity() - rhs) {
+                    return infinity();
+                }
+                if constexpr (std::is_signed_v<Cost>) {
+                    if (rhs < 0 && lhs < std::numeric_limits<Cost>::lowest() - rhs) {
+                        return std::numeric_limits<Cost>::lowest();
+                    }
+                }
+                return lhs + rhs;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Type of the path costs of a graph with the given edge cost type:
+ *        Cost itself, or hop counts of type Id for unweighted (void Cost) graphs.
+ */
+template <typename Cost, typename Id>
+using path_cost_t = std::conditional_t<std::is_void_v<Cost>, Id, Cost>;
+
+}
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace impl
+{
+
+/**
+ * @class cycle_error
+ * @brief Thrown when an algorithm that needs an acyclic graph runs into a cycle.
+ */
+class cycle_error : public std::runtime_error
+{
+public:
+    cycle_error(const std::string& what, std::size_t node)
+        : std::runtime_error(what)
+        , m_node{node}
+    { }
+
+    /**
+     * @brief Return the id of a node on the cycle.
+     */
+    [[nodiscard]] inline std::size_t node() const noexcept { return m_node; }
+
+private:
+    std::size_t m_node;
+
+};
+
+}
+
 #include <tuple>
 #include <limits>
+#include <memory>
 
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include <algorithm>
 
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace impl
+{
+
+/**
+ * @class edge_index
+ * @brief Open addressing hash index of the edge list of one node.
+ * @details Maps the other endpoint of every edge (the target if ByTarget,
+ *          otherwise the source) to the position of the edge in the list.
+ *          Parallel edges get one slot each. Uses linear probing on the
+ *          address of the endpoint with backward shift deletion.
+ */
+template <typename Edge, bool ByTarget>
+class edge_index
+{
+public:
+    using size_type                 = std::size_t;
+
+    constexpr static size_type NOT_FOUND = std::numeric_limits<size_type>::max();
+
+public:
+    /**
+     * @brief Index the given edge list.
+     */
+    explicit edge_index(const std::vector<Edge*>& edges);
+
+    /**
+     * @brief Return number of indexed edges.
+     */
+    [[nodiscard]] inline size_type size() const noexcept { return m_size; }
+
+    /**
+     * @brief Return position of an edge with the given endpoint, NOT_FOUND if there is none.
+     */
+    [[nodiscard]] size_type find(const void* endpoint) const noexcept;
+
+    /**
+     * @brief Return position of the given edge, NOT_FOUND if it is not indexed.
+     */
+    [[nodiscard]] size_type find(const Edge* e) const noexcept;
+
+    /**
+     * @brief Index the edge at the given position.
+     */
+    void insert(const Edge* e, size_type position);
+
+    /**
+     * @brief Move the indexed edge to another position.
+     */
+    void move(const Edge* e, size_type position) noexcept;
+
+    /**
+     * @brief Remove the edge from the index.
+     */
+    void erase(const Edge* e) noexcept;
+
+private:
+    /**
+     * @brief Slot of the index, free slots have no edge.
+     */
+    struct entry
+    {
+        const Edge* edge;
+        size_type position;
+    };
+
+private:
+    [[nodiscard]] inline static const void* endpoint_of(const Edge* e) noexcept;
+    [[nodiscard]] inline size_type home_of(const void* endpoint) const noexcept;
+    [[nodiscard]] size_type find_slot(const Edge* e) const noexcept;
+    void rehash(size_type capacity);
+
+private:
+    std::vector<entry> m_slots;
+    size_type m_size = 0;
+
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace impl
+{
+
+template <typename Edge, bool ByTarget>
+edge_index<Edge, ByTarget>::edge_index(const std::vector<Edge*>& edges)
+{
+    size_type capacity = 16;
+    while (capacity < edges.size() * 2) {
+        capacity *= 2;
+    }
+    rehash(capacity);
+    for (size_type i = 0; i < edges.size(); ++i) {
+        insert(edges[i], i);
+    }
+}
+
+template <typename Edge, bool ByTarget>
+inline const void* edge_index<Edge, ByTarget>::endpoint_of(const Edge* e) noexcept
+{
+    if constexpr (ByTarget) {
+        return e->get_to();
+    } else {
+        return e->get_from();
+    }
+}
+
+template <typename Edge, bool ByTarget>
+inline typename edge_index<Edge, ByTarget>::size_type edge_index<Edge, ByTarget>::home_of(const void* endpoint) const noexcept
+{
+    // Fibonacci hashing of the address, the low bits are always zero
+    const auto address = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(endpoint));
+    return static_cast<size_type>((address * 0x9E3779B97F4A7C15ull) >> 32) & (m_slots.size() - 1);
+}
+
+template <typename Edge, bool ByTarget>
+typename edge_index<Edge, ByTarget>::size_type edge_index<Edge, ByTarget>::find(const void* endpoint) const noexcept
+{
+    const size_type mask = m_slots.size() - 1;
+    for (size_type i = home_of(endpoint); nullptr != m_slots[i].edge; i = (i + 1) & mask) {
+        if (endpoint == endpoint_of(m_slots[i].edge)) {
+            return m_slots[i].position;
+        }
+    }
+    return NOT_FOUND;
+}
+
+template <typename Edge, bool ByTarget>
+typename edge_index<Edge, ByTarget>::size_type edge_index<Edge, ByTarget>::find(const Edge* e) const noexcept
+{
+    const entry& slot = m_slots[find_slot(e)];
+    return nullptr == slot.edge ? NOT_FOUND : slot.position;
+}
+
+template <typename Edge, bool ByTarget>
+typename edge_index<Edge, ByTarget>::size_type edge_index<Edge, ByTarget>::find_slot(const Edge* e) const noexcept
+{
+    const size_type mask = m_slots.size() - 1;
+    size_type i = home_of(endpoint_of(e));
+    while (nullptr != m_slots[i].edge && e != m_slots[i].edge) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+template <typename Edge, bool ByTarget>
+void edge_index<Edge, ByTarget>::insert(const Edge* e, size_type position)
+{
+    if ((m_size + 1) * 2 > m_slots.size()) {
+        rehash(m_slots.size() * 2);
+    }
+    entry& slot = m_slots[find_slot(e)];
+    if (nullptr == slot.edge) {
+        ++m_size;
+    }
+    slot = entry{e, position};
+}
+
+template <typename Edge, bool ByTarget>
+void edge_index<Edge, ByTarget>::move(const Edge* e, size_type position) noexcept
+{
+    entry& slot = m_slots[find_slot(e)];
+    if (nullptr != slot.edge) {
+        slot.position = position;
+    }
+}
+
+template <typename Edge, bool ByTarget>
+void edge_index<Edge, ByTarget>::erase(const Edge* e) noexcept
+{
+    const size_type mask = m_slots.size() - 1;
+    size_type hole = find_slot(e);
+    if (nullptr == m_slots[hole].edge) {
+        return;
+    }
+
+    // Backward shift: move the following entries of the cluster into the hole,
+    // unless their home slot lies cyclically in (hole, current].
+    for (size_type i = (hole + 1) & mask; nullptr != m_slots[i].edge; i = (i + 1) & mask) {
+        const size_type home = home_of(endpoint_of(m_slots[i].edge));
+        const bool stays = (hole < i) ? (hole < home && home <= i)
+                                      : (hole < home || home <= i);
+        if (!stays) {
+            m_slots[hole] = m_slots[i];
+            hole = i;
+        }
+    }
+    m_slots[hole] = entry{nullptr, 0};
+    --m_size;
+}
+
+template <typename Edge, bool ByTarget>
+void edge_index<Edge, ByTarget>::rehash(size_type capacity)
+{
+    std::vector<entry> old(capacity, entry{nullptr, 0});
+    old.swap(m_slots);
+
+    const size_type mask = capacity - 1;
+    for (const entry& slot : old) {
+        if (nullptr == slot.edge) {
+            continue;
+        }
+        size_type i = home_of(endpoint_of(slot.edge));
+        while (nullptr != m_slots[i].edge) {
+            i = (i + 1) & mask;
+        }
+        m_slots[i] = slot;
+    }
+}
+
+}
+
 namespace impl
 {
-class node;
+template <typename Cost, typename Id>
+class basic_node;
+
+/**
+ * @class iterator_range
+ * @brief Pair of iterators usable in range-based for loops.
+ */
+template <typename Iterator>
+class iterator_range
+{
+public:
+    iterator_range(Iterator first, Iterator last)
+        : m_begin{first}
+        , m_end{last}
+    { }
+
+    [[nodiscard]] inline Iterator begin() const { return m_begin; }
+    [[nodiscard]] inline Iterator end() const { return m_end; }
+    [[nodiscard]] inline bool empty() const { return m_begin == m_end; }
+
+private:
+    Iterator m_begin;
+    Iterator m_end;
+
+};
+
+namespace detail
+{
+
+/**
+ * @brief Cost of an edge, stored as Value.
+ */
+template <typename Cost, typename Value>
+class edge_cost
+{
+public:
+    explicit edge_cost(Value cost) noexcept
+        : m_cost{cost}
+    { }
+
+    inline void set_cost(Value cost) noexcept { m_cost = cost; }
+    [[nodiscard]] inline Value get_cost() const noexcept { return m_cost; }
+
+private:
+    Value m_cost;
+};
+
+/**
+ * @brief Edges of unweighted graphs store no cost, every edge costs 1.
+ */
+template <typename Value>
+class edge_cost<void, Value>
+{
+public:
+    explicit edge_cost(Value) noexcept
+    { }
 
-class edge
+    inline void set_cost(Value) noexcept { }
+    [[nodiscard]] inline Value get_cost() const noexcept { return 1; }
+};
+
+}
+
+/**
+ * @class basic_edge
+ * @brief Directed weighted edge between two nodes.
+ * @details With void Cost the edge is unweighted, it only holds its two
+ *          nodes and get_cost() is always 1.
+ */
+template <typename Cost, typename Id>
+class basic_edge : private detail::edge_cost<Cost, path_cost_t<Cost, Id>>
 {
+    using cost_base = detail::edge_cost<Cost, path_cost_t<Cost, Id>>;
+
 public:
-    using Cost_t = int;
-    constexpr static Cost_t INF_COST = std::numeric_limits<Cost_t>::max();
+    using Cost_t = path_cost_t<Cost, Id>;
+    using node = basic_node<Cost, Id>;
+    constexpr static Cost_t INF_COST = cost_traits<Cost_t>::infinity();
+    constexpr static bool is_weighted = !std::is_void_v<Cost>;
 
 public:
-    edge(node* from, node* to, Cost_t cost)
-        : m_from{from}
+    basic_edge(node* from, node* to, Cost_t cost)
+        : cost_base{cost}
+        , m_from{from}
         , m_to{to}
-        , m_cost{cost}
     { }
 
-    ~edge() = default;
+    ~basic_edge() = default;
 
     inline void set_from(node* from) noexcept { m_from = from; }
     inline void set_to(node* to) noexcept { m_to = to; }
@@ -47,76 +449,121 @@ public:
     [[nodiscard]] inline const node* get_to() const noexcept { return m_to; }
     [[nodiscard]] inline node* get_to() noexcept { return m_to; }
 
-    [[nodiscard]] inline size_t get_from_idx() const noexcept;
-    [[nodiscard]] inline size_t get_to_idx() const noexcept;
+    [[nodiscard]] inline Id get_from_idx() const noexcept;
+    [[nodiscard]] inline Id get_to_idx() const noexcept;
 
-    inline void set_cost(Cost_t cost) noexcept { m_cost = cost; }
-    [[nodiscard]] inline Cost_t get_cost() const noexcept { return m_cost; }
+    using cost_base::set_cost;
+    using cost_base::get_cost;
 
-    [[nodiscard]] bool compare(const edge* rhs) const noexcept;
+    [[nodiscard]] bool compare(const basic_edge* rhs) const noexcept;
 
 private:
     node* m_from;
     node* m_to;
-    Cost_t m_cost;
 
 };
 
 /**
- * @class node
+ * @brief Id based view of an outgoing edge: target node id and cost.
+ */
+template <typename Cost, typename Id>
+struct basic_arc
+{
+    Id to;
+    path_cost_t<Cost, Id> cost;
+};
+
+/**
+ * @class basic_node
  * @brief node object of the graph data structure.
+ * @details Edge lists of EDGE_INDEX_THRESHOLD or more edges get a hash index
+ *          by endpoint, so has_edge and the removals stay O(1) on hub nodes.
+ *          Removing from an indexed list moves its last edge into the gap,
+ *          short lists keep their order.
  * @note Supports multigraph
  */
-class node
+template <typename Cost, typename Id>
+class basic_node
 {
 public:
     using size_type = std::size_t;
-    using edge_iterator = std::vector<edge*>::iterator;
-    using const_edge_iterator = std::vector<edge*>::const_iterator;
+    using id_type = Id;
+    using node = basic_node;
+    using edge = basic_edge<Cost, Id>;
+    using arc = basic_arc<Cost, Id>;
+    using edge_iterator = typename std::vector<edge*>::iterator;
+    using const_edge_iterator = typename std::vector<edge*>::const_iterator;
+
+    constexpr static size_type EDGE_INDEX_THRESHOLD = 32;
 
 public:
-    node(size_type id);
+    basic_node(id_type id);
     /**
      * @brief Construct a new node object with the given id and name.
+     * @details The node only references the name, the characters must outlive it.
      */
-    node(size_type id, std::string  name);
+    basic_node(id_type id, std::string_view name);
 
     /**
      * @brief Destroy the node object.
      */
-    ~node();
+    ~basic_node() = default;
 
     size_type degree() const { return m_edges.size(); }
 
     /**
      * @brief Get the id of the node.
      */
-    [[nodiscard]] inline size_type get_id() const { return m_id; };
+    [[nodiscard]] inline id_type get_id() const { return m_id; };
 
     /**
      * @brief Update the id of the node.
      */
-    void set_id(size_type id) { m_id = id; }
+    void set_id(id_type id) { m_id = id; }
 
     /**
      * @brief Get the name of the node.
      */
-    [[nodiscard]] inline const std::string& get_name() const { return m_name; }
+    [[nodiscard]] inline std::string_view get_name() const { return m_name; }
+
+    [[nodiscard]] inline edge* get_edge(size_type idx) { return m_edges[idx]; }
+    [[nodiscard]] inline const edge* get_edge(size_type idx) const { return m_edges[idx]; }
 
     /**
-     * @brief Update the name of the node.
+     * @brief Add the outgoing edge to the node.
+     * @details The edge is owned by the graph, the node only references it.
      */
-    inline void set_name(std::string name) {  m_name = std::move(name); }
+    inline void add_edge(edge* e);
 
-    [[nodiscard]] inline edge* get_edge(size_type idx) { return m_edges[idx]; }
-    [[nodiscard]] inline const edge* get_edge(size_type idx) const { return m_edges[idx]; }
+    /**
+     * @brief Reserve space for the given number of outgoing edges.
+     */
+    inline void reserve_edges(size_type count) { m_edges.reserve(count); }
 
     /**
-     * @brief Add edge to the destinaion node with the given cost.
-     * 
-     * @return pointer to edge if it was added successfully, otherwise nullptr.
+     * @brief Add the incoming edge to the node.
+     */
+    inline void add_in_edge(edge* e);
+
+    /**
+     * @brief Remove the incoming edge from the node.
+     */
+    inline void remove_in_edge(const edge* e);
+
+    /**
+     * @brief Remove the outgoing edge from the node.
+     */
+    inline void remove_out_edge(const edge* e);
+
+    /**
+     * @brief Drop all the incoming edges and release their memory.
      */
-    [[nodiscard]] edge* add_edge(node* to, edge::Cost_t cost = 1);
+    inline void clear_in_edges() { std::vector<edge*>().swap(m_inEdges); m_inEdgeIndex.reset(); }
+
+    /**
+     * @brief Reserve space for the given number of incoming edges.
+     */
+    inline void reserve_in_edges(size_type count) { m_inEdges.reserve(count); }
 
     /**
      * @brief Checks weather the edge exists from the current node to the given.
@@ -124,7 +571,7 @@ public:
     [[nodiscard]] inline bool has_edge(node* to) const;
 
     /**
-     * @brief Removes the edge if exists.
+     * @brief Removes the edge if exists, also from the incoming edges of its target.
      * @return true if the edge was removed, false if does not exist.
      */
     [[nodiscard]] inline bool remove_edge(node* to);
@@ -136,15 +583,17 @@ public:
      */
     void dump(std::ostream &os) const;
 
-    std::vector<edge*>::iterator begin_edges() { return m_edges.begin(); }
-    std::vector<edge*>::iterator end_edges() { return m_edges.end(); }
+    typename std::vector<edge*>::iterator begin_edges() { return m_edges.begin(); }
+    typename std::vector<edge*>::iterator end_edges() { return m_edges.end(); }
 
     const size_type get_num_of_edges() const { return m_edges.size(); }
     const std::vector<edge*>& get_edges() const { return m_edges; }
+    const std::vector<edge*>& get_in_edges() const { return m_inEdges; }
 
 public:
     /**
-     * @brief Iterator class of all the neighboring nodes.
+     * @brief Iterator class of all the neighboring nodes, the targets of the
+     *        outgoing edges or the sources of the incoming edges.
      */
     class node_iterator
     {
@@ -155,7 +604,7 @@ public:
         using pointer = node*;
         using reference = node&;
     public:
-        node_iterator(std::vector<edge*>::iterator iter);
+        node_iterator(typename std::vector<edge*>::iterator iter, bool incoming = false);
 
         ~node_iterator() = default;
 
@@ -169,11 +618,13 @@ public:
         pointer operator*() const;
 
     private:
-        std::vector<edge*>::iterator m_iter;
+        typename std::vector<edge*>::iterator m_iter;
+        bool m_incoming;
     };
 
     /**
-     * @brief Const iterator class of all the neighboring nodes.
+     * @brief Const iterator class of all the neighboring nodes, the targets of
+     *        the outgoing edges or the sources of the incoming edges.
      */
     class const_node_iterator
     {
@@ -186,7 +637,7 @@ public:
         using reference = node&;
         using const_reference = const node&;
     public:
-        const_node_iterator(std::vector<edge*>::const_iterator iter);
+        const_node_iterator(typename std::vector<edge*>::const_iterator iter, bool incoming = false);
 
         ~const_node_iterator() = default;
 
@@ -200,7 +651,37 @@ public:
         const_pointer operator*() const;
 
     private:
-        std::vector<edge*>::const_iterator m_iter;
+        typename std::vector<edge*>::const_iterator m_iter;
+        bool m_incoming;
+    };
+
+    /**
+     * @brief Const iterator of the outgoing edges as (target id, cost) arcs,
+     *        or of the incoming edges as (source id, cost) arcs.
+     */
+    class const_arc_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = arc;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const arc*;
+        using reference = arc;
+    public:
+        const_arc_iterator(typename std::vector<edge*>::const_iterator iter, bool incoming = false);
+
+        ~const_arc_iterator() = default;
+
+        const_arc_iterator& operator++();
+        const_arc_iterator operator++(int);
+
+        bool operator==(const const_arc_iterator& other) const;
+        bool operator!=(const const_arc_iterator& other) const;
+        value_type operator*() const;
+
+    private:
+        typename std::vector<edge*>::const_iterator m_iter;
+        bool m_incoming;
     };
 
     node_iterator begin_nodes() { return node_iterator(m_edges.begin()); }
@@ -212,16 +693,52 @@ public:
     const_node_iterator cbegin_nodes() const { return begin_nodes(); }
     const_node_iterator cend_nodes() const { return end_nodes(); }
 
+    node_iterator begin_in_nodes() { return node_iterator(m_inEdges.begin(), true); }
+    node_iterator end_in_nodes() { return node_iterator(m_inEdges.end(), true); }
+    const_node_iterator begin_in_nodes() const { return const_node_iterator(m_inEdges.cbegin(), true); }
+    const_node_iterator end_in_nodes() const { return const_node_iterator(m_inEdges.cend(), true); }
+
+    const_arc_iterator begin_arcs() const { return const_arc_iterator(m_edges.cbegin()); }
+    const_arc_iterator end_arcs() const { return const_arc_iterator(m_edges.cend()); }
+
+    const_arc_iterator begin_in_arcs() const { return const_arc_iterator(m_inEdges.cbegin(), true); }
+    const_arc_iterator end_in_arcs() const { return const_arc_iterator(m_inEdges.cend(), true); }
+
+private:
+    template <typename, typename>
+    friend class basic_graph;
+
+    /**
+     * @brief Update the name of the node.
+     * @details The node only references the name, so only the graph sets it
+     *          to a name interned in its name table.
+     */
+    inline void set_name(std::string_view name) { m_name = name; }
+
+    /**
+     * @brief Remove the edge at the position of the list, keep the index in sync.
+     */
+    template <typename Index>
+    static void erase_edge(std::vector<edge*>& edges, std::unique_ptr<Index>& index, size_type position);
+
 private:
-    size_type m_id;
-    std::string m_name;
+    id_type m_id;
+    std::string_view m_name;
     std::vector<edge*> m_edges;
+    std::vector<edge*> m_inEdges;
+    std::unique_ptr<edge_index<edge, true>> m_edgeIndex;     // outgoing edges by target
+    std::unique_ptr<edge_index<edge, false>> m_inEdgeIndex;  // incoming edges by source
 
 };
 
+using edge = basic_edge<int, std::size_t>;
+using arc = basic_arc<int, std::size_t>;
+using node = basic_node<int, std::size_t>;
+
 }
 
-std::ostream& operator<<(std::ostream& os, const impl::node* node);
+template <typename Cost, typename Id>
+std::ostream& operator<<(std::ostream& os, const impl::basic_node<Cost, Id>* node);
 
 ////////////////////////////////////////////////////////////////////////////////
 ////  Includes  ////////////////////////////////////////////////////////////////
@@ -230,17 +747,21 @@ std::ostream& operator<<(std::ostream& os, const impl::node* node);
 namespace impl
 {
 
-node::node_iterator::node_iterator(std::vector<edge*>::iterator iter)
+template <typename Cost, typename Id>
+basic_node<Cost, Id>::node_iterator::node_iterator(typename std::vector<edge*>::iterator iter, bool incoming)
     : m_iter(iter)
+    , m_incoming(incoming)
 { }
 
-node::node_iterator& node::node_iterator::operator++()
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::node_iterator& basic_node<Cost, Id>::node_iterator::operator++()
 {
     ++m_iter;
     return *this;
 }
 
-node::node_iterator node::node_iterator::operator++(int)
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::node_iterator basic_node<Cost, Id>::node_iterator::operator++(int)
 {
     node_iterator temp{*this};
     ++m_iter;
@@ -249,34 +770,41 @@ node::node_iterator node::node_iterator::operator++(int)
 
 //! NOTE: if iter_types are the same, and if nodes they point to
 //        are the same, they are equal
-bool node::node_iterator::operator==(const node_iterator& other) const
+template <typename Cost, typename Id>
+bool basic_node<Cost, Id>::node_iterator::operator==(const node_iterator& other) const
 {
     return m_iter == other.m_iter;
 }
 
-bool node::node_iterator::operator!=(const node_iterator& other) const
+template <typename Cost, typename Id>
+bool basic_node<Cost, Id>::node_iterator::operator!=(const node_iterator& other) const
 {
     return m_iter != other.m_iter;
 }
 
-node::node_iterator::pointer node::node_iterator::operator*() const
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::node_iterator::pointer basic_node<Cost, Id>::node_iterator::operator*() const
 {
-    return (*m_iter)->get_to();
+    return m_incoming ? (*m_iter)->get_from() : (*m_iter)->get_to();
 }
 
 ///////////////////////////////
 
-node::const_node_iterator::const_node_iterator(std::vector<edge*>::const_iterator iter)
+template <typename Cost, typename Id>
+basic_node<Cost, Id>::const_node_iterator::const_node_iterator(typename std::vector<edge*>::const_iterator iter, bool incoming)
     : m_iter(iter)
+    , m_incoming(incoming)
 { }
 
-node::const_node_iterator& node::const_node_iterator::operator++()
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::const_node_iterator& basic_node<Cost, Id>::const_node_iterator::operator++()
 {
     ++m_iter;
     return *this;
 }
 
-node::const_node_iterator node::const_node_iterator::operator++(int)
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::const_node_iterator basic_node<Cost, Id>::const_node_iterator::operator++(int)
 {
     const_node_iterator temp{*this};
     ++m_iter;
@@ -285,58 +813,110 @@ node::const_node_iterator node::const_node_iterator::operator++(int)
 
 //! NOTE: if iter_types are the same, and if nodes they point to
 //        are the same, they are equal
-bool node::const_node_iterator::operator==(const const_node_iterator& other) const
+template <typename Cost, typename Id>
+bool basic_node<Cost, Id>::const_node_iterator::operator==(const const_node_iterator& other) const
 {
     return m_iter == other.m_iter;
 }
 
-bool node::const_node_iterator::operator!=(const const_node_iterator& other) const
+template <typename Cost, typename Id>
+bool basic_node<Cost, Id>::const_node_iterator::operator!=(const const_node_iterator& other) const
 {
     return m_iter != other.m_iter;
 }
 
-node::const_node_iterator::const_pointer node::const_node_iterator::operator*() const
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::const_node_iterator::const_pointer basic_node<Cost, Id>::const_node_iterator::operator*() const
 {
-    return (*m_iter)->get_to();
+    const edge* e = *m_iter;
+    return m_incoming ? e->get_from() : e->get_to();
 }
 
-}
+///////////////////////////////
 
-namespace impl
-{
+template <typename Cost, typename Id>
+basic_node<Cost, Id>::const_arc_iterator::const_arc_iterator(typename std::vector<edge*>::const_iterator iter, bool incoming)
+    : m_iter(iter)
+    , m_incoming(incoming)
+{ }
 
-inline size_t edge::get_from_idx() const noexcept
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::const_arc_iterator& basic_node<Cost, Id>::const_arc_iterator::operator++()
 {
-    return m_from->get_id();
+    ++m_iter;
+    return *this;
 }
 
-inline size_t edge::get_to_idx() const noexcept
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::const_arc_iterator basic_node<Cost, Id>::const_arc_iterator::operator++(int)
 {
-    return m_to->get_id();
-}
+    const_arc_iterator temp{*this};
+    ++m_iter;
+    return temp;
+}
+
+template <typename Cost, typename Id>
+bool basic_node<Cost, Id>::const_arc_iterator::operator==(const const_arc_iterator& other) const
+{
+    return m_iter == other.m_iter;
+}
+
+template <typename Cost, typename Id>
+bool basic_node<Cost, Id>::const_arc_iterator::operator!=(const const_arc_iterator& other) const
+{
+    return m_iter != other.m_iter;
+}
+
+template <typename Cost, typename Id>
+typename basic_node<Cost, Id>::const_arc_iterator::value_type basic_node<Cost, Id>::const_arc_iterator::operator*() const
+{
+    const edge* e = *m_iter;
+    return arc{m_incoming ? e->get_from_idx() : e->get_to_idx(), e->get_cost()};
+}
+
+}
 
-bool edge::compare(const edge* e) const noexcept
+namespace impl
+{
+
+template <typename Cost, typename Id>
+inline Id basic_edge<Cost, Id>::get_from_idx() const noexcept
+{
+    return m_from->get_id();
+}
+
+template <typename Cost, typename Id>
+inline Id basic_edge<Cost, Id>::get_to_idx() const noexcept
+{
+    return m_to->get_id();
+}
+
+template <typename Cost, typename Id>
+bool basic_edge<Cost, Id>::compare(const basic_edge* e) const noexcept
 {
     assert(nullptr != e);
-    return (m_from == e->m_from && m_to == e->m_to && m_cost == e->m_cost);
+    // By id, so that edges of different graphs compare
+    return (m_from->get_id() == e->m_from->get_id() && m_to->get_id() == e->m_to->get_id()
+            && get_cost() == e->get_cost());
 }
 
-node::node(size_type id)
+template <typename Cost, typename Id>
+basic_node<Cost, Id>::basic_node(id_type id)
     : m_id(id)
 { }
 
-node::node(size_type id, std::string name)
+template <typename Cost, typename Id>
+basic_node<Cost, Id>::basic_node(id_type id, std::string_view name)
     : m_id(id)
-    , m_name(std::move(name))
+    , m_name(name)
 { }
 
-node::~node()
-{
-    std::destroy(m_edges.begin(), m_edges.end());
-}
-
-inline bool node::has_edge(node* to) const
+template <typename Cost, typename Id>
+inline bool basic_node<Cost, Id>::has_edge(node* to) const
 {
+    if (m_edgeIndex) {
+        return edge_index<edge, true>::NOT_FOUND != m_edgeIndex->find(to);
+    }
     for (const edge* edge : m_edges) {
         if (to == edge->get_to()) {
             return true;
@@ -345,32 +925,110 @@ inline bool node::has_edge(node* to) const
     return false;
 }
 
-edge* node::add_edge(node* to, edge::Cost_t cost)
+template <typename Cost, typename Id>
+inline void basic_node<Cost, Id>::add_edge(edge* e)
 {
-    // if (std::find(m_edges.begin(), m_edges.end(), edge) != m_edges.end()) {
-    //     return false;
-    // }
+    assert(this == e->get_from());
     // (from, to) can repeat - supports multigraph (not sure if I need this)
-    edge* e = new edge(this, to, cost);
     m_edges.push_back(e);
-    return e;
+    if (m_edgeIndex) {
+        m_edgeIndex->insert(e, m_edges.size() - 1);
+    } else if (m_edges.size() >= EDGE_INDEX_THRESHOLD) {
+        m_edgeIndex = std::make_unique<edge_index<edge, true>>(m_edges);
+    }
 }
 
-bool node::remove_edge(node* to)
+template <typename Cost, typename Id>
+inline void basic_node<Cost, Id>::add_in_edge(edge* e)
 {
-    for (auto it = m_edges.begin(); it != m_edges.end(); ++it) {
-        if (to == (*it)->get_to()) {
-            m_edges.erase(it);
-            return true;
+    assert(this == e->get_to());
+    m_inEdges.push_back(e);
+    if (m_inEdgeIndex) {
+        m_inEdgeIndex->insert(e, m_inEdges.size() - 1);
+    } else if (m_inEdges.size() >= EDGE_INDEX_THRESHOLD) {
+        m_inEdgeIndex = std::make_unique<edge_index<edge, false>>(m_inEdges);
+    }
+}
+
+template <typename Cost, typename Id>
+template <typename Index>
+void basic_node<Cost, Id>::erase_edge(std::vector<edge*>& edges, std::unique_ptr<Index>& index, size_type position)
+{
+    if (!index) {
+        edges.erase(edges.begin() + static_cast<std::ptrdiff_t>(position));
+        return;
+    }
+    index->erase(edges[position]);
+    if (position + 1 != edges.size()) {
+        edges[position] = edges.back();
+        index->move(edges[position], position);
+    }
+    edges.pop_back();
+    // Hysteresis, so that a degree around the threshold does not rebuild every time
+    if (edges.size() < EDGE_INDEX_THRESHOLD / 4) {
+        index.reset();
+    }
+}
+
+template <typename Cost, typename Id>
+inline void basic_node<Cost, Id>::remove_in_edge(const edge* e)
+{
+    if (m_inEdgeIndex) {
+        const size_type position = m_inEdgeIndex->find(e);
+        if (edge_index<edge, false>::NOT_FOUND != position) {
+            erase_edge(m_inEdges, m_inEdgeIndex, position);
         }
+        return;
     }
-    return false;
+    auto it = std::find(m_inEdges.begin(), m_inEdges.end(), e);
+    if (it != m_inEdges.end()) {
+        m_inEdges.erase(it);
+    }
+}
+
+template <typename Cost, typename Id>
+inline void basic_node<Cost, Id>::remove_out_edge(const edge* e)
+{
+    if (m_edgeIndex) {
+        const size_type position = m_edgeIndex->find(e);
+        if (edge_index<edge, true>::NOT_FOUND != position) {
+            erase_edge(m_edges, m_edgeIndex, position);
+        }
+        return;
+    }
+    auto it = std::find(m_edges.begin(), m_edges.end(), e);
+    if (it != m_edges.end()) {
+        m_edges.erase(it);
+    }
+}
+
+template <typename Cost, typename Id>
+bool basic_node<Cost, Id>::remove_edge(node* to)
+{
+    size_type position = m_edges.size();
+    if (m_edgeIndex) {
+        position = std::min(position, m_edgeIndex->find(to));
+    } else {
+        for (size_type i = 0; i < m_edges.size(); ++i) {
+            if (to == m_edges[i]->get_to()) {
+                position = i;
+                break;
+            }
+        }
+    }
+    if (position == m_edges.size()) {
+        return false;
+    }
+    to->remove_in_edge(m_edges[position]);
+    erase_edge(m_edges, m_edgeIndex, position);
+    return true;
 }
 
-bool node::compare(const node* n) const
+template <typename Cost, typename Id>
+bool basic_node<Cost, Id>::compare(const node* n) const
 {
     assert(nullptr != n);
-    if (degree() != n->degree()) {
+    if (get_name() != n->get_name() || degree() != n->degree()) {
         return false;
     }
     for (size_type i = 0; i < degree(); ++i) {
@@ -383,7 +1041,8 @@ bool node::compare(const node* n) const
     return true;
 }
 
-void node::dump(std::ostream &os) const
+template <typename Cost, typename Id>
+void basic_node<Cost, Id>::dump(std::ostream &os) const
 {
     os << this << ":" << std::endl;
     for (auto& edge : m_edges) {
@@ -394,7 +1053,8 @@ void node::dump(std::ostream &os) const
 
 }
 
-std::ostream& operator<<(std::ostream& os, const impl::node* node)
+template <typename Cost, typename Id>
+std::ostream& operator<<(std::ostream& os, const impl::basic_node<Cost, Id>* node)
 {
     if (nullptr == node) {
         os << "'nullptr'";
@@ -404,469 +1064,5396 @@ std::ostream& operator<<(std::ostream& os, const impl::node* node)
     return os;
 }
 
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace impl
+{
+
+/**
+ * @brief Strongly connected components of a graph.
+ * @details Nodes reach each other if and only if they have the same
+ *          component. Component c is node c of the condensation, where
+ *          u reaches v if and only if component(u) reaches component(v).
+ */
+template <typename Id = std::size_t>
+struct scc_result
+{
+    using size_type = std::size_t;
+
+    constexpr static Id INVALID_ID = std::numeric_limits<Id>::max();
+
+    /// component of every node id, INVALID_ID for removed ids
+    std::vector<Id> components;
+    /// number of nodes of every component
+    std::vector<Id> sizes;
+
+    /**
+     * @brief Return number of components.
+     */
+    [[nodiscard]] inline size_type count() const noexcept { return sizes.size(); }
+};
+
+}
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <vector>
+
 namespace impl
 {
 
 /**
- * @class graph
- * @brief Class representing a graph data structure.
- * 
- * @todo Add API to take iterators.
+ * @brief Shortest path between two nodes.
  */
-class graph
+template <typename Cost, typename Id = std::size_t>
+struct shortest_path_result
 {
-public:
-    //using value_type                = ;
-    using size_type                 = std::size_t;
+    using size_type = std::size_t;
 
-private:
-    constexpr static size_type INVALID_ID = std::numeric_limits<size_type>::max();
+    /// cost of the path, infinity of Cost if the target is not reachable
+    Cost cost = cost_traits<Cost>::infinity();
+    /// ids of the nodes on the path from the source to the target, empty if not reachable
+    std::vector<Id> nodes;
+    /// number of nodes settled by the search
+    size_type settled = 0;
+};
+
+/**
+ * @brief Levels and parents of a breadth first search.
+ */
+template <typename Id = std::size_t>
+struct bfs_result
+{
+    constexpr static Id INVALID_ID = std::numeric_limits<Id>::max();
+
+    /// number of edges from the source, INVALID_ID if not reachable
+    std::vector<Id> levels;
+    /// node that reached the node, INVALID_ID for the source and if not reachable
+    std::vector<Id> parents;
+};
 
+/**
+ * @class shortest_path_tree
+ * @brief Costs and predecessors of single source shortest paths.
+ * @details Node i is reached from predecessor(i), optionally through the
+ *          predecessor_edge(i)-th outgoing edge of the predecessor. Paths are
+ *          walked back from the target lazily, without allocating.
+ */
+template <typename Cost, typename Id = std::size_t>
+class shortest_path_tree
+{
 public:
-    using node_iterator = std::vector<node*>::iterator;
-    using const_node_iterator = std::vector<node*>::const_iterator;
-    using neighbor_node_iterator = node::node_iterator;
-    using const_neighbor_node_iterator = node::const_node_iterator;
-    using edge_iterator = std::vector<const edge*>::iterator;
-    using const_edge_iterator = std::vector<const edge*>::const_iterator;
+    using size_type                 = std::size_t;
+    using id_type                   = Id;
+    using cost_type                 = Cost;
+
+    constexpr static id_type INVALID_ID = std::numeric_limits<id_type>::max();
+    constexpr static cost_type INF_COST = cost_traits<cost_type>::infinity();
 
 public:
     /**
-     * @brief Construct a new empty graph object that doesn't have any nodes or edges.
+     * @brief Iterator over the nodes of a path, from the target back to the source.
      */
-    graph();
+    class path_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = id_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const id_type*;
+        using reference = id_type;
+    public:
+        path_iterator(const id_type* predecessors, id_type id);
 
-    graph(graph&& other);
+        ~path_iterator() = default;
 
-    /**
-     * @brief Destroy the graph object
-     */
-    ~graph();
+        path_iterator& operator++();
+        path_iterator operator++(int);
 
-    void clear();
+        bool operator==(const path_iterator& other) const;
+        bool operator!=(const path_iterator& other) const;
+        value_type operator*() const;
 
-    /**
-     * @brief Return number of nodes in the graph.
-     */
-    [[nodiscard]] inline size_type size() const noexcept;
+    private:
+        const id_type* m_predecessors;
+        id_type m_id;
+    };
+
+    using path_range = iterator_range<path_iterator>;
 
+public:
     /**
-     * @brief Return number of edges in the graph.
+     * @brief Construct a tree of size nodes where only the source is reached.
+     * @param withEdges also record the predecessor edge of every node.
      */
-    [[nodiscard]] inline size_type num_of_edges() const noexcept { return m_edges.size(); }
+    shortest_path_tree(size_type size, size_type source, bool withEdges = false);
 
     /**
-     * @brief Returns true if the graph is empty, false otherwise.
+     * @brief Return number of nodes.
      */
-    [[nodiscard]] inline bool empty() const noexcept;
+    [[nodiscard]] inline size_type size() const noexcept { return m_costs.size(); }
 
     /**
-     * @brief Return true if the name already maps to a node, false otherwise.
+     * @brief Return id of the source node.
      */
-    [[nodiscard]] inline bool contains(const std::string& name) const;
+    [[nodiscard]] inline id_type source() const noexcept { return m_source; }
 
     /**
-     * @brief Create a new node and add it to the graph.
-     * @details Name must be a hashable type.
-     * 
-     * @return value indicates if a node was actually added, true means a new
-     *  node was created and added, false means that a node with that name already
-     *  exists in this graph, and it was not overwritten.
+     * @brief Return cost of the shortest path to the node, INF_COST if not reached.
      */
-    bool add_node(const std::string& name);
+    [[nodiscard]] inline cost_type cost(size_type id) const { return m_costs[id]; }
 
     /**
-     * @brief Removes the node with the given name
-     * 
-     * @return value indicates if the node was actually removed, true means name
-     *         maped to a node, and the node was removed, false otherwise.
+     * @brief Return costs of the shortest paths to all nodes.
      */
-    bool remove_node(const std::string& name);
+    [[nodiscard]] inline const std::vector<cost_type>& costs() const noexcept { return m_costs; }
 
     /**
-     * @brief Return true if a connection or path exists between from and to nodes.
+     * @brief Returns true if the node is reached from the source, false otherwise.
      */
-    [[nodiscard]] inline bool has_edge(const std::string& from, const std::string& to);
+    [[nodiscard]] inline bool reachable(size_type id) const { return INF_COST != m_costs[id]; }
 
     /**
-     * @brief Create an edge between from and to with the provided weight.
-     * @details If either of the names is not already a member of the graph,
-     *          create that node and add it to the graph first.
-     * 
-     * @return true if the edge was added successfully, false if the edge already
-     *          exists (nothing happens in this case).
+     * @brief Return the node preceding the node on its shortest path,
+     *        INVALID_ID for the source and not reached nodes.
      */
-    bool add_edge(const std::string& from, const std::string& to, edge::Cost_t cost = 1);
+    [[nodiscard]] inline id_type predecessor(size_type id) const { return m_predecessors[id]; }
 
     /**
-     * @brief Removes the edge between from and to nodes.
-     * 
-     * @return true if the edge existed and was removed successfully, false if
-     *         either nodes or the edge was not found.
+     * @brief Returns true if predecessor edges are recorded, false otherwise.
      */
-    bool remove_edge(const std::string& from, const std::string& to);
-
-    [[nodiscard]] bool compare(const graph* g) const;
-
-    neighbor_node_iterator begin_neighbors(node* start) { return start->begin_nodes(); };
-    neighbor_node_iterator begin_neighbors(const std::string& name) { return begin_neighbors(get_node(name)); };
-    neighbor_node_iterator end_neighbors(node* start) { return start->end_nodes(); };
-    neighbor_node_iterator end_neighbors(const std::string& name) { return end_neighbors(get_node(name)); };
-    const_neighbor_node_iterator begin_neighbors(const node* start) const { return start->cbegin_nodes(); };
-    const_neighbor_node_iterator begin_neighbors(const std::string& name) const { return begin_neighbors(get_node(name)); };
-    const_neighbor_node_iterator end_neighbors(const node* start) const { return start->cend_nodes(); };
-    const_neighbor_node_iterator end_neighbors(const std::string& name) const { return end_neighbors(get_node(name)); };
-    const_neighbor_node_iterator cbegin_neighbors(const std::string& name) const { return begin_neighbors(name); };
-    const_neighbor_node_iterator cend_neighbors(const std::string& name) const { return end_neighbors(name); };
+    [[nodiscard]] inline bool has_predecessor_edges() const noexcept { return !m_edges.empty(); }
 
     /**
-     * @brief Return an iterator that yields the node names (in no particular order).
+     * @brief Return position of the edge to the node among the outgoing edges
+     *        of its predecessor, INVALID_ID if there is none or edges are not recorded.
      */
-    node_iterator begin_nodes() { return m_adjList.begin(); }
-    node_iterator end_nodes() { return m_adjList.end(); }
-    const_node_iterator begin_nodes() const { return m_adjList.cbegin(); }
-    const_node_iterator end_nodes() const { return m_adjList.cend(); }
-    const_node_iterator cbegin_nodes() const { return begin_nodes(); }
-    const_node_iterator cend_nodes() const { return end_nodes(); }
+    [[nodiscard]] inline size_type predecessor_edge(size_type id) const
+    {
+        return has_predecessor_edges() ? m_edges[id] : INVALID_ID;
+    }
 
     /**
-     * @brief Return all the edges as an iterator of Edges (named tuples) with values
-     *        (from, to, weight). Edges are yielded in no particular order.
+     * @brief Return nodes of the shortest path from the target back to the
+     *        source, empty if the target is not reached.
      */
-    //edge_iterator edges() const;
+    [[nodiscard]] path_range path(size_type target) const;
 
     /**
-     * @brief Dumps the graph object to ostream.
+     * @brief Record that the node is reached through the rank-th edge of from.
      */
-    void dump(std::ostream& os) const;
+    inline void relax(size_type id, cost_type cost, size_type from, size_type rank);
 
-    void serialize(const std::string& fileName) const;
-    void deserialize(const std::string& fileName);
+private:
+    id_type m_source;
+    std::vector<cost_type> m_costs;
+    std::vector<id_type> m_predecessors;
+    std::vector<size_type> m_edges;
+
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace impl
+{
+
+////////////////////////////////////////////////////////////////////////////////
+///// shortest_path_tree::path_iterator
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+shortest_path_tree<Cost, Id>::path_iterator::path_iterator(const id_type* predecessors, id_type id)
+    : m_predecessors(predecessors)
+    , m_id(id)
+{ }
+
+template <typename Cost, typename Id>
+typename shortest_path_tree<Cost, Id>::path_iterator& shortest_path_tree<Cost, Id>::path_iterator::operator++()
+{
+    m_id = m_predecessors[m_id];
+    return *this;
+}
+
+template <typename Cost, typename Id>
+typename shortest_path_tree<Cost, Id>::path_iterator shortest_path_tree<Cost, Id>::path_iterator::operator++(int)
+{
+    path_iterator temp{*this};
+    ++*this;
+    return temp;
+}
+
+template <typename Cost, typename Id>
+bool shortest_path_tree<Cost, Id>::path_iterator::operator==(const path_iterator& other) const
+{
+    return m_id == other.m_id;
+}
+
+template <typename Cost, typename Id>
+bool shortest_path_tree<Cost, Id>::path_iterator::operator!=(const path_iterator& other) const
+{
+    return m_id != other.m_id;
+}
+
+template <typename Cost, typename Id>
+typename shortest_path_tree<Cost, Id>::path_iterator::value_type shortest_path_tree<Cost, Id>::path_iterator::operator*() const
+{
+    return m_id;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///// shortest_path_tree
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+shortest_path_tree<Cost, Id>::shortest_path_tree(size_type size, size_type source, bool withEdges)
+    : m_source(source)
+    , m_costs(size, INF_COST)
+    , m_predecessors(size, INVALID_ID)
+    , m_edges(withEdges ? size : 0, INVALID_ID)
+{
+    m_costs[source] = 0;
+}
+
+template <typename Cost, typename Id>
+typename shortest_path_tree<Cost, Id>::path_range shortest_path_tree<Cost, Id>::path(size_type target) const
+{
+    const id_type first = reachable(target) ? static_cast<id_type>(target) : INVALID_ID;
+    return path_range(path_iterator(m_predecessors.data(), first),
+                      path_iterator(m_predecessors.data(), INVALID_ID));
+}
+
+template <typename Cost, typename Id>
+inline void shortest_path_tree<Cost, Id>::relax(size_type id, cost_type cost, size_type from, size_type rank)
+{
+    m_costs[id] = cost;
+    m_predecessors[id] = static_cast<id_type>(from);
+    if (has_predecessor_edges()) {
+        m_edges[id] = rank;
+    }
+}
+
+}
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace impl
+{
+
+/**
+ * @class thread_pool
+ * @brief Fixed set of worker threads running one job at a time.
+ * @details The calling thread takes part in every job as worker 0, so a pool
+ *          of one thread runs everything inline without spawning threads.
+ *          The first exception thrown by a worker is rethrown to the caller.
+ */
+class thread_pool
+{
+public:
+    using size_type                 = std::size_t;
 
 public:
-    ///@{ @name Algorithms
-    /// @brief Algorithms to work with the graph.
     /**
-     * @brief What is a Mother Vertex?
-     * @details A mother vertex in a graph G = (V,E) is a vertex v such that all
-     *          other vertices in G can be reached by a path from v.
-     * 
-     * @return const pointer to mother node if found, otherwise nullptr.
+     * @brief Start the workers.
+     * @param numOfThreads total number of threads including the caller,
+     *        0 means std::thread::hardware_concurrency().
      */
-    [[nodiscard]] const node* mother_node() const;
+    explicit thread_pool(size_type numOfThreads = 0);
+
     /**
-     * @brief Count the total number of ways or paths that exist between two vertices in a directed graph.
-     * @details These paths don’t contain a cycle, the simple enough reason is
-     *          that a cycle contains an infinite number of paths and hence they create a problem.
+     * @brief Stop and join the workers.
      */
-    [[nodiscard]] size_type num_of_paths(const node* from, const node* to) const;
+    ~thread_pool();
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
 
     /**
-     * @brief Given a directed graph, check whether the graph contains a cycle or not.
+     * @brief Return number of threads including the caller.
      */
-    [[nodiscard]] bool is_cyclic() const;
+    [[nodiscard]] inline size_type size() const noexcept { return m_threads.size() + 1; }
 
     /**
-     * @brief Given a graph and a source vertex in the graph, find shortest paths
-     *        from source to all vertices in the given graph.
-     * 
-     * @return vector of costs from source to all nodes.
+     * @brief Call job(worker) once on every worker and wait for all of them.
      */
-    [[nodiscard]] std::vector<edge::Cost_t> dijkstra(size_type start) const;
+    template <typename Job>
+    void run(Job&& job);
 
     /**
-     * @brief Given a directed graph, check whether the graph contains a negative cycle or not.
+     * @brief Split [0, count) into blocks and call job(first, last, worker)
+     *        for each of them, blocks are handed out dynamically.
+     * @param grain size of the blocks, 0 picks one from count and size().
      */
-    [[nodiscard]] bool has_negative_cycle() const;
-    ///@}
+    template <typename Job>
+    void parallel_for(size_type count, Job&& job, size_type grain = 0);
 
 private:
-    ///@{ @name Algorithms Utils
-    bool is_cyclic_util(size_type i, std::vector<bool>& visited, std::vector<bool>& stack) const;
-    ///@}
+    void run_job(const std::function<void(size_type)>& job);
+    void worker_loop(size_type worker);
 
-public:
-    /**
-     * @class iterator
-     * @brief Iterator class to provide DFS and BFS traversal functionality.
-     */
-    class iterator
-    {
-    public:
-        using iterator_category = std::forward_iterator_tag;
-        using value_type = node;
-        using difference_type = size_t;
-        using pointer = node*;
-        using const_pointer = const node*;
-        using reference = node&;
-        using const_reference = const node&;
-    public:
-        enum class iter_type
+private:
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    const std::function<void(size_type)>* m_job = nullptr;
+    size_type m_generation = 0;
+    size_type m_pending = 0;
+    bool m_stop = false;
+    std::exception_ptr m_error;
+
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+
+namespace impl
+{
+
+inline thread_pool::thread_pool(size_type numOfThreads)
+{
+    if (0 == numOfThreads) {
+        numOfThreads = std::max<size_type>(1, std::thread::hardware_concurrency());
+    }
+    m_threads.reserve(numOfThreads - 1);
+    for (size_type worker = 1; worker < numOfThreads; ++worker) {
+        m_threads.emplace_back(&thread_pool::worker_loop, this, worker);
+    }
+}
+
+inline thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_start.notify_all();
+    for (std::thread& t : m_threads) {
+        t.join();
+    }
+}
+
+template <typename Job>
+void thread_pool::run(Job&& job)
+{
+    const std::function<void(size_type)> f = [&job](size_type worker) { job(worker); };
+    run_job(f);
+}
+
+template <typename Job>
+void thread_pool::parallel_for(size_type count, Job&& job, size_type grain)
+{
+    if (0 == count) {
+        return;
+    }
+    if (0 == grain) {
+        // A few blocks per thread balance the load without much contention
+        grain = std::max<size_type>(1, count / (8 * size()));
+    }
+    if (1 == size() || count <= grain) {
+        job(size_type{0}, count, size_type{0});
+        return;
+    }
+
+    std::atomic<size_type> next{0};
+    run([&](size_type worker) {
+        for (;;) {
+            const size_type first = next.fetch_add(grain, std::memory_order_relaxed);
+            if (first >= count) {
+                break;
+            }
+            job(first, std::min(first + grain, count), worker);
+        }
+    });
+}
+
+inline void thread_pool::run_job(const std::function<void(size_type)>& job)
+{
+    if (m_threads.empty()) {
+        job(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_pending = m_threads.size();
+        m_error = nullptr;
+        ++m_generation;
+    }
+    m_start.notify_all();
+
+    std::exception_ptr error;
+    try {
+        job(0);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return 0 == m_pending; });
+    m_job = nullptr;
+    if (nullptr == error) {
+        error = m_error;
+    }
+    lock.unlock();
+
+    if (nullptr != error) {
+        std::rethrow_exception(error);
+    }
+}
+
+inline void thread_pool::worker_loop(size_type worker)
+{
+    size_type generation = 0;
+    for (;;) {
+        const std::function<void(size_type)>* job = nullptr;
         {
-            DFS,
-            BFS
-        };
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start.wait(lock, [&] { return m_stop || generation != m_generation; });
+            if (m_stop) {
+                return;
+            }
+            generation = m_generation;
+            job = m_job;
+        }
 
-    public:
-        explicit iterator(const graph& g, node* n, iter_type type);
-        ~iterator() = default;
+        std::exception_ptr error;
+        try {
+            (*job)(worker);
+        } catch (...) {
+            error = std::current_exception();
+        }
 
-        iterator& operator++();
-        iterator operator++(int);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (nullptr != error && nullptr == m_error) {
+                m_error = error;
+            }
+            --m_pending;
+        }
+        m_done.notify_one();
+    }
+}
 
-        //! NOTE: if iter_types are the same, and if nodes they point to
-        //        are the same, they are equal
-        bool operator==(const iterator& other) const;
-        bool operator!=(const iterator& other) const;
-        reference operator*() const;
+}
 
-        [[nodiscard]] inline bool is_BFS() const noexcept { return iter_type::BFS == m_type; }
-        [[nodiscard]] inline bool is_DFS() const noexcept { return iter_type::DFS == m_type; }
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
 
-    private:
-        void collect_nodes();
+namespace impl
+{
 
-    private:
-        iter_type m_type;
-        node* m_node; // nullptr means the end of the graph
-        std::vector<bool> m_visited;
-        std::deque<node*> m_deque;
+/**
+ * @class traversal_workspace
+ * @brief Visited marks, frontier and DFS path of a graph traversal, reusable without allocation.
+ * @details A node is visited if its stamp is the current epoch, and finished
+ *          if its stamp is the epoch + 1, so reset() forgets all the marks by
+ *          bumping the epoch instead of clearing them. The frontier holds every node at most once per traversal,
+ *          nodes are taken from its front for BFS and from its back for DFS.
+ *          The path is the frame stack of the iterative DFS, its frames hold
+ *          arc iterators of the graph, so it is typed on first use.
+ *          Memory only grows, to the largest graph the workspace was reset for.
+ */
+class traversal_workspace
+{
+public:
+    using size_type                 = std::size_t;
+    using epoch_type                = std::uint32_t;
+
+public:
+    traversal_workspace() = default;
+
+    /**
+     * @brief Start a new traversal of ids in [0, numOfIds): no node is
+     *        visited and the frontier is empty.
+     */
+    inline void reset(size_type numOfIds);
+
+    /**
+     * @brief Mark the id as visited.
+     * @return true if it was not visited before, false otherwise.
+     */
+    inline bool visit(size_type id) noexcept;
+
+    /**
+     * @brief Returns true if the id was visited since the last reset, false otherwise.
+     */
+    [[nodiscard]] inline bool visited(size_type id) const noexcept { return static_cast<epoch_type>(m_stamps[id] - m_epoch) <= 1; }
+
+    /**
+     * @brief Mark the visited id as finished, all of its descendants are done.
+     */
+    inline void finish(size_type id) noexcept { m_stamps[id] = m_epoch + 1; }
+
+    /**
+     * @brief Returns true if the id was finished since the last reset, false otherwise.
+     */
+    [[nodiscard]] inline bool finished(size_type id) const noexcept { return m_epoch + 1 == m_stamps[id]; }
+
+    ///@{ @name Frontier
+    [[nodiscard]] inline bool empty() const noexcept { return m_head == m_frontier.size(); }
+    [[nodiscard]] inline size_type size() const noexcept { return m_frontier.size() - m_head; }
+    inline void push(size_type id) { m_frontier.push_back(id); }
+    [[nodiscard]] inline size_type pop_front() noexcept { return m_frontier[m_head++]; }
+    [[nodiscard]] inline size_type pop_back() noexcept;
+    ///@}
+
+    /**
+     * @brief Return the empty DFS frame stack, its memory is kept between traversals.
+     * @details All the traversals of a graph use the same Frame, another Frame
+     *          replaces the stack.
+     */
+    template <typename Frame>
+    [[nodiscard]] inline std::vector<Frame>& path();
+
+    /**
+     * @brief Return the bytes reserved by the stamps, the frontier and the path.
+     */
+    [[nodiscard]] inline size_type capacity_bytes() const noexcept;
+
+private:
+    struct path_base
+    {
+        virtual ~path_base() = default;
+        [[nodiscard]] virtual size_type capacity_bytes() const noexcept = 0;
     };
 
-    class const_iterator
+    template <typename Frame>
+    struct typed_path : path_base
+    {
+        [[nodiscard]] size_type capacity_bytes() const noexcept override { return frames.capacity() * sizeof(Frame); }
+
+        std::vector<Frame> frames;
+    };
+
+    template <typename Frame>
+    [[nodiscard]] inline static const void* key_of() noexcept
+    {
+        static const char key = 0;
+        return &key;
+    }
+
+private:
+    std::vector<epoch_type> m_stamps;
+    std::vector<size_type> m_frontier;
+    size_type m_head = 0;
+    epoch_type m_epoch = 0;
+    std::unique_ptr<path_base> m_path;
+    const void* m_pathKey = nullptr;    // key_of the Frame of m_path
+
+};
+
+/**
+ * @class workspace_pool
+ * @brief Traversal workspaces of a graph, lent to iterators and algorithms.
+ * @details A workspace is free again once every copy of the pointer that
+ *          borrowed it is gone, so the same few workspaces serve all the
+ *          traversals that do not overlap. Borrowing is thread safe. Copies
+ *          and moves of the pool are empty, workspaces are never shared
+ *          between graphs.
+ */
+class workspace_pool
+{
+public:
+    using workspace_ptr             = std::shared_ptr<traversal_workspace>;
+
+public:
+    workspace_pool() = default;
+    workspace_pool(const workspace_pool&) noexcept { }
+    workspace_pool& operator=(const workspace_pool&) noexcept { return *this; }
+
+    /**
+     * @brief Return a workspace no one else is using, reset for numOfIds ids.
+     */
+    [[nodiscard]] inline workspace_ptr borrow(std::size_t numOfIds);
+
+private:
+    std::mutex m_mutex;
+    std::vector<workspace_ptr> m_workspaces;
+
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+
+namespace impl
+{
+
+////////////////////////////////////////////////////////////////////////////////
+///// traversal_workspace
+////////////////////////////////////////////////////////////////////////////////
+inline void traversal_workspace::reset(size_type numOfIds)
+{
+    if (m_stamps.size() < numOfIds) {
+        m_stamps.resize(numOfIds, 0);
+        m_frontier.reserve(numOfIds);
+    }
+    // Every traversal takes two stamps, visited and finished
+    m_epoch += 2;
+    if (0 == m_epoch) {
+        // Stamps of the previous traversals would look current again
+        std::fill(m_stamps.begin(), m_stamps.end(), 0);
+        m_epoch = 2;
+    }
+    m_frontier.clear();
+    m_head = 0;
+}
+
+inline bool traversal_workspace::visit(size_type id) noexcept
+{
+    if (visited(id)) {
+        return false;
+    }
+    m_stamps[id] = m_epoch;
+    return true;
+}
+
+inline traversal_workspace::size_type traversal_workspace::pop_back() noexcept
+{
+    const size_type id = m_frontier.back();
+    m_frontier.pop_back();
+    return id;
+}
+
+template <typename Frame>
+inline std::vector<Frame>& traversal_workspace::path()
+{
+    if (key_of<Frame>() != m_pathKey) {
+        m_path = std::make_unique<typed_path<Frame>>();
+        m_pathKey = key_of<Frame>();
+    }
+    std::vector<Frame>& frames = static_cast<typed_path<Frame>&>(*m_path).frames;
+    frames.clear();
+    return frames;
+}
+
+inline traversal_workspace::size_type traversal_workspace::capacity_bytes() const noexcept
+{
+    return m_stamps.capacity() * sizeof(epoch_type) + m_frontier.capacity() * sizeof(size_type)
+        + (m_path ? m_path->capacity_bytes() : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///// workspace_pool
+////////////////////////////////////////////////////////////////////////////////
+inline workspace_pool::workspace_ptr workspace_pool::borrow(std::size_t numOfIds)
+{
+    workspace_ptr workspace;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const workspace_ptr& candidate : m_workspaces) {
+            // Only the pool holds it, and only the pool hands out new copies
+            if (1 == candidate.use_count()) {
+                workspace = candidate;
+                break;
+            }
+        }
+        if (!workspace) {
+            workspace = std::make_shared<traversal_workspace>();
+            m_workspaces.push_back(workspace);
+        }
+    }
+    // Pairs with the release of the last borrower dropping its copy
+    std::atomic_thread_fence(std::memory_order_acquire);
+    workspace->reset(numOfIds);
+    return workspace;
+}
+
+}
+
+#include <cstddef>
+
+namespace impl
+{
+
+/**
+ * @brief What a traversal does after a visitor callback.
+ */
+enum class visit_result
+{
+    PROCEED,    ///< continue as usual
+    SKIP,       ///< do not expand the discovered node, do not follow the edge
+    STOP        ///< end the traversal
+};
+
+/**
+ * @struct default_visitor
+ * @brief Visitor of graph::bfs and graph::dfs that does nothing and never stops.
+ * @details Visitors derive from it and hide the callbacks they need, the
+ *          traversal calls them directly, so they are inlined. Callbacks get
+ *          node ids, edges are passed as (from, to, cost).
+ *          - discover(id, depth): id is reached for the first time, depth is
+ *            its number of tree edges from the start. SKIP leaves its edges
+ *            unexamined.
+ *          - examine_edge(from, to, cost): every edge of an expanded node.
+ *            SKIP ignores the edge.
+ *          - tree_edge(from, to, cost): the edge is about to discover to.
+ *            SKIP leaves to undiscovered, another edge may still reach it.
+ *          - back_edge(from, to, cost): dfs only, to is an ancestor of from.
+ *          - non_tree_edge(from, to, cost): to is already discovered and, in
+ *            dfs, not an ancestor of from (forward and cross edges).
+ *          - finish(id): all the edges of the expanded node are examined,
+ *            in dfs also all of its descendants are finished.
+ *          STOP ends the traversal from any callback.
+ */
+struct default_visitor
+{
+    using size_type = std::size_t;
+
+    template <typename Cost>
+    constexpr visit_result examine_edge(size_type, size_type, Cost) noexcept { return visit_result::PROCEED; }
+    template <typename Cost>
+    constexpr visit_result tree_edge(size_type, size_type, Cost) noexcept { return visit_result::PROCEED; }
+    template <typename Cost>
+    constexpr visit_result back_edge(size_type, size_type, Cost) noexcept { return visit_result::PROCEED; }
+    template <typename Cost>
+    constexpr visit_result non_tree_edge(size_type, size_type, Cost) noexcept { return visit_result::PROCEED; }
+    constexpr visit_result discover(size_type, size_type) noexcept { return visit_result::PROCEED; }
+    constexpr visit_result finish(size_type) noexcept { return visit_result::PROCEED; }
+};
+
+}
+
+namespace impl
+{
+template <typename Cost, typename Id>
+class basic_graph;
+
+/**
+ * @class basic_csr_graph
+ * @brief Immutable compressed sparse row (CSR) snapshot of a graph.
+ * @details Outgoing edges of node i occupy the range [offsets[i], offsets[i + 1])
+ *          of the flat target and cost arrays. Ids are the same as in the
+ *          graph the snapshot was taken from, ids of removed nodes are kept
+ *          but not contained, so the algorithms skip them like the graph
+ *          does. The arrays are either owned by
+ *          the snapshot or are a view of a mapped binary file, copies share them.
+ *          Offsets and targets are stored as Id, costs as Cost. Unweighted
+ *          (void Cost) snapshots have no cost array, their arcs cost 1.
+ */
+template <typename Cost = int, typename Id = std::size_t>
+class basic_csr_graph
+{
+public:
+    using size_type                 = std::size_t;
+    using id_type                   = Id;
+    using cost_type                 = path_cost_t<Cost, Id>;
+    using arc                       = basic_arc<Cost, Id>;
+
+    constexpr static id_type INVALID_ID = std::numeric_limits<id_type>::max();
+    constexpr static bool is_weighted = !std::is_void_v<Cost>;
+
+public:
+    /**
+     * @brief Const iterator of the outgoing edges of a node as (target id, cost) arcs.
+     */
+    class const_arc_iterator
     {
     public:
         using iterator_category = std::forward_iterator_tag;
-        using value_type = node;
-        using difference_type = size_t;
-        using pointer = node*;
-        using const_pointer = const node*;
-        using reference = node&;
-        using const_reference = const node&;
+        using value_type = arc;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const arc*;
+        using reference = arc;
     public:
-        enum class iter_type
-        {
-            DFS,
-            BFS
-        };
+        const_arc_iterator(const id_type* target, const cost_type* cost);
+
+        ~const_arc_iterator() = default;
+
+        const_arc_iterator& operator++();
+        const_arc_iterator operator++(int);
+
+        bool operator==(const const_arc_iterator& other) const;
+        bool operator!=(const const_arc_iterator& other) const;
+        value_type operator*() const;
+
+    private:
+        const id_type* m_target;
+        const cost_type* m_cost;
+    };
+
+    using arc_range = iterator_range<const_arc_iterator>;
+
+public:
+    /**
+     * @brief Construct an empty snapshot.
+     */
+    basic_csr_graph() = default;
+
+    /**
+     * @brief Pack the adjacency of the given graph into flat arrays.
+     */
+    explicit basic_csr_graph(const basic_graph<Cost, Id>& g);
+
+    /**
+     * @brief Map a file written by graph::serialize_binary and view it in place.
+     * @details Nothing is parsed or allocated per node or edge. The header and
+     *          the sizes of the sections are always validated, the offsets and
+     *          targets only when validate is set, which reads every page once.
+     * @param validate check that the offsets do not decrease and every target
+     *        is a node, pass false only for trusted files.
+     * @throw serialization_error if the file is not a compatible binary graph,
+     *        including one written with other id or cost types, or is corrupted.
+     * @throw std::system_error if the file can not be opened or mapped.
+     */
+    [[nodiscard]] static basic_csr_graph map(const std::string& fileName, bool validate = true);
+
+    /**
+     * @brief Return number of nodes in the snapshot.
+     */
+    [[nodiscard]] inline size_type size() const noexcept { return m_numOfNodes; }
+
+    /**
+     * @brief Return the upper bound of the node ids, greater than size() if the
+     *        graph had removed nodes.
+     */
+    [[nodiscard]] inline size_type num_of_ids() const noexcept { return m_size; }
+
+    /**
+     * @brief Return true if the id belongs to a node of the snapshot, false otherwise.
+     */
+    [[nodiscard]] inline bool contains(size_type id) const noexcept
+    {
+        return id < m_size && (nullptr == m_removed || 0 == m_removed[id]);
+    }
+
+    /**
+     * @brief Return number of edges in the snapshot.
+     */
+    [[nodiscard]] inline size_type num_of_edges() const noexcept { return m_numOfEdges; }
+
+    /**
+     * @brief Returns true if the snapshot is empty, false otherwise.
+     */
+    [[nodiscard]] inline bool empty() const noexcept { return 0 == size(); }
+
+    /**
+     * @brief Borrow a traversal workspace reset for num_of_ids() ids, see graph::borrow_workspace.
+     */
+    [[nodiscard]] inline workspace_pool::workspace_ptr borrow_workspace() const { return m_workspaces.borrow(m_size); }
+
+    /**
+     * @brief Return number of outgoing edges of the node.
+     */
+    [[nodiscard]] inline size_type degree(size_type id) const { return m_offsets[id + 1] - m_offsets[id]; }
+
+    /**
+     * @brief Return the outgoing edges of the node as (target id, cost) arcs.
+     */
+    [[nodiscard]] inline arc_range out_edges(size_type id) const;
+
+    /**
+     * @brief Return the name of the node.
+     */
+    [[nodiscard]] inline std::string_view get_name(size_type id) const;
+
+public:
+    ///@{ @name Algorithms
+    /// @brief Same algorithms as in graph, working on node ids.
+    /**
+     * @return id of the mother node if found, otherwise INVALID_ID.
+     */
+    [[nodiscard]] size_type mother_node() const;
+    template <typename Count = size_type>
+    [[nodiscard]] Count num_of_paths(size_type from, size_type to) const;
+    template <typename Count = size_type, typename ForwardIt>
+    [[nodiscard]] std::vector<Count> num_of_paths(size_type from, ForwardIt first, ForwardIt last) const;
+    template <typename Count = size_type>
+    [[nodiscard]] std::vector<Count> num_of_paths_from(size_type from) const;
+    [[nodiscard]] bool is_cyclic() const;
+    template <typename Progress>
+    [[nodiscard]] bool is_cyclic(Progress&& progress, size_type numOfThreads = 0) const;
+    [[nodiscard]] std::vector<size_type> find_cycle() const;
+    [[nodiscard]] std::vector<size_type> topological_order() const;
+    [[nodiscard]] std::vector<std::vector<size_type>> topological_levels(size_type numOfThreads = 0) const;
+    [[nodiscard]] scc_result<id_type> strongly_connected_components() const;
+    [[nodiscard]] scc_result<id_type> parallel_strongly_connected_components(size_type numOfThreads = 0) const;
+    [[nodiscard]] basic_graph<Cost, Id> condensation(const scc_result<id_type>& scc) const;
+    [[nodiscard]] std::vector<cost_type> dijkstra(size_type start) const;
+    [[nodiscard]] cost_type dijkstra(size_type start, size_type target) const;
+    [[nodiscard]] shortest_path_tree<cost_type, id_type> shortest_paths(size_type start, bool withEdges = false) const;
+    [[nodiscard]] std::vector<cost_type> delta_stepping(size_type start, cost_type delta = 0,
+                                                        size_type numOfThreads = 0) const;
+    [[nodiscard]] std::vector<cost_type> delta_stepping(size_type start, cost_type delta, thread_pool& pool) const;
+    [[nodiscard]] bool has_negative_cycle() const;
+    template <typename Visitor>
+    bool bfs(size_type start, Visitor&& visitor) const;
+    template <typename Visitor>
+    bool dfs(size_type start, Visitor&& visitor) const;
+    ///@}
+
+private:
+    std::shared_ptr<const void> m_storage; // keeps the arrays alive
+    size_type m_size = 0;                  // number of ids
+    size_type m_numOfNodes = 0;
+    size_type m_numOfEdges = 0;
+    const id_type* m_offsets = nullptr;
+    const id_type* m_targets = nullptr;
+    const cost_type* m_costs = nullptr;
+    const std::uint64_t* m_nameOffsets = nullptr;
+    const char* m_names = nullptr;
+    const std::uint8_t* m_removed = nullptr; // 1 for removed ids, nullptr if there are none
+    mutable workspace_pool m_workspaces; // not shared by copies
+
+};
+
+using csr_graph = basic_csr_graph<int, std::size_t>;
+
+template <typename Id = std::size_t>
+using unweighted_csr_graph = basic_csr_graph<void, Id>;
+
+}
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace impl
+{
+
+/**
+ * @class indexed_heap
+ * @brief Min d-ary heap of ids in [0, capacity) with decrease-key.
+ * @details Every id is in the heap at most once, the position of each id is
+ *          tracked so that its key can be lowered in place. Keys and ids are
+ *          stored next to each other, a node of the heap has Arity children.
+ */
+template <typename Key, std::size_t Arity = 4>
+class indexed_heap
+{
+    static_assert(Arity >= 2, "indexed_heap needs at least two children per node");
+
+public:
+    using size_type                 = std::size_t;
+    using key_type                  = Key;
+    using value_type                = std::pair<Key, size_type>;
+
+    constexpr static size_type NOT_IN_HEAP = std::numeric_limits<size_type>::max();
+
+public:
+    /**
+     * @brief Construct an empty heap for ids in [0, capacity).
+     */
+    explicit indexed_heap(size_type capacity = 0);
+
+    /**
+     * @brief Returns true if the heap is empty, false otherwise.
+     */
+    [[nodiscard]] inline bool empty() const noexcept { return m_heap.empty(); }
+
+    /**
+     * @brief Return number of ids in the heap.
+     */
+    [[nodiscard]] inline size_type size() const noexcept { return m_heap.size(); }
+
+    /**
+     * @brief Returns true if the id is in the heap, false otherwise.
+     */
+    [[nodiscard]] inline bool contains(size_type id) const { return NOT_IN_HEAP != m_positions[id]; }
+
+    /**
+     * @brief Return the (key, id) pair with the smallest key.
+     */
+    [[nodiscard]] inline const value_type& top() const { return m_heap.front(); }
+
+    /**
+     * @brief Insert the id if it is not in the heap, otherwise lower its key.
+     * @return true if the id was inserted or its key lowered, false if the
+     *         key in the heap is already smaller or equal.
+     */
+    bool push_or_decrease(size_type id, Key key);
+
+    /**
+     * @brief Remove the (key, id) pair with the smallest key.
+     */
+    void pop();
+
+    /**
+     * @brief Remove all the ids, keep the memory.
+     */
+    void clear() noexcept;
+
+private:
+    void sift_up(size_type position);
+    void sift_down(size_type position);
+    void place(size_type position, const value_type& value);
+
+private:
+    std::vector<value_type> m_heap;
+    std::vector<size_type> m_positions;
+
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace impl
+{
+
+template <typename Key, std::size_t Arity>
+indexed_heap<Key, Arity>::indexed_heap(size_type capacity)
+    : m_positions(capacity, NOT_IN_HEAP)
+{ }
+
+template <typename Key, std::size_t Arity>
+bool indexed_heap<Key, Arity>::push_or_decrease(size_type id, Key key)
+{
+    size_type position = m_positions[id];
+    if (NOT_IN_HEAP == position) {
+        position = m_heap.size();
+        m_heap.emplace_back(key, id);
+        m_positions[id] = position;
+    } else if (key < m_heap[position].first) {
+        m_heap[position].first = key;
+    } else {
+        return false;
+    }
+    sift_up(position);
+    return true;
+}
+
+template <typename Key, std::size_t Arity>
+void indexed_heap<Key, Arity>::pop()
+{
+    m_positions[m_heap.front().second] = NOT_IN_HEAP;
+    const value_type last = m_heap.back();
+    m_heap.pop_back();
+    if (!m_heap.empty()) {
+        place(0, last);
+        sift_down(0);
+    }
+}
+
+template <typename Key, std::size_t Arity>
+void indexed_heap<Key, Arity>::clear() noexcept
+{
+    for (const value_type& value : m_heap) {
+        m_positions[value.second] = NOT_IN_HEAP;
+    }
+    m_heap.clear();
+}
+
+template <typename Key, std::size_t Arity>
+void indexed_heap<Key, Arity>::sift_up(size_type position)
+{
+    const value_type value = m_heap[position];
+    while (position > 0) {
+        const size_type parent = (position - 1) / Arity;
+        if (!(value.first < m_heap[parent].first)) {
+            break;
+        }
+        place(position, m_heap[parent]);
+        position = parent;
+    }
+    place(position, value);
+}
+
+template <typename Key, std::size_t Arity>
+void indexed_heap<Key, Arity>::sift_down(size_type position)
+{
+    const value_type value = m_heap[position];
+    const size_type size = m_heap.size();
+    for (;;) {
+        const size_type first = position * Arity + 1;
+        if (first >= size) {
+            break;
+        }
+        const size_type last = std::min(first + Arity, size);
+        size_type best = first;
+        for (size_type child = first + 1; child < last; ++child) {
+            if (m_heap[child].first < m_heap[best].first) {
+                best = child;
+            }
+        }
+        if (!(m_heap[best].first < value.first)) {
+            break;
+        }
+        place(position, m_heap[best]);
+        position = best;
+    }
+    place(position, value);
+}
+
+template <typename Key, std::size_t Arity>
+void indexed_heap<Key, Arity>::place(size_type position, const value_type& value)
+{
+    m_heap[position] = value;
+    m_positions[value.second] = position;
+}
+
+}
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GRAPH_HAS_MMAP 1
+#else
+#define GRAPH_HAS_MMAP 0
+#endif
+
+namespace impl
+{
+
+/**
+ * @class mapped_file
+ * @brief Read-only view of a whole file.
+ * @details The file is memory mapped where mmap is available, so its pages are
+ *          only read when touched. Elsewhere the file is read into a buffer.
+ *          The data is aligned to at least 8 bytes.
+ */
+class mapped_file
+{
+public:
+    using size_type                 = std::size_t;
+
+public:
+    /**
+     * @brief Map the file.
+     * @throw std::system_error if the file can not be opened or mapped.
+     */
+    explicit mapped_file(const std::string& fileName);
+
+    /**
+     * @brief Unmap the file.
+     */
+    ~mapped_file();
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    [[nodiscard]] inline const char* data() const noexcept { return m_data; }
+    [[nodiscard]] inline size_type size() const noexcept { return m_size; }
+    [[nodiscard]] inline const char* begin() const noexcept { return m_data; }
+    [[nodiscard]] inline const char* end() const noexcept { return m_data + m_size; }
+
+private:
+    const char* m_data = nullptr;
+    size_type m_size = 0;
+#if !GRAPH_HAS_MMAP
+    std::vector<std::uint64_t> m_buffer;
+#endif
+
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cerrno>
+#include <system_error>
+
+#if GRAPH_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace impl
+{
+
+#if GRAPH_HAS_MMAP
+
+inline mapped_file::mapped_file(const std::string& fileName)
+{
+    const int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (-1 == fd) {
+        throw std::system_error(errno, std::generic_category(), "Can't open " + fileName);
+    }
+
+    struct stat st{};
+    if (-1 == ::fstat(fd, &st)) {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "Can't stat " + fileName);
+    }
+
+    m_size = static_cast<size_type>(st.st_size);
+    if (0 != m_size) {
+        void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (MAP_FAILED == data) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "Can't map " + fileName);
+        }
+        m_data = static_cast<const char*>(data);
+    }
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+}
+
+inline mapped_file::~mapped_file()
+{
+    if (nullptr != m_data) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+#else
+
+inline mapped_file::mapped_file(const std::string& fileName)
+{
+    std::ifstream is{fileName, std::ios::binary | std::ios::ate};
+    if (!is) {
+        throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory), "Can't open " + fileName);
+    }
+    m_size = static_cast<size_type>(is.tellg());
+    m_buffer.resize((m_size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+    is.seekg(0);
+    is.read(reinterpret_cast<char*>(m_buffer.data()), static_cast<std::streamsize>(m_size));
+    m_data = reinterpret_cast<const char*>(m_buffer.data());
+}
+
+inline mapped_file::~mapped_file() = default;
+
+#endif
+
+}
+
+#include <limits>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace impl
+{
+
+/**
+ * @class object_pool
+ * @brief Slab allocator that constructs objects in large chunks.
+ * @details Objects are never freed one by one, all of them are destroyed and
+ *          their memory is released at once by clear() or by the destructor.
+ *          Addresses of created objects stay valid until then.
+ */
+template <typename T>
+class object_pool
+{
+public:
+    using size_type                 = std::size_t;
+    using value_type                = T;
+
+    constexpr static size_type MIN_CHUNK_SIZE = 64;
+    constexpr static size_type MAX_CHUNK_SIZE = 64 * 1024;
+
+public:
+    object_pool() = default;
+    object_pool(object_pool&& other) noexcept;
+    object_pool& operator=(object_pool&& other) noexcept;
+    object_pool(const object_pool&) = delete;
+    object_pool& operator=(const object_pool&) = delete;
+
+    /**
+     * @brief Destroy all the objects and release the memory.
+     */
+    ~object_pool();
+
+    /**
+     * @brief Construct a new object in the pool.
+     */
+    template <typename... Args>
+    [[nodiscard]] T* create(Args&&... args);
+
+    /**
+     * @brief Construct count value initialized objects next to each other.
+     * @return pointer to the first object.
+     */
+    [[nodiscard]] T* create_n(size_type count);
+
+    /**
+     * @brief Make sure the next count objects are created in one chunk.
+     */
+    void reserve(size_type count);
+
+    /**
+     * @brief Take over all the objects of the other pool, leaving it empty.
+     */
+    void splice(object_pool& other);
+
+    /**
+     * @brief Destroy all the objects and release the memory.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Return number of objects created since the last clear.
+     */
+    [[nodiscard]] inline size_type size() const noexcept { return m_size; }
+
+    /**
+     * @brief Return number of objects the allocated chunks can hold.
+     */
+    [[nodiscard]] inline size_type capacity() const noexcept { return m_capacity; }
+
+private:
+    struct chunk
+    {
+        T* data;
+        size_type size;
+        size_type capacity;
+    };
+
+private:
+    [[nodiscard]] size_type next_chunk_size() const noexcept;
+    void add_chunk(size_type capacity);
+
+private:
+    std::vector<chunk> m_chunks;
+    size_type m_size = 0;
+    size_type m_capacity = 0;
+
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <memory>
+
+namespace impl
+{
+
+template <typename T>
+object_pool<T>::object_pool(object_pool&& other) noexcept
+    : m_chunks(std::move(other.m_chunks))
+    , m_size(other.m_size)
+    , m_capacity(other.m_capacity)
+{
+    other.m_chunks.clear();
+    other.m_size = 0;
+    other.m_capacity = 0;
+}
+
+template <typename T>
+object_pool<T>& object_pool<T>::operator=(object_pool&& other) noexcept
+{
+    if (this != &other) {
+        clear();
+        m_chunks = std::move(other.m_chunks);
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+        other.m_chunks.clear();
+        other.m_size = 0;
+        other.m_capacity = 0;
+    }
+    return *this;
+}
+
+template <typename T>
+object_pool<T>::~object_pool()
+{
+    clear();
+}
+
+template <typename T>
+template <typename... Args>
+T* object_pool<T>::create(Args&&... args)
+{
+    if (m_chunks.empty() || m_chunks.back().size == m_chunks.back().capacity) {
+        // Grow geometrically, so that small graphs stay small
+        add_chunk(next_chunk_size());
+    }
+    chunk& c = m_chunks.back();
+    T* object = ::new (static_cast<void*>(c.data + c.size)) T(std::forward<Args>(args)...);
+    ++c.size;
+    ++m_size;
+    return object;
+}
+
+template <typename T>
+T* object_pool<T>::create_n(size_type count)
+{
+    reserve(count);
+    chunk& c = m_chunks.back();
+    T* first = c.data + c.size;
+    std::uninitialized_value_construct_n(first, count);
+    c.size += count;
+    m_size += count;
+    return first;
+}
+
+template <typename T>
+void object_pool<T>::reserve(size_type count)
+{
+    if (!m_chunks.empty() && m_chunks.back().capacity - m_chunks.back().size >= count) {
+        return;
+    }
+    add_chunk(std::max(count, next_chunk_size()));
+}
+
+template <typename T>
+void object_pool<T>::splice(object_pool& other)
+{
+    if (this == &other) {
+        return;
+    }
+    // Keep the chunk with free space at the back, so that it is used first
+    m_chunks.insert(m_chunks.end() - (m_chunks.empty() ? 0 : 1), other.m_chunks.begin(), other.m_chunks.end());
+    m_size += other.m_size;
+    m_capacity += other.m_capacity;
+    other.m_chunks.clear();
+    other.m_size = 0;
+    other.m_capacity = 0;
+}
+
+template <typename T>
+void object_pool<T>::clear() noexcept
+{
+    std::allocator<T> allocator;
+    for (chunk& c : m_chunks) {
+        std::destroy(c.data, c.data + c.size);
+        allocator.deallocate(c.data, c.capacity);
+    }
+    m_chunks.clear();
+    m_size = 0;
+    m_capacity = 0;
+}
+
+template <typename T>
+typename object_pool<T>::size_type object_pool<T>::next_chunk_size() const noexcept
+{
+    return std::clamp(m_capacity, MIN_CHUNK_SIZE, MAX_CHUNK_SIZE);
+}
+
+template <typename T>
+void object_pool<T>::add_chunk(size_type capacity)
+{
+    // The storage is owned until the chunk list took it, a failed push_back does not leak it
+    auto deallocate = [capacity](T* data) { std::allocator<T>().deallocate(data, capacity); };
+    std::unique_ptr<T, decltype(deallocate)> data(std::allocator<T>().allocate(capacity), deallocate);
+    m_chunks.push_back(chunk{data.get(), 0, capacity});
+    data.release();
+    m_capacity += capacity;
+}
+
+}
+
+namespace impl
+{
+
+/**
+ * @class name_table
+ * @brief Interned node names with an open addressing hash index.
+ * @details Every name is copied once into a chunked character pool, so the
+ *          returned views stay valid until clear(). Lookups take a
+ *          std::string_view and never allocate. The index uses linear probing
+ *          with backward shift deletion.
+ */
+class name_table
+{
+public:
+    using size_type                 = std::size_t;
+
+    constexpr static size_type INVALID_ID = std::numeric_limits<size_type>::max();
+
+    /**
+     * @brief Slot of the hash index, free slots have INVALID_ID.
+     */
+    struct entry
+    {
+        std::string_view name;
+        size_type hash;
+        size_type id;
+    };
+
+public:
+    name_table() = default;
+    name_table(name_table&& other) noexcept;
+    name_table& operator=(name_table&& other) noexcept;
+    name_table(const name_table&) = delete;
+    name_table& operator=(const name_table&) = delete;
+
+    /**
+     * @brief Return number of mapped names.
+     */
+    [[nodiscard]] inline size_type size() const noexcept { return m_size; }
+
+    /**
+     * @brief Returns true if no name is mapped, false otherwise.
+     */
+    [[nodiscard]] inline bool empty() const noexcept { return 0 == m_size; }
+
+    /**
+     * @brief Return id mapped to the name, INVALID_ID if the name is not mapped.
+     */
+    [[nodiscard]] inline size_type find(std::string_view name) const noexcept;
+
+    /**
+     * @brief Intern the name and map it to the id, unless it is already mapped.
+     *
+     * @return the entry of the name (valid until the next insertion) and true
+     *         if the name was inserted, false if it was already mapped.
+     */
+    std::pair<const entry*, bool> emplace(std::string_view name, size_type id);
+
+    /**
+     * @brief Change the id of an already mapped name.
+     *
+     * @return true if the name was mapped, false otherwise.
+     */
+    bool assign(std::string_view name, size_type id) noexcept;
+
+    /**
+     * @brief Remove the name from the index.
+     * @details The characters stay in the pool until clear().
+     *
+     * @return true if the name was mapped and removed, false otherwise.
+     */
+    bool erase(std::string_view name) noexcept;
+
+    /**
+     * @brief Prepare the index for count names without rehashing.
+     */
+    void reserve(size_type count);
+
+    /**
+     * @brief Remove all the names and release the pool.
+     */
+    void clear() noexcept;
+
+private:
+    [[nodiscard]] inline static size_type hash_of(std::string_view name) noexcept;
+    [[nodiscard]] inline size_type find_slot(std::string_view name, size_type hash) const noexcept;
+    [[nodiscard]] std::string_view store(std::string_view name);
+    void rehash(size_type capacity);
+
+private:
+    std::vector<entry> m_slots;
+    size_type m_size = 0;
+    object_pool<char> m_chars;
+
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace impl
+{
+
+inline name_table::name_table(name_table&& other) noexcept
+    : m_slots(std::move(other.m_slots))
+    , m_size(other.m_size)
+    , m_chars(std::move(other.m_chars))
+{
+    other.m_slots.clear();
+    other.m_size = 0;
+}
+
+inline name_table& name_table::operator=(name_table&& other) noexcept
+{
+    if (this != &other) {
+        m_slots = std::move(other.m_slots);
+        m_size = other.m_size;
+        m_chars = std::move(other.m_chars);
+        other.m_slots.clear();
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+inline name_table::size_type name_table::hash_of(std::string_view name) noexcept
+{
+    return std::hash<std::string_view>{}(name);
+}
+
+inline name_table::size_type name_table::find_slot(std::string_view name, size_type hash) const noexcept
+{
+    const size_type mask = m_slots.size() - 1;
+    for (size_type i = hash & mask; ; i = (i + 1) & mask) {
+        const entry& e = m_slots[i];
+        if (INVALID_ID == e.id || (hash == e.hash && name == e.name)) {
+            return i;
+        }
+    }
+}
+
+inline name_table::size_type name_table::find(std::string_view name) const noexcept
+{
+    if (m_slots.empty()) {
+        return INVALID_ID;
+    }
+    return m_slots[find_slot(name, hash_of(name))].id;
+}
+
+inline std::pair<const name_table::entry*, bool> name_table::emplace(std::string_view name, size_type id)
+{
+    assert(INVALID_ID != id);
+    if ((m_size + 1) * 2 > m_slots.size()) {
+        rehash(std::max<size_type>(16, m_slots.size() * 2));
+    }
+
+    const size_type hash = hash_of(name);
+    entry& e = m_slots[find_slot(name, hash)];
+    if (INVALID_ID != e.id) {
+        return {&e, false};
+    }
+    e = entry{store(name), hash, id};
+    ++m_size;
+    return {&e, true};
+}
+
+inline bool name_table::assign(std::string_view name, size_type id) noexcept
+{
+    if (m_slots.empty()) {
+        return false;
+    }
+    entry& e = m_slots[find_slot(name, hash_of(name))];
+    if (INVALID_ID == e.id) {
+        return false;
+    }
+    e.id = id;
+    return true;
+}
+
+inline bool name_table::erase(std::string_view name) noexcept
+{
+    if (m_slots.empty()) {
+        return false;
+    }
+    const size_type mask = m_slots.size() - 1;
+    size_type hole = find_slot(name, hash_of(name));
+    if (INVALID_ID == m_slots[hole].id) {
+        return false;
+    }
+
+    // Backward shift: move the following entries of the cluster into the hole,
+    // unless their home slot lies cyclically in (hole, current].
+    for (size_type i = (hole + 1) & mask; INVALID_ID != m_slots[i].id; i = (i + 1) & mask) {
+        const size_type home = m_slots[i].hash & mask;
+        const bool stays = (hole < i) ? (hole < home && home <= i)
+                                      : (hole < home || home <= i);
+        if (!stays) {
+            m_slots[hole] = m_slots[i];
+            hole = i;
+        }
+    }
+    m_slots[hole] = entry{{}, 0, INVALID_ID};
+    --m_size;
+    return true;
+}
+
+inline void name_table::reserve(size_type count)
+{
+    size_type capacity = 16;
+    while (capacity < count * 2) {
+        capacity *= 2;
+    }
+    if (capacity > m_slots.size()) {
+        rehash(capacity);
+    }
+}
+
+inline void name_table::clear() noexcept
+{
+    std::vector<entry>().swap(m_slots);
+    m_size = 0;
+    m_chars.clear();
+}
+
+inline std::string_view name_table::store(std::string_view name)
+{
+    if (name.empty()) {
+        return {};
+    }
+    char* data = m_chars.create_n(name.size());
+    std::copy(name.begin(), name.end(), data);
+    return {data, name.size()};
+}
+
+inline void name_table::rehash(size_type capacity)
+{
+    std::vector<entry> old(capacity, entry{{}, 0, INVALID_ID});
+    old.swap(m_slots);
+
+    const size_type mask = capacity - 1;
+    for (const entry& e : old) {
+        if (INVALID_ID == e.id) {
+            continue;
+        }
+        size_type i = e.hash & mask;
+        while (INVALID_ID != m_slots[i].id) {
+            i = (i + 1) & mask;
+        }
+        m_slots[i] = e;
+    }
+}
+
+}
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace impl
+{
+
+/**
+ * @class serialization_error
+ * @brief Thrown when a serialized graph can not be read.
+ */
+class serialization_error : public std::runtime_error
+{
+public:
+    explicit serialization_error(const std::string& what)
+        : std::runtime_error(what)
+        , m_line{0}
+    { }
+
+    /**
+     * @brief Error at the given (1 based) line of a text file.
+     */
+    serialization_error(const std::string& fileName, std::size_t line, const std::string& what)
+        : std::runtime_error(fileName + ':' + std::to_string(line) + ": " + what)
+        , m_line{line}
+    { }
+
+    /**
+     * @brief Return the line of the error, 0 if not known.
+     */
+    [[nodiscard]] inline std::size_t line() const noexcept { return m_line; }
+
+private:
+    std::size_t m_line;
+
+};
+
+}
+
+namespace impl
+{
+
+/**
+ * @class basic_graph
+ * @brief Class representing a graph data structure.
+ * @details Cost is the type of the edge weights, an integer or floating point
+ *          type, path costs are added with cost_traits<Cost>. With void Cost
+ *          the graph is unweighted: edges store no cost, every edge costs 1,
+ *          path costs are hop counts of type Id and dijkstra runs as BFS.
+ *          Id is the unsigned type of the node ids, it bounds the number of
+ *          nodes and sets the width of the ids stored by the graph, its
+ *          snapshots and the results of the algorithms.
+ *          impl::graph is basic_graph<int, std::size_t>.
+ */
+template <typename Cost = int, typename Id = std::size_t>
+class basic_graph
+{
+    static_assert(std::is_unsigned_v<Id>, "Node ids must be an unsigned integer type");
+
+public:
+    //using value_type                = ;
+    using size_type                 = std::size_t;
+    using id_type                   = Id;
+    using cost_type                 = path_cost_t<Cost, Id>;
+    using node                      = basic_node<Cost, Id>;
+    using edge                      = basic_edge<Cost, Id>;
+    using arc                       = basic_arc<Cost, Id>;
+    using csr_graph                 = basic_csr_graph<Cost, Id>;
+
+    constexpr static id_type INVALID_ID = std::numeric_limits<id_type>::max();
+    constexpr static bool is_weighted = !std::is_void_v<Cost>;
+
+public:
+    /**
+     * @brief Iterator over the nodes of the graph in id order, skipping the
+     *        ids of removed nodes.
+     */
+    template <typename Pointer, typename BaseIterator>
+    class live_node_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Pointer;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Pointer*;
+        using reference = Pointer;
+    public:
+        live_node_iterator(BaseIterator iter, BaseIterator last);
+
+        ~live_node_iterator() = default;
+
+        live_node_iterator& operator++();
+        live_node_iterator operator++(int);
+
+        bool operator==(const live_node_iterator& other) const;
+        bool operator!=(const live_node_iterator& other) const;
+        reference operator*() const;
+
+    private:
+        void skip_removed();
+
+    private:
+        BaseIterator m_iter;
+        BaseIterator m_last;
+    };
+
+    /**
+     * @brief Iterator over all the edges of the graph, node by node.
+     */
+    class const_edge_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = const edge*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const edge* const*;
+        using reference = const edge*;
+    public:
+        const_edge_iterator(typename std::vector<node*>::const_iterator iter, typename std::vector<node*>::const_iterator last);
+
+        ~const_edge_iterator() = default;
+
+        const_edge_iterator& operator++();
+        const_edge_iterator operator++(int);
+
+        bool operator==(const const_edge_iterator& other) const;
+        bool operator!=(const const_edge_iterator& other) const;
+        reference operator*() const;
+
+    private:
+        void skip_empty();
+
+    private:
+        typename std::vector<node*>::const_iterator m_iter;
+        typename std::vector<node*>::const_iterator m_last;
+        size_type m_edge;
+    };
+
+    using node_iterator = live_node_iterator<node*, typename std::vector<node*>::iterator>;
+    using const_node_iterator = live_node_iterator<const node*, typename std::vector<node*>::const_iterator>;
+    using neighbor_node_iterator = typename node::node_iterator;
+    using const_neighbor_node_iterator = typename node::const_node_iterator;
+    using edge_iterator = const_edge_iterator;
+    using arc_range = iterator_range<typename node::const_arc_iterator>;
+
+public:
+    /**
+     * @brief Construct a new empty graph object that doesn't have any nodes or edges.
+     */
+    basic_graph();
+
+    /**
+     * @brief Construct a graph from a range of (from, to) or (from, to, cost) tuples.
+     * @see add_edges
+     */
+    template <typename ForwardIt>
+    basic_graph(ForwardIt first, ForwardIt last);
+
+    basic_graph(basic_graph&& other);
+
+    /**
+     * @brief Destroy the graph object
+     */
+    ~basic_graph();
+
+    /**
+     * @brief Remove all the nodes and edges, releasing their memory at once.
+     */
+    void clear();
+
+    /**
+     * @brief Return number of nodes in the graph.
+     */
+    [[nodiscard]] inline size_type size() const noexcept;
+
+    /**
+     * @brief Return the upper bound of the node ids, including the ids of
+     *        removed nodes that are not compacted yet.
+     */
+    [[nodiscard]] inline size_type num_of_ids() const noexcept { return m_adjList.size(); }
+
+    /**
+     * @brief Return number of edges in the graph.
+     */
+    [[nodiscard]] inline size_type num_of_edges() const noexcept { return m_numOfEdges; }
+
+    /**
+     * @brief Returns true if the graph is empty, false otherwise.
+     */
+    [[nodiscard]] inline bool empty() const noexcept;
+
+    /**
+     * @brief Borrow a traversal workspace reset for num_of_ids() ids.
+     * @details It goes back to the graph when the last copy of the pointer is
+     *          gone, repeated traversals reuse it without allocating.
+     */
+    [[nodiscard]] inline workspace_pool::workspace_ptr borrow_workspace() const { return m_workspaces.borrow(num_of_ids()); }
+
+    /**
+     * @brief Return true if the name already maps to a node, false otherwise.
+     */
+    [[nodiscard]] inline bool contains(std::string_view name) const;
+
+    /**
+     * @brief Return true if the id belongs to a node that is not removed, false otherwise.
+     */
+    [[nodiscard]] inline bool contains(size_type id) const noexcept;
+
+    /**
+     * @brief Create a new node and add it to the graph.
+     * @details Name must be a hashable type.
+     * 
+     * @return value indicates if a node was actually added, true means a new
+     *  node was created and added, false means that a node with that name already
+     *  exists in this graph, and it was not overwritten.
+     * @throw std::length_error if the ids of id_type are used up.
+     */
+    bool add_node(std::string_view name);
+
+    /**
+     * @brief Removes the node with the given name
+     * @details Only the edges of the node are touched, in O(degree) with the
+     *          incoming index. The id of the node is left as a hole and the
+     *          ids of the other nodes do not change, the memory of the node
+     *          and its edges is reclaimed by compact().
+     * 
+     * @return value indicates if the node was actually removed, true means name
+     *         maped to a node, and the node was removed, false otherwise.
+     */
+    bool remove_node(std::string_view name);
+
+    /**
+     * @brief Renumber the nodes to close the holes left by remove_node and
+     *        move the nodes and edges to fresh pools, releasing the old ones.
+     * @details Nodes keep their relative order, so node i gets the id i minus
+     *          the number of removed ids below i. O(V + E).
+     */
+    void compact();
+
+    /**
+     * @brief Return true if a connection or path exists between from and to nodes.
+     */
+    [[nodiscard]] inline bool has_edge(std::string_view from, std::string_view to);
+
+    /**
+     * @brief Create an edge between from and to with the provided weight.
+     * @details If either of the names is not already a member of the graph,
+     *          create that node and add it to the graph first.
+     * 
+     * @return true if the edge was added successfully, false if the edge already
+     *          exists (nothing happens in this case).
+     */
+    bool add_edge(std::string_view from, std::string_view to, cost_type cost = 1);
+
+    /**
+     * @brief Add all the edges of a range of (from, to) or (from, to, cost) tuples.
+     * @details Endpoints are either node names or node ids. Missing named nodes
+     *          are created like in add_edge, missing ids create the nodes up to
+     *          the largest id, named after their id. The degrees are counted in
+     *          a first pass, so every adjacency vector is grown only once.
+     *          The cost defaults to 1 for (from, to) tuples. Ids are all
+     *          checked before anything is added.
+     * @throw std::length_error if an id exceeds the range of the id type.
+     * @throw std::invalid_argument if an id belongs to a removed node, or a
+     *        new id is the name of another node.
+     */
+    template <typename ForwardIt>
+    void add_edges(ForwardIt first, ForwardIt last);
+
+    /**
+     * @brief Removes the edge between from and to nodes.
+     * 
+     * @return true if the edge existed and was removed successfully, false if
+     *         either nodes or the edge was not found.
+     */
+    bool remove_edge(std::string_view from, std::string_view to);
+
+    /**
+     * @brief Return true if g has the same nodes, names and edges, by id.
+     */
+    [[nodiscard]] bool compare(const basic_graph* g) const;
+
+    neighbor_node_iterator begin_neighbors(node* start) { return start->begin_nodes(); };
+    neighbor_node_iterator begin_neighbors(std::string_view name) { return begin_neighbors(get_node(name)); };
+    neighbor_node_iterator end_neighbors(node* start) { return start->end_nodes(); };
+    neighbor_node_iterator end_neighbors(std::string_view name) { return end_neighbors(get_node(name)); };
+    const_neighbor_node_iterator begin_neighbors(const node* start) const { return start->cbegin_nodes(); };
+    const_neighbor_node_iterator begin_neighbors(std::string_view name) const { return begin_neighbors(get_node(name)); };
+    const_neighbor_node_iterator end_neighbors(const node* start) const { return start->cend_nodes(); };
+    const_neighbor_node_iterator end_neighbors(std::string_view name) const { return end_neighbors(get_node(name)); };
+    const_neighbor_node_iterator cbegin_neighbors(std::string_view name) const { return begin_neighbors(name); };
+    const_neighbor_node_iterator cend_neighbors(std::string_view name) const { return end_neighbors(name); };
+
+    /**
+     * @brief Iterators over the nodes with an edge to the given node.
+     * @details Empty if the incoming edges are not indexed.
+     */
+    neighbor_node_iterator begin_in_neighbors(node* start) { return start->begin_in_nodes(); };
+    neighbor_node_iterator begin_in_neighbors(std::string_view name) { return begin_in_neighbors(get_node(name)); };
+    neighbor_node_iterator end_in_neighbors(node* start) { return start->end_in_nodes(); };
+    neighbor_node_iterator end_in_neighbors(std::string_view name) { return end_in_neighbors(get_node(name)); };
+    const_neighbor_node_iterator begin_in_neighbors(const node* start) const { return start->begin_in_nodes(); };
+    const_neighbor_node_iterator begin_in_neighbors(std::string_view name) const { return begin_in_neighbors(get_node(name)); };
+    const_neighbor_node_iterator end_in_neighbors(const node* start) const { return start->end_in_nodes(); };
+    const_neighbor_node_iterator end_in_neighbors(std::string_view name) const { return end_in_neighbors(get_node(name)); };
+    const_neighbor_node_iterator cbegin_in_neighbors(std::string_view name) const { return begin_in_neighbors(name); };
+    const_neighbor_node_iterator cend_in_neighbors(std::string_view name) const { return end_in_neighbors(name); };
+
+    /**
+     * @brief Turn the index of incoming edges on or off, it is on by default.
+     * @details While on, every node also lists its incoming edges, kept up to
+     *          date by add_edge, remove_edge and remove_node. Turning it on
+     *          indexes the existing edges in O(V + E), turning it off releases
+     *          the lists. Without the index remove_node scans all the edges
+     *          and shortest_path searches forward only.
+     */
+    void index_incoming_edges(bool enable);
+
+    /**
+     * @brief Returns true if the incoming edges are indexed, false otherwise.
+     */
+    [[nodiscard]] inline bool has_incoming_index() const noexcept { return m_incomingIndex; }
+
+    /**
+     * @brief Return an iterator that yields the node names (in no particular order).
+     */
+    node_iterator begin_nodes() { return node_iterator(m_adjList.begin(), m_adjList.end()); }
+    node_iterator end_nodes() { return node_iterator(m_adjList.end(), m_adjList.end()); }
+    const_node_iterator begin_nodes() const { return const_node_iterator(m_adjList.cbegin(), m_adjList.cend()); }
+    const_node_iterator end_nodes() const { return const_node_iterator(m_adjList.cend(), m_adjList.cend()); }
+    const_node_iterator cbegin_nodes() const { return begin_nodes(); }
+    const_node_iterator cend_nodes() const { return end_nodes(); }
+
+    /**
+     * @brief Return all the edges as an iterator of Edges (named tuples) with values
+     *        (from, to, weight). Edges are yielded in no particular order.
+     */
+    //edge_iterator edges() const;
+
+    /**
+     * @brief Return the outgoing edges of the node with the given id as
+     *        (target id, cost) arcs, empty for the id of a removed node.
+     */
+    [[nodiscard]] inline arc_range out_edges(size_type id) const;
+
+    /**
+     * @brief Return number of outgoing edges of the node with the given id, 0 for a removed node.
+     */
+    [[nodiscard]] inline size_type degree(size_type id) const;
+
+    /**
+     * @brief Return the incoming edges of the node with the given id as
+     *        (source id, cost) arcs, empty if they are not indexed.
+     */
+    [[nodiscard]] inline arc_range in_edges(size_type id) const;
+
+    /**
+     * @brief Take an immutable CSR snapshot of the graph.
+     * @details The snapshot keeps the node ids and provides the same algorithms,
+     *          storing one index and one cost per edge in flat arrays.
+     */
+    [[nodiscard]] csr_graph freeze() const;
+
+    /**
+     * @brief Dumps the graph object to ostream.
+     */
+    void dump(std::ostream& os) const;
+
+    void serialize(const std::string& fileName) const;
+
+    /**
+     * @brief Replace the graph with the one serialized to the file.
+     * @details The whole file is mapped and tokenized in place, numbers are
+     *          parsed with std::from_chars. On error the graph is left empty.
+     * @throw serialization_error with the line of the malformed data.
+     * @throw std::system_error if the file can not be opened.
+     */
+    void deserialize(const std::string& fileName);
+
+    /**
+     * @brief Replace the graph with the one serialized to the file, parsing
+     *        it on the given number of threads (0 means all the cores).
+     * @details Requires the layout written by serialize: the number of nodes
+     *          on the first line, then one node with all its edges per line.
+     *          After indexing the newlines, each thread parses whole lines,
+     *          creates their edges in its own pool and fills the adjacency of
+     *          those nodes, the pools are merged at the end.
+     * @throw serialization_error with the line of the malformed data.
+     * @throw std::system_error if the file can not be opened.
+     */
+    void deserialize(const std::string& fileName, size_type numOfThreads);
+
+    /**
+     * @brief Serialize the graph to the versioned binary format.
+     * @details The file can be viewed in place with csr_graph::map.
+     * @throw serialization_error if the file can not be written.
+     */
+    void serialize_binary(const std::string& fileName) const;
+
+public:
+    ///@{ @name Algorithms
+    /// @brief Algorithms to work with the graph.
+    /**
+     * @brief What is a Mother Vertex?
+     * @details A mother vertex in a graph G = (V,E) is a vertex v such that all
+     *          other vertices in G can be reached by a path from v. Found in
+     *          O(V + E) by one pass of depth first searches sharing their
+     *          visited marks, the last start is checked by a bitset BFS.
+     * 
+     * @return const pointer to mother node if found, otherwise nullptr.
+     */
+    [[nodiscard]] const node* mother_node() const;
+    /**
+     * @brief Count the total number of ways or paths that exist between two vertices in a directed graph.
+     * @details Paths end at the first visit of the target. Runs in O(V + E),
+     *          by dynamic programming over the nodes reachable from the
+     *          source in topological order.
+     * @tparam Count type of the count, integer counts are checked for
+     *         overflow, a floating point or big integer type counts further.
+     * @throw cycle_error if a cycle lies on a path, which gives an infinite number of paths.
+     * @throw std::overflow_error if the count does not fit an integer Count.
+     */
+    template <typename Count = size_type>
+    [[nodiscard]] Count num_of_paths(const node* from, const node* to) const;
+    /**
+     * @brief Count the paths from one node to each node of [first, last) at once.
+     * @details One depth first search and one sweep of the nodes reachable
+     *          from the source in topological order count the paths to all of
+     *          them, then the counts of the targets are gathered. Paths go on
+     *          through the targets, so unlike num_of_paths(from, to) a cycle
+     *          through a target gives it an infinite number of paths. Ids
+     *          that are not in the graph count 0.
+     * @return the counts, in the order of the targets.
+     * @throw cycle_error if a cycle lies on a path to one of the targets.
+     * @throw std::overflow_error if the count of a target does not fit an integer Count.
+     */
+    template <typename Count = size_type, typename ForwardIt>
+    [[nodiscard]] std::vector<Count> num_of_paths(size_type from, ForwardIt first, ForwardIt last) const;
+    /**
+     * @brief Count the paths from one node to every node, in the same sweep.
+     * @return the counts indexed by node id, 0 for the nodes not reachable.
+     * @throw cycle_error if a cycle is reachable from the source.
+     * @throw std::overflow_error if a count does not fit an integer Count.
+     */
+    template <typename Count = size_type>
+    [[nodiscard]] std::vector<Count> num_of_paths_from(size_type from) const;
+
+    /**
+     * @brief Given a directed graph, check whether the graph contains a cycle or not.
+     * @details Iterative depth first search, stack safe on long chains. The
+     *          three colors of the nodes are epoch stamps of one borrowed
+     *          workspace, shared by the searches from all roots.
+     */
+    [[nodiscard]] bool is_cyclic() const;
+    /**
+     * @brief Same as is_cyclic, with Kahn's algorithm.
+     * @details The in-degrees are counted in parallel, then nodes without
+     *          incoming edges are removed one after another. Nodes left over
+     *          are on or behind a cycle.
+     * @param progress called as progress(removed, total) every
+     *        65536 removed nodes and once at the end.
+     * @param numOfThreads number of threads counting the in-degrees, 0 uses
+     *        all hardware threads.
+     */
+    template <typename Progress>
+    [[nodiscard]] bool is_cyclic(Progress&& progress, size_type numOfThreads = 0) const;
+    /**
+     * @brief Return the ids of a cycle, each node has an edge to the next one
+     *        and the last one to the first one, empty if the graph is acyclic.
+     */
+    [[nodiscard]] std::vector<size_type> find_cycle() const;
+
+    /**
+     * @brief Return the ids of the nodes in topological order, every edge goes
+     *        from a node to a later one.
+     * @details Kahn's algorithm in O(V + E), nodes without incoming edges come
+     *          first, by id.
+     * @throw cycle_error if the graph has a cycle, naming a node of it.
+     */
+    [[nodiscard]] std::vector<size_type> topological_order() const;
+    /**
+     * @brief Group the nodes into levels, each node comes one level after the
+     *        last of its predecessors.
+     * @details The nodes of a level have no path between them, so they can be
+     *          processed concurrently once the levels before are done. Level
+     *          synchronous parallel Kahn's algorithm with atomic in-degrees,
+     *          the ids of a level are sorted.
+     * @param numOfThreads number of threads, 0 uses all hardware threads.
+     * @throw cycle_error if the graph has a cycle, naming a node of it.
+     */
+    [[nodiscard]] std::vector<std::vector<size_type>> topological_levels(size_type numOfThreads = 0) const;
+
+    /**
+     * @brief Strongly connected components, numbered in topological order:
+     *        the edges between components go to higher components.
+     * @details Iterative Tarjan's algorithm in O(V + E), stack safe.
+     */
+    [[nodiscard]] scc_result<id_type> strongly_connected_components() const;
+    /**
+     * @brief Same components found by several threads, for large graphs,
+     *        numbered in no particular order.
+     * @details Trims the nodes that are components on their own, takes the
+     *          component of a high degree pivot by a forward and a backward
+     *          search (FW-BW), then the rest by coloring: every node gets the
+     *          largest id reaching it, the nodes of a color reaching its root
+     *          backward are the component of the root.
+     * @param numOfThreads number of threads, 0 uses all hardware threads.
+     */
+    [[nodiscard]] scc_result<id_type> parallel_strongly_connected_components(size_type numOfThreads = 0) const;
+    /**
+     * @brief Return the condensation, the acyclic graph of the components.
+     * @details Node c, named after c, is component c. Components get one edge
+     *          if any of their nodes do, with the lowest cost. A node u
+     *          reaches v if and only if component(u) reaches component(v),
+     *          the graph has a mother node if and only if the condensation
+     *          does, and it is cyclic if and only if a component has more than
+     *          one node or a node has an edge to itself.
+     */
+    [[nodiscard]] basic_graph condensation(const scc_result<id_type>& scc) const;
+
+    /**
+     * @brief Given a graph and a source vertex in the graph, find shortest paths
+     *        from source to all vertices in the given graph.
+     * 
+     * @details Costs must be non-negative. Every node enters the heap once and
+     *          has its key lowered in place, so no stale entries are popped.
+     *
+     * @return vector of costs from source to all nodes.
+     */
+    [[nodiscard]] std::vector<cost_type> dijkstra(size_type start) const;
+
+    /**
+     * @brief Shortest path cost from source to target, stops as soon as the
+     *        target is settled.
+     *
+     * @return cost of the shortest path, edge::INF_COST if target is not reachable.
+     */
+    [[nodiscard]] cost_type dijkstra(size_type start, size_type target) const;
+
+    /**
+     * @brief Dijkstra that also records the predecessor of every node, in the
+     *        same relaxation loop.
+     * @param withEdges also record which outgoing edge of the predecessor is
+     *        used, as its position in get_edges() of the predecessor.
+     *
+     * @return costs and predecessors, paths are walked with path(target).
+     */
+    [[nodiscard]] shortest_path_tree<cost_type, id_type> shortest_paths(size_type start, bool withEdges = false) const;
+
+    /**
+     * @brief Shortest path between two nodes with bidirectional dijkstra.
+     * @details Searches forward from the source over the outgoing edges and
+     *          backward from the target over the incoming edges, until the
+     *          two searches meet. Without the incoming index only the forward
+     *          search runs. Costs must be non-negative.
+     */
+    [[nodiscard]] shortest_path_result<cost_type, id_type> shortest_path(size_type from, size_type to) const;
+
+    /**
+     * @brief Shortest path between two nodes with A*.
+     * @param heuristic callable as heuristic(id), returning a lower bound of
+     *        the cost from the node to the target. The tighter the bound,
+     *        the fewer nodes are settled.
+     */
+    template <typename Heuristic>
+    [[nodiscard]] shortest_path_result<cost_type, id_type> shortest_path(size_type from, size_type to,
+                                                                            Heuristic&& heuristic) const;
+
+    /**
+     * @brief Parallel delta-stepping version of dijkstra, returns the same costs.
+     * @details Nodes are grouped in buckets of width delta by tentative cost and
+     *          all nodes of the lowest bucket relax their light edges (cost up
+     *          to delta) concurrently until the bucket stays empty, then its
+     *          heavy edges once. Small delta does less redundant work, large
+     *          delta exposes more parallelism. Costs must be non-negative.
+     * @param delta bucket width, 0 picks the largest edge cost divided by the average degree.
+     * @param numOfThreads number of threads, 0 uses all hardware threads.
+     *
+     * @return vector of costs from source to all nodes.
+     */
+    [[nodiscard]] std::vector<cost_type> delta_stepping(size_type start, cost_type delta = 0,
+                                                           size_type numOfThreads = 0) const;
+    /**
+     * @brief Same, on the threads of pool, which repeated searches can share.
+     */
+    [[nodiscard]] std::vector<cost_type> delta_stepping(size_type start, cost_type delta, thread_pool& pool) const;
+
+    /**
+     * @brief Given a directed graph, check whether the graph contains a negative cycle or not.
+     */
+    [[nodiscard]] bool has_negative_cycle() const;
+
+    /**
+     * @brief Breadth first search from start, calling the visitor on every
+     *        node and edge it reaches.
+     * @param visitor callbacks as in default_visitor, whose return values
+     *        prune or stop the search.
+     * @return true if the visitor stopped the search, false otherwise.
+     */
+    template <typename Visitor>
+    bool bfs(size_type start, Visitor&& visitor) const;
+
+    /**
+     * @brief Depth first search from start, calling the visitor on every
+     *        node and edge it reaches, see bfs. Also reports back edges.
+     */
+    template <typename Visitor>
+    bool dfs(size_type start, Visitor&& visitor) const;
+
+    /**
+     * @brief Multi-threaded breadth first search returning the level and the
+     *        parent of every node.
+     * @details Direction-optimizing: while the frontier is small its nodes
+     *          claim their unvisited targets (top-down). Once the edges of
+     *          the frontier outnumber the edges left to check by far, every
+     *          unvisited node looks for a parent in the frontier over its
+     *          incoming edges instead (bottom-up), until the frontier shrinks
+     *          again. Without the incoming index all steps are top-down.
+     *          Any parent one level up may be reported.
+     * @param numOfThreads number of threads, 0 uses all hardware threads.
+     */
+    [[nodiscard]] bfs_result<id_type> parallel_bfs(size_type start, size_type numOfThreads = 0) const;
+    ///@}
+
+public:
+    /**
+     * @class iterator
+     * @brief Iterator class to provide DFS and BFS traversal functionality.
+     * @details The visited nodes and the frontier live in a workspace borrowed
+     *          from the graph, copies of the iterator share it, so advancing
+     *          one of them advances the traversal of all (single pass).
+     */
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = node;
+        using difference_type = size_t;
+        using pointer = node*;
+        using const_pointer = const node*;
+        using reference = node&;
+        using const_reference = const node&;
+    public:
+        enum class iter_type
+        {
+            DFS,
+            BFS
+        };
+
+    public:
+        explicit iterator(const basic_graph& g, node* n, iter_type type);
+        ~iterator() = default;
+
+        /**
+         * @brief Move to the next node, the end iterator stays at the end.
+         */
+        iterator& operator++();
+        iterator operator++(int);
+
+        //! NOTE: if iter_types are the same, and if nodes they point to
+        //        are the same, they are equal
+        bool operator==(const iterator& other) const;
+        bool operator!=(const iterator& other) const;
+        reference operator*() const;
+
+        [[nodiscard]] inline bool is_BFS() const noexcept { return iter_type::BFS == m_type; }
+        [[nodiscard]] inline bool is_DFS() const noexcept { return iter_type::DFS == m_type; }
+
+    private:
+        void collect_nodes();
+
+    private:
+        iter_type m_type;
+        node* m_node; // nullptr means the end of the graph
+        const std::vector<node*>* m_adjList;
+        workspace_pool::workspace_ptr m_workspace; // shared by the copies
+    };
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = node;
+        using difference_type = size_t;
+        using pointer = node*;
+        using const_pointer = const node*;
+        using reference = node&;
+        using const_reference = const node&;
+    public:
+        enum class iter_type
+        {
+            DFS,
+            BFS
+        };
+
+    public:
+        explicit const_iterator(const basic_graph& g, const node* n, iter_type type);
+        ~const_iterator() = default;
+
+        /**
+         * @brief Move to the next node, the end iterator stays at the end.
+         */
+        const_iterator& operator++();
+        const_iterator operator++(int);
+
+        //! NOTE: if iter_types are the same, and if nodes they point to
+        //        are the same, they are equal
+        bool operator==(const const_iterator& other) const;
+        bool operator!=(const const_iterator& other) const;
+        const_reference operator*() const;
+
+        [[nodiscard]] inline bool is_BFS() const noexcept { return iter_type::BFS == m_type; }
+        [[nodiscard]] inline bool is_DFS() const noexcept { return iter_type::DFS == m_type; }
+
+    private:
+        void collect_nodes();
+
+    private:
+        iter_type m_type;
+        const node* m_node; // nullptr means the end of the graph
+        const std::vector<node*>* m_adjList;
+        workspace_pool::workspace_ptr m_workspace; // shared by the copies
+    };
+
+    [[nodiscard]] iterator begin_BFS(size_type start) { return iterator(*this, get_node(start), iterator::iter_type::BFS); }
+    [[nodiscard]] iterator begin_BFS(std::string_view name) { return iterator(*this, get_node(name), iterator::iter_type::BFS); }
+    [[nodiscard]] iterator end_BFS() { return iterator(*this, nullptr, iterator::iter_type::BFS); }
+    [[nodiscard]] iterator begin_DFS(size_type start) { return iterator(*this, get_node(start), iterator::iter_type::DFS); }
+    [[nodiscard]] iterator begin_DFS(std::string_view name) { return iterator(*this, get_node(name), iterator::iter_type::DFS); }
+    [[nodiscard]] iterator end_DFS() { return iterator(*this, nullptr, iterator::iter_type::DFS); }
+
+    [[nodiscard]] const_iterator begin_BFS(size_type start) const { return const_iterator(*this, get_node(start), const_iterator::iter_type::BFS); }
+    [[nodiscard]] const_iterator begin_BFS(std::string_view name) const { return const_iterator(*this, get_node(name), const_iterator::iter_type::BFS); }
+    [[nodiscard]] const_iterator end_BFS() const { return const_iterator(*this, nullptr, const_iterator::iter_type::BFS); }
+    [[nodiscard]] const_iterator begin_DFS(size_type start) const { return const_iterator(*this, get_node(start), const_iterator::iter_type::DFS); }
+    [[nodiscard]] const_iterator begin_DFS(std::string_view name) const { return const_iterator(*this, get_node(name), const_iterator::iter_type::DFS); }
+    [[nodiscard]] const_iterator end_DFS() const { return const_iterator(*this, nullptr, const_iterator::iter_type::DFS); }
+
+    [[nodiscard]] const_iterator cbegin_BFS(size_type start) const { return begin_BFS(start); }
+    [[nodiscard]] const_iterator cbegin_BFS(std::string_view name) const { return begin_BFS(name); }
+    [[nodiscard]] const_iterator cend_BFS() const { return end_BFS(); }
+    [[nodiscard]] const_iterator cbegin_DFS(size_type start) const { return begin_DFS(start); }
+    [[nodiscard]] const_iterator cbegin_DFS(std::string_view name) const { return begin_DFS(name); }
+    [[nodiscard]] const_iterator cend_DFS() const { return end_DFS(); }
+
+    [[nodiscard]] const_edge_iterator begin_edges() const { return const_edge_iterator(m_adjList.cbegin(), m_adjList.cend()); }
+    [[nodiscard]] const_edge_iterator end_edges() const { return const_edge_iterator(m_adjList.cend(), m_adjList.cend()); }
+    [[nodiscard]] const_edge_iterator cbegin_edges() const { return begin_edges(); }
+    [[nodiscard]] const_edge_iterator cend_edges() const { return end_edges(); }
+
+    [[nodiscard]] inline node* get_node(std::string_view name);
+    [[nodiscard]] inline const node* get_node(std::string_view name) const;
+
+    /**
+     * @brief Return the node with the given id, nullptr if there is none or it was removed.
+     */
+    [[nodiscard]] inline node* get_node(size_type start);
+    [[nodiscard]] inline const node* get_node(size_type start) const;
+
+private:
+    [[nodiscard]] inline size_type get_node_id(std::string_view name) const;
+    /**
+     * @throw std::length_error if the name is new and all the ids are taken.
+     */
+    inline void check_free_id(std::string_view name) const;
+    [[nodiscard]] inline node* get_or_create_node(std::string_view name);
+    [[nodiscard]] inline node* create_node(size_type id, std::string_view name);
+    void deserialize(const std::string& fileName, const char* first, const char* last);
+    void deserialize(const std::string& fileName, const char* first, const char* last, thread_pool& pool);
+    [[nodiscard]] inline bool add_edge(node* fromNode, node* toNode, cost_type cost);
+
+    /**
+     * @brief Return the id every node gets by compact(), INVALID_ID for removed ids.
+     */
+    [[nodiscard]] std::vector<id_type> compacted_ids() const;
+
+    /**
+     * @brief Fill the incoming edge lists of all the nodes from their outgoing edges.
+     */
+    void build_incoming_index();
+    /**
+     * @brief Same, with the in-degrees of the ids already counted.
+     */
+    void build_incoming_index(const std::vector<size_type>& inDegrees);
+
+private:
+    std::vector<node*> m_adjList; // nullptr for the ids of removed nodes
+    size_type m_numOfRemoved = 0;
+    size_type m_numOfEdges = 0;
+    name_table m_names;
+    object_pool<node> m_nodePool;
+    object_pool<edge> m_edgePool;
+    bool m_incomingIndex = true;
+    mutable workspace_pool m_workspaces;
+
+};
+
+using graph = basic_graph<int, std::size_t>;
+
+template <typename Id = std::size_t>
+using unweighted_graph = basic_graph<void, Id>;
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////  Includes  ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace impl
+{
+
+////////////////////////////////////////////////////////////////////////////////
+///// basic_graph::live_node_iterator
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+template <typename Pointer, typename BaseIterator>
+basic_graph<Cost, Id>::live_node_iterator<Pointer, BaseIterator>::live_node_iterator(BaseIterator iter, BaseIterator last)
+    : m_iter(iter)
+    , m_last(last)
+{
+    skip_removed();
+}
+
+template <typename Cost, typename Id>
+template <typename Pointer, typename BaseIterator>
+typename basic_graph<Cost, Id>::template live_node_iterator<Pointer, BaseIterator>& basic_graph<Cost, Id>::live_node_iterator<Pointer, BaseIterator>::operator++()
+{
+    ++m_iter;
+    skip_removed();
+    return *this;
+}
+
+template <typename Cost, typename Id>
+template <typename Pointer, typename BaseIterator>
+typename basic_graph<Cost, Id>::template live_node_iterator<Pointer, BaseIterator> basic_graph<Cost, Id>::live_node_iterator<Pointer, BaseIterator>::operator++(int)
+{
+    live_node_iterator temp{*this};
+    ++*this;
+    return temp;
+}
+
+template <typename Cost, typename Id>
+template <typename Pointer, typename BaseIterator>
+bool basic_graph<Cost, Id>::live_node_iterator<Pointer, BaseIterator>::operator==(const live_node_iterator& other) const
+{
+    return m_iter == other.m_iter;
+}
+
+template <typename Cost, typename Id>
+template <typename Pointer, typename BaseIterator>
+bool basic_graph<Cost, Id>::live_node_iterator<Pointer, BaseIterator>::operator!=(const live_node_iterator& other) const
+{
+    return m_iter != other.m_iter;
+}
+
+template <typename Cost, typename Id>
+template <typename Pointer, typename BaseIterator>
+typename basic_graph<Cost, Id>::template live_node_iterator<Pointer, BaseIterator>::reference
+basic_graph<Cost, Id>::live_node_iterator<Pointer, BaseIterator>::operator*() const
+{
+    return *m_iter;
+}
+
+template <typename Cost, typename Id>
+template <typename Pointer, typename BaseIterator>
+void basic_graph<Cost, Id>::live_node_iterator<Pointer, BaseIterator>::skip_removed()
+{
+    while (m_iter != m_last && nullptr == *m_iter) {
+        ++m_iter;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///// basic_graph::const_edge_iterator
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+basic_graph<Cost, Id>::const_edge_iterator::const_edge_iterator(typename std::vector<node*>::const_iterator iter,
+                                                                typename std::vector<node*>::const_iterator last)
+    : m_iter(iter)
+    , m_last(last)
+    , m_edge(0)
+{
+    skip_empty();
+}
+
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::const_edge_iterator& basic_graph<Cost, Id>::const_edge_iterator::operator++()
+{
+    ++m_edge;
+    skip_empty();
+    return *this;
+}
+
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::const_edge_iterator basic_graph<Cost, Id>::const_edge_iterator::operator++(int)
+{
+    const_edge_iterator temp{*this};
+    ++*this;
+    return temp;
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::const_edge_iterator::operator==(const const_edge_iterator& other) const
+{
+    return m_iter == other.m_iter && m_edge == other.m_edge;
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::const_edge_iterator::operator!=(const const_edge_iterator& other) const
+{
+    return !(*this == other);
+}
+
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::const_edge_iterator::reference basic_graph<Cost, Id>::const_edge_iterator::operator*() const
+{
+    return (*m_iter)->get_edge(m_edge);
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::const_edge_iterator::skip_empty()
+{
+    while (m_iter != m_last && (nullptr == *m_iter || m_edge == (*m_iter)->degree())) {
+        ++m_iter;
+        m_edge = 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///// basic_graph::iterator
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+basic_graph<Cost, Id>::iterator::iterator(const basic_graph& g, node* n, iter_type type)
+    : m_type(type)
+    , m_node(n)
+    , m_adjList(&g.m_adjList)
+    , m_workspace()
+{
+    if (nullptr != m_node) {
+        m_workspace = g.borrow_workspace();
+        m_workspace->visit(m_node->get_id());
+        collect_nodes();
+    }
+}
+
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::iterator& basic_graph<Cost, Id>::iterator::operator++()
+{
+    // The end iterator has no workspace, incrementing it stays at the end
+    if (nullptr == m_workspace) {
+        return *this;
+    }
+    if (m_workspace->empty()) {
+        m_node = nullptr;
+        m_workspace.reset();
+        return *this;
+    }
+
+    if (iter_type::BFS == m_type) {
+        m_node = (*m_adjList)[m_workspace->pop_front()];
+    } else {
+        m_node = (*m_adjList)[m_workspace->pop_back()];
+    }
+    collect_nodes();
+
+    return *this;
+}
+
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::iterator basic_graph<Cost, Id>::iterator::operator++(int)
+{
+    iterator tmp = *this;
+    ++*this;
+    return tmp;
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::iterator::operator==(const iterator& other) const
+{
+    return (m_type == other.m_type && m_node == other.m_node);
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::iterator::operator!=(const iterator& other) const
+{
+    return !(other == *this);
+}
+
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::iterator::reference basic_graph<Cost, Id>::iterator::operator*() const
+{
+    return *m_node;
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::iterator::collect_nodes()
+{
+    assert(nullptr != m_node);
+    for (const edge* e : m_node->get_edges()) {
+        const size_type id = e->get_to_idx();
+        if (m_workspace->visit(id)) {
+            m_workspace->push(id);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+basic_graph<Cost, Id>::const_iterator::const_iterator(const basic_graph& g, const node* n, iter_type type)
+    : m_type(type)
+    , m_node(n)
+    , m_adjList(&g.m_adjList)
+    , m_workspace()
+{
+    if (nullptr != m_node) {
+        m_workspace = g.borrow_workspace();
+        m_workspace->visit(m_node->get_id());
+        collect_nodes();
+    }
+}
+
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::const_iterator& basic_graph<Cost, Id>::const_iterator::operator++()
+{
+    // The end iterator has no workspace, incrementing it stays at the end
+    if (nullptr == m_workspace) {
+        return *this;
+    }
+    if (m_workspace->empty()) {
+        m_node = nullptr;
+        m_workspace.reset();
+        return *this;
+    }
+
+    if (iter_type::BFS == m_type) {
+        m_node = (*m_adjList)[m_workspace->pop_front()];
+    } else {
+        m_node = (*m_adjList)[m_workspace->pop_back()];
+    }
+    collect_nodes();
+
+    return *this;
+}
+
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::const_iterator basic_graph<Cost, Id>::const_iterator::operator++(int)
+{
+    const_iterator tmp = *this;
+    ++*this;
+    return tmp;
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::const_iterator::operator==(const const_iterator& other) const
+{
+    return (m_type == other.m_type && m_node == other.m_node);
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::const_iterator::operator!=(const const_iterator& other) const
+{
+    return !(other == *this);
+}
+
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::const_iterator::const_reference basic_graph<Cost, Id>::const_iterator::operator*() const
+{
+    return *m_node;
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::const_iterator::collect_nodes()
+{
+    assert(nullptr != m_node);
+    for (const edge* e : m_node->get_edges()) {
+        const size_type id = e->get_to_idx();
+        if (m_workspace->visit(id)) {
+            m_workspace->push(id);
+        }
+    }
+}
+
+}
+
+namespace impl
+{
+
+////////////////////////////////////////////////////////////////////////////////
+///// basic_graph
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+inline size_t basic_graph<Cost, Id>::get_node_id(std::string_view name) const
+{
+    return m_names.find(name);
+}
+
+template <typename Cost, typename Id>
+inline typename basic_graph<Cost, Id>::node* basic_graph<Cost, Id>::get_node(std::string_view name)
+{
+    const size_type id = m_names.find(name);
+    if (name_table::INVALID_ID == id) {
+        return nullptr;
+    }
+    return m_adjList[id];
+}
+
+template <typename Cost, typename Id>
+inline const typename basic_graph<Cost, Id>::node* basic_graph<Cost, Id>::get_node(std::string_view name) const
+{
+    const size_type id = m_names.find(name);
+    if (name_table::INVALID_ID == id) {
+        return nullptr;
+    }
+    return m_adjList[id];
+}
+
+template <typename Cost, typename Id>
+inline typename basic_graph<Cost, Id>::node* basic_graph<Cost, Id>::get_node(size_t start)
+{
+    if (start >= m_adjList.size()) {
+        return nullptr;
+    }
+    return m_adjList[start];
+}
+
+template <typename Cost, typename Id>
+inline const typename basic_graph<Cost, Id>::node* basic_graph<Cost, Id>::get_node(size_t start) const
+{
+    if (start >= m_adjList.size()) {
+        return nullptr;
+    }
+    return m_adjList[start];
+}
+
+template <typename Cost, typename Id>
+inline typename basic_graph<Cost, Id>::arc_range basic_graph<Cost, Id>::out_edges(size_type id) const
+{
+    assert(id < m_adjList.size());
+    const node* n = m_adjList[id];
+    if (nullptr == n) {
+        return arc_range(typename node::const_arc_iterator({}), typename node::const_arc_iterator({}));
+    }
+    return arc_range(n->begin_arcs(), n->end_arcs());
+}
+
+template <typename Cost, typename Id>
+inline typename basic_graph<Cost, Id>::size_type basic_graph<Cost, Id>::degree(size_type id) const
+{
+    assert(id < m_adjList.size());
+    const node* n = m_adjList[id];
+    return nullptr == n ? 0 : n->degree();
+}
+
+template <typename Cost, typename Id>
+inline typename basic_graph<Cost, Id>::arc_range basic_graph<Cost, Id>::in_edges(size_type id) const
+{
+    assert(id < m_adjList.size());
+    const node* n = m_adjList[id];
+    if (nullptr == n) {
+        return arc_range(typename node::const_arc_iterator({}), typename node::const_arc_iterator({}));
+    }
+    return arc_range(n->begin_in_arcs(), n->end_in_arcs());
+}
+
+template <typename Cost, typename Id>
+inline typename basic_graph<Cost, Id>::node* basic_graph<Cost, Id>::get_or_create_node(std::string_view name)
+{
+    check_free_id(name);
+    const auto [entry, inserted] = m_names.emplace(name, m_adjList.size());
+    if (!inserted) {
+        return m_adjList[entry->id];
+    }
+    return create_node(entry->id, entry->name);
+}
+
+template <typename Cost, typename Id>
+inline typename basic_graph<Cost, Id>::node* basic_graph<Cost, Id>::create_node(size_type id, std::string_view name)
+{
+    assert(id == m_adjList.size());
+    assert(id < INVALID_ID);
+    node* n = m_nodePool.create(id, name);
+    m_adjList.push_back(n);
+    return n;
+}
+
+template <typename Cost, typename Id>
+inline void basic_graph<Cost, Id>::check_free_id(std::string_view name) const
+{
+    if (m_adjList.size() >= INVALID_ID && !contains(name)) {
+        throw std::length_error("Number of nodes exceeds the range of the node id type");
+    }
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::add_edge(node* fromNode, node* toNode, cost_type cost)
+{
+    edge* e = m_edgePool.create(fromNode, toNode, cost);
+    fromNode->add_edge(e);
+    if (m_incomingIndex) {
+        toNode->add_in_edge(e);
+    }
+    ++m_numOfEdges;
+    return true;
+}
+
+template <typename Cost, typename Id>
+basic_graph<Cost, Id>::basic_graph()
+    : m_adjList{}
+    , m_numOfRemoved{0}
+    , m_numOfEdges{0}
+    , m_names{}
+    , m_nodePool{}
+    , m_edgePool{}
+    , m_incomingIndex{true}
+{ }
+
+template <typename Cost, typename Id>
+basic_graph<Cost, Id>::basic_graph(basic_graph&& other)
+    : m_adjList(std::move(other.m_adjList))
+    , m_numOfRemoved(other.m_numOfRemoved)
+    , m_numOfEdges(other.m_numOfEdges)
+    , m_names(std::move(other.m_names))
+    , m_nodePool(std::move(other.m_nodePool))
+    , m_edgePool(std::move(other.m_edgePool))
+    , m_incomingIndex(other.m_incomingIndex)
+{
+    other.m_adjList.clear();
+    other.m_numOfRemoved = 0;
+    other.m_numOfEdges = 0;
+}
+
+template <typename Cost, typename Id>
+basic_graph<Cost, Id>::~basic_graph()
+{
+    clear();
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::clear()
+{
+    m_names.clear();
+    m_adjList.clear();
+    m_numOfRemoved = 0;
+    m_numOfEdges = 0;
+    m_edgePool.clear();
+    m_nodePool.clear();
+}
+
+template <typename Cost, typename Id>
+inline size_t basic_graph<Cost, Id>::size() const noexcept
+{
+    return m_adjList.size() - m_numOfRemoved;
+}
+
+template <typename Cost, typename Id>
+inline bool basic_graph<Cost, Id>::empty() const noexcept
+{
+    return 0 == size();
+}
+
+template <typename Cost, typename Id>
+inline bool basic_graph<Cost, Id>::contains(std::string_view name) const
+{
+    return name_table::INVALID_ID != m_names.find(name);
+}
+
+template <typename Cost, typename Id>
+inline bool basic_graph<Cost, Id>::contains(size_type id) const noexcept
+{
+    return id < m_adjList.size() && nullptr != m_adjList[id];
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::add_node(std::string_view name)
+{
+    check_free_id(name);
+    const auto [entry, inserted] = m_names.emplace(name, m_adjList.size());
+    if (!inserted) {
+        return false;
+    }
+    (void)create_node(entry->id, entry->name);
+    return true;
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::remove_node(std::string_view name)
+{
+    node* node = get_node(name);
+    if (nullptr == node) {
+        return false;
+    }
+
+    (void)m_names.erase(name);
+
+    // Outgoing edges leave the incoming lists of their targets
+    for (edge* e : node->get_edges()) {
+        e->get_to()->remove_in_edge(e);
+    }
+    m_numOfEdges -= node->degree();
+    // Incoming edges leave the outgoing lists of their sources
+    if (m_incomingIndex) {
+        for (edge* e : node->get_in_edges()) {
+            if (e->get_from() != node) {
+                e->get_from()->remove_out_edge(e);
+                --m_numOfEdges;
+            }
+        }
+    } else {
+        for (auto* n : m_adjList) {
+            while (nullptr != n && n != node && n->remove_edge(node)) {
+                --m_numOfEdges;
+            }
+        }
+    }
+
+    // The slot stays as a hole, the node and its edges stay in the pools until compact
+    m_adjList[node->get_id()] = nullptr;
+    ++m_numOfRemoved;
+    return true;
+}
+
+template <typename Cost, typename Id>
+std::vector<typename basic_graph<Cost, Id>::id_type> basic_graph<Cost, Id>::compacted_ids() const
+{
+    std::vector<id_type> ids(m_adjList.size(), INVALID_ID);
+    id_type next = 0;
+    for (size_type id = 0; id < m_adjList.size(); ++id) {
+        if (nullptr != m_adjList[id]) {
+            ids[id] = next++;
+        }
+    }
+    return ids;
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::compact()
+{
+    std::vector<node*> adjList;
+    name_table names;
+    object_pool<node> nodePool;
+    object_pool<edge> edgePool;
+    adjList.reserve(size());
+    names.reserve(size());
+    nodePool.reserve(size());
+    edgePool.reserve(m_numOfEdges);
+
+    for (const node* n : m_adjList) {
+        if (nullptr != n) {
+            const auto [entry, inserted] = names.emplace(n->get_name(), adjList.size());
+            assert(inserted);
+            adjList.push_back(nodePool.create(adjList.size(), entry->name));
+        }
+    }
+    const std::vector<id_type> ids = compacted_ids();
+    for (const node* n : m_adjList) {
+        if (nullptr == n) {
+            continue;
+        }
+        node* from = adjList[ids[n->get_id()]];
+        from->reserve_edges(n->degree());
+        for (const edge* e : n->get_edges()) {
+            from->add_edge(edgePool.create(from, adjList[ids[e->get_to_idx()]], e->get_cost()));
+        }
+    }
+
+    m_adjList = std::move(adjList);
+    m_names = std::move(names);
+    m_nodePool = std::move(nodePool);
+    m_edgePool = std::move(edgePool);
+    m_numOfRemoved = 0;
+    if (m_incomingIndex) {
+        build_incoming_index();
+    }
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::index_incoming_edges(bool enable)
+{
+    if (enable == m_incomingIndex) {
+        return;
+    }
+    m_incomingIndex = enable;
+    if (!enable) {
+        for (node* n : m_adjList) {
+            if (nullptr != n) {
+                n->clear_in_edges();
+            }
+        }
+        return;
+    }
+    build_incoming_index();
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::build_incoming_index()
+{
+    std::vector<size_type> inDegrees(m_adjList.size(), 0);
+    for (const node* n : m_adjList) {
+        if (nullptr != n) {
+            for (const edge* e : n->get_edges()) {
+                ++inDegrees[e->get_to_idx()];
+            }
+        }
+    }
+    build_incoming_index(inDegrees);
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::build_incoming_index(const std::vector<size_type>& inDegrees)
+{
+    assert(inDegrees.size() == m_adjList.size());
+    for (size_type i = 0; i < m_adjList.size(); ++i) {
+        if (nullptr != m_adjList[i]) {
+            m_adjList[i]->reserve_in_edges(inDegrees[i]);
+        }
+    }
+    for (node* n : m_adjList) {
+        if (nullptr != n) {
+            for (edge* e : n->get_edges()) {
+                e->get_to()->add_in_edge(e);
+            }
+        }
+    }
+}
+
+template <typename Cost, typename Id>
+inline bool basic_graph<Cost, Id>::has_edge(std::string_view from, std::string_view to)
+{
+    node* fromNode = get_node(from);
+    node* toNode = get_node(to);
+
+    if (nullptr == fromNode || nullptr == toNode) {
+        return false;
+    }
+
+    return fromNode->has_edge(toNode);
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::add_edge(std::string_view from, std::string_view to, cost_type cost)
+{
+    node* fromNode = get_or_create_node(from);
+    node* toNode = get_or_create_node(to);
+
+    return add_edge(fromNode, toNode, cost);
+}
+
+template <typename Cost, typename Id>
+template <typename ForwardIt>
+basic_graph<Cost, Id>::basic_graph(ForwardIt first, ForwardIt last)
+    : basic_graph()
+{
+    add_edges(first, last);
+}
+
+template <typename Cost, typename Id>
+template <typename ForwardIt>
+void basic_graph<Cost, Id>::add_edges(ForwardIt first, ForwardIt last)
+{
+    using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+    using end_type = std::decay_t<std::tuple_element_t<0, value_type>>;
+    constexpr bool isNamed = std::is_convertible_v<const end_type&, std::string_view>;
+    constexpr bool hasCost = std::tuple_size_v<value_type> > 2;
+    static_assert(isNamed || std::is_integral_v<end_type>, "Endpoints must be names or ids");
+
+    // First pass: resolve the endpoints and count the new edges per node
+    std::vector<size_type> degrees(num_of_ids(), 0);
+    std::vector<size_type> inDegrees(num_of_ids(), 0);
+    std::vector<node*> ends;
+    size_type numOfEdges = 0;
+    if constexpr (isNamed) {
+        using category = typename std::iterator_traits<ForwardIt>::iterator_category;
+        if constexpr (std::is_base_of_v<std::random_access_iterator_tag, category>) {
+            ends.reserve(2 * static_cast<size_type>(last - first));
+        }
+        // Edge lists are usually grouped by source, so the previous source is reused
+        node* fromNode = nullptr;
+        for (auto it = first; it != last; ++it, ++numOfEdges) {
+            const std::string_view from = std::get<0>(*it);
+            if (nullptr == fromNode || fromNode->get_name() != from) {
+                fromNode = get_or_create_node(from);
+            }
+            node* toNode = get_or_create_node(std::get<1>(*it));
+            ends.push_back(fromNode);
+            ends.push_back(toNode);
+            if (degrees.size() < num_of_ids()) {
+                degrees.resize(num_of_ids(), 0);
+                inDegrees.resize(num_of_ids(), 0);
+            }
+            ++degrees[fromNode->get_id()];
+            ++inDegrees[toNode->get_id()];
+        }
+    } else {
+        for (auto it = first; it != last; ++it, ++numOfEdges) {
+            const auto from = static_cast<size_type>(std::get<0>(*it));
+            const auto to = static_cast<size_type>(std::get<1>(*it));
+            if (std::max(from, to) >= INVALID_ID) {
+                throw std::length_error("Node id " + std::to_string(std::max(from, to))
+                                        + " exceeds the range of the node id type");
+            }
+            for (const size_type id : {from, to}) {
+                if (id < num_of_ids() && !contains(id)) {
+                    throw std::invalid_argument("Node id " + std::to_string(id) + " belongs to a removed node");
+                }
+            }
+            if (degrees.size() <= std::max(from, to)) {
+                degrees.resize(std::max(from, to) + 1, 0);
+                inDegrees.resize(std::max(from, to) + 1, 0);
+            }
+            ++degrees[from];
+            ++inDegrees[to];
+        }
+        for (size_type id = num_of_ids(); id < degrees.size(); ++id) {
+            const size_type other = m_names.find(std::to_string(id));
+            if (name_table::INVALID_ID != other) {
+                throw std::invalid_argument("Node id " + std::to_string(id) + " can not be named after its id, node "
+                                            + std::to_string(other) + " has that name");
+            }
+        }
+        m_names.reserve(degrees.size());
+        for (size_type id = num_of_ids(); id < degrees.size(); ++id) {
+            (void)create_node(id, m_names.emplace(std::to_string(id), id).first->name);
+        }
+    }
+
+    // Reserve everything exactly once
+    for (size_type id = 0; id < degrees.size(); ++id) {
+        if (0 != degrees[id]) {
+            m_adjList[id]->reserve_edges(m_adjList[id]->degree() + degrees[id]);
+        }
+        if (m_incomingIndex && 0 != inDegrees[id]) {
+            m_adjList[id]->reserve_in_edges(m_adjList[id]->get_in_edges().size() + inDegrees[id]);
+        }
+    }
+    m_edgePool.reserve(numOfEdges);
+
+    // Second pass: create the edges
+    size_type i = 0;
+    for (auto it = first; it != last; ++it, ++i) {
+        node* fromNode = nullptr;
+        node* toNode = nullptr;
+        if constexpr (isNamed) {
+            fromNode = ends[2 * i];
+            toNode = ends[2 * i + 1];
+        } else {
+            fromNode = m_adjList[static_cast<size_type>(std::get<0>(*it))];
+            toNode = m_adjList[static_cast<size_type>(std::get<1>(*it))];
+            assert(nullptr != fromNode && nullptr != toNode);
+        }
+        cost_type cost = 1;
+        if constexpr (hasCost) {
+            cost = static_cast<cost_type>(std::get<2>(*it));
+        }
+        (void)add_edge(fromNode, toNode, cost);
+    }
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::remove_edge(std::string_view from, std::string_view to)
+{
+    node* fromNode = get_node(from);
+    node* toNode = get_node(to);
+
+    if (nullptr == fromNode || nullptr == toNode) {
+        return false;
+    }
+
+    if (!fromNode->remove_edge(toNode)) {
+        return false;
+    }
+    --m_numOfEdges;
+    return true;
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::compare(const basic_graph* g) const
+{
+    if (size() != g->size()) {
+        return false;
+    }
+    if (num_of_edges() != g->num_of_edges()) {
+        return false;
+    }
+    for (size_type i = 0; i < std::max(num_of_ids(), g->num_of_ids()); ++i) {
+        const node* lhs = get_node(i);
+        const node* rhs = g->get_node(i);
+        if ((nullptr == lhs) != (nullptr == rhs)) {
+            return false;
+        }
+        if (nullptr != lhs && !lhs->compare(rhs)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::dump(std::ostream& os) const
+{
+    for (const auto* node : m_adjList) {
+        if (nullptr != node) {
+            node->dump(os);
+        }
+    }
+}
+
+}
+
+namespace impl
+{
+
+////////////////////////////////////////////////////////////////////////////////
+///// basic_csr_graph::const_arc_iterator
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+basic_csr_graph<Cost, Id>::const_arc_iterator::const_arc_iterator(const id_type* target, const cost_type* cost)
+    : m_target(target)
+    , m_cost(cost)
+{ }
+
+template <typename Cost, typename Id>
+typename basic_csr_graph<Cost, Id>::const_arc_iterator& basic_csr_graph<Cost, Id>::const_arc_iterator::operator++()
+{
+    ++m_target;
+    if constexpr (is_weighted) {
+        ++m_cost;
+    }
+    return *this;
+}
+
+template <typename Cost, typename Id>
+typename basic_csr_graph<Cost, Id>::const_arc_iterator basic_csr_graph<Cost, Id>::const_arc_iterator::operator++(int)
+{
+    const_arc_iterator temp{*this};
+    ++*this;
+    return temp;
+}
+
+template <typename Cost, typename Id>
+bool basic_csr_graph<Cost, Id>::const_arc_iterator::operator==(const const_arc_iterator& other) const
+{
+    return m_target == other.m_target;
+}
+
+template <typename Cost, typename Id>
+bool basic_csr_graph<Cost, Id>::const_arc_iterator::operator!=(const const_arc_iterator& other) const
+{
+    return m_target != other.m_target;
+}
+
+template <typename Cost, typename Id>
+typename basic_csr_graph<Cost, Id>::const_arc_iterator::value_type basic_csr_graph<Cost, Id>::const_arc_iterator::operator*() const
+{
+    if constexpr (is_weighted) {
+        return arc{*m_target, *m_cost};
+    } else {
+        return arc{*m_target, 1};
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///// basic_csr_graph
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+basic_csr_graph<Cost, Id>::basic_csr_graph(const basic_graph<Cost, Id>& g)
+{
+    struct arrays
+    {
+        std::vector<id_type> offsets;
+        std::vector<id_type> targets;
+        std::vector<cost_type> costs;
+        std::vector<std::uint64_t> nameOffsets;
+        std::string names;
+        std::vector<std::uint8_t> removed;
+    };
+    if (g.num_of_edges() >= INVALID_ID) {
+        throw std::length_error("Number of edges exceeds the range of the node id type");
+    }
+    auto storage = std::make_shared<arrays>();
+
+    storage->offsets.reserve(g.num_of_ids() + 1);
+    storage->targets.reserve(g.num_of_edges());
+    if constexpr (is_weighted) {
+        storage->costs.reserve(g.num_of_edges());
+    }
+    storage->nameOffsets.reserve(g.num_of_ids() + 1);
+    if (g.size() != g.num_of_ids()) {
+        storage->removed.resize(g.num_of_ids(), 0);
+    }
+
+    storage->offsets.push_back(0);
+    storage->nameOffsets.push_back(0);
+    for (size_type i = 0; i < g.num_of_ids(); ++i) {
+        for (const auto [to, cost] : g.out_edges(i)) {
+            storage->targets.push_back(to);
+            if constexpr (is_weighted) {
+                storage->costs.push_back(cost);
+            }
+        }
+        storage->offsets.push_back(static_cast<id_type>(storage->targets.size()));
+        if (const auto* n = g.get_node(i)) {
+            storage->names += n->get_name();
+        } else if (!storage->removed.empty()) {
+            storage->removed[i] = 1;
+        }
+        storage->nameOffsets.push_back(storage->names.size());
+    }
+
+    m_size = g.num_of_ids();
+    m_numOfNodes = g.size();
+    m_numOfEdges = storage->targets.size();
+    m_offsets = storage->offsets.data();
+    m_targets = storage->targets.data();
+    m_costs = is_weighted ? storage->costs.data() : nullptr;
+    m_nameOffsets = storage->nameOffsets.data();
+    m_names = storage->names.data();
+    m_removed = storage->removed.empty() ? nullptr : storage->removed.data();
+    m_storage = std::move(storage);
+}
+
+template <typename Cost, typename Id>
+inline typename basic_csr_graph<Cost, Id>::arc_range basic_csr_graph<Cost, Id>::out_edges(size_type id) const
+{
+    assert(id < m_size);
+    const size_type first = m_offsets[id];
+    const size_type last = m_offsets[id + 1];
+    if constexpr (is_weighted) {
+        return arc_range(const_arc_iterator(m_targets + first, m_costs + first),
+                         const_arc_iterator(m_targets + last, m_costs + last));
+    } else {
+        return arc_range(const_arc_iterator(m_targets + first, nullptr),
+                         const_arc_iterator(m_targets + last, nullptr));
+    }
+}
+
+template <typename Cost, typename Id>
+inline std::string_view basic_csr_graph<Cost, Id>::get_name(size_type id) const
+{
+    assert(id < m_size);
+    const std::uint64_t first = m_nameOffsets[id];
+    return std::string_view(m_names + first, m_nameOffsets[id + 1] - first);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///// basic_graph
+////////////////////////////////////////////////////////////////////////////////
+template <typename Cost, typename Id>
+typename basic_graph<Cost, Id>::csr_graph basic_graph<Cost, Id>::freeze() const
+{
+    return csr_graph(*this);
+}
+
+}
+
+namespace impl
+{
+
+namespace detail
+{
+
+/**
+ * @brief Breadth first search from start with the visitor callbacks.
+ * @details Nodes already visited in the workspace are treated as discovered,
+ *          so several searches can share one reset of the workspace. The
+ *          frontier is processed level by level to know the depth.
+ * @return true if the visitor stopped the search, false otherwise.
+ */
+template <typename Graph, typename Visitor>
+bool bfs(const Graph& g, typename Graph::size_type start, Visitor& visitor, traversal_workspace& workspace)
+{
+    using size_type = typename Graph::size_type;
+
+    if (!workspace.visit(start)) {
+        return false;
+    }
+    switch (visitor.discover(start, 0)) {
+    case visit_result::STOP: return true;
+    case visit_result::SKIP: return false;
+    case visit_result::PROCEED: workspace.push(start); break;
+    }
+
+    for (size_type depth = 1; !workspace.empty(); ++depth) {
+        for (size_type pending = workspace.size(); pending > 0; --pending) {
+            const size_type id = workspace.pop_front();
+            for (const auto [toId, toCost] : g.out_edges(id)) {
+                const visit_result examined = visitor.examine_edge(id, toId, toCost);
+                if (visit_result::STOP == examined) {
+                    return true;
+                }
+                if (visit_result::SKIP == examined) {
+                    continue;
+                }
+                if (workspace.visited(toId)) {
+                    if (visit_result::STOP == visitor.non_tree_edge(id, toId, toCost)) {
+                        return true;
+                    }
+                    continue;
+                }
+                const visit_result tree = visitor.tree_edge(id, toId, toCost);
+                if (visit_result::STOP == tree) {
+                    return true;
+                }
+                if (visit_result::SKIP == tree) {
+                    continue;
+                }
+                workspace.visit(toId);
+                const visit_result discovered = visitor.discover(toId, depth);
+                if (visit_result::STOP == discovered) {
+                    return true;
+                }
+                if (visit_result::PROCEED == discovered) {
+                    workspace.push(toId);
+                }
+            }
+            if (visit_result::STOP == visitor.finish(id)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Node on the depth first search path and its remaining outgoing edges.
+ * @details Depends on the graph type only, so every search of a graph shares
+ *          the frame stack of the workspace.
+ */
+template <typename Graph>
+struct dfs_frame
+{
+    using arc_iterator = decltype(std::declval<const Graph&>().out_edges(0).begin());
+
+    typename Graph::size_type id;
+    arc_iterator next;
+    arc_iterator last;
+};
+
+/**
+ * @brief Depth first search from start with the visitor callbacks.
+ * @details Iterative, the path from start to the current node is a stack of
+ *          (node, next edge) frames kept in the workspace, so repeated
+ *          searches do not allocate. Nodes on the path are visited, the
+ *          others are finished, which tells back edges from the other non
+ *          tree edges. Nodes already visited in the workspace are treated as
+ *          discovered, so several searches can share one reset of the workspace.
+ * @return true if the visitor stopped the search, false otherwise.
+ */
+template <typename Graph, typename Visitor>
+bool dfs(const Graph& g, typename Graph::size_type start, Visitor& visitor, traversal_workspace& workspace)
+{
+    using size_type = typename Graph::size_type;
+    using frame = dfs_frame<Graph>;
+
+    if (!workspace.visit(start)) {
+        return false;
+    }
+    switch (visitor.discover(start, 0)) {
+    case visit_result::STOP: return true;
+    case visit_result::SKIP: workspace.finish(start); return false;
+    case visit_result::PROCEED: break;
+    }
+
+    std::vector<frame>& path = workspace.template path<frame>();
+    path.push_back(frame{start, g.out_edges(start).begin(), g.out_edges(start).end()});
+    while (!path.empty()) {
+        frame& top = path.back();
+        if (top.next == top.last) {
+            const size_type id = top.id;
+            path.pop_back();
+            workspace.finish(id);
+            if (visit_result::STOP == visitor.finish(id)) {
+                return true;
+            }
+            continue;
+        }
+
+        const size_type id = top.id;
+        const auto [toId, toCost] = *top.next;
+        ++top.next;
+
+        const visit_result examined = visitor.examine_edge(id, toId, toCost);
+        if (visit_result::STOP == examined) {
+            return true;
+        }
+        if (visit_result::SKIP == examined) {
+            continue;
+        }
+        if (workspace.visited(toId)) {
+            const visit_result result = workspace.finished(toId) ? visitor.non_tree_edge(id, toId, toCost)
+                                                                 : visitor.back_edge(id, toId, toCost);
+            if (visit_result::STOP == result) {
+                return true;
+            }
+            continue;
+        }
+        const visit_result tree = visitor.tree_edge(id, toId, toCost);
+        if (visit_result::STOP == tree) {
+            return true;
+        }
+        if (visit_result::SKIP == tree) {
+            continue;
+        }
+        workspace.visit(toId);
+        const visit_result discovered = visitor.discover(toId, path.size());
+        if (visit_result::STOP == discovered) {
+            return true;
+        }
+        if (visit_result::SKIP == discovered) {
+            workspace.finish(toId);
+            continue;
+        }
+        const auto edges = g.out_edges(toId);
+        path.push_back(frame{static_cast<size_type>(toId), edges.begin(), edges.end()});
+    }
+    return false;
+}
+
+}
+
+template <typename Cost, typename Id>
+template <typename Visitor>
+bool basic_graph<Cost, Id>::bfs(size_type start, Visitor&& visitor) const
+{
+    if (!contains(start)) {
+        return false;
+    }
+    const workspace_pool::workspace_ptr workspace = borrow_workspace();
+    return detail::bfs(*this, start, visitor, *workspace);
+}
+
+template <typename Cost, typename Id>
+template <typename Visitor>
+bool basic_graph<Cost, Id>::dfs(size_type start, Visitor&& visitor) const
+{
+    if (!contains(start)) {
+        return false;
+    }
+    const workspace_pool::workspace_ptr workspace = borrow_workspace();
+    return detail::dfs(*this, start, visitor, *workspace);
+}
+
+template <typename Cost, typename Id>
+template <typename Visitor>
+bool basic_csr_graph<Cost, Id>::bfs(size_type start, Visitor&& visitor) const
+{
+    if (!contains(start)) {
+        return false;
+    }
+    const workspace_pool::workspace_ptr workspace = borrow_workspace();
+    return detail::bfs(*this, start, visitor, *workspace);
+}
+
+template <typename Cost, typename Id>
+template <typename Visitor>
+bool basic_csr_graph<Cost, Id>::dfs(size_type start, Visitor&& visitor) const
+{
+    if (!contains(start)) {
+        return false;
+    }
+    const workspace_pool::workspace_ptr workspace = borrow_workspace();
+    return detail::dfs(*this, start, visitor, *workspace);
+}
+
+}
+
+#include <atomic>
+
+namespace impl
+{
+
+namespace detail
+{
+
+/**
+ * @brief Fixed size bitmap whose bits can be set by several threads at once.
+ */
+class atomic_bitmap
+{
+public:
+    using size_type = std::size_t;
+    using word_type = std::uint64_t;
+
+    constexpr static size_type WORD_BITS = 64;
+
+public:
+    explicit atomic_bitmap(size_type size)
+        : m_words((size + WORD_BITS - 1) / WORD_BITS)
+    {
+        clear();
+    }
+
+    [[nodiscard]] inline size_type num_of_words() const noexcept { return m_words.size(); }
+
+    [[nodiscard]] inline bool test(size_type i) const noexcept
+    {
+        return 0 != (m_words[i / WORD_BITS].load(std::memory_order_relaxed) & mask(i));
+    }
+
+    /**
+     * @return true if the bit was not set before, false otherwise.
+     */
+    inline bool set(size_type i) noexcept
+    {
+        return 0 == (m_words[i / WORD_BITS].fetch_or(mask(i), std::memory_order_relaxed) & mask(i));
+    }
+
+    inline word_type word(size_type w) const noexcept { return m_words[w].load(std::memory_order_relaxed); }
+    inline void or_word(size_type w, word_type bits) noexcept { m_words[w].fetch_or(bits, std::memory_order_relaxed); }
+
+    void clear() noexcept
+    {
+        for (std::atomic<word_type>& w : m_words) {
+            w.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void swap(atomic_bitmap& other) noexcept { m_words.swap(other.m_words); }
+
+private:
+    [[nodiscard]] inline static word_type mask(size_type i) noexcept { return word_type{1} << (i % WORD_BITS); }
+
+private:
+    std::vector<std::atomic<word_type>> m_words;
+
+};
+
+/**
+ * @brief Direction-optimizing parallel breadth first search (Beamer et al.).
+ * @details The frontier is a list of ids while the search runs top-down and a
+ *          bitmap while it runs bottom-up. Top-down steps claim nodes in the
+ *          visited bitmap with an atomic or, bottom-up steps give every
+ *          unvisited node to one thread, so levels and parents are written
+ *          by a single thread each. Both directions sum the out-degrees of
+ *          the nodes they add to the frontier and take them off the edges left
+ *          to check. The search turns bottom-up when the edges of the frontier
+ *          exceed 1 / ALPHA of the edges left to check, and back top-down
+ *          when the frontier stops growing and has less than 1 / BETA of the
+ *          nodes.
+ */
+template <typename Graph>
+bfs_result<typename Graph::id_type> parallel_bfs(const Graph& g, typename Graph::size_type start,
+                                                  bool bottomUp, thread_pool& pool)
+{
+    using size_type = typename Graph::size_type;
+    using id_type = typename Graph::id_type;
+    using frontier = std::vector<id_type>;
+    constexpr id_type INVALID_ID = bfs_result<id_type>::INVALID_ID;
+    constexpr size_type ALPHA = 15;
+    constexpr size_type BETA = 18;
+
+    const size_type size = g.num_of_ids();
+    bfs_result<id_type> result;
+    result.levels.assign(size, INVALID_ID);
+    result.parents.assign(size, INVALID_ID);
+    if (!g.contains(start)) {
+        return result;
+    }
+
+    atomic_bitmap visited(size);
+    std::vector<frontier> locals(pool.size());
+    std::vector<size_type> scouts(pool.size());
+    auto take_scout = [&]() {
+        size_type scout = 0;
+        for (size_type& count : scouts) {
+            scout += count;
+            count = 0;
+        }
+        return scout;
+    };
+    auto gather = [&](frontier& queue) {
+        queue.clear();
+        for (frontier& local : locals) {
+            queue.insert(queue.end(), local.begin(), local.end());
+            local.clear();
+        }
+        return take_scout();
+    };
+
+    // Claim the unvisited targets of the frontier nodes
+    auto top_down_step = [&](const frontier& queue, id_type level) {
+        pool.parallel_for(queue.size(), [&](size_type first, size_type last, size_type worker) {
+            frontier& local = locals[worker];
+            size_type scout = 0;
+            for (size_type i = first; i < last; ++i) {
+                const id_type id = queue[i];
+                for (const auto [toId, toCost] : g.out_edges(id)) {
+                    if (!visited.test(toId) && visited.set(toId)) {
+                        result.parents[toId] = id;
+                        result.levels[toId] = level;
+                        local.push_back(toId);
+                        scout += g.degree(toId);
+                    }
+                }
+            }
+            scouts[worker] += scout;
+        });
+    };
+
+    // Every unvisited node looks for a parent in the frontier
+    auto bottom_up_step = [&](const atomic_bitmap& current, atomic_bitmap& next, id_type level) {
+        std::vector<size_type> awake(pool.size(), 0);
+        pool.parallel_for(current.num_of_words(), [&](size_type first, size_type last, size_type worker) {
+            size_type scout = 0;
+            for (size_type w = first; w < last; ++w) {
+                std::uint64_t found = 0;
+                const std::uint64_t seen = visited.word(w);
+                for (size_type bit = 0; bit < atomic_bitmap::WORD_BITS; ++bit) {
+                    const size_type id = w * atomic_bitmap::WORD_BITS + bit;
+                    if (id >= size) {
+                        break;
+                    }
+                    if (0 != (seen & (std::uint64_t{1} << bit))) {
+                        continue;
+                    }
+                    for (const auto [fromId, fromCost] : g.in_edges(id)) {
+                        if (current.test(fromId)) {
+                            result.parents[id] = fromId;
+                            result.levels[id] = level;
+                            found |= std::uint64_t{1} << bit;
+                            ++awake[worker];
+                            scout += g.degree(id);
+                            break;
+                        }
+                    }
+                }
+                if (0 != found) {
+                    next.or_word(w, found);
+                    visited.or_word(w, found);
+                }
+            }
+            scouts[worker] += scout;
+        }, 64);
+        size_type total = 0;
+        for (const size_type count : awake) {
+            total += count;
+        }
+        return total;
+    };
+
+    visited.set(start);
+    result.levels[start] = 0;
+    frontier queue{static_cast<id_type>(start)};
+    size_type scout = g.degree(start);
+    size_type edgesToCheck = g.num_of_edges();
+    id_type level = 0;
+
+    while (!queue.empty()) {
+        if (bottomUp && scout > edgesToCheck / ALPHA) {
+            atomic_bitmap current(size);
+            atomic_bitmap next(size);
+            for (const id_type id : queue) {
+                current.set(id);
+            }
+            size_type awake = queue.size();
+            size_type oldAwake = 0;
+            do {
+                edgesToCheck -= std::min(edgesToCheck, scout);
+                oldAwake = awake;
+                awake = bottom_up_step(current, next, ++level);
+                scout = take_scout();
+                current.swap(next);
+                next.clear();
+            } while (awake > 0 && (awake >= oldAwake || awake > size / BETA));
+
+            // Back to a list of the frontier nodes
+            pool.parallel_for(current.num_of_words(), [&](size_type first, size_type last, size_type worker) {
+                for (size_type w = first; w < last; ++w) {
+                    const std::uint64_t bits = current.word(w);
+                    for (size_type bit = 0; 0 != bits && bit < atomic_bitmap::WORD_BITS; ++bit) {
+                        if (0 != (bits & (std::uint64_t{1} << bit))) {
+                            locals[worker].push_back(static_cast<id_type>(w * atomic_bitmap::WORD_BITS + bit));
+                        }
+                    }
+                }
+            }, 64);
+            gather(queue);
+        } else {
+            edgesToCheck -= std::min(edgesToCheck, scout);
+            top_down_step(queue, ++level);
+            scout = gather(queue);
+        }
+    }
+
+    return result;
+}
+
+}
+
+template <typename Cost, typename Id>
+bfs_result<Id> basic_graph<Cost, Id>::parallel_bfs(size_type start, size_type numOfThreads) const
+{
+    thread_pool pool{numOfThreads};
+    return detail::parallel_bfs(*this, start, m_incomingIndex, pool);
+}
+
+}
+
+namespace impl
+{
+
+namespace detail
+{
+
+/**
+ * @brief Return true if every node is reachable from start.
+ * @details Breadth first search marking the nodes in a bitset, one bit per
+ *          id instead of a stamp per id, and counting them, so it ends as
+ *          soon as all nodes are reached.
+ */
+template <typename Graph>
+bool reaches_all(const Graph& g, typename Graph::size_type start)
+{
+    using size_type = typename Graph::size_type;
+    using id_type = typename Graph::id_type;
+    using word_type = std::uint64_t;
+    constexpr size_type WORD_BITS = 64;
+
+    std::vector<word_type> reached((g.num_of_ids() + WORD_BITS - 1) / WORD_BITS, 0);
+    std::vector<id_type> queue{static_cast<id_type>(start)};
+    reached[start / WORD_BITS] |= word_type{1} << (start % WORD_BITS);
+    for (size_type head = 0; head < queue.size() && queue.size() < g.size(); ++head) {
+        for (const auto [toId, toCost] : g.out_edges(queue[head])) {
+            word_type& word = reached[toId / WORD_BITS];
+            const word_type bit = word_type{1} << (toId % WORD_BITS);
+            if (0 == (word & bit)) {
+                word |= bit;
+                queue.push_back(toId);
+            }
+        }
+    }
+
+    return queue.size() == g.size();
+}
+
+/**
+ * @brief Return the mother node, or INVALID_ID if there is none.
+ * @details One pass of depth first searches from every node not visited yet
+ *          shares the visited marks, so every node and edge is seen once.
+ *          The last start is the only candidate: the nodes before it do not
+ *          reach it. It is then verified with reaches_all. O(V + E).
+ */
+template <typename Graph>
+typename Graph::size_type mother_node(const Graph& g)
+{
+    using size_type = typename Graph::size_type;
+
+    const size_type numOfIds = g.num_of_ids();
+    if (0 == g.size()) {
+        return Graph::INVALID_ID;
+    }
+
+    const workspace_pool::workspace_ptr workspace = g.borrow_workspace();
+    default_visitor visitor;
+
+    // Ids of removed nodes are never candidates and never need to be reached
+    size_type motherNode = 0;
+    for (size_type i = 0; i < numOfIds; ++i) {
+        if (g.contains(i) && !workspace->visited(i)) {
+            dfs(g, i, visitor, *workspace);
+            motherNode = i;
+        }
+    }
+
+    return reaches_all(g, motherNode) ? motherNode : Graph::INVALID_ID;
+}
+}
+
+template <typename Cost, typename Id>
+const typename basic_graph<Cost, Id>::node* basic_graph<Cost, Id>::mother_node() const
+{
+    const size_type motherNode = detail::mother_node(*this);
+    if (INVALID_ID == motherNode) {
+        return nullptr;
+    }
+    return get_node(motherNode);
+}
+
+template <typename Cost, typename Id>
+typename basic_csr_graph<Cost, Id>::size_type basic_csr_graph<Cost, Id>::mother_node() const
+{
+    return detail::mother_node(*this);
+}
+
+}
+
+namespace impl
+{
+
+namespace detail
+{
+
+/**
+ * @brief sum += value unless the sum does not fit an integer Count.
+ * @return false if the sum does not fit, sum is left unchanged then.
+ */
+template <typename Count>
+[[nodiscard]] inline bool try_add_count(Count& sum, const Count& value)
+{
+    if constexpr (std::is_integral_v<Count>) {
+        if (value > std::numeric_limits<Count>::max() - sum) {
+            return false;
+        }
+    }
+    sum += value;
+    return true;
+}
+
+/**
+ * @brief sum += value, throwing instead of wrapping around for integer counts.
+ * @throw std::overflow_error if the sum does not fit an integer Count.
+ */
+template <typename Count>
+inline void add_count(Count& sum, const Count& value)
+{
+    if (!try_add_count(sum, value)) {
+        throw std::overflow_error("Number of paths does not fit the count type");
+    }
+}
+
+/**
+ * @brief Depth first search visitor counting the paths to target in post-order.
+ * @details A node is finished after all of its successors, so the number of
+ *          paths from it is the sum over its finished successors, the
+ *          target counts 1 and is not expanded. Successors that are not
+ *          finished are ancestors (back edges), their cycle goes on forever
+ *          if the ancestor turns out to reach the target.
+ */
+template <typename Graph, typename Count>
+struct path_counter : default_visitor
+{
+    path_counter(const Graph& g, size_type target, const traversal_workspace& workspace)
+        : g(g)
+        , target(target)
+        , workspace(workspace)
+        , counts(g.num_of_ids(), Count{0})
+        , onCycle(g.num_of_ids(), false)
+    { }
+
+    inline visit_result discover(size_type id, size_type)
+    {
+        if (id == target) {
+            counts[id] = Count{1};
+            return visit_result::SKIP;
+        }
+        return visit_result::PROCEED;
+    }
+
+    template <typename Cost>
+    inline visit_result back_edge(size_type, size_type toId, Cost)
+    {
+        onCycle[toId] = true;
+        return visit_result::PROCEED;
+    }
+
+    inline visit_result finish(size_type id)
+    {
+        Count& count = counts[id];
+        for (const auto [toId, toCost] : g.out_edges(id)) {
+            if (workspace.finished(toId)) {
+                add_count(count, counts[toId]);
+            }
+        }
+        if (onCycle[id] && Count{0} != count) {
+            throw cycle_error("Infinite number of paths, node " + std::to_string(id)
+                              + " is on a cycle that reaches the target", id);
+        }
+        return visit_result::PROCEED;
+    }
+
+    const Graph& g;
+    size_type target;
+    const traversal_workspace& workspace;
+    std::vector<Count> counts;
+    std::vector<bool> onCycle;
+};
+
+/**
+ * @brief Count the paths from one node to another in O(V + E).
+ * @details Dynamic programming over the nodes reachable from the source, in
+ *          the topological order given by a depth first search.
+ */
+template <typename Count, typename Graph>
+Count num_of_paths(const Graph& g, typename Graph::size_type from, typename Graph::size_type to)
+{
+    const workspace_pool::workspace_ptr workspace = g.borrow_workspace();
+    path_counter<Graph, Count> visitor(g, to, *workspace);
+    (void)dfs(g, from, visitor, *workspace);
+    return visitor.counts[from];
+}
+
+/**
+ * @brief Depth first search visitor recording the reachable nodes in
+ *        post-order and the targets of back edges.
+ */
+struct post_order_recorder : default_visitor
+{
+    explicit post_order_recorder(size_type size)
+        : onCycle(size, false)
+    { }
+
+    template <typename Cost>
+    inline visit_result back_edge(size_type, size_type toId, Cost)
+    {
+        onCycle[toId] = true;
+        return visit_result::PROCEED;
+    }
+
+    inline visit_result finish(size_type id)
+    {
+        order.push_back(id);
+        return visit_result::PROCEED;
+    }
+
+    std::vector<size_type> order;
+    std::vector<bool> onCycle;
+};
+
+/**
+ * @brief Number of paths from one node to every node, in one sweep.
+ * @details Nodes reachable from the source are swept in topological order
+ *          (reverse post-order of a depth first search), every node adds its
+ *          count to its successors. A node reachable from a cycle has an
+ *          infinite count, it remembers a node of the cycle instead. Sums
+ *          that do not fit an integer Count are flagged, so that only the
+ *          counts asked for throw.
+ */
+template <typename Count, typename Graph>
+class path_count_table
+{
+public:
+    using size_type = typename Graph::size_type;
+
+public:
+    path_count_table(const Graph& g, size_type from)
+        : m_counts(g.num_of_ids(), Count{0})
+        , m_cycleNodes(g.num_of_ids(), Graph::INVALID_ID)
+        , m_overflow(g.num_of_ids(), false)
+    {
+        post_order_recorder visitor(g.num_of_ids());
+        (void)dfs(g, from, visitor, *g.borrow_workspace());
+
+        m_counts[from] = Count{1};
+        for (auto it = visitor.order.rbegin(); it != visitor.order.rend(); ++it) {
+            const size_type id = *it;
+            if (visitor.onCycle[id] && Graph::INVALID_ID == m_cycleNodes[id]) {
+                m_cycleNodes[id] = id;
+            }
+            for (const auto [toId, toCost] : g.out_edges(id)) {
+                if (Graph::INVALID_ID != m_cycleNodes[id]) {
+                    if (Graph::INVALID_ID == m_cycleNodes[toId]) {
+                        m_cycleNodes[toId] = m_cycleNodes[id];
+                    }
+                } else if (m_overflow[id] || !try_add_count(m_counts[toId], m_counts[id])) {
+                    m_overflow[toId] = true;
+                }
+            }
+        }
+    }
+
+    /**
+     * @throw cycle_error if a cycle lies on a path to the node.
+     * @throw std::overflow_error if the count does not fit an integer Count.
+     */
+    [[nodiscard]] Count count(size_type id) const
+    {
+        if (Graph::INVALID_ID != m_cycleNodes[id]) {
+            throw cycle_error("Infinite number of paths, node " + std::to_string(m_cycleNodes[id])
+                              + " is on a cycle that reaches node " + std::to_string(id), m_cycleNodes[id]);
+        }
+        if (m_overflow[id]) {
+            throw std::overflow_error("Number of paths does not fit the count type");
+        }
+        return m_counts[id];
+    }
+
+    /**
+     * @brief Return the counts of all the nodes, checked as count(id).
+     */
+    [[nodiscard]] std::vector<Count> release()
+    {
+        for (size_type id = 0; id < m_counts.size(); ++id) {
+            (void)count(id);
+        }
+        return std::move(m_counts);
+    }
+
+private:
+    std::vector<Count> m_counts;
+    std::vector<size_type> m_cycleNodes;
+    std::vector<bool> m_overflow;
+
+};
+
+template <typename Count, typename Graph, typename ForwardIt>
+std::vector<Count> num_of_paths(const Graph& g, typename Graph::size_type from, ForwardIt first, ForwardIt last)
+{
+    std::vector<Count> result;
+    result.reserve(static_cast<std::size_t>(std::distance(first, last)));
+    if (!g.contains(from)) {
+        result.resize(result.capacity(), Count{0});
+        return result;
+    }
+
+    const path_count_table<Count, Graph> table(g, from);
+    for (; first != last; ++first) {
+        const auto to = *first;
+        result.push_back(g.contains(to) ? table.count(to) : Count{0});
+    }
+    return result;
+}
+
+template <typename Count, typename Graph>
+std::vector<Count> num_of_paths_from(const Graph& g, typename Graph::size_type from)
+{
+    if (!g.contains(from)) {
+        return std::vector<Count>(g.num_of_ids(), Count{0});
+    }
+    return path_count_table<Count, Graph>(g, from).release();
+}
+
+}
+
+template <typename Cost, typename Id>
+template <typename Count>
+Count basic_graph<Cost, Id>::num_of_paths(const node* from, const node* to) const
+{
+    if (nullptr == from || nullptr == to) {
+        return Count{0};
+    }
+
+    return detail::num_of_paths<Count>(*this, from->get_id(), to->get_id());
+}
+
+template <typename Cost, typename Id>
+template <typename Count>
+Count basic_csr_graph<Cost, Id>::num_of_paths(size_type from, size_type to) const
+{
+    if (!contains(from) || !contains(to)) {
+        return Count{0};
+    }
+
+    return detail::num_of_paths<Count>(*this, from, to);
+}
+
+template <typename Cost, typename Id>
+template <typename Count, typename ForwardIt>
+std::vector<Count> basic_graph<Cost, Id>::num_of_paths(size_type from, ForwardIt first, ForwardIt last) const
+{
+    return detail::num_of_paths<Count>(*this, from, first, last);
+}
+
+template <typename Cost, typename Id>
+template <typename Count>
+std::vector<Count> basic_graph<Cost, Id>::num_of_paths_from(size_type from) const
+{
+    return detail::num_of_paths_from<Count>(*this, from);
+}
+
+template <typename Cost, typename Id>
+template <typename Count, typename ForwardIt>
+std::vector<Count> basic_csr_graph<Cost, Id>::num_of_paths(size_type from, ForwardIt first, ForwardIt last) const
+{
+    return detail::num_of_paths<Count>(*this, from, first, last);
+}
+
+template <typename Cost, typename Id>
+template <typename Count>
+std::vector<Count> basic_csr_graph<Cost, Id>::num_of_paths_from(size_type from) const
+{
+    return detail::num_of_paths_from<Count>(*this, from);
+}
+
+}
+
+#include <atomic>
+
+namespace impl
+{
+
+namespace detail
+{
+
+/**
+ * @brief Depth first search that stops at the first back edge.
+ */
+struct cycle_finder : default_visitor
+{
+    template <typename Cost>
+    constexpr visit_result back_edge(size_type, size_type, Cost) noexcept { return visit_result::STOP; }
+};
+
+template <typename Graph>
+bool is_cyclic(const Graph& g)
+{
+    using size_type = typename Graph::size_type;
+
+    const workspace_pool::workspace_ptr workspace = g.borrow_workspace();
+    cycle_finder visitor;
+    for (size_type i = 0; i < g.num_of_ids(); ++i) {
+        if (g.contains(i) && dfs(g, i, visitor, *workspace)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Depth first search that stops at the first back edge and keeps the
+ *        path from the root, so the cycle closed by the back edge is known.
+ */
+struct cycle_recorder : default_visitor
+{
+    inline visit_result discover(size_type id, size_type)
+    {
+        path.push_back(id);
+        return visit_result::PROCEED;
+    }
+
+    template <typename Cost>
+    inline visit_result back_edge(size_type, size_type toId, Cost)
+    {
+        const auto it = std::find(path.rbegin(), path.rend(), toId);
+        cycle.assign(std::prev(it.base()), path.end());
+        return visit_result::STOP;
+    }
+
+    inline visit_result finish(size_type)
+    {
+        path.pop_back();
+        return visit_result::PROCEED;
+    }
+
+    std::vector<size_type> path;
+    std::vector<size_type> cycle;
+};
+
+template <typename Graph>
+std::vector<typename Graph::size_type> find_cycle(const Graph& g)
+{
+    using size_type = typename Graph::size_type;
+
+    const workspace_pool::workspace_ptr workspace = g.borrow_workspace();
+    cycle_recorder visitor;
+    for (size_type i = 0; i < g.num_of_ids(); ++i) {
+        if (g.contains(i) && dfs(g, i, visitor, *workspace)) {
+            break;
+        }
+    }
+
+    return std::move(visitor.cycle);
+}
+
+/**
+ * @brief Count the incoming edges of every node, each thread takes a block of
+ *        nodes and increments the counters of their targets.
+ * @details Counters are size_type, parallel edges can give a node more
+ *          incoming edges than the id type holds.
+ */
+template <typename Graph>
+std::vector<std::atomic<typename Graph::size_type>> in_degrees(const Graph& g, thread_pool& pool)
+{
+    using size_type = typename Graph::size_type;
+
+    std::vector<std::atomic<size_type>> degrees(g.num_of_ids());
+    pool.parallel_for(degrees.size(), [&](size_type first, size_type last, size_type) {
+        for (size_type i = first; i < last; ++i) {
+            degrees[i].store(0, std::memory_order_relaxed);
+        }
+    });
+    pool.parallel_for(g.num_of_ids(), [&](size_type first, size_type last, size_type) {
+        for (size_type i = first; i < last; ++i) {
+            if (!g.contains(i)) {
+                continue;
+            }
+            for (const auto [toId, toCost] : g.out_edges(i)) {
+                degrees[toId].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    });
+    return degrees;
+}
+
+/**
+ * @brief Kahn's algorithm: remove the nodes without incoming edges until none
+ *        is left, in the order they are removed. The nodes on or behind a
+ *        cycle are never removed, so the order is short of them.
+ */
+template <typename Graph, typename Progress>
+std::vector<typename Graph::size_type> kahn_order(const Graph& g, Progress& progress, thread_pool& pool)
+{
+    using size_type = typename Graph::size_type;
+    constexpr size_type PROGRESS_STEP = size_type{1} << 16;
+
+    std::vector<std::atomic<size_type>> degrees = in_degrees(g, pool);
+    std::vector<size_type> order;
+    order.reserve(g.size());
+    for (size_type i = 0; i < g.num_of_ids(); ++i) {
+        if (g.contains(i) && 0 == degrees[i].load(std::memory_order_relaxed)) {
+            order.push_back(i);
+        }
+    }
+
+    // The order is the queue, nodes before head are removed
+    for (size_type head = 0; head < order.size(); ++head) {
+        for (const auto [toId, toCost] : g.out_edges(order[head])) {
+            std::atomic<size_type>& degree = degrees[toId];
+            const size_type left = degree.load(std::memory_order_relaxed) - 1;
+            degree.store(left, std::memory_order_relaxed);
+            if (0 == left) {
+                order.push_back(toId);
+            }
+        }
+        if (0 == (head + 1) % PROGRESS_STEP) {
+            progress(head + 1, g.size());
+        }
+    }
+    progress(order.size(), g.size());
+
+    return order;
+}
+
+}
+
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::is_cyclic() const
+{
+    return detail::is_cyclic(*this);
+}
+
+template <typename Cost, typename Id>
+bool basic_csr_graph<Cost, Id>::is_cyclic() const
+{
+    return detail::is_cyclic(*this);
+}
+
+template <typename Cost, typename Id>
+template <typename Progress>
+bool basic_graph<Cost, Id>::is_cyclic(Progress&& progress, size_type numOfThreads) const
+{
+    thread_pool pool{numOfThreads};
+    return detail::kahn_order(*this, progress, pool).size() != size();
+}
+
+template <typename Cost, typename Id>
+template <typename Progress>
+bool basic_csr_graph<Cost, Id>::is_cyclic(Progress&& progress, size_type numOfThreads) const
+{
+    thread_pool pool{numOfThreads};
+    return detail::kahn_order(*this, progress, pool).size() != size();
+}
+
+template <typename Cost, typename Id>
+std::vector<typename basic_graph<Cost, Id>::size_type> basic_graph<Cost, Id>::find_cycle() const
+{
+    return detail::find_cycle(*this);
+}
+
+template <typename Cost, typename Id>
+std::vector<typename basic_csr_graph<Cost, Id>::size_type> basic_csr_graph<Cost, Id>::find_cycle() const
+{
+    return detail::find_cycle(*this);
+}
+
+}
+
+namespace impl
+{
+
+namespace detail
+{
+
+/**
+ * @brief Throw a cycle_error naming a node of a cycle found by find_cycle.
+ * @details Kahn's algorithm left nodes over, so the depth first search must
+ *          find a cycle, the error names no node if it does not.
+ */
+template <typename Graph>
+[[noreturn]] void throw_cycle_error(const Graph& g)
+{
+    const std::vector<typename Graph::size_type> cycle = find_cycle(g);
+    assert(!cycle.empty() && "Kahn's algorithm and the depth first search disagree on the cycle");
+    if (cycle.empty()) {
+        throw cycle_error("No topological order, the graph has a cycle", Graph::INVALID_ID);
+    }
+    throw cycle_error("No topological order, node " + std::to_string(cycle.front()) + " is on a cycle",
+                      cycle.front());
+}
+
+template <typename Graph>
+std::vector<typename Graph::size_type> topological_order(const Graph& g)
+{
+    thread_pool pool{1};
+    auto ignore = [](typename Graph::size_type, typename Graph::size_type) { };
+    std::vector<typename Graph::size_type> order = kahn_order(g, ignore, pool);
+    if (order.size() != g.size()) {
+        throw_cycle_error(g);
+    }
+    return order;
+}
+
+/**
+ * @brief Level synchronous parallel Kahn's algorithm.
+ * @details The frontier holds the nodes whose in-degree dropped to 0, the
+ *          threads split it and decrement the atomic in-degrees of the
+ *          targets, the thread that takes a counter to 0 owns the node for
+ *          the next level. The end of parallel_for orders the levels, so the
+ *          counters need no stronger ordering than relaxed.
+ */
+template <typename Graph>
+std::vector<std::vector<typename Graph::size_type>> topological_levels(const Graph& g, thread_pool& pool)
+{
+    using size_type = typename Graph::size_type;
+    using frontier = std::vector<size_type>;
+
+    std::vector<std::atomic<size_type>> degrees = in_degrees(g, pool);
+    frontier queue;
+    for (size_type i = 0; i < g.num_of_ids(); ++i) {
+        if (g.contains(i) && 0 == degrees[i].load(std::memory_order_relaxed)) {
+            queue.push_back(i);
+        }
+    }
+
+    std::vector<frontier> levels;
+    std::vector<frontier> locals(pool.size());
+    size_type placed = 0;
+    while (!queue.empty()) {
+        pool.parallel_for(queue.size(), [&](size_type first, size_type last, size_type worker) {
+            frontier& local = locals[worker];
+            for (size_type i = first; i < last; ++i) {
+                for (const auto [toId, toCost] : g.out_edges(queue[i])) {
+                    if (1 == degrees[toId].fetch_sub(1, std::memory_order_relaxed)) {
+                        local.push_back(toId);
+                    }
+                }
+            }
+        });
+        placed += queue.size();
+        levels.push_back(std::move(queue));
+
+        queue = frontier{};
+        for (frontier& local : locals) {
+            queue.insert(queue.end(), local.begin(), local.end());
+            local.clear();
+        }
+        std::sort(queue.begin(), queue.end());
+    }
+
+    if (placed != g.size()) {
+        throw_cycle_error(g);
+    }
+    return levels;
+}
+
+}
+
+template <typename Cost, typename Id>
+std::vector<typename basic_graph<Cost, Id>::size_type> basic_graph<Cost, Id>::topological_order() const
+{
+    return detail::topological_order(*this);
+}
+
+template <typename Cost, typename Id>
+std::vector<std::vector<typename basic_graph<Cost, Id>::size_type>>
+basic_graph<Cost, Id>::topological_levels(size_type numOfThreads) const
+{
+    thread_pool pool{numOfThreads};
+    return detail::topological_levels(*this, pool);
+}
+
+template <typename Cost, typename Id>
+std::vector<typename basic_csr_graph<Cost, Id>::size_type> basic_csr_graph<Cost, Id>::topological_order() const
+{
+    return detail::topological_order(*this);
+}
+
+template <typename Cost, typename Id>
+std::vector<std::vector<typename basic_csr_graph<Cost, Id>::size_type>>
+basic_csr_graph<Cost, Id>::topological_levels(size_type numOfThreads) const
+{
+    thread_pool pool{numOfThreads};
+    return detail::topological_levels(*this, pool);
+}
+
+}
+
+#include <atomic>
+
+namespace impl
+{
+
+namespace detail
+{
+
+/**
+ * @brief Tarjan's algorithm, iterative.
+ * @details The path from the root is a stack of (node, next edge) frames.
+ *          Every node gets a discovery index and the lowest index it reaches
+ *          over nodes still on the component stack, a node whose low index
+ *          is its own closes a component. Components close sinks first, so
+ *          they are numbered backwards to be in topological order.
+ */
+template <typename Graph>
+scc_result<typename Graph::id_type> tarjan(const Graph& g)
+{
+    using size_type = typename Graph::size_type;
+    using id_type = typename Graph::id_type;
+    using arc_iterator = decltype(g.out_edges(0).begin());
+    constexpr id_type INVALID_ID = scc_result<id_type>::INVALID_ID;
+
+    struct frame
+    {
+        size_type id;
+        arc_iterator next;
+        arc_iterator last;
+    };
+
+    const size_type size = g.num_of_ids();
+    scc_result<id_type> result;
+    result.components.assign(size, INVALID_ID);
+    std::vector<id_type> index(size, INVALID_ID);
+    std::vector<id_type> low(size, INVALID_ID);
+    std::vector<id_type> stack;
+    std::vector<frame> path;
+    id_type counter = 0;
+
+    auto discover = [&](size_type id) {
+        index[id] = low[id] = counter++;
+        stack.push_back(static_cast<id_type>(id));
+        const auto edges = g.out_edges(id);
+        path.push_back(frame{id, edges.begin(), edges.end()});
+    };
+
+    for (size_type root = 0; root < size; ++root) {
+        if (!g.contains(root) || INVALID_ID != index[root]) {
+            continue;
+        }
+        discover(root);
+        while (!path.empty()) {
+            frame& top = path.back();
+            if (top.next != top.last) {
+                const size_type id = top.id;
+                const size_type toId = (*top.next).to;
+                ++top.next;
+                if (INVALID_ID == index[toId]) {
+                    discover(toId);
+                } else if (INVALID_ID == result.components[toId]) {
+                    // Visited without a component: still on the stack
+                    low[id] = std::min(low[id], index[toId]);
+                }
+                continue;
+            }
+
+            const size_type id = top.id;
+            path.pop_back();
+            if (!path.empty()) {
+                low[path.back().id] = std::min(low[path.back().id], low[id]);
+            }
+            if (low[id] == index[id]) {
+                const auto component = static_cast<id_type>(result.sizes.size());
+                id_type count = 0;
+                id_type member = INVALID_ID;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    result.components[member] = component;
+                    ++count;
+                } while (member != id);
+                result.sizes.push_back(count);
+            }
+        }
+    }
+
+    const auto last = static_cast<id_type>(result.sizes.size() - 1);
+    for (id_type& component : result.components) {
+        if (INVALID_ID != component) {
+            component = last - component;
+        }
+    }
+    std::reverse(result.sizes.begin(), result.sizes.end());
+    return result;
+}
+
+/**
+ * @brief Parallel strongly connected components: trim, forward-backward and coloring.
+ * @details The incoming edges are built as CSR arrays first. Each round
+ *          trims the remaining nodes without incoming or outgoing edges
+ *          among the remaining nodes, they are components on their own.
+ *          The first round then takes the component of a pivot of high
+ *          degree, usually the giant one, as the nodes both reachable from
+ *          it and reaching it, with two parallel breadth first searches.
+ *          The later rounds color every node with the largest id that
+ *          reaches it. A node keeping its own color is a root, its color
+ *          class holds its component, the nodes that reach it backward
+ *          within the class, each root is searched by one thread.
+ */
+template <typename Graph>
+scc_result<typename Graph::id_type> parallel_scc(const Graph& g, thread_pool& pool)
+{
+    using size_type = typename Graph::size_type;
+    using id_type = typename Graph::id_type;
+    using frontier = std::vector<id_type>;
+    constexpr id_type INVALID_ID = scc_result<id_type>::INVALID_ID;
+
+    const size_type size = g.num_of_ids();
+
+    // Incoming edges, the in-degree counters become the insert positions
+    std::vector<std::atomic<size_type>> cursors = in_degrees(g, pool);
+    std::vector<size_type> offsets(size + 1, 0);
+    for (size_type i = 0; i < size; ++i) {
+        offsets[i + 1] = offsets[i] + cursors[i].load(std::memory_order_relaxed);
+        cursors[i].store(offsets[i], std::memory_order_relaxed);
+    }
+    std::vector<id_type> sources(offsets[size]);
+    pool.parallel_for(size, [&](size_type first, size_type last, size_type) {
+        for (size_type i = first; i < last; ++i) {
+            if (!g.contains(i)) {
+                continue;
+            }
+            for (const auto [toId, toCost] : g.out_edges(i)) {
+                sources[cursors[toId].fetch_add(1, std::memory_order_relaxed)] = static_cast<id_type>(i);
+            }
+        }
+    });
+
+    auto for_each_out = [&](size_type id, auto&& f) {
+        for (const auto [toId, toCost] : g.out_edges(id)) {
+            f(static_cast<size_type>(toId));
+        }
+    };
+    auto for_each_in = [&](size_type id, auto&& f) {
+        for (size_type i = offsets[id]; i < offsets[id + 1]; ++i) {
+            f(static_cast<size_type>(sources[i]));
+        }
+    };
+
+    std::vector<std::atomic<id_type>> components(size);
+    std::atomic<id_type> numOfComponents{0};
+    frontier remaining;
+    for (size_type i = 0; i < size; ++i) {
+        components[i].store(INVALID_ID, std::memory_order_relaxed);
+        if (g.contains(i)) {
+            remaining.push_back(static_cast<id_type>(i));
+        }
+    }
+    auto alive = [&](size_type id) { return INVALID_ID == components[id].load(std::memory_order_relaxed); };
+    auto new_component = [&]() { return numOfComponents.fetch_add(1, std::memory_order_relaxed); };
+    auto compact = [&]() {
+        remaining.erase(std::remove_if(remaining.begin(), remaining.end(), [&](id_type id) { return !alive(id); }),
+                        remaining.end());
+    };
+
+    // A node trimmed at the same time as its neighbor is alone in its
+    // component, so seeing the neighbor either way is right
+    auto trim = [&]() {
+        pool.parallel_for(remaining.size(), [&](size_type first, size_type last, size_type) {
+            for (size_type i = first; i < last; ++i) {
+                const size_type id = remaining[i];
+                bool in = false;
+                bool out = false;
+                for_each_in(id, [&](size_type from) { in = in || (from != id && alive(from)); });
+                for_each_out(id, [&](size_type to) { out = out || (to != id && alive(to)); });
+                if (!in || !out) {
+                    components[id].store(new_component(), std::memory_order_relaxed);
+                }
+            }
+        });
+        compact();
+    };
+
+    std::vector<frontier> locals(pool.size());
+    auto reach = [&](size_type pivot, auto&& expand, atomic_bitmap& seen) {
+        seen.set(pivot);
+        frontier queue{static_cast<id_type>(pivot)};
+        while (!queue.empty()) {
+            pool.parallel_for(queue.size(), [&](size_type first, size_type last, size_type worker) {
+                for (size_type i = first; i < last; ++i) {
+                    expand(queue[i], [&](size_type to) {
+                        if (alive(to) && !seen.test(to) && seen.set(to)) {
+                            locals[worker].push_back(static_cast<id_type>(to));
+                        }
+                    });
+                }
+            });
+            queue.clear();
+            for (frontier& local : locals) {
+                queue.insert(queue.end(), local.begin(), local.end());
+                local.clear();
+            }
+        }
+    };
+
+    trim();
+    if (!remaining.empty()) {
+        size_type pivot = remaining.front();
+        size_type best = 0;
+        for (const id_type id : remaining) {
+            const size_type degree = (offsets[id + 1] - offsets[id]) * g.degree(id);
+            if (degree > best) {
+                best = degree;
+                pivot = id;
+            }
+        }
+        atomic_bitmap forward(size);
+        atomic_bitmap backward(size);
+        reach(pivot, for_each_out, forward);
+        reach(pivot, for_each_in, backward);
+        const id_type component = new_component();
+        pool.parallel_for(remaining.size(), [&](size_type first, size_type last, size_type) {
+            for (size_type i = first; i < last; ++i) {
+                if (forward.test(remaining[i]) && backward.test(remaining[i])) {
+                    components[remaining[i]].store(component, std::memory_order_relaxed);
+                }
+            }
+        });
+        compact();
+    }
+
+    std::vector<std::atomic<id_type>> colors(size);
+    for (trim(); !remaining.empty(); trim()) {
+        pool.parallel_for(remaining.size(), [&](size_type first, size_type last, size_type) {
+            for (size_type i = first; i < last; ++i) {
+                colors[remaining[i]].store(remaining[i], std::memory_order_relaxed);
+            }
+        });
+
+        // Push the largest colors forward until none changes
+        for (std::atomic<bool> changed{true}; changed.exchange(false);) {
+            pool.parallel_for(remaining.size(), [&](size_type first, size_type last, size_type) {
+                bool local = false;
+                for (size_type i = first; i < last; ++i) {
+                    const id_type color = colors[remaining[i]].load(std::memory_order_relaxed);
+                    for_each_out(remaining[i], [&](size_type to) {
+                        if (!alive(to)) {
+                            return;
+                        }
+                        id_type current = colors[to].load(std::memory_order_relaxed);
+                        while (current < color) {
+                            if (colors[to].compare_exchange_weak(current, color, std::memory_order_relaxed)) {
+                                local = true;
+                                break;
+                            }
+                        }
+                    });
+                }
+                if (local) {
+                    changed.store(true, std::memory_order_relaxed);
+                }
+            });
+        }
+
+        frontier roots;
+        for (const id_type id : remaining) {
+            if (id == colors[id].load(std::memory_order_relaxed)) {
+                roots.push_back(id);
+            }
+        }
+        pool.parallel_for(roots.size(), [&](size_type first, size_type last, size_type) {
+            frontier stack;
+            for (size_type i = first; i < last; ++i) {
+                const id_type root = roots[i];
+                const id_type component = new_component();
+                components[root].store(component, std::memory_order_relaxed);
+                stack.push_back(root);
+                while (!stack.empty()) {
+                    const id_type id = stack.back();
+                    stack.pop_back();
+                    for_each_in(id, [&](size_type from) {
+                        if (root == colors[from].load(std::memory_order_relaxed) && alive(from)) {
+                            components[from].store(component, std::memory_order_relaxed);
+                            stack.push_back(static_cast<id_type>(from));
+                        }
+                    });
+                }
+            }
+        }, 1);
+        compact();
+    }
+
+    scc_result<id_type> result;
+    result.components.resize(size);
+    result.sizes.assign(numOfComponents.load(), 0);
+    for (size_type i = 0; i < size; ++i) {
+        result.components[i] = components[i].load(std::memory_order_relaxed);
+        if (INVALID_ID != result.components[i]) {
+            ++result.sizes[result.components[i]];
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Graph of the components, node c named after component c, with the
+ *        cheapest edge between every two components that have edges.
+ */
+template <typename Cost, typename Id, typename Graph>
+basic_graph<Cost, Id> condensation(const Graph& g, const scc_result<Id>& scc)
+{
+    using size_type = typename Graph::size_type;
+    using edge_type = std::conditional_t<basic_graph<Cost, Id>::is_weighted,
+                                         std::tuple<size_type, size_type, typename Graph::cost_type>,
+                                         std::tuple<size_type, size_type>>;
+
+    std::vector<edge_type> edges;
+    for (size_type i = 0; i < g.num_of_ids(); ++i) {
+        if (!g.contains(i)) {
+            continue;
+        }
+        for (const auto [toId, toCost] : g.out_edges(i)) {
+            if (scc.components[i] != scc.components[toId]) {
+                if constexpr (basic_graph<Cost, Id>::is_weighted) {
+                    edges.emplace_back(scc.components[i], scc.components[toId], toCost);
+                } else {
+                    edges.emplace_back(scc.components[i], scc.components[toId]);
+                }
+            }
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end(), [](const edge_type& lhs, const edge_type& rhs) {
+        return std::get<0>(lhs) == std::get<0>(rhs) && std::get<1>(lhs) == std::get<1>(rhs);
+    }), edges.end());
+
+    basic_graph<Cost, Id> result;
+    for (size_type c = 0; c < scc.count(); ++c) {
+        result.add_node(std::to_string(c));
+    }
+    result.add_edges(edges.begin(), edges.end());
+    return result;
+}
 
-    public:
-        explicit const_iterator(const graph& g, const node* n, iter_type type);
-        ~const_iterator() = default;
+}
 
-        const_iterator& operator++();
-        const_iterator operator++(int);
+template <typename Cost, typename Id>
+scc_result<Id> basic_graph<Cost, Id>::strongly_connected_components() const
+{
+    return detail::tarjan(*this);
+}
 
-        //! NOTE: if iter_types are the same, and if nodes they point to
-        //        are the same, they are equal
-        bool operator==(const const_iterator& other) const;
-        bool operator!=(const const_iterator& other) const;
-        const_reference operator*() const;
+template <typename Cost, typename Id>
+scc_result<Id> basic_graph<Cost, Id>::parallel_strongly_connected_components(size_type numOfThreads) const
+{
+    thread_pool pool{numOfThreads};
+    return detail::parallel_scc(*this, pool);
+}
 
-        [[nodiscard]] inline bool is_BFS() const noexcept { return iter_type::BFS == m_type; }
-        [[nodiscard]] inline bool is_DFS() const noexcept { return iter_type::DFS == m_type; }
+template <typename Cost, typename Id>
+basic_graph<Cost, Id> basic_graph<Cost, Id>::condensation(const scc_result<Id>& scc) const
+{
+    return detail::condensation<Cost, Id>(*this, scc);
+}
 
-    private:
-        void collect_nodes();
+template <typename Cost, typename Id>
+scc_result<Id> basic_csr_graph<Cost, Id>::strongly_connected_components() const
+{
+    return detail::tarjan(*this);
+}
 
-    private:
-        iter_type m_type;
-        const node* m_node; // nullptr means the end of the graph
-        std::vector<bool> m_visited;
-        std::deque<const node*> m_deque;
-    };
+template <typename Cost, typename Id>
+scc_result<Id> basic_csr_graph<Cost, Id>::parallel_strongly_connected_components(size_type numOfThreads) const
+{
+    thread_pool pool{numOfThreads};
+    return detail::parallel_scc(*this, pool);
+}
 
-    [[nodiscard]] iterator begin_BFS(size_type start) { return iterator(*this, get_node(start), iterator::iter_type::BFS); }
-    [[nodiscard]] iterator begin_BFS(const std::string& name) { return iterator(*this, get_node(name), iterator::iter_type::BFS); }
-    [[nodiscard]] iterator end_BFS() { return iterator(*this, nullptr, iterator::iter_type::BFS); }
-    [[nodiscard]] iterator begin_DFS(size_type start) { return iterator(*this, get_node(start), iterator::iter_type::DFS); }
-    [[nodiscard]] iterator begin_DFS(const std::string& name) { return iterator(*this, get_node(name), iterator::iter_type::DFS); }
-    [[nodiscard]] iterator end_DFS() { return iterator(*this, nullptr, iterator::iter_type::DFS); }
+template <typename Cost, typename Id>
+basic_graph<Cost, Id> basic_csr_graph<Cost, Id>::condensation(const scc_result<Id>& scc) const
+{
+    return detail::condensation<Cost, Id>(*this, scc);
+}
 
-    [[nodiscard]] const_iterator begin_BFS(size_type start) const { return const_iterator(*this, get_node(start), const_iterator::iter_type::BFS); }
-    [[nodiscard]] const_iterator begin_BFS(const std::string& name) const { return const_iterator(*this, get_node(name), const_iterator::iter_type::BFS); }
-    [[nodiscard]] const_iterator end_BFS() const { return const_iterator(*this, nullptr, const_iterator::iter_type::BFS); }
-    [[nodiscard]] const_iterator begin_DFS(size_type start) const { return const_iterator(*this, get_node(start), const_iterator::iter_type::DFS); }
-    [[nodiscard]] const_iterator begin_DFS(const std::string& name) const { return const_iterator(*this, get_node(name), const_iterator::iter_type::DFS); }
-    [[nodiscard]] const_iterator end_DFS() const { return const_iterator(*this, nullptr, const_iterator::iter_type::DFS); }
+}
 
-    [[nodiscard]] const_iterator cbegin_BFS(size_type start) const { return begin_BFS(start); }
-    [[nodiscard]] const_iterator cbegin_BFS(const std::string& name) const { return begin_BFS(name); }
-    [[nodiscard]] const_iterator cend_BFS() const { return end_BFS(); }
-    [[nodiscard]] const_iterator cbegin_DFS(size_type start) const { return begin_DFS(start); }
-    [[nodiscard]] const_iterator cbegin_DFS(const std::string& name) const { return begin_DFS(name); }
-    [[nodiscard]] const_iterator cend_DFS() const { return end_DFS(); }
+namespace impl
+{
 
-    [[nodiscard]] edge_iterator begin_edges() { return m_edges.begin(); }
-    [[nodiscard]] edge_iterator end_edges() { return m_edges.end(); }
-    [[nodiscard]] const_edge_iterator begin_edges() const { return m_edges.cbegin(); }
-    [[nodiscard]] const_edge_iterator end_edges() const { return m_edges.cend(); }
-    [[nodiscard]] const_edge_iterator cbegin_edges() const { return begin_edges(); }
-    [[nodiscard]] const_edge_iterator cend_edges() const { return end_edges(); }
+namespace detail
+{
 
-    [[nodiscard]] inline node* get_node(const std::string& name);
-    [[nodiscard]] inline const node* get_node(const std::string& name) const;
+/**
+ * @brief Costs of single source shortest paths, without predecessors.
+ */
+template <typename Cost>
+struct cost_recorder
+{
+    using size_type = std::size_t;
 
-private:
-    [[nodiscard]] inline size_type get_node_id(const std::string& name) const;
-    [[nodiscard]] inline node* get_node(size_type start);
-    [[nodiscard]] inline const node* get_node(size_type start) const;
-    [[nodiscard]] inline node* get_or_create_node(const std::string& name);
-    [[nodiscard]] inline bool add_edge(node* fromNode, node* toNode, edge::Cost_t cost);
-    inline void add_edge(edge* e);
+    cost_recorder(size_type size, size_type source)
+        : costs(size, cost_traits<Cost>::infinity())
+    {
+        costs[source] = 0;
+    }
 
-private:
-    std::vector<node*> m_adjList;
-    std::vector<const edge*> m_edges;
-    std::map<std::string, node*> m_nameToNode;
+    [[nodiscard]] inline Cost cost(size_type id) const { return costs[id]; }
+    inline void relax(size_type id, Cost cost, size_type, size_type) { costs[id] = cost; }
 
+    std::vector<Cost> costs;
 };
 
-}
+/**
+ * @brief Breadth first search visitor that records hop counts (and
+ *        predecessors) of an unweighted graph in a dijkstra result.
+ * @details Every node is relaxed once, from the first node that reaches it,
+ *          the search stops when the target is discovered.
+ */
+template <typename Result, typename Graph>
+struct hop_recorder : default_visitor
+{
+    using cost_type = typename Graph::cost_type;
 
-////////////////////////////////////////////////////////////////////////////////
-////  Includes  ////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+    hop_recorder(Result& result, size_type target)
+        : result(result)
+        , target(target)
+    { }
 
-namespace impl
-{
+    template <typename Cost>
+    inline visit_result examine_edge(size_type id, size_type, Cost) noexcept
+    {
+        rank = (id == from) ? rank + 1 : 0;
+        from = id;
+        return visit_result::PROCEED;
+    }
 
-////////////////////////////////////////////////////////////////////////////////
-///// graph::iterator
-////////////////////////////////////////////////////////////////////////////////
-graph::iterator::iterator(const graph& g, node* n, iter_type type)
-    : m_type(type)
-    , m_node(n)
-    , m_visited(g.size(), false)
-    , m_deque()
-{
-    if (nullptr != m_node) {
-        m_visited[m_node->get_id()] = true;
-        collect_nodes();
+    template <typename Cost>
+    inline visit_result tree_edge(size_type id, size_type toId, Cost)
+    {
+        result.relax(toId, static_cast<cost_type>(result.cost(id) + 1), id, rank);
+        return visit_result::PROCEED;
+    }
+
+    inline visit_result discover(size_type id, size_type) const noexcept
+    {
+        return id == target ? visit_result::STOP : visit_result::PROCEED;
     }
-}
 
-graph::iterator& graph::iterator::operator++()
+    Result& result;
+    size_type target;
+    size_type from = Graph::INVALID_ID;
+    size_type rank = 0;
+};
+
+/**
+ * @brief Dijkstra over an indexed heap, every node is popped at most once.
+ * @details Costs (and predecessors) are written to the result in the
+ *          relaxation loop. Stops as soon as the target is settled, costs of
+ *          the nodes that are not settled by then are upper bounds only.
+ *          Unweighted graphs are searched breadth first with hop_recorder instead.
+ */
+template <typename Graph, typename Result>
+void dijkstra_search(const Graph& g, typename Graph::size_type start, Result& result,
+                     typename Graph::size_type target = Graph::INVALID_ID)
 {
-    if (m_deque.empty()) {
-        m_node = nullptr;
-        return *this;
+    using size_type = typename Graph::size_type;
+    using cost_type = typename Graph::cost_type;
+
+    if constexpr (!Graph::is_weighted) {
+        hop_recorder<Result, Graph> visitor(result, target);
+        (void)bfs(g, start, visitor, *g.borrow_workspace());
+        return;
     }
 
-    if (iter_type::BFS == m_type) {
-        m_node = m_deque.front();
-        m_deque.pop_front();
-    } else {
-        m_node = m_deque.back();
-        m_deque.pop_back();
+    indexed_heap<cost_type> queue(g.num_of_ids());
+    queue.push_or_decrease(start, 0);
+
+    while (!queue.empty()) {
+        const auto [cost, id] = queue.top();
+        queue.pop();
+        if (id == target) {
+            break;
+        }
+
+        size_type rank = 0;
+        for (const auto [toId, toCost] : g.out_edges(id)) {
+            const cost_type totalCost = cost_traits<cost_type>::add(cost, toCost);
+            if (totalCost < result.cost(toId)) {
+                result.relax(toId, totalCost, id, rank);
+                queue.push_or_decrease(toId, totalCost);
+            }
+            ++rank;
+        }
     }
-    collect_nodes();
+}
 
-    return *this;
+template <typename Graph>
+std::vector<typename Graph::cost_type> dijkstra(const Graph& g, typename Graph::size_type start,
+                                                typename Graph::size_type target = Graph::INVALID_ID)
+{
+    cost_recorder<typename Graph::cost_type> result(g.num_of_ids(), start);
+    dijkstra_search(g, start, result, target);
+    return std::move(result.costs);
 }
 
-graph::iterator graph::iterator::operator++(int)
+template <typename Graph>
+shortest_path_tree<typename Graph::cost_type, typename Graph::id_type> shortest_paths(const Graph& g,
+                                                                                     typename Graph::size_type start,
+                                                                                     bool withEdges)
 {
-    iterator tmp = *this;
-    ++*this;
-    return tmp;
+    shortest_path_tree<typename Graph::cost_type, typename Graph::id_type> result(g.num_of_ids(), start, withEdges);
+    dijkstra_search(g, start, result);
+    return result;
 }
 
-bool graph::iterator::operator==(const iterator& other) const
+}
+
+template <typename Cost, typename Id>
+std::vector<path_cost_t<Cost, Id>> basic_graph<Cost, Id>::dijkstra(size_type start) const
 {
-    return (m_type == other.m_type && m_node == other.m_node);
+    return detail::dijkstra(*this, start);
 }
 
-bool graph::iterator::operator!=(const iterator& other) const
+template <typename Cost, typename Id>
+path_cost_t<Cost, Id> basic_graph<Cost, Id>::dijkstra(size_type start, size_type target) const
 {
-    return !(other == *this);
+    return detail::dijkstra(*this, start, target)[target];
 }
 
-graph::iterator::reference graph::iterator::operator*() const
+template <typename Cost, typename Id>
+shortest_path_tree<path_cost_t<Cost, Id>, Id> basic_graph<Cost, Id>::shortest_paths(size_type start, bool withEdges) const
 {
-    return *m_node;
+    return detail::shortest_paths(*this, start, withEdges);
 }
 
-void graph::iterator::collect_nodes()
+template <typename Cost, typename Id>
+std::vector<path_cost_t<Cost, Id>> basic_csr_graph<Cost, Id>::dijkstra(size_type start) const
 {
-    assert(nullptr != m_node);
-    //for (auto* edge : m_node->get_edges()) {
-    for (auto it = m_node->begin_nodes(); it != m_node->end_nodes(); ++it) {
-        node* to = *it;
-        const graph::size_type id = to->get_id();
-        if (!m_visited[id]) {
-            m_visited[id] = true;
-            m_deque.push_back(to);
-        }
-    }
+    return detail::dijkstra(*this, start);
 }
 
-////////////////////////////////////////////////////////////////////////////////
-graph::const_iterator::const_iterator(const graph& g, const node* n, iter_type type)
-    : m_type(type)
-    , m_node(n)
-    , m_visited(g.size(), false)
-    , m_deque()
+template <typename Cost, typename Id>
+path_cost_t<Cost, Id> basic_csr_graph<Cost, Id>::dijkstra(size_type start, size_type target) const
 {
-    if (nullptr != m_node) {
-        m_visited[m_node->get_id()] = true;
-        collect_nodes();
+    return detail::dijkstra(*this, start, target)[target];
+}
+
+template <typename Cost, typename Id>
+shortest_path_tree<path_cost_t<Cost, Id>, Id> basic_csr_graph<Cost, Id>::shortest_paths(size_type start, bool withEdges) const
+{
+    return detail::shortest_paths(*this, start, withEdges);
+}
+
+}
+
+#include <atomic>
+#include <map>
+
+namespace impl
+{
+
+namespace detail
+{
+
+/**
+ * @brief Pick a bucket width when the caller did not: the largest edge cost
+ *        divided by the average out degree, at least 1.
+ */
+template <typename Graph>
+typename Graph::cost_type default_delta(const Graph& g)
+{
+    using size_type = typename Graph::size_type;
+    using cost_type = typename Graph::cost_type;
+
+    cost_type maxCost = 1;
+    size_type numOfEdges = 0;
+    for (size_type i = 0; i < g.num_of_ids(); ++i) {
+        for (const auto [toId, toCost] : g.out_edges(i)) {
+            maxCost = std::max(maxCost, toCost);
+            ++numOfEdges;
+        }
     }
+    const size_type avgDegree = std::max<size_type>(1, numOfEdges / std::max<size_type>(1, g.num_of_ids()));
+    return std::max<cost_type>(1, static_cast<cost_type>(maxCost / static_cast<cost_type>(avgDegree)));
 }
 
-graph::const_iterator& graph::const_iterator::operator++()
+/**
+ * @brief Parallel delta-stepping (Meyer and Sanders).
+ * @details Nodes are kept in buckets of width delta by tentative distance.
+ *          The lowest non-empty bucket is the frontier, its nodes relax their
+ *          light edges (cost up to delta) in parallel, improved nodes go to
+ *          the bucket of their new distance in the local buckets of the
+ *          relaxing thread. The same bucket is processed again until it stays
+ *          empty, then the nodes it held relax their heavy edges once, those
+ *          can not reach the bucket again. Distances are lowered with compare
+ *          and swap, entries whose distance dropped below their bucket are
+ *          stale and skipped. The buckets of a thread are a map by index, so
+ *          memory follows the entries, not the largest distance over delta.
+ */
+template <typename Graph>
+std::vector<typename Graph::cost_type> delta_stepping(const Graph& g, typename Graph::size_type start,
+                                                      typename Graph::cost_type delta, thread_pool& pool)
 {
-    if (m_deque.empty()) {
-        m_node = nullptr;
-        return *this;
+    using size_type = typename Graph::size_type;
+    using cost_type = typename Graph::cost_type;
+    using bucket = std::vector<size_type>;
+    constexpr cost_type INF_COST = cost_traits<cost_type>::infinity();
+
+    if (delta <= 0) {
+        delta = default_delta(g);
     }
+    const size_type size = g.num_of_ids();
+    std::vector<std::atomic<cost_type>> dist(size);
+    pool.parallel_for(size, [&dist](size_type first, size_type last, size_type) {
+        for (size_type i = first; i < last; ++i) {
+            dist[i].store(INF_COST, std::memory_order_relaxed);
+        }
+    });
+    dist[start].store(0, std::memory_order_relaxed);
+
+    // Buckets of every thread by index distance / delta
+    std::vector<std::map<size_type, bucket>> buckets(pool.size());
+    auto relax = [&](size_type toId, cost_type totalCost, std::map<size_type, bucket>& local) {
+        cost_type old = dist[toId].load(std::memory_order_relaxed);
+        while (totalCost < old) {
+            if (dist[toId].compare_exchange_weak(old, totalCost, std::memory_order_relaxed)) {
+                local[static_cast<size_type>(totalCost / delta)].push_back(toId);
+                return;
+            }
+        }
+    };
+    auto take_bucket = [&](size_type index, bucket& frontier) {
+        frontier.clear();
+        for (std::map<size_type, bucket>& local : buckets) {
+            const auto it = local.find(index);
+            if (local.end() != it) {
+                frontier.insert(frontier.end(), it->second.begin(), it->second.end());
+                local.erase(it);
+            }
+        }
+    };
 
-    if (iter_type::BFS == m_type) {
-        m_node = m_deque.front();
-        m_deque.pop_front();
-    } else {
-        m_node = m_deque.back();
-        m_deque.pop_back();
+    bucket frontier{start};
+    bucket settled;
+    size_type current = 0;
+    while (true) {
+        const cost_type lowerBound = static_cast<cost_type>(current) * delta;
+        settled.clear();
+        while (!frontier.empty()) {
+            pool.parallel_for(frontier.size(), [&](size_type first, size_type last, size_type worker) {
+                for (size_type i = first; i < last; ++i) {
+                    const size_type id = frontier[i];
+                    const cost_type cost = dist[id].load(std::memory_order_relaxed);
+                    if (cost < lowerBound) {
+                        continue;
+                    }
+                    for (const auto [toId, toCost] : g.out_edges(id)) {
+                        assert(toCost >= 0);
+                        if (toCost <= delta) {
+                            relax(toId, cost_traits<cost_type>::add(cost, toCost), buckets[worker]);
+                        }
+                    }
+                }
+            });
+            settled.insert(settled.end(), frontier.begin(), frontier.end());
+            take_bucket(current, frontier);
+        }
+
+        // Heavy edges of the emptied bucket, from the final distances of its nodes
+        std::sort(settled.begin(), settled.end());
+        settled.erase(std::unique(settled.begin(), settled.end()), settled.end());
+        pool.parallel_for(settled.size(), [&](size_type first, size_type last, size_type worker) {
+            for (size_type i = first; i < last; ++i) {
+                const size_type id = settled[i];
+                const cost_type cost = dist[id].load(std::memory_order_relaxed);
+                for (const auto [toId, toCost] : g.out_edges(id)) {
+                    if (toCost > delta) {
+                        relax(toId, cost_traits<cost_type>::add(cost, toCost), buckets[worker]);
+                    }
+                }
+            }
+        });
+
+        // Next frontier is the lowest non-empty bucket of any thread
+        size_type next = std::numeric_limits<size_type>::max();
+        for (const std::map<size_type, bucket>& local : buckets) {
+            if (!local.empty()) {
+                next = std::min(next, local.begin()->first);
+            }
+        }
+        if (std::numeric_limits<size_type>::max() == next) {
+            break;
+        }
+        current = next;
+        take_bucket(current, frontier);
     }
-    collect_nodes();
 
-    return *this;
+    std::vector<cost_type> result(size);
+    pool.parallel_for(size, [&](size_type first, size_type last, size_type) {
+        for (size_type i = first; i < last; ++i) {
+            result[i] = dist[i].load(std::memory_order_relaxed);
+        }
+    });
+    return result;
 }
 
-graph::const_iterator graph::const_iterator::operator++(int)
-{
-    const_iterator tmp = *this;
-    ++*this;
-    return tmp;
 }
 
-bool graph::const_iterator::operator==(const const_iterator& other) const
+template <typename Cost, typename Id>
+std::vector<path_cost_t<Cost, Id>> basic_graph<Cost, Id>::delta_stepping(size_type start, cost_type delta, size_type numOfThreads) const
 {
-    return (m_type == other.m_type && m_node == other.m_node);
+    thread_pool pool{numOfThreads};
+    return detail::delta_stepping(*this, start, delta, pool);
 }
 
-bool graph::const_iterator::operator!=(const const_iterator& other) const
+template <typename Cost, typename Id>
+std::vector<path_cost_t<Cost, Id>> basic_graph<Cost, Id>::delta_stepping(size_type start, cost_type delta,
+                                                                       thread_pool& pool) const
 {
-    return !(other == *this);
+    return detail::delta_stepping(*this, start, delta, pool);
 }
 
-graph::const_iterator::const_reference graph::const_iterator::operator*() const
+template <typename Cost, typename Id>
+std::vector<path_cost_t<Cost, Id>> basic_csr_graph<Cost, Id>::delta_stepping(size_type start, cost_type delta,
+                                                            size_type numOfThreads) const
 {
-    return *m_node;
+    thread_pool pool{numOfThreads};
+    return detail::delta_stepping(*this, start, delta, pool);
 }
 
-void graph::const_iterator::collect_nodes()
+template <typename Cost, typename Id>
+std::vector<path_cost_t<Cost, Id>> basic_csr_graph<Cost, Id>::delta_stepping(size_type start, cost_type delta,
+                                                                           thread_pool& pool) const
 {
-    assert(nullptr != m_node);
-    //for (auto* edge : m_node->get_edges()) {
-    for (auto it = m_node->begin_nodes(); it != m_node->end_nodes(); ++it) {
-        const node* to = *it;
-        const graph::size_type id = to->get_id();
-        if (!m_visited[id]) {
-            m_visited[id] = true;
-            m_deque.push_back(to);
-        }
-    }
+    return detail::delta_stepping(*this, start, delta, pool);
 }
 
 }
@@ -874,419 +6461,992 @@ void graph::const_iterator::collect_nodes()
 namespace impl
 {
 
-////////////////////////////////////////////////////////////////////////////////
-///// graph
-////////////////////////////////////////////////////////////////////////////////
-inline size_t graph::get_node_id(const std::string& name) const
+namespace detail
 {
-    auto it = m_nameToNode.find(name);
-    if (it != m_nameToNode.end()) {
-        return it->second->get_id();
-    }
-    return INVALID_ID;
-}
 
-inline node* graph::get_node(const std::string& name)
+/**
+ * @brief Graph with all its edges reversed, the out_edges are the in_edges
+ *        of the underlying graph.
+ */
+template <typename Graph>
+class reversed_view
+{
+public:
+    using size_type = typename Graph::size_type;
+    using id_type = typename Graph::id_type;
+    using cost_type = typename Graph::cost_type;
+
+    constexpr static id_type INVALID_ID = Graph::INVALID_ID;
+
+public:
+    explicit reversed_view(const Graph& g)
+        : m_graph(g)
+    { }
+
+    [[nodiscard]] inline size_type num_of_ids() const noexcept { return m_graph.num_of_ids(); }
+    [[nodiscard]] inline auto out_edges(size_type id) const { return m_graph.in_edges(id); }
+
+private:
+    const Graph& m_graph;
+};
+
+/**
+ * @brief Bidirectional dijkstra, a forward search from the source and a
+ *        backward search from the target over the incoming edges.
+ * @details The side with the smaller top key is expanded. Every relaxed edge
+ *          that reaches a node labeled by the other side is a candidate path,
+ *          the search stops once the two top keys together can not beat the
+ *          best candidate.
+ */
+template <typename Graph>
+shortest_path_result<typename Graph::cost_type, typename Graph::id_type>
+bidirectional_dijkstra(const Graph& g, typename Graph::size_type from, typename Graph::size_type to)
 {
-    auto it = m_nameToNode.find(name);
-    if (it != m_nameToNode.end()) {
-        return it->second;
+    using size_type = typename Graph::size_type;
+    using id_type = typename Graph::id_type;
+    using cost_type = typename Graph::cost_type;
+    using traits = cost_traits<cost_type>;
+    constexpr cost_type INF_COST = traits::infinity();
+    constexpr id_type INVALID_ID = Graph::INVALID_ID;
+
+    shortest_path_result<cost_type, id_type> result;
+    if (from == to) {
+        result.cost = 0;
+        result.nodes.push_back(static_cast<id_type>(from));
+        result.settled = 1;
+        return result;
     }
-    return nullptr;
+
+    struct side
+    {
+        explicit side(size_type size)
+            : dist(size, cost_traits<cost_type>::infinity())
+            , pred(size, Graph::INVALID_ID)
+            , queue(size)
+        { }
+
+        std::vector<cost_type> dist;
+        std::vector<id_type> pred;
+        indexed_heap<cost_type> queue;
+    };
+    side forward(g.num_of_ids());
+    side backward(g.num_of_ids());
+    forward.dist[from] = 0;
+    forward.queue.push_or_decrease(from, 0);
+    backward.dist[to] = 0;
+    backward.queue.push_or_decrease(to, 0);
+
+    // Best path found so far goes through the edge meetFrom -> meetTo
+    cost_type best = INF_COST;
+    id_type meetFrom = INVALID_ID;
+    id_type meetTo = INVALID_ID;
+
+    auto expand = [&](const auto& adjacency, side& self, const side& other, bool isForward) {
+        const auto [cost, id] = self.queue.top();
+        self.queue.pop();
+        ++result.settled;
+        for (const auto [toId, toCost] : adjacency.out_edges(id)) {
+            const cost_type totalCost = traits::add(cost, toCost);
+            if (totalCost < self.dist[toId]) {
+                self.dist[toId] = totalCost;
+                self.pred[toId] = static_cast<id_type>(id);
+                self.queue.push_or_decrease(toId, totalCost);
+            }
+            if (INF_COST != other.dist[toId] && traits::add(totalCost, other.dist[toId]) < best) {
+                best = traits::add(totalCost, other.dist[toId]);
+                meetFrom = static_cast<id_type>(isForward ? id : toId);
+                meetTo = static_cast<id_type>(isForward ? toId : id);
+            }
+        }
+    };
+
+    const reversed_view<Graph> reversed(g);
+    while (!forward.queue.empty() && !backward.queue.empty()) {
+        const cost_type forwardTop = forward.queue.top().first;
+        const cost_type backwardTop = backward.queue.top().first;
+        if (INF_COST != best && traits::add(forwardTop, backwardTop) >= best) {
+            break;
+        }
+        if (forwardTop <= backwardTop) {
+            expand(g, forward, backward, true);
+        } else {
+            expand(reversed, backward, forward, false);
+        }
+    }
+
+    if (INF_COST == best) {
+        return result;
+    }
+    result.cost = best;
+    for (id_type id = meetFrom; INVALID_ID != id; id = forward.pred[id]) {
+        result.nodes.push_back(id);
+    }
+    std::reverse(result.nodes.begin(), result.nodes.end());
+    for (id_type id = meetTo; INVALID_ID != id; id = backward.pred[id]) {
+        result.nodes.push_back(id);
+    }
+    return result;
 }
 
-inline const node* graph::get_node(const std::string& name) const
+/**
+ * @brief A* search guided by a lower bound of the remaining cost.
+ * @details Nodes are popped by cost + heuristic(id). A node reached again
+ *          with a lower cost is pushed again, so an admissible heuristic is
+ *          enough, a consistent one settles every node at most once.
+ */
+template <typename Graph, typename Heuristic>
+shortest_path_result<typename Graph::cost_type, typename Graph::id_type>
+astar(const Graph& g, typename Graph::size_type from, typename Graph::size_type to, Heuristic&& heuristic)
 {
-    auto it = m_nameToNode.find(name);
-    if (it != m_nameToNode.end()) {
-        return it->second;
+    using size_type = typename Graph::size_type;
+    using id_type = typename Graph::id_type;
+    using cost_type = typename Graph::cost_type;
+    using traits = cost_traits<cost_type>;
+    constexpr cost_type INF_COST = traits::infinity();
+    constexpr id_type INVALID_ID = Graph::INVALID_ID;
+
+    shortest_path_result<cost_type, id_type> result;
+    std::vector<cost_type> dist(g.num_of_ids(), INF_COST);
+    std::vector<id_type> pred(g.num_of_ids(), INVALID_ID);
+    indexed_heap<cost_type> queue(g.num_of_ids());
+    dist[from] = 0;
+    queue.push_or_decrease(from, static_cast<cost_type>(heuristic(from)));
+
+    while (!queue.empty()) {
+        const size_type id = queue.top().second;
+        queue.pop();
+        ++result.settled;
+        if (id == to) {
+            break;
+        }
+
+        for (const auto [toId, toCost] : g.out_edges(id)) {
+            const cost_type totalCost = traits::add(dist[id], toCost);
+            if (totalCost < dist[toId]) {
+                dist[toId] = totalCost;
+                pred[toId] = static_cast<id_type>(id);
+                queue.push_or_decrease(toId, traits::add(totalCost, static_cast<cost_type>(heuristic(toId))));
+            }
+        }
+    }
+
+    if (INF_COST == dist[to]) {
+        return result;
     }
-    return nullptr;
+    result.cost = dist[to];
+    for (id_type id = static_cast<id_type>(to); INVALID_ID != id; id = pred[id]) {
+        result.nodes.push_back(id);
+    }
+    std::reverse(result.nodes.begin(), result.nodes.end());
+    return result;
+}
+
 }
 
-inline node* graph::get_node(size_t start)
+template <typename Cost, typename Id>
+shortest_path_result<path_cost_t<Cost, Id>, Id> basic_graph<Cost, Id>::shortest_path(size_type from, size_type to) const
 {
-    if (start >= size()) {
-        return nullptr;
+    if (!m_incomingIndex) {
+        return detail::astar(*this, from, to, [](size_type) { return cost_type{0}; });
     }
-    return m_adjList[start];
+    return detail::bidirectional_dijkstra(*this, from, to);
 }
 
-inline const node* graph::get_node(size_t start) const
+template <typename Cost, typename Id>
+template <typename Heuristic>
+shortest_path_result<path_cost_t<Cost, Id>, Id> basic_graph<Cost, Id>::shortest_path(size_type from, size_type to,
+                                                                    Heuristic&& heuristic) const
 {
-    if (start >= size()) {
-        return nullptr;
-    }
-    return m_adjList[start];
+    return detail::astar(*this, from, to, std::forward<Heuristic>(heuristic));
 }
 
-inline node* graph::get_or_create_node(const std::string& name)
+}
+
+namespace impl
+{
+
+namespace detail
+{
+
+template <typename Graph>
+bool has_negative_cycle(const Graph& g)
 {
-    node* n = get_node(name);
-    if (nullptr != n) {
-        return n;
+    using size_type = typename Graph::size_type;
+    using cost_type = typename Graph::cost_type;
+    using traits = cost_traits<cost_type>;
+    constexpr cost_type INF_COST = traits::infinity();
+
+    assert(!g.empty());
+    if constexpr (!Graph::is_weighted) {
+        return false;
     }
-    const size_t id = m_adjList.size();
-    n = new node(id, name);
-    m_adjList.push_back(n);
-    m_nameToNode.insert({name, n});
-    return n;
+    std::vector<cost_type> dist(g.num_of_ids(), INF_COST);
+    dist[0] = 0;
+    for (size_type i = 1; i < g.num_of_ids(); ++i) {
+        for (size_type fromIdx = 0; fromIdx < g.num_of_ids(); ++fromIdx) {
+            if (dist[fromIdx] == INF_COST) {
+                continue;
+            }
+            for (const auto [toIdx, cost] : g.out_edges(fromIdx)) {
+                const cost_type totalCost = traits::add(dist[fromIdx], cost);
+                if (totalCost < dist[toIdx]) {
+                    dist[toIdx] = totalCost;
+                }
+            }
+        }
+    }
+
+    for (size_type fromIdx = 0; fromIdx < g.num_of_ids(); ++fromIdx) {
+        if (dist[fromIdx] == INF_COST) {
+            continue;
+        }
+        for (const auto [toIdx, cost] : g.out_edges(fromIdx)) {
+            if (traits::add(dist[fromIdx], cost) < dist[toIdx]) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 }
 
-inline void graph::add_edge(edge* e)
+template <typename Cost, typename Id>
+bool basic_graph<Cost, Id>::has_negative_cycle() const
 {
-    m_edges.push_back(e);
+    return detail::has_negative_cycle(*this);
 }
 
-bool graph::add_edge(node* fromNode, node* toNode, edge::Cost_t cost)
+template <typename Cost, typename Id>
+bool basic_csr_graph<Cost, Id>::has_negative_cycle() const
 {
-    edge* e = fromNode->add_edge(toNode, cost);
-    if (e == nullptr) {
-        return false;
-    }
+    return detail::has_negative_cycle(*this);
+}
 
-    add_edge(e);
-    return true;
 }
 
-graph::graph()
-    : m_adjList{}
-    , m_edges{}
-    , m_nameToNode{}
-{ }
+#include <charconv>
 
-graph::graph(graph&& other)
-    : m_adjList(std::move(other.m_adjList))
-    , m_nameToNode(std::move(other.m_nameToNode))
+namespace impl
 {
-    other.m_adjList.clear();
-    other.m_nameToNode.clear();
-}
 
-graph::~graph()
+namespace detail
 {
-    clear();
-}
 
-void graph::clear()
+/**
+ * @brief Write the shortest text that parses back to the same number.
+ */
+template <typename T>
+void write_number(std::ostream& os, T value)
 {
-    m_nameToNode.clear();
-    std::destroy(m_adjList.begin(), m_adjList.end());
-    m_adjList.clear();
+    char buffer[64];
+    const auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    assert(std::errc{} == ec);
+    os.write(buffer, ptr - buffer);
 }
 
-inline size_t graph::size() const noexcept
-{
-    return m_adjList.size();
 }
 
-inline bool graph::empty() const noexcept
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::serialize(const std::string& fileName) const
 {
-    return 0 == size();
+    std::ofstream os{fileName};
+    // Removed ids are skipped, the nodes are written with their compacted ids
+    const std::vector<id_type> ids = compacted_ids();
+    os << size() << '\n';
+    for (auto it = begin_nodes(); it != end_nodes(); ++it) {
+        const node* n = *it;
+        os << n->get_name() << ' ' << n->get_num_of_edges() << ' ';
+        for (const edge* e : n->get_edges()) {
+            detail::write_number(os, ids[e->get_to_idx()]);
+            os << ' ';
+            detail::write_number(os, e->get_cost());
+            os << ' ';
+        }
+        os << '\n';
+    }
 }
 
-inline bool graph::contains(const std::string& name) const
-{
-    return (m_nameToNode.find(name) != m_nameToNode.end());
 }
 
-bool graph::add_node(const std::string& name)
+#include <charconv>
+
+namespace impl
 {
-    if (contains(name)) {
-        return false;
-    }
-    const size_t id = m_adjList.size();
-    node* n = new node(id, name);
-    m_adjList.push_back(n);
-    m_nameToNode.insert({name, n});
-    return true;
-}
 
-bool graph::remove_node(const std::string& name)
+namespace detail
 {
-    // Not implemented yet
-    node* node = get_node(name);
-    if (nullptr == node) {
-        return false;
+
+/**
+ * @brief Whitespace separated token reader over an in-memory text, counting lines.
+ */
+class text_reader
+{
+public:
+    using size_type = std::size_t;
+
+    constexpr static size_type MIN_ITEM_BYTES = 4;
+
+public:
+    text_reader(const std::string& fileName, const char* first, const char* last, size_type line = 1)
+        : m_fileName(fileName)
+        , m_cur(first)
+        , m_end(last)
+        , m_line(line)
+    { }
+
+    /**
+     * @brief Return the next token, empty at the end of the text.
+     */
+    [[nodiscard]] std::string_view token()
+    {
+        skip_spaces();
+        const char* first = m_cur;
+        while (m_cur != m_end && !is_space(*m_cur)) {
+            ++m_cur;
+        }
+        return std::string_view(first, static_cast<size_type>(m_cur - first));
     }
 
-    size_t id = node->get_id();
+    /**
+     * @brief Parse the next token as a number.
+     * @throw serialization_error if the token is missing or is not a number.
+     */
+    template <typename T>
+    [[nodiscard]] T number(const char* what)
+    {
+        const std::string_view str = token();
+        T value{};
+        const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+        if (str.empty() || std::errc{} != ec || ptr != str.data() + str.size()) {
+            fail(std::string("expected ") + what + (str.empty() ? std::string(", got end of file")
+                                                                 : ", got '" + std::string(str) + '\''));
+        }
+        return value;
+    }
 
-    auto iter = m_adjList.erase(m_adjList.begin() + id);
-    for (; iter != m_adjList.end(); ++iter, ++id) {
-        (*iter)->set_id(id);
-        (void)(*iter)->remove_edge(node);
+    /**
+     * @brief Fail unless count items fit in the rest of the text.
+     * @details A node ("a 0" and a separator) and an edge (a separator and
+     *          "1 2") take MIN_ITEM_BYTES at least, checking counts read from
+     *          the text before reserving memory for them.
+     */
+    void check_count(size_type count, const char* what) const
+    {
+        const auto bytes = static_cast<size_type>(m_end - m_cur);
+        if (count > (bytes + 1) / MIN_ITEM_BYTES) {
+            fail(std::to_string(count) + ' ' + what + " do not fit in the " + std::to_string(bytes) + " bytes left");
+        }
     }
 
-    return true;
-}
+    /**
+     * @brief Return the current position in the text.
+     */
+    [[nodiscard]] inline const char* position() const noexcept { return m_cur; }
 
-inline bool graph::has_edge(const std::string& from, const std::string& to)
-{
-    node* fromNode = get_node(from);
-    node* toNode = get_node(to);
+    /**
+     * @brief Returns true if only whitespace is left.
+     */
+    [[nodiscard]] bool at_end()
+    {
+        skip_spaces();
+        return m_cur == m_end;
+    }
 
-    if (nullptr == fromNode || nullptr == toNode) {
-        return false;
+    [[noreturn]] void fail(const std::string& what) const
+    {
+        throw serialization_error(m_fileName, m_line, what);
     }
 
-    return fromNode->has_edge(toNode);
-}
+private:
+    [[nodiscard]] inline static bool is_space(char c) noexcept
+    {
+        return ' ' == c || '\n' == c || '\t' == c || '\r' == c || '\v' == c || '\f' == c;
+    }
 
-bool graph::add_edge(const std::string& from, const std::string& to, edge::Cost_t cost)
-{
-    node* fromNode = get_or_create_node(from);
-    node* toNode = get_or_create_node(to);
+    void skip_spaces() noexcept
+    {
+        while (m_cur != m_end && is_space(*m_cur)) {
+            if ('\n' == *m_cur) {
+                ++m_line;
+            }
+            ++m_cur;
+        }
+    }
+
+private:
+    const std::string& m_fileName;
+    const char* m_cur;
+    const char* m_end;
+    size_type m_line;
+};
 
-    return add_edge(fromNode, toNode, cost);
 }
 
-bool graph::remove_edge(const std::string& from, const std::string& to)
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::deserialize(const std::string& fileName)
 {
-    node* fromNode = get_node(from);
-    node* toNode = get_node(to);
-
-    return fromNode->remove_edge(toNode);
+    clear();
+    try {
+        const mapped_file file{fileName};
+        deserialize(fileName, file.begin(), file.end());
+    } catch (...) {
+        clear();
+        throw;
+    }
 }
 
-bool graph::compare(const graph* g) const
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::deserialize(const std::string& fileName, const char* first, const char* last)
 {
-    if (size() != g->size()) {
-        return false;
+    detail::text_reader reader{fileName, first, last};
+
+    const size_type size = reader.number<size_type>("number of nodes");
+    if (size >= INVALID_ID) {
+        reader.fail(std::to_string(size) + " nodes do not fit the node id type");
     }
-    if (num_of_edges() != g->num_of_edges()) {
-        return false;
+    reader.check_count(size, "nodes");
+
+    // The graph is empty, so the reserved pool places node i at nodes + i and
+    // edge targets need no random lookup in the adjacency list
+    m_adjList.reserve(size);
+    m_nodePool.reserve(size);
+    m_names.reserve(size);
+    for (size_type i = 0; i < size; ++i) {
+        (void)create_node(i, std::string_view{});
     }
-    for (size_type i = 0; i < size(); ++i) {
-        const node* lhs = get_node(i);
-        const node* rhs = get_node(i);
-        if (!lhs->compare(rhs)) {
-            return false;
+    node* const nodes = m_adjList.empty() ? nullptr : m_adjList.front();
+    assert(m_adjList.empty() || nodes + (size - 1) == m_adjList.back());
+    for (node* n : m_adjList) {
+        const std::string_view name = reader.token();
+        if (name.empty()) {
+            reader.fail("expected name of node " + std::to_string(n->get_id()) + ", got end of file");
+        }
+        const auto [entry, inserted] = m_names.emplace(name, n->get_id());
+        if (!inserted) {
+            reader.fail("duplicate node name '" + std::string(name) + '\'');
+        }
+        n->set_name(entry->name);
+
+        const size_type degree = reader.number<size_type>("number of edges");
+        reader.check_count(degree, "edges");
+        n->reserve_edges(degree);
+        m_edgePool.reserve(degree);
+        for (size_type j = 0; j < degree; ++j) {
+            const size_type to = reader.number<size_type>("edge target id");
+            if (to >= size) {
+                reader.fail("edge target id " + std::to_string(to) + " is out of range");
+            }
+            const cost_type cost = reader.number<cost_type>("edge cost");
+            n->add_edge(m_edgePool.create(n, nodes + to, cost));
         }
+        m_numOfEdges += degree;
     }
-    return true;
-}
 
-void graph::dump(std::ostream& os) const
-{
-    for (const auto* node : m_adjList) {
-        node->dump(os);
+    if (!reader.at_end()) {
+        reader.fail("unexpected data after the last node");
+    }
+    // Incoming edges are added once all are read, every list is reserved exactly.
+    // The targets are counted by address, without reading the target nodes.
+    if (m_incomingIndex) {
+        std::vector<size_type> inDegrees(size, 0);
+        for (const node* n : m_adjList) {
+            for (const edge* e : n->get_edges()) {
+                ++inDegrees[static_cast<size_type>(e->get_to() - nodes)];
+            }
+        }
+        build_incoming_index(inDegrees);
     }
 }
 
-}
-
-namespace impl
+namespace detail
 {
 
-const node* graph::mother_node() const
+/**
+ * @brief Find the starts of the first count lines of the text in parallel.
+ * @return count + 1 pointers, line i is [lines[i], lines[i + 1]), missing
+ *         lines are empty ranges at the end of the text.
+ */
+inline std::vector<const char*> index_lines(const char* first, const char* last,
+                                            std::size_t count, thread_pool& pool)
 {
-    const size_type numOfNodes = size();
+    using size_type = std::size_t;
 
-    std::vector<bool> visited(numOfNodes, false);
-    auto util = [&visited](auto& node) { visited[node.get_id()] = true; };
+    const size_type bytes = static_cast<size_type>(last - first);
+    const size_type numOfBlocks = std::max<size_type>(1, std::min(bytes, 4 * pool.size()));
+    const size_type blockSize = (bytes + numOfBlocks - 1) / numOfBlocks;
+    auto block_first = [&](size_type b) { return first + std::min(bytes, b * blockSize); };
 
-    size_t motherNode = 0;
-    for (size_t i = 0; i < numOfNodes; ++i) {
-        if (!visited[i]) {
-            std::for_each(this->begin_DFS(i), this->end_DFS(), util);
-            motherNode = i;
+    // Count the newlines of every block, then give each block its first line number
+    std::vector<size_type> newlines(numOfBlocks + 1, 0);
+    pool.parallel_for(numOfBlocks, [&](size_type b0, size_type b1, size_type) {
+        for (size_type b = b0; b < b1; ++b) {
+            newlines[b + 1] = static_cast<size_type>(std::count(block_first(b), block_first(b + 1), '\n'));
         }
+    }, 1);
+    for (size_type b = 0; b < numOfBlocks; ++b) {
+        newlines[b + 1] += newlines[b];
     }
 
-    std::fill(visited.begin(), visited.end(), false);
-    std::for_each(this->begin_DFS(motherNode), this->end_DFS(), util);
-
-    for (size_t i = 0; i < numOfNodes; ++i) {
-        if (!visited[i]) {
-            return nullptr;
+    std::vector<const char*> lines(count + 1, last);
+    lines[0] = first;
+    pool.parallel_for(numOfBlocks, [&](size_type b0, size_type b1, size_type) {
+        for (size_type b = b0; b < b1; ++b) {
+            size_type line = newlines[b];
+            for (const char* p = block_first(b); p != block_first(b + 1) && line < count; ++p) {
+                if ('\n' == *p) {
+                    lines[++line] = p + 1;
+                }
+            }
         }
-    }
-
-    return get_node(motherNode);
+    }, 1);
+    return lines;
 }
 
 }
 
-namespace impl
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::deserialize(const std::string& fileName, size_type numOfThreads)
 {
+    clear();
+    try {
+        const mapped_file file{fileName};
+        thread_pool pool{numOfThreads};
+        deserialize(fileName, file.begin(), file.end(), pool);
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
 
-graph::size_type graph::num_of_paths(const node* from, const node* to) const
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::deserialize(const std::string& fileName, const char* first, const char* last,
+                                        thread_pool& pool)
 {
-    if (nullptr == from || nullptr == to) {
-        return 0;
+    const char* firstLineEnd = std::find(first, last, '\n');
+    detail::text_reader header{fileName, first, firstLineEnd};
+    const size_type size = header.number<size_type>("number of nodes");
+    if (size >= INVALID_ID) {
+        header.fail(std::to_string(size) + " nodes do not fit the node id type");
     }
+    if (!header.at_end()) {
+        header.fail("unexpected data after the number of nodes");
+    }
+    detail::text_reader{fileName, header.position(), last}.check_count(size, "nodes");
+
+    // Line i holds node i, the file line numbers start at 2
+    const char* body = (firstLineEnd == last) ? last : firstLineEnd + 1;
+    const std::vector<const char*> lines = detail::index_lines(body, last, size, pool);
+    auto line_end = [&lines](size_type i) {
+        const char* end = lines[i + 1];
+        return (end != lines[i] && '\n' == end[-1]) ? end - 1 : end;
+    };
 
-    size_type numOfPaths = 0;
-
-    std::queue<const node*> queue;
-    queue.push(from);
-
-    while (!queue.empty()) {
-        const node* current = queue.front();
-        queue.pop();
-
-        if (current == to) {
-            ++numOfPaths;
-            continue;
+    // Names and degrees
+    std::vector<std::string_view> names(size);
+    std::vector<size_type> offsets(size + 1, 0);
+    std::vector<const char*> edgeData(size);
+    pool.parallel_for(size, [&](size_type first, size_type last, size_type) {
+        for (size_type i = first; i < last; ++i) {
+            detail::text_reader reader{fileName, lines[i], line_end(i), i + 2};
+            names[i] = reader.token();
+            if (names[i].empty()) {
+                reader.fail("expected name of node " + std::to_string(i));
+            }
+            offsets[i + 1] = reader.number<size_type>("number of edges");
+            reader.check_count(offsets[i + 1], "edges");
+            edgeData[i] = reader.position();
         }
+    });
+
+    m_adjList.reserve(size);
+    m_nodePool.reserve(size);
+    m_names.reserve(size);
+    for (size_type i = 0; i < size; ++i) {
+        const auto [entry, inserted] = m_names.emplace(names[i], i);
+        if (!inserted) {
+            throw serialization_error(fileName, i + 2, "duplicate node name '" + std::string(names[i]) + '\'');
+        }
+        (void)create_node(i, entry->name);
+        offsets[i + 1] += offsets[i];
+    }
 
-        for (auto nodeIter = current->cbegin_nodes(); nodeIter != current->cend_nodes(); ++nodeIter) {
-            queue.push(*nodeIter);
+    // Edges, every worker creates them in its own pool
+    m_numOfEdges = offsets[size];
+    std::vector<object_pool<edge>> pools(pool.size());
+    pool.parallel_for(size, [&](size_type first, size_type last, size_type worker) {
+        pools[worker].reserve(offsets[last] - offsets[first]);
+        for (size_type i = first; i < last; ++i) {
+            detail::text_reader reader{fileName, edgeData[i], line_end(i), i + 2};
+            node* n = m_adjList[i];
+            const size_type degree = offsets[i + 1] - offsets[i];
+            n->reserve_edges(degree);
+            for (size_type j = 0; j < degree; ++j) {
+                const size_type to = reader.number<size_type>("edge target id");
+                if (to >= size) {
+                    reader.fail("edge target id " + std::to_string(to) + " is out of range");
+                }
+                const cost_type cost = reader.number<cost_type>("edge cost");
+                n->add_edge(pools[worker].create(n, m_adjList[to], cost));
+            }
+            if (!reader.at_end()) {
+                reader.fail("unexpected data after the edges of node " + std::to_string(i));
+            }
         }
+    });
+    for (object_pool<edge>& p : pools) {
+        m_edgePool.splice(p);
+    }
+
+    // Incoming edges, the targets are shared between the workers
+    if (m_incomingIndex) {
+        build_incoming_index();
     }
 
-    return numOfPaths;
+    detail::text_reader rest{fileName, lines[size], last, size + 2};
+    if (!rest.at_end()) {
+        rest.fail("unexpected data after the last node");
+    }
 }
 
 }
 
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
 namespace impl
 {
-bool graph::is_cyclic_util(size_type i, std::vector<bool>& visited, std::vector<bool>& stack) const
+
+namespace detail
 {
-    if (!visited[i]) {
-        visited[i] = true;
-        stack[i] = true;
-        for(auto it = m_adjList[i]->begin_nodes(); it !=  m_adjList[i]->end_nodes(); ++it) {
-            const size_type id = (*it)->get_id();
-            if ( !visited[id] && is_cyclic_util(id, visited, stack)) {
-                return true;
-            } else if (stack[id]) {
-                return true;
-            }
-        }
-    }
-    stack[i] = false;
-    return false;
-}
 
-bool graph::is_cyclic() const
+/**
+ * @brief Header of the binary graph format.
+ * @details The header is followed by these sections, each starting at an
+ *          8 byte aligned offset:
+ *          - uint64 name offsets [numOfNodes + 1]
+ *          - name characters [nameBytes]
+ *          - id edge offsets [numOfNodes + 1]
+ *          - id edge targets [numOfEdges]
+ *          - cost edge costs [numOfEdges]
+ *          Numbers are stored in the byte order of the machine that wrote them.
+ *          Ids take idBytes, costs take costBytes and are integers or floating
+ *          point numbers as told by costKind. Unweighted graphs have no cost
+ *          section, their costBytes is 0.
+ */
+struct binary_header
 {
-    std::vector<bool> visited(size(), false);
-    std::vector<bool> stack(size(), false);
+    constexpr static char MAGIC[8] = {'G', 'R', 'A', 'P', 'H', 'B', 'I', 'N'};
+    constexpr static std::uint32_t VERSION = 2;
+    constexpr static std::uint32_t ENDIAN_MARK = 0x01020304;
+    /// version 1 headers end before costKind and always have signed integer costs
+    constexpr static std::size_t VERSION_1_SIZE = 48;
 
-    for (size_type i = 0; i < size(); ++i) {
-        if (is_cyclic_util(i, visited, stack)) {
-            return true;
+    enum cost_kind : std::uint32_t
+    {
+        SIGNED_INTEGER = 0,
+        UNSIGNED_INTEGER = 1,
+        FLOATING_POINT = 2,
+        UNWEIGHTED = 3
+    };
+
+    template <typename Cost>
+    [[nodiscard]] constexpr static std::uint32_t kind_of() noexcept
+    {
+        if constexpr (std::is_void_v<Cost>) {
+            return UNWEIGHTED;
+        } else if constexpr (std::is_floating_point_v<Cost>) {
+            return FLOATING_POINT;
+        } else if constexpr (std::is_signed_v<Cost>) {
+            return SIGNED_INTEGER;
+        } else {
+            return UNSIGNED_INTEGER;
         }
     }
 
-    return false;
-}
-
-}
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t endianMark;
+    std::uint32_t idBytes;
+    std::uint32_t costBytes;
+    std::uint64_t numOfNodes;
+    std::uint64_t numOfEdges;
+    std::uint64_t nameBytes;
+    std::uint32_t costKind;
+    std::uint32_t reserved;
+};
+static_assert(offsetof(binary_header, costKind) == binary_header::VERSION_1_SIZE,
+              "Version 2 must only append to the version 1 header");
 
-namespace impl
+/**
+ * @brief Byte offsets of the sections from the start of the file.
+ * @details The counts come from the header, which may be crafted, so every
+ *          offset is computed with checked arithmetic.
+ * @throw std::overflow_error if an offset does not fit 64 bits.
+ */
+struct binary_layout
 {
+    binary_layout(const binary_header& header, std::uint64_t headerBytes)
+    {
+        const std::uint64_t numOfNodes = add(header.numOfNodes, 1);
+        nameOffsets = align(headerBytes);
+        names = align(add(nameOffsets, mul(numOfNodes, sizeof(std::uint64_t))));
+        offsets = align(add(names, header.nameBytes));
+        targets = align(add(offsets, mul(numOfNodes, header.idBytes)));
+        costs = align(add(targets, mul(header.numOfEdges, header.idBytes)));
+        total = add(costs, mul(header.numOfEdges, header.costBytes));
+    }
 
-std::vector<edge::Cost_t> graph::dijkstra(size_type start) const
-{
-    std::vector<edge::Cost_t> dist(size(), edge::INF_COST);
-    dist[start] = 0;
+    [[nodiscard]] inline static std::uint64_t align(std::uint64_t offset)
+    {
+        return add(offset, 7) & ~std::uint64_t{7};
+    }
 
-    std::priority_queue<std::pair<edge::Cost_t, size_type>> queue;
-    queue.push({0, start});
+    [[nodiscard]] inline static std::uint64_t add(std::uint64_t lhs, std::uint64_t rhs)
+    {
+        if (lhs > std::numeric_limits<std::uint64_t>::max() - rhs) {
+            throw std::overflow_error("Binary section offset does not fit 64 bits");
+        }
+        return lhs + rhs;
+    }
 
-    while (!queue.empty()) {
-        const auto [cost, id] = queue.top();
-        queue.pop();
+    [[nodiscard]] inline static std::uint64_t mul(std::uint64_t lhs, std::uint64_t rhs)
+    {
+        if (0 != rhs && lhs > std::numeric_limits<std::uint64_t>::max() / rhs) {
+            throw std::overflow_error("Binary section size does not fit 64 bits");
+        }
+        return lhs * rhs;
+    }
 
-        for (const edge* edge : m_adjList[id]->get_edges()) {
-            const size_type toId = edge->get_to()->get_id();
-            const edge::Cost_t toCost = edge->get_cost();
-            const edge::Cost_t totalCost = cost + toCost;
-            if (totalCost < dist[toId]) {
-                dist[toId] = totalCost;
-                queue.push({totalCost, toId});
-            }
+    template <typename Cost>
+    [[nodiscard]] constexpr static std::uint32_t cost_bytes() noexcept
+    {
+        if constexpr (std::is_void_v<Cost>) {
+            return 0;
+        } else {
+            return sizeof(Cost);
         }
     }
-    return dist;
-}
 
-}
+    std::uint64_t nameOffsets;
+    std::uint64_t names;
+    std::uint64_t offsets;
+    std::uint64_t targets;
+    std::uint64_t costs;
+    std::uint64_t total;
+};
 
-namespace impl
+/**
+ * @brief Buffered writer of raw values, keeps track of the file offset.
+ */
+class binary_writer
 {
+public:
+    explicit binary_writer(std::ostream& os)
+        : m_os(os)
+    {
+        m_buffer.reserve(BUFFER_SIZE);
+    }
 
-bool graph::has_negative_cycle() const
-{
-    assert(!empty());
-    std::vector<edge::Cost_t> dist(size(), edge::INF_COST);
-    dist[0] = 0;
-    for (size_type i = 1; i < size(); ++i) {
-        for (auto it = cbegin_edges(); it != cend_edges(); ++it) {
-            size_type fromIdx = (*it)->get_from_idx();
-            size_type toIdx = (*it)->get_to_idx();
-            edge::Cost_t cost = (*it)->get_cost();
-            if (dist[fromIdx] != edge::INF_COST && dist[fromIdx] + cost < dist[toIdx]) {
-                dist[toIdx] = dist[fromIdx] + cost;
-            }
+    ~binary_writer()
+    {
+        flush();
+    }
+
+    template <typename T>
+    void put(const T& value)
+    {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        put(bytes, sizeof(T));
+    }
+
+    void put(const char* data, std::size_t size)
+    {
+        if (m_buffer.size() + size > BUFFER_SIZE) {
+            flush();
+        }
+        if (size > BUFFER_SIZE) {
+            m_os.write(data, static_cast<std::streamsize>(size));
+        } else {
+            m_buffer.insert(m_buffer.end(), data, data + size);
         }
+        m_offset += size;
     }
 
-    for (auto it = cbegin_edges(); it != cend_edges(); ++it) {
-        size_type fromIdx = (*it)->get_from_idx();
-        size_type toIdx = (*it)->get_to_idx();
-        edge::Cost_t cost = (*it)->get_cost();
-        if (dist[fromIdx] != edge::INF_COST && dist[fromIdx] + cost < dist[toIdx]) {
-            return true;
+    void pad_to(std::uint64_t offset)
+    {
+        assert(offset >= m_offset);
+        while (m_offset < offset) {
+            put('\0');
         }
     }
 
-    return false;
-}
+    void flush()
+    {
+        m_os.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+        m_buffer.clear();
+    }
+
+private:
+    constexpr static std::size_t BUFFER_SIZE = 1 << 20;
+
+    std::ostream& m_os;
+    std::vector<char> m_buffer;
+    std::uint64_t m_offset = 0;
+};
 
 }
 
-namespace impl
+template <typename Cost, typename Id>
+void basic_graph<Cost, Id>::serialize_binary(const std::string& fileName) const
 {
+    detail::binary_header header{};
+    std::memcpy(header.magic, detail::binary_header::MAGIC, sizeof(header.magic));
+    header.version = detail::binary_header::VERSION;
+    header.endianMark = detail::binary_header::ENDIAN_MARK;
+    header.idBytes = sizeof(id_type);
+    header.costBytes = detail::binary_layout::cost_bytes<Cost>();
+    header.costKind = detail::binary_header::kind_of<Cost>();
+    header.numOfNodes = size();
+    header.numOfEdges = 0;
+    header.nameBytes = 0;
+    // Removed ids are skipped, the nodes are written with their compacted ids
+    const iterator_range<const_node_iterator> nodes(begin_nodes(), end_nodes());
+    const std::vector<id_type> ids = compacted_ids();
+    for (const node* n : nodes) {
+        header.numOfEdges += n->degree();
+        header.nameBytes += n->get_name().size();
+    }
+    if (header.numOfEdges >= INVALID_ID) {
+        throw serialization_error("Number of edges exceeds the range of the node id type");
+    }
+    const detail::binary_layout layout(header, sizeof(header));
 
-void graph::serialize(const std::string& fileName) const
-{
-    std::ofstream os{fileName};
-    os << size() << '\n';
-    for (const node* n : m_adjList) {
-        os << n->get_name() << ' ' << n->get_num_of_edges() << ' ';
+    std::ofstream os{fileName, std::ios::binary};
+    if (!os) {
+        throw serialization_error("Can't open " + fileName + " for writing");
+    }
+    detail::binary_writer writer(os);
+    writer.put(header);
+
+    writer.pad_to(layout.nameOffsets);
+    std::uint64_t nameOffset = 0;
+    writer.put(nameOffset);
+    for (const node* n : nodes) {
+        nameOffset += n->get_name().size();
+        writer.put(nameOffset);
+    }
+
+    writer.pad_to(layout.names);
+    for (const node* n : nodes) {
+        writer.put(n->get_name().data(), n->get_name().size());
+    }
+
+    writer.pad_to(layout.offsets);
+    id_type offset = 0;
+    writer.put(offset);
+    for (const node* n : nodes) {
+        offset += static_cast<id_type>(n->degree());
+        writer.put(offset);
+    }
+
+    writer.pad_to(layout.targets);
+    for (const node* n : nodes) {
         for (const edge* e : n->get_edges()) {
-            os << e->get_to()->get_id() << ' ' << e->get_cost() << ' ';
+            writer.put(ids[e->get_to_idx()]);
         }
-        os << '\n';
     }
-}
 
+    writer.pad_to(layout.costs);
+    if constexpr (is_weighted) {
+        for (const node* n : nodes) {
+            for (const edge* e : n->get_edges()) {
+                writer.put(e->get_cost());
+            }
+        }
+    }
+    writer.flush();
+    os.flush();
+    if (!os) {
+        throw serialization_error("Can't write " + fileName);
+    }
 }
 
-namespace impl
-{
-
-void graph::deserialize(const std::string& fileName)
+template <typename Cost, typename Id>
+basic_csr_graph<Cost, Id> basic_csr_graph<Cost, Id>::map(const std::string& fileName, bool validate)
 {
-    clear();
-    std::ifstream is{fileName};
-
-    size_type size = 0;
-    is >> size;
+    auto file = std::make_shared<const mapped_file>(fileName);
 
-    m_adjList.resize(size);
-    for (size_t i = 0; i < m_adjList.size(); ++i) {
-        m_adjList[i] = new node(i);
+    detail::binary_header header{};
+    if (file->size() < detail::binary_header::VERSION_1_SIZE) {
+        throw serialization_error(fileName + ": not a binary graph");
+    }
+    std::memcpy(&header, file->data(), std::min<std::size_t>(sizeof(header), file->size()));
+    if (0 != std::memcmp(header.magic, detail::binary_header::MAGIC, sizeof(header.magic))) {
+        throw serialization_error(fileName + ": not a binary graph");
+    }
+    std::uint64_t headerBytes = sizeof(header);
+    if (1 == header.version) {
+        headerBytes = detail::binary_header::VERSION_1_SIZE;
+        header.costKind = detail::binary_header::SIGNED_INTEGER;
+    } else if (detail::binary_header::VERSION != header.version) {
+        throw serialization_error(fileName + ": unsupported version " + std::to_string(header.version));
+    } else if (file->size() < sizeof(header)) {
+        throw serialization_error(fileName + ": truncated file");
+    }
+    if (detail::binary_header::ENDIAN_MARK != header.endianMark) {
+        throw serialization_error(fileName + ": written with a different byte order");
+    }
+    if (sizeof(id_type) != header.idBytes || detail::binary_layout::cost_bytes<Cost>() != header.costBytes
+        || detail::binary_header::kind_of<Cost>() != header.costKind) {
+        throw serialization_error(fileName + ": id or cost type does not match");
+    }
+    const detail::binary_layout layout = [&] {
+        try {
+            return detail::binary_layout(header, headerBytes);
+        } catch (const std::overflow_error&) {
+            throw serialization_error(fileName + ": corrupted section sizes");
+        }
+    }();
+    if (file->size() < layout.total) {
+        throw serialization_error(fileName + ": truncated file");
     }
 
-    for (size_t i = 0; i < m_adjList.size(); ++i) {
-        std::string name;
-        is >> name >> size;
-        m_adjList[i]->set_name(std::move(name));
-        for (size_t j = 0; j < size; ++j) {
-            size_type to;
-            edge::Cost_t cost;
-            is >> to >> cost;
-            assert(to >= 0 && to < m_adjList.size());
-            (void)add_edge(m_adjList[i], m_adjList[to], cost);
+    basic_csr_graph g;
+    g.m_size = header.numOfNodes;
+    g.m_numOfNodes = header.numOfNodes;
+    g.m_numOfEdges = header.numOfEdges;
+    g.m_nameOffsets = reinterpret_cast<const std::uint64_t*>(file->data() + layout.nameOffsets);
+    g.m_names = file->data() + layout.names;
+    g.m_offsets = reinterpret_cast<const id_type*>(file->data() + layout.offsets);
+    g.m_targets = reinterpret_cast<const id_type*>(file->data() + layout.targets);
+    if constexpr (is_weighted) {
+        g.m_costs = reinterpret_cast<const cost_type*>(file->data() + layout.costs);
+    }
+    if (g.m_offsets[g.m_size] != g.m_numOfEdges || g.m_nameOffsets[g.m_size] != header.nameBytes) {
+        throw serialization_error(fileName + ": corrupted section sizes");
+    }
+    if (validate) {
+        if (0 != g.m_offsets[0] || 0 != g.m_nameOffsets[0]) {
+            throw serialization_error(fileName + ": corrupted offsets");
+        }
+        for (size_type i = 0; i < g.m_size; ++i) {
+            if (g.m_offsets[i] > g.m_offsets[i + 1] || g.m_nameOffsets[i] > g.m_nameOffsets[i + 1]) {
+                throw serialization_error(fileName + ": corrupted offsets of node " + std::to_string(i));
+            }
+        }
+        for (size_type i = 0; i < g.m_numOfEdges; ++i) {
+            if (g.m_targets[i] >= g.m_size) {
+                throw serialization_error(fileName + ": edge " + std::to_string(i) + " targets missing node "
+                                          + std::to_string(g.m_targets[i]));
+            }
         }
     }
-    m_adjList.shrink_to_fit();
+    g.m_storage = std::move(file);
+    return g;
 }
 
 }
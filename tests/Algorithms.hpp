@@ -1,5 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <tuple>
+#include <vector>
+
 TEST(Algorithms, is_cyclic_false)
 {
     impl::graph g;
@@ -25,6 +32,293 @@ TEST(Algorithms, is_cyclic_true)
     ASSERT_EQ(true, g.is_cyclic());
 }
 
+TEST(Algorithms, find_cycle_on_long_chain)
+{
+    // Deep enough to overflow the stack of a recursive search
+    constexpr std::size_t SIZE = 300000;
+    constexpr std::size_t CLOSE = 1000;
+    std::vector<std::tuple<std::size_t, std::size_t, int>> edges;
+    for (std::size_t i = 0; i + 1 < SIZE; ++i) {
+        edges.emplace_back(i, i + 1, 1);
+    }
+    const impl::graph chain(edges.begin(), edges.end());
+    edges.emplace_back(SIZE - 1, CLOSE, 1);
+    const impl::graph g(edges.begin(), edges.end());
+
+    ASSERT_EQ(false, chain.is_cyclic());
+    ASSERT_EQ(true, chain.find_cycle().empty());
+    ASSERT_EQ(true, g.is_cyclic());
+
+    const std::vector<std::size_t> cycle = g.find_cycle();
+    ASSERT_EQ(SIZE - CLOSE, cycle.size());
+    for (std::size_t i = 0; i < cycle.size(); ++i) {
+        const std::size_t next = cycle[(i + 1) % cycle.size()];
+        const auto edges = g.out_edges(cycle[i]);
+        ASSERT_EQ(true, std::any_of(edges.begin(), edges.end(), [&](const auto& e) { return next == e.to; }));
+    }
+    ASSERT_EQ(cycle, g.freeze().find_cycle());
+
+    // Kahn's algorithm removes the nodes before the cycle only
+    std::vector<std::pair<std::size_t, std::size_t>> calls;
+    auto progress = [&](std::size_t removed, std::size_t total) { calls.emplace_back(removed, total); };
+    ASSERT_EQ(true, g.is_cyclic(progress, 2));
+    ASSERT_EQ((std::vector<std::pair<std::size_t, std::size_t>>{{CLOSE, SIZE}}), calls);
+    calls.clear();
+    ASSERT_EQ(false, chain.freeze().is_cyclic(progress, 2));
+    ASSERT_EQ(SIZE / 65536 + 1, calls.size());
+    ASSERT_EQ(std::make_pair(SIZE, SIZE), calls.back());
+
+    impl::graph loop;
+    loop.add_edge("A", "B");
+    loop.add_edge("B", "B");
+    ASSERT_EQ(std::vector<std::size_t>{loop.get_node("B")->get_id()}, loop.find_cycle());
+    ASSERT_EQ(true, loop.is_cyclic([](std::size_t, std::size_t) {}, 1));
+}
+
+TEST(Algorithms, kahn_counts_parallel_edges_beyond_the_id_type)
+{
+    // More incoming edges than an 8 bit id holds
+    impl::basic_graph<int, std::uint8_t> g;
+    for (int i = 0; i < 256; ++i) {
+        g.add_edge("A", "B");
+    }
+    g.add_edge("B", "C");
+
+    auto ignore = [](std::size_t, std::size_t) {};
+    ASSERT_EQ(false, g.is_cyclic());
+    ASSERT_EQ(false, g.is_cyclic(ignore, 2));
+    g.add_edge("C", "A");
+    ASSERT_EQ(true, g.is_cyclic(ignore, 2));
+}
+
+TEST(Algorithms, topological_order_with_parallel_edges_beyond_the_id_type)
+{
+    impl::basic_graph<int, std::uint8_t> g;
+    for (int i = 0; i < 256; ++i) {
+        g.add_edge("A", "B");
+    }
+    g.add_edge("B", "C");
+
+    const std::vector<std::size_t> ids{g.get_node("A")->get_id(), g.get_node("B")->get_id(),
+                                       g.get_node("C")->get_id()};
+    ASSERT_EQ(ids, g.topological_order());
+    ASSERT_EQ((std::vector<std::vector<std::size_t>>{{ids[0]}, {ids[1]}, {ids[2]}}), g.topological_levels(2));
+    g.add_edge("C", "B");
+    ASSERT_THROW((void)g.topological_order(), impl::cycle_error);
+}
+
+TEST(Algorithms, topological_order_and_levels)
+{
+    // Random DAG, edges go from lower to higher ids
+    std::mt19937 rng{11};
+    constexpr std::size_t SIZE = 3000;
+    std::uniform_int_distribution<std::size_t> pick(0, SIZE - 1);
+    std::vector<std::tuple<std::size_t, std::size_t, int>> edges;
+    for (std::size_t i = 0; i < 4 * SIZE; ++i) {
+        const std::size_t a = pick(rng);
+        const std::size_t b = pick(rng);
+        if (a != b) {
+            edges.emplace_back(std::min(a, b), std::max(a, b), 1);
+        }
+    }
+    const impl::graph g(edges.begin(), edges.end());
+
+    const std::vector<std::size_t> order = g.topological_order();
+    ASSERT_EQ(g.size(), order.size());
+    std::vector<std::size_t> position(g.num_of_ids());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        position[order[i]] = i;
+    }
+    std::vector<std::size_t> level(g.num_of_ids(), 0);
+    for (const auto& [from, to, cost] : edges) {
+        ASSERT_LT(position[from], position[to]);
+    }
+    for (const std::size_t id : order) {
+        for (const auto [toId, toCost] : g.out_edges(id)) {
+            level[toId] = std::max(level[toId], level[id] + 1);
+        }
+    }
+
+    const std::vector<std::vector<std::size_t>> levels = g.topological_levels(4);
+    std::size_t placed = 0;
+    for (std::size_t l = 0; l < levels.size(); ++l) {
+        ASSERT_EQ(true, std::is_sorted(levels[l].begin(), levels[l].end()));
+        for (const std::size_t id : levels[l]) {
+            ASSERT_EQ(level[id], l);
+        }
+        placed += levels[l].size();
+    }
+    ASSERT_EQ(g.size(), placed);
+    ASSERT_EQ(levels, g.topological_levels(1));
+    ASSERT_EQ(levels, g.freeze().topological_levels(3));
+    ASSERT_EQ(order, g.freeze().topological_order());
+
+    impl::graph cyclic;
+    cyclic.add_edge("A", "B");
+    cyclic.add_edge("B", "C");
+    cyclic.add_edge("C", "B");
+    cyclic.add_edge("C", "D");
+    ASSERT_THROW((void)cyclic.topological_order(), impl::cycle_error);
+    try {
+        (void)cyclic.topological_levels(2);
+        FAIL() << "expected a cycle_error";
+    } catch (const impl::cycle_error& e) {
+        ASSERT_EQ(true, e.node() == cyclic.get_node("B")->get_id() || e.node() == cyclic.get_node("C")->get_id());
+    }
+}
+
+TEST(Algorithms, mother_node_with_many_sources)
+{
+    // Sources 1..SOURCES all lead into a shared chain, node 0 may reach them all
+    constexpr std::size_t SOURCES = 1000;
+    constexpr std::size_t CHAIN = 1000;
+    auto sources = [](bool withRoot) {
+        std::vector<std::pair<std::size_t, std::size_t>> edges;
+        for (std::size_t i = 1; i <= SOURCES; ++i) {
+            edges.emplace_back(i, SOURCES + 1);
+            if (withRoot) {
+                edges.emplace_back(0, i);
+            }
+        }
+        for (std::size_t i = SOURCES + 1; i < SOURCES + CHAIN; ++i) {
+            edges.emplace_back(i, i + 1);
+        }
+        return impl::unweighted_graph<>(edges.begin(), edges.end());
+    };
+
+    const impl::unweighted_graph<> none = sources(false);
+    ASSERT_EQ(nullptr, none.mother_node());
+    ASSERT_EQ(impl::unweighted_graph<>::INVALID_ID, none.freeze().mother_node());
+
+    const impl::unweighted_graph<> rooted = sources(true);
+    ASSERT_EQ(0u, rooted.mother_node()->get_id());
+    ASSERT_EQ(0u, rooted.freeze().mother_node());
+
+    // The last start is the candidate
+    impl::graph g;
+    g.add_edge("A", "B");
+    g.add_edge("C", "B");
+    g.add_edge("D", "C");
+    g.add_edge("D", "A");
+    ASSERT_EQ("D", g.mother_node()->get_name());
+}
+
+TEST(Algorithms, strongly_connected_components)
+{
+    // Cycles of random lengths linked by random edges, plus isolated nodes
+    std::mt19937 rng{5};
+    constexpr std::size_t SIZE = 5000;
+    std::vector<std::tuple<std::size_t, std::size_t, int>> edges;
+    for (std::size_t first = 0; first < SIZE - 20;) {
+        const std::size_t length = std::uniform_int_distribution<std::size_t>(1, 40)(rng);
+        for (std::size_t i = 0; i + 1 < length; ++i) {
+            edges.emplace_back(first + i, first + i + 1, 1);
+        }
+        edges.emplace_back(first + length - 1, first, 2);
+        first += length;
+    }
+    std::uniform_int_distribution<std::size_t> pick(0, SIZE - 1);
+    for (std::size_t i = 0; i < SIZE / 2; ++i) {
+        edges.emplace_back(pick(rng), pick(rng), 3);
+    }
+    const impl::graph g(edges.begin(), edges.end());
+
+    const impl::scc_result<std::size_t> scc = g.strongly_connected_components();
+    ASSERT_EQ(g.num_of_ids(), scc.components.size());
+    std::size_t total = 0;
+    for (const std::size_t size : scc.sizes) {
+        total += size;
+    }
+    ASSERT_EQ(g.size(), total);
+    for (const auto& [from, to, cost] : edges) {
+        ASSERT_LE(scc.components[from], scc.components[to]);
+    }
+
+    // The parallel components are the same up to their numbering
+    for (const std::size_t numOfThreads : {1, 4}) {
+        const impl::scc_result<std::size_t> parallel = g.parallel_strongly_connected_components(numOfThreads);
+        ASSERT_EQ(scc.count(), parallel.count());
+        std::vector<std::size_t> renumber(scc.count(), impl::graph::INVALID_ID);
+        for (std::size_t id = 0; id < g.num_of_ids(); ++id) {
+            std::size_t& expected = renumber[parallel.components[id]];
+            if (impl::graph::INVALID_ID == expected) {
+                expected = scc.components[id];
+            }
+            ASSERT_EQ(expected, scc.components[id]);
+            ASSERT_EQ(scc.sizes[scc.components[id]], parallel.sizes[parallel.components[id]]);
+        }
+    }
+
+    // Reachability, mother node and cycles from the condensation
+    const impl::graph dag = g.condensation(scc);
+    ASSERT_EQ(scc.count(), dag.size());
+    ASSERT_EQ(false, dag.is_cyclic());
+    ASSERT_EQ(nullptr == g.mother_node(), nullptr == dag.mother_node());
+    for (std::size_t from = 0; from < SIZE; from += 997) {
+        std::vector<bool> reached(g.num_of_ids(), false);
+        for (auto it = g.begin_BFS(from); it != g.end_BFS(); ++it) {
+            reached[(*it).get_id()] = true;
+        }
+        std::vector<bool> reachedComponents(dag.num_of_ids(), false);
+        for (auto it = dag.begin_BFS(scc.components[from]); it != dag.end_BFS(); ++it) {
+            reachedComponents[(*it).get_id()] = true;
+        }
+        for (std::size_t to = 0; to < g.num_of_ids(); ++to) {
+            ASSERT_EQ(reached[to], reachedComponents[scc.components[to]]);
+        }
+    }
+
+    const impl::csr_graph csr = g.freeze();
+    ASSERT_EQ(scc.components, csr.strongly_connected_components().components);
+    ASSERT_EQ(scc.count(), csr.parallel_strongly_connected_components(2).count());
+    ASSERT_EQ(dag.num_of_edges(), csr.condensation(scc).num_of_edges());
+}
+
+TEST(Algorithms, strongly_connected_components_with_narrow_ids)
+{
+    // More edges than an 8 bit id holds
+    impl::basic_graph<int, std::uint8_t> g;
+    for (int i = 0; i + 1 < 120; ++i) {
+        for (int copy = 0; copy < 3; ++copy) {
+            g.add_edge(std::to_string(i), std::to_string(i + 1));
+        }
+    }
+    g.add_edge("60", "30");
+
+    const impl::scc_result<std::uint8_t> scc = g.strongly_connected_components();
+    ASSERT_EQ(90u, scc.count());
+    for (const std::size_t numOfThreads : {1, 2}) {
+        const impl::scc_result<std::uint8_t> parallel = g.parallel_strongly_connected_components(numOfThreads);
+        ASSERT_EQ(scc.count(), parallel.count());
+        for (std::size_t id = 0; id < g.num_of_ids(); ++id) {
+            ASSERT_EQ(scc.sizes[scc.components[id]], parallel.sizes[parallel.components[id]]);
+        }
+    }
+}
+
+TEST(Algorithms, strongly_connected_components_on_long_cycle)
+{
+    constexpr std::size_t SIZE = 300000;
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    for (std::size_t i = 0; i < SIZE; ++i) {
+        edges.emplace_back(i, (i + 1) % SIZE);
+    }
+    edges.emplace_back(0, SIZE);
+    const impl::unweighted_graph<> g(edges.begin(), edges.end());
+
+    const impl::scc_result<std::size_t> scc = g.strongly_connected_components();
+    ASSERT_EQ(2u, scc.count());
+    ASSERT_EQ((std::vector<std::size_t>{SIZE, 1}), scc.sizes);
+    ASSERT_EQ(1u, scc.components[SIZE]);
+    std::vector<std::size_t> sizes = g.parallel_strongly_connected_components(2).sizes;
+    std::sort(sizes.begin(), sizes.end());
+    ASSERT_EQ((std::vector<std::size_t>{1, SIZE}), sizes);
+
+    const impl::unweighted_graph<> dag = g.condensation(scc);
+    ASSERT_EQ(1u, dag.num_of_edges());
+    ASSERT_EQ("0", dag.mother_node()->get_name());
+}
+
 TEST(Algorithms, has_negative_cycle_false)
 {
     impl::graph g;
@@ -57,3 +351,388 @@ TEST(Algorithms, has_negative_cycle_true)
 
     ASSERT_EQ(true, g.has_negative_cycle());
 }
+
+TEST(Algorithms, delta_stepping_matches_dijkstra)
+{
+    std::mt19937 rng{7};
+    std::uniform_int_distribution<std::size_t> pick(0, 299);
+    std::uniform_int_distribution<int> weight(0, 50);
+    std::vector<std::tuple<std::size_t, std::size_t, int>> edges(1500);
+    for (auto& e : edges) {
+        e = {pick(rng), pick(rng), weight(rng)};
+    }
+    impl::graph g(edges.begin(), edges.end());
+    g.add_node("Unreachable");
+
+    const std::vector<int> expected = g.dijkstra(0);
+    for (int delta : {0, 1, 7, 1000}) {
+        for (impl::graph::size_type numOfThreads : {1u, 4u}) {
+            ASSERT_EQ(expected, g.delta_stepping(0, delta, numOfThreads));
+        }
+    }
+    ASSERT_EQ(expected, g.freeze().delta_stepping(0, 5, 3));
+}
+
+TEST(Algorithms, delta_stepping_with_sparse_buckets_and_a_shared_pool)
+{
+    impl::graph g;
+    g.add_edge("A", "B", 1000000000);
+    g.add_edge("A", "C", 1);
+    g.add_edge("C", "B", 999999998);
+    g.add_edge("B", "D", 1);
+
+    const std::vector<int> expected = g.dijkstra(0);
+    impl::thread_pool pool{3};
+    for (int delta : {1, 2, 1000}) {
+        ASSERT_EQ(expected, g.delta_stepping(0, delta, pool));
+        ASSERT_EQ(expected, g.freeze().delta_stepping(0, delta, pool));
+    }
+}
+
+TEST(Algorithms, dijkstra_to_target)
+{
+    impl::graph g;
+    g.add_edge("A", "B", 4);
+    g.add_edge("A", "C", 1);
+    g.add_edge("C", "B", 2);
+    g.add_edge("B", "D", 5);
+    g.add_edge("C", "D", 8);
+    g.add_node("E");
+
+    ASSERT_EQ((std::vector<int>{0, 3, 1, 8, impl::edge::INF_COST}), g.dijkstra(0));
+    ASSERT_EQ(3, g.dijkstra(0, 1));
+    ASSERT_EQ(8, g.dijkstra(0, 3));
+    ASSERT_EQ(impl::edge::INF_COST, g.dijkstra(0, 4));
+    ASSERT_EQ(g.dijkstra(2, 3), g.freeze().dijkstra(2, 3));
+}
+
+TEST(Algorithms, shortest_paths_walks_back)
+{
+    impl::graph g;
+    g.add_edge("A", "B", 4);
+    g.add_edge("A", "C", 1);
+    g.add_edge("C", "B", 2);
+    g.add_edge("C", "B", 7);
+    g.add_edge("B", "D", 5);
+    g.add_edge("C", "D", 8);
+    g.add_node("E");
+
+    const auto tree = g.shortest_paths(0, true);
+    ASSERT_EQ(g.dijkstra(0), tree.costs());
+    ASSERT_EQ(2u, tree.predecessor(1));
+    ASSERT_EQ(0u, tree.predecessor_edge(1));
+    ASSERT_EQ(impl::graph::INVALID_ID, tree.predecessor(0));
+    ASSERT_EQ(false, tree.reachable(4));
+    ASSERT_EQ(true, tree.path(4).empty());
+
+    std::vector<std::size_t> path;
+    for (const std::size_t id : tree.path(3)) {
+        path.push_back(id);
+    }
+    ASSERT_EQ((std::vector<std::size_t>{3, 1, 2, 0}), path);
+
+    const auto frozen = g.freeze().shortest_paths(0);
+    ASSERT_EQ(tree.costs(), frozen.costs());
+    ASSERT_EQ(false, frozen.has_predecessor_edges());
+    ASSERT_EQ(2u, frozen.predecessor(1));
+}
+
+namespace
+{
+
+/**
+ * @brief Build a width x height grid with edges both ways between neighbors.
+ */
+impl::graph make_grid(std::size_t width, std::size_t height)
+{
+    std::mt19937 rng{11};
+    std::uniform_int_distribution<int> weight(1, 9);
+    std::vector<std::tuple<std::size_t, std::size_t, int>> edges;
+    for (std::size_t y = 0; y < height; ++y) {
+        for (std::size_t x = 0; x < width; ++x) {
+            const std::size_t id = y * width + x;
+            if (x + 1 < width) {
+                edges.emplace_back(id, id + 1, weight(rng));
+                edges.emplace_back(id + 1, id, weight(rng));
+            }
+            if (y + 1 < height) {
+                edges.emplace_back(id, id + width, weight(rng));
+                edges.emplace_back(id + width, id, weight(rng));
+            }
+        }
+    }
+    return impl::graph(edges.begin(), edges.end());
+}
+
+int path_cost(const impl::graph& g, const std::vector<std::size_t>& nodes)
+{
+    int total = 0;
+    for (std::size_t i = 1; i < nodes.size(); ++i) {
+        int best = impl::edge::INF_COST;
+        for (const auto [to, cost] : g.out_edges(nodes[i - 1])) {
+            if (to == nodes[i]) {
+                best = std::min(best, cost);
+            }
+        }
+        total += best;
+    }
+    return total;
+}
+
+}
+
+TEST(Algorithms, shortest_path_matches_dijkstra)
+{
+    constexpr std::size_t width = 30;
+    const impl::graph g = make_grid(width, 30);
+    // Every edge costs at least 1, so the manhattan distance is a lower bound
+    for (const auto& [from, to] : {std::pair<std::size_t, std::size_t>{0, 899}, {31, 45}, {450, 452}, {7, 7}}) {
+        const int expected = g.dijkstra(from, to);
+        const auto manhattan = [to = to](std::size_t id) {
+            const auto dx = static_cast<int>(id % width) - static_cast<int>(to % width);
+            const auto dy = static_cast<int>(id / width) - static_cast<int>(to / width);
+            return std::abs(dx) + std::abs(dy);
+        };
+
+        const auto bidirectional = g.shortest_path(from, to);
+        ASSERT_EQ(expected, bidirectional.cost);
+        ASSERT_EQ(from, bidirectional.nodes.front());
+        ASSERT_EQ(to, bidirectional.nodes.back());
+        ASSERT_EQ(expected, path_cost(g, bidirectional.nodes));
+
+        const auto astar = g.shortest_path(from, to, manhattan);
+        ASSERT_EQ(expected, astar.cost);
+        ASSERT_EQ(expected, path_cost(g, astar.nodes));
+    }
+    ASSERT_LT(g.shortest_path(450, 452).settled, g.size() / 10);
+}
+
+TEST(Algorithms, shortest_path_unreachable)
+{
+    impl::graph g;
+    g.add_edge("A", "B", 1);
+    g.add_edge("C", "B", 1);
+
+    const auto result = g.shortest_path(0, 2);
+    ASSERT_EQ(impl::edge::INF_COST, result.cost);
+    ASSERT_EQ(true, result.nodes.empty());
+    ASSERT_EQ(true, g.shortest_path(0, 2, [](std::size_t) { return 0; }).nodes.empty());
+}
+
+TEST(Algorithms, visitor_traversals)
+{
+    // A -> B -> D -> E, A -> C -> E, E -> C, C -> A
+    impl::graph g;
+    g.add_edge("A", "B");
+    g.add_edge("A", "C");
+    g.add_edge("B", "D");
+    g.add_edge("D", "E");
+    g.add_edge("C", "E");
+    g.add_edge("E", "C");
+    g.add_edge("C", "A");
+
+    struct recorder : impl::default_visitor
+    {
+        impl::visit_result discover(size_type id, size_type depth)
+        {
+            order.push_back(id);
+            depths.push_back(depth);
+            return id == skip ? impl::visit_result::SKIP : impl::visit_result::PROCEED;
+        }
+        impl::visit_result tree_edge(size_type from, size_type to, int)
+        {
+            parents.emplace_back(from, to);
+            return impl::visit_result::PROCEED;
+        }
+        impl::visit_result back_edge(size_type from, size_type to, int)
+        {
+            backEdges.emplace_back(from, to);
+            return impl::visit_result::PROCEED;
+        }
+        impl::visit_result finish(size_type id)
+        {
+            finished.push_back(id);
+            return id == stop ? impl::visit_result::STOP : impl::visit_result::PROCEED;
+        }
+
+        size_type skip = impl::graph::INVALID_ID;
+        size_type stop = impl::graph::INVALID_ID;
+        std::vector<size_type> order;
+        std::vector<size_type> depths;
+        std::vector<std::pair<size_type, size_type>> parents;
+        std::vector<std::pair<size_type, size_type>> backEdges;
+        std::vector<size_type> finished;
+    };
+    using edges = std::vector<std::pair<std::size_t, std::size_t>>;
+
+    recorder bfs;
+    ASSERT_EQ(false, g.bfs(0, bfs));
+    ASSERT_EQ((std::vector<std::size_t>{0, 1, 2, 3, 4}), bfs.order);
+    ASSERT_EQ((std::vector<std::size_t>{0, 1, 1, 2, 2}), bfs.depths);
+    ASSERT_EQ((edges{{0, 1}, {0, 2}, {1, 3}, {2, 4}}), bfs.parents);
+    ASSERT_EQ(true, bfs.backEdges.empty());
+
+    recorder dfs;
+    ASSERT_EQ(false, g.dfs(0, dfs));
+    ASSERT_EQ((std::vector<std::size_t>{0, 1, 3, 4, 2}), dfs.order);
+    ASSERT_EQ((std::vector<std::size_t>{0, 1, 2, 3, 4}), dfs.depths);
+    ASSERT_EQ((edges{{2, 4}, {2, 0}}), dfs.backEdges);
+    ASSERT_EQ((std::vector<std::size_t>{2, 4, 3, 1, 0}), dfs.finished);
+
+    // Skipped nodes are not expanded, stopping ends the search at once
+    recorder pruned;
+    pruned.skip = 1;
+    ASSERT_EQ(false, g.dfs(0, pruned));
+    ASSERT_EQ((std::vector<std::size_t>{0, 1, 2, 4}), pruned.order);
+    recorder stopped;
+    stopped.stop = 1;
+    ASSERT_EQ(true, g.bfs(0, stopped));
+    ASSERT_EQ((std::vector<std::size_t>{0, 1, 2, 3}), stopped.order);
+    ASSERT_EQ((std::vector<std::size_t>{0, 1}), stopped.finished);
+
+    const impl::csr_graph frozen = g.freeze();
+    recorder frozenDfs;
+    ASSERT_EQ(false, frozen.dfs(0, frozenDfs));
+    ASSERT_EQ(dfs.order, frozenDfs.order);
+    ASSERT_EQ(dfs.backEdges, frozenDfs.backEdges);
+}
+
+TEST(Algorithms, parallel_bfs_matches_bfs)
+{
+    // Low diameter random graph, so that the search turns bottom-up
+    std::mt19937 rng{7};
+    constexpr std::size_t SIZE = 2000;
+    std::uniform_int_distribution<std::size_t> pick(0, SIZE - 1);
+    std::vector<std::tuple<std::size_t, std::size_t, int>> edges;
+    for (std::size_t i = 0; i < 16 * SIZE; ++i) {
+        edges.emplace_back(pick(rng), pick(rng), 1);
+    }
+    impl::graph g(edges.begin(), edges.end());
+    g.add_node("isolated");
+    const std::vector<int> hops = g.dijkstra(0);
+
+    auto check = [&](const impl::bfs_result<std::size_t>& result) {
+        for (std::size_t id = 0; id < g.num_of_ids(); ++id) {
+            if (impl::edge::INF_COST == hops[id]) {
+                ASSERT_EQ(impl::graph::INVALID_ID, result.levels[id]);
+                ASSERT_EQ(impl::graph::INVALID_ID, result.parents[id]);
+                continue;
+            }
+            ASSERT_EQ(static_cast<std::size_t>(hops[id]), result.levels[id]);
+            if (0 != id) {
+                const std::size_t parent = result.parents[id];
+                ASSERT_EQ(result.levels[id], result.levels[parent] + 1);
+                ASSERT_EQ(true, g.get_node(parent)->has_edge(g.get_node(id)));
+            }
+        }
+        ASSERT_EQ(impl::graph::INVALID_ID, result.parents[0]);
+    };
+    check(g.parallel_bfs(0, 1));
+    check(g.parallel_bfs(0, 4));
+    g.index_incoming_edges(false);
+    check(g.parallel_bfs(0, 4));
+}
+
+TEST(Algorithms, num_of_paths_on_layered_dag)
+{
+    // Layers of two nodes, each node linked to both nodes of the next layer
+    auto layered = [](std::size_t numOfLayers) {
+        impl::graph g;
+        g.add_node("source");
+        g.add_node("target");
+        for (std::size_t layer = 0; layer < numOfLayers; ++layer) {
+            for (int i = 0; i < 2; ++i) {
+                const std::string name = std::to_string(layer) + '_' + std::to_string(i);
+                if (0 == layer) {
+                    g.add_edge("source", name);
+                } else {
+                    g.add_edge(std::to_string(layer - 1) + "_0", name);
+                    g.add_edge(std::to_string(layer - 1) + "_1", name);
+                }
+                if (numOfLayers == layer + 1) {
+                    g.add_edge(name, "target");
+                }
+            }
+        }
+        return g;
+    };
+
+    const impl::graph g = layered(40);
+    ASSERT_EQ(std::size_t{1} << 40, g.num_of_paths(g.get_node("source"), g.get_node("target")));
+    ASSERT_EQ(std::size_t{1} << 39, g.num_of_paths(g.get_node("0_1"), g.get_node("target")));
+    ASSERT_EQ(0u, g.num_of_paths(g.get_node("target"), g.get_node("source")));
+    ASSERT_EQ(1u, g.num_of_paths(g.get_node("source"), g.get_node("source")));
+    ASSERT_EQ(g.num_of_paths(g.get_node("source"), g.get_node("target")), g.freeze().num_of_paths(0, 1));
+
+    const impl::graph big = layered(70);
+    ASSERT_THROW((void)big.num_of_paths(big.get_node("source"), big.get_node("target")), std::overflow_error);
+    ASSERT_DOUBLE_EQ(std::ldexp(1.0, 70), big.num_of_paths<double>(big.get_node("source"), big.get_node("target")));
+}
+
+TEST(Algorithms, num_of_paths_reports_cycles)
+{
+    impl::graph g;
+    g.add_edge("A", "B");
+    g.add_edge("A", "C");
+    g.add_edge("B", "D");
+    g.add_edge("D", "E");
+    g.add_edge("C", "E");
+    g.add_edge("C", "D");
+    ASSERT_EQ(3u, g.num_of_paths(g.get_node("A"), g.get_node("E")));
+
+    // A cycle that can not reach the target, or only behind it, is harmless
+    g.add_edge("B", "X");
+    g.add_edge("X", "Y");
+    g.add_edge("Y", "X");
+    g.add_edge("E", "A");
+    ASSERT_EQ(3u, g.num_of_paths(g.get_node("A"), g.get_node("E")));
+
+    // Walking the cycle any number of times gives another path
+    g.add_edge("Y", "D");
+    try {
+        (void)g.num_of_paths(g.get_node("A"), g.get_node("E"));
+        FAIL() << "expected a cycle_error";
+    } catch (const impl::cycle_error& e) {
+        ASSERT_EQ(true, e.node() == g.get_node("X")->get_id() || e.node() == g.get_node("Y")->get_id());
+    }
+}
+
+TEST(Algorithms, num_of_paths_batch_matches_pairs)
+{
+    impl::graph g;
+    g.add_edge("A", "B");
+    g.add_edge("A", "C");
+    g.add_edge("B", "D");
+    g.add_edge("D", "E");
+    g.add_edge("C", "E");
+    g.add_edge("C", "D");
+    g.add_edge("C", "D");
+    g.add_node("F");
+
+    const std::vector<std::size_t> all = g.num_of_paths_from(g.get_node("A")->get_id());
+    ASSERT_EQ(g.num_of_ids(), all.size());
+    std::vector<std::size_t> targets;
+    for (std::size_t id = 0; id < g.num_of_ids(); ++id) {
+        ASSERT_EQ(g.num_of_paths(g.get_node("A"), g.get_node(id)), all[id]);
+        targets.push_back(g.num_of_ids() - id - 1);
+    }
+    targets.push_back(impl::graph::INVALID_ID);
+    const std::vector<std::size_t> batch = g.num_of_paths(g.get_node("A")->get_id(), targets.begin(), targets.end());
+    ASSERT_EQ(targets.size(), batch.size());
+    for (std::size_t i = 0; i + 1 < targets.size(); ++i) {
+        ASSERT_EQ(all[targets[i]], batch[i]);
+    }
+    ASSERT_EQ(0u, batch.back());
+    ASSERT_EQ(all, g.freeze().num_of_paths_from(g.get_node("A")->get_id()));
+
+    // Only the targets behind the cycle have an infinite number of paths
+    g.add_edge("E", "X");
+    g.add_edge("X", "Y");
+    g.add_edge("Y", "X");
+    const std::size_t e = g.get_node("E")->get_id();
+    const std::size_t y = g.get_node("Y")->get_id();
+    ASSERT_EQ(std::vector<std::size_t>{4u}, g.num_of_paths(g.get_node("A")->get_id(), &e, &e + 1));
+    ASSERT_THROW((void)g.num_of_paths(g.get_node("A")->get_id(), &y, &y + 1), impl::cycle_error);
+    ASSERT_THROW((void)g.num_of_paths_from(g.get_node("A")->get_id()), impl::cycle_error);
+    ASSERT_EQ(std::vector<double>{1.0}, g.num_of_paths<double>(e, &e, &e + 1));
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+TEST(BasicGraph, cost_traits_saturate)
+{
+    using int_traits = impl::cost_traits<int>;
+    using long_traits = impl::cost_traits<std::int64_t>;
+    using float_traits = impl::cost_traits<double>;
+
+    ASSERT_EQ(int_traits::infinity(), int_traits::add(int_traits::infinity(), -5));
+    ASSERT_EQ(int_traits::infinity(), int_traits::add(std::numeric_limits<int>::max() - 1, 2));
+    ASSERT_EQ(std::numeric_limits<int>::lowest(), int_traits::add(std::numeric_limits<int>::lowest(), -1));
+    ASSERT_EQ(7, int_traits::add(3, 4));
+    ASSERT_EQ(long_traits::infinity(), long_traits::add(long_traits::infinity() - 1, 2));
+    ASSERT_EQ(-1, long_traits::add(long_traits::infinity() - 1, -long_traits::infinity()));
+    ASSERT_EQ(std::numeric_limits<std::int64_t>::lowest(),
+              long_traits::add(std::numeric_limits<std::int64_t>::lowest(), -1));
+    ASSERT_TRUE(std::isinf(float_traits::infinity()));
+    ASSERT_EQ(float_traits::infinity(), float_traits::add(float_traits::infinity(), -5.0));
+    ASSERT_DOUBLE_EQ(0.75, float_traits::add(0.5, 0.25));
+}
+
+TEST(BasicGraph, int_costs_do_not_overflow)
+{
+    // Path cost does not fit an int, it stays at infinity instead of wrapping around
+    constexpr int BIG = std::numeric_limits<int>::max() / 2 + 1;
+    impl::graph g;
+    g.add_edge("A", "B", BIG);
+    g.add_edge("B", "C", BIG);
+    g.add_edge("A", "C", 5);
+    ASSERT_EQ(5, g.dijkstra(0)[2]);
+    ASSERT_EQ(BIG, g.dijkstra(0, 1));
+
+    impl::graph chain;
+    chain.add_edge("A", "B", BIG);
+    chain.add_edge("B", "C", BIG);
+    ASSERT_EQ(impl::edge::INF_COST, chain.dijkstra(0)[2]);
+    ASSERT_EQ(impl::edge::INF_COST, chain.shortest_path(0, 2).cost);
+}
+
+TEST(BasicGraph, floating_point_costs)
+{
+    using graph = impl::basic_graph<double, std::uint32_t>;
+    static_assert(sizeof(graph::node::id_type) == 4);
+
+    graph g;
+    g.add_edge("A", "B", 0.5);
+    g.add_edge("B", "C", 0.25);
+    g.add_edge("A", "C", 1.0);
+    g.add_edge("C", "D", 1e-3);
+
+    const std::vector<double> costs = g.dijkstra(0);
+    ASSERT_DOUBLE_EQ(0.75, costs[2]);
+    ASSERT_DOUBLE_EQ(0.751, costs[3]);
+    ASSERT_EQ(g.dijkstra(0), g.delta_stepping(0, 0.5, 2));
+    ASSERT_DOUBLE_EQ(0.751, g.shortest_path(0, 3).cost);
+    ASSERT_EQ((std::vector<std::uint32_t>{0, 1, 2, 3}), g.shortest_path(0, 3).nodes);
+    ASSERT_EQ(graph::INVALID_ID, g.shortest_paths(0).predecessor(0));
+    ASSERT_EQ(false, g.has_negative_cycle());
+
+    const graph::csr_graph frozen = g.freeze();
+    ASSERT_EQ(costs, frozen.dijkstra(0));
+
+    const std::string fileName = testing::TempDir() + "float_graph.txt";
+    g.serialize(fileName);
+    graph loaded;
+    loaded.deserialize(fileName);
+    ASSERT_EQ(costs, loaded.dijkstra(0));
+}
+
+TEST(BasicGraph, binary_format_checks_types)
+{
+    using graph = impl::basic_graph<std::int64_t, std::uint32_t>;
+    graph g;
+    g.add_edge("A", "B", std::int64_t{1} << 40);
+    g.add_edge("B", "C", 3);
+
+    const std::string fileName = testing::TempDir() + "wide_graph.bin";
+    g.serialize_binary(fileName);
+    const graph::csr_graph mapped = graph::csr_graph::map(fileName);
+    ASSERT_EQ(g.dijkstra(0), mapped.dijkstra(0));
+    ASSERT_EQ((std::int64_t{1} << 40) + 3, mapped.dijkstra(0, 2));
+
+    ASSERT_THROW(impl::csr_graph::map(fileName), impl::serialization_error);
+    ASSERT_THROW((impl::basic_csr_graph<double, std::uint32_t>::map(fileName)), impl::serialization_error);
+}
+
+TEST(BasicGraph, narrow_ids_are_bounded)
+{
+    impl::basic_graph<int, std::uint8_t> g;
+    for (int i = 0; i < 255; ++i) {
+        g.add_node(std::to_string(i));
+    }
+    ASSERT_EQ(255u, g.size());
+    ASSERT_THROW(g.add_node("one too many"), std::length_error);
+    ASSERT_THROW(g.add_edge("0", "one too many"), std::length_error);
+    ASSERT_EQ(false, g.contains("one too many"));
+    ASSERT_EQ(true, g.add_edge("0", "254"));
+    ASSERT_EQ(255u, g.size());
+}
+
+TEST(BasicGraph, unweighted_graph_runs_bfs)
+{
+    using graph = impl::unweighted_graph<std::uint32_t>;
+    static_assert(!graph::is_weighted);
+    static_assert(std::is_same_v<std::uint32_t, graph::cost_type>);
+    static_assert(sizeof(graph::edge) == 2 * sizeof(graph::node*));
+
+    // Same graph with unit costs gives the hop counts
+    graph g;
+    impl::graph weighted;
+    const std::vector<std::pair<std::string, std::string>> edges{
+        {"A", "B"}, {"A", "C"}, {"B", "D"}, {"C", "D"}, {"D", "E"}, {"E", "B"}, {"F", "A"}};
+    for (const auto& [from, to] : edges) {
+        g.add_edge(from, to);
+        weighted.add_edge(from, to, 1);
+    }
+
+    const std::vector<std::uint32_t> hops = g.dijkstra(0);
+    const std::vector<int> costs = weighted.dijkstra(0);
+    ASSERT_EQ(costs.size(), hops.size());
+    for (std::size_t i = 0; i < costs.size(); ++i) {
+        ASSERT_EQ(impl::edge::INF_COST == costs[i] ? graph::INVALID_ID : static_cast<std::uint32_t>(costs[i]),
+                  hops[i]);
+    }
+    ASSERT_EQ(3u, g.dijkstra(0, 4));
+    ASSERT_EQ(3u, g.shortest_path(0, 4).cost);
+    ASSERT_EQ(4u, g.shortest_path(0, 4).nodes.size());
+    ASSERT_EQ(graph::INVALID_ID, g.shortest_path(0, 5).cost);
+    ASSERT_EQ(hops, g.delta_stepping(0, 1, 2));
+    ASSERT_EQ(false, g.has_negative_cycle());
+
+    const impl::shortest_path_tree<std::uint32_t, std::uint32_t> tree = g.shortest_paths(0);
+    ASSERT_EQ(3u, tree.cost(4));
+    ASSERT_EQ(3u, tree.predecessor(4));
+
+    const graph::csr_graph frozen = g.freeze();
+    ASSERT_EQ(hops, frozen.dijkstra(0));
+
+    const std::string fileName = testing::TempDir() + "unweighted_graph.bin";
+    g.serialize_binary(fileName);
+    const graph::csr_graph mapped = graph::csr_graph::map(fileName);
+    ASSERT_EQ(hops, mapped.dijkstra(0));
+    ASSERT_THROW((impl::basic_csr_graph<std::uint32_t, std::uint32_t>::map(fileName)), impl::serialization_error);
+
+    const std::string textName = testing::TempDir() + "unweighted_graph.txt";
+    g.serialize(textName);
+    graph loaded;
+    loaded.deserialize(textName);
+    ASSERT_EQ(hops, loaded.dijkstra(0));
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+TEST(CsrGraph, freeze_keeps_adjacency)
+{
+    impl::graph g;
+    g.add_edge("A", "B", 5);
+    g.add_edge("A", "C", 2);
+    g.add_edge("B", "D", 1);
+    g.add_edge("D", "E", 3);
+    g.add_edge("C", "E", 4);
+
+    const impl::csr_graph csr = g.freeze();
+    ASSERT_EQ(g.size(), csr.size());
+    ASSERT_EQ(g.num_of_edges(), csr.num_of_edges());
+    for (impl::graph::size_type i = 0; i < g.size(); ++i) {
+        auto it = csr.out_edges(i).begin();
+        for (const auto [to, cost] : g.out_edges(i)) {
+            ASSERT_EQ(to, (*it).to);
+            ASSERT_EQ(cost, (*it).cost);
+            ++it;
+        }
+        ASSERT_EQ(csr.out_edges(i).end(), it);
+    }
+    ASSERT_EQ(2u, csr.degree(0));
+}
+
+TEST(CsrGraph, algorithms_match_graph)
+{
+    impl::graph g;
+    g.add_edge("A", "B", 5);
+    g.add_edge("A", "C", 2);
+    g.add_edge("B", "D", 1);
+    g.add_edge("D", "E", 3);
+    g.add_edge("C", "E", 3);
+    g.add_edge("C", "D", 1);
+
+    const impl::csr_graph csr = g.freeze();
+    ASSERT_EQ(g.dijkstra(0), csr.dijkstra(0));
+    ASSERT_EQ(g.is_cyclic(), csr.is_cyclic());
+    ASSERT_EQ(g.has_negative_cycle(), csr.has_negative_cycle());
+    ASSERT_EQ(g.mother_node()->get_id(), csr.mother_node());
+    ASSERT_EQ(g.num_of_paths(g.get_node("A"), g.get_node("E")), csr.num_of_paths(0, 4));
+
+    g.add_edge("E", "A", 1);
+    ASSERT_EQ(true, g.freeze().is_cyclic());
+}
+
+TEST(CsrGraph, algorithms_skip_removed_ids)
+{
+    impl::graph g;
+    g.add_edge("R", "A", 1);
+    g.add_edge("A", "B", 5);
+    g.add_edge("A", "C", 2);
+    g.add_edge("C", "D", 1);
+    g.add_edge("D", "C", 1);
+    ASSERT_TRUE(g.remove_node("R"));
+
+    const impl::csr_graph csr = g.freeze();
+    ASSERT_EQ(g.size(), csr.size());
+    ASSERT_EQ(g.num_of_ids(), csr.num_of_ids());
+    ASSERT_FALSE(csr.contains(0));
+    ASSERT_TRUE(csr.contains(1));
+    ASSERT_EQ(g.mother_node()->get_id(), csr.mother_node());
+    ASSERT_EQ(g.find_cycle(), csr.find_cycle());
+    ASSERT_EQ(g.dijkstra(1), csr.dijkstra(1));
+
+    const impl::scc_result<std::size_t> expected = g.strongly_connected_components();
+    const impl::scc_result<std::size_t> actual = csr.strongly_connected_components();
+    ASSERT_EQ(expected.components, actual.components);
+    ASSERT_EQ(expected.sizes, actual.sizes);
+
+    ASSERT_TRUE(g.remove_edge("D", "C"));
+    const impl::csr_graph dag = g.freeze();
+    ASSERT_EQ(g.topological_order(), dag.topological_order());
+    ASSERT_EQ(g.topological_levels(2), dag.topological_levels(2));
+    ASSERT_EQ(0u, dag.num_of_paths(0, 3));
+    ASSERT_EQ(g.num_of_paths_from(1), dag.num_of_paths_from(1));
+}
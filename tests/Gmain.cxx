@@ -2,7 +2,13 @@
 
 #include "core/graph.hpp"
 
+#include "NameTable.hpp"
+#include "IndexedHeap.hpp"
+#include "Graph.hpp"
+#include "BasicGraph.hpp"
 #include "Algorithms.hpp"
+#include "CsrGraph.hpp"
+#include "Serialization.hpp"
 
 int main(int argc, char *argv[])
 {
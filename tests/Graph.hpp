@@ -0,0 +1,345 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+TEST(Graph, clear_and_rebuild)
+{
+    impl::graph g;
+    g.add_edge("A", "B", 5);
+    g.add_edge("A", "C", 2);
+    g.add_edge("B", "C", 1);
+
+    std::ostringstream before;
+    g.dump(before);
+
+    g.clear();
+    ASSERT_EQ(true, g.empty());
+    ASSERT_EQ(0u, g.num_of_edges());
+    ASSERT_EQ(nullptr, g.get_node("A"));
+
+    g.add_edge("A", "B", 5);
+    g.add_edge("A", "C", 2);
+    g.add_edge("B", "C", 1);
+
+    std::ostringstream after;
+    g.dump(after);
+    ASSERT_EQ(before.str(), after.str());
+}
+
+TEST(Graph, remove_node_updates_names)
+{
+    impl::graph g;
+    g.add_edge("A", "B");
+    g.add_edge("B", "C");
+    g.add_edge("C", "D");
+
+    ASSERT_EQ(true, g.remove_node("B"));
+    ASSERT_EQ(false, g.contains("B"));
+    ASSERT_EQ(3u, g.size());
+    ASSERT_EQ(2u, g.get_node("C")->get_id());
+    ASSERT_EQ(3u, g.get_node("D")->get_id());
+    ASSERT_EQ(true, g.add_node("B"));
+    ASSERT_EQ(4u, g.get_node("B")->get_id());
+
+    g.compact();
+    ASSERT_EQ(4u, g.num_of_ids());
+    ASSERT_EQ(1u, g.get_node("C")->get_id());
+    ASSERT_EQ(2u, g.get_node("D")->get_id());
+    ASSERT_EQ(3u, g.get_node("B")->get_id());
+    ASSERT_EQ(true, g.has_edge("C", "D"));
+}
+
+TEST(Graph, remove_node_keeps_ids_stable)
+{
+    impl::graph g;
+    g.add_edge("A", "B", 1);
+    g.add_edge("B", "C", 2);
+    g.add_edge("C", "A", 3);
+    g.add_edge("A", "C", 4);
+    g.add_edge("D", "B", 5);
+
+    ASSERT_EQ(true, g.remove_node("B"));
+    ASSERT_EQ(false, g.remove_node("B"));
+    ASSERT_EQ(3u, g.size());
+    ASSERT_EQ(4u, g.num_of_ids());
+    ASSERT_EQ(false, g.contains(std::size_t{1}));
+    ASSERT_EQ(nullptr, g.get_node(std::size_t{1}));
+    ASSERT_EQ(2u, g.num_of_edges());
+    ASSERT_EQ(0u, g.get_node("D")->degree());
+    ASSERT_EQ(2u, g.get_node("C")->get_id());
+
+    std::vector<std::string> names;
+    for (auto it = g.cbegin_nodes(); it != g.cend_nodes(); ++it) {
+        names.emplace_back((*it)->get_name());
+    }
+    ASSERT_EQ((std::vector<std::string>{"A", "C", "D"}), names);
+    ASSERT_EQ(2, std::distance(g.begin_edges(), g.end_edges()));
+    ASSERT_EQ((std::vector<int>{0, impl::edge::INF_COST, 4, impl::edge::INF_COST}), g.dijkstra(0));
+    ASSERT_EQ(nullptr, g.mother_node());
+
+    g.compact();
+    ASSERT_EQ(3u, g.num_of_ids());
+    ASSERT_EQ(2u, g.num_of_edges());
+    ASSERT_EQ(1u, g.get_node("C")->get_id());
+    ASSERT_EQ((std::vector<int>{0, 4, impl::edge::INF_COST}), g.dijkstra(0));
+    ASSERT_EQ(1u, g.get_node("A")->get_in_edges().size());
+}
+
+TEST(Graph, add_edges_matches_add_edge)
+{
+    const std::vector<std::tuple<std::string, std::string, int>> edges{
+        {"A", "B", 5}, {"A", "C", 2}, {"B", "D", 1}, {"D", "E", 3}, {"C", "E", 4}, {"E", "A", 1}};
+
+    impl::graph expected;
+    for (const auto& [from, to, cost] : edges) {
+        expected.add_edge(from, to, cost);
+    }
+
+    const impl::graph g(edges.begin(), edges.end());
+    ASSERT_EQ(true, expected.compare(&g));
+    ASSERT_EQ(expected.num_of_edges(), g.num_of_edges());
+    ASSERT_EQ(expected.dijkstra(0), g.dijkstra(0));
+
+    impl::graph other(edges.begin(), edges.end() - 1);
+    ASSERT_EQ(false, expected.compare(&other));
+    other.add_edge("E", "A", 2);
+    ASSERT_EQ(false, expected.compare(&other));
+    ASSERT_EQ(false, other.compare(&expected));
+}
+
+TEST(Graph, add_edges_rejects_ids_named_like_other_nodes)
+{
+    const std::vector<std::pair<int, int>> edges{{0, 2}};
+
+    impl::graph g;
+    g.add_node("2");
+    ASSERT_THROW(g.add_edges(edges.begin(), edges.end()), std::invalid_argument);
+    ASSERT_EQ(1u, g.size());
+}
+
+TEST(Graph, add_edges_by_id)
+{
+    const std::vector<std::pair<int, int>> edges{{0, 1}, {0, 3}, {3, 2}};
+
+    impl::graph g;
+    g.add_node("A");
+    g.add_edges(edges.begin(), edges.end());
+    ASSERT_EQ(4u, g.size());
+    ASSERT_EQ(3u, g.num_of_edges());
+    ASSERT_EQ(0u, g.get_node("A")->get_id());
+    ASSERT_EQ(3u, g.get_node("3")->get_id());
+    ASSERT_EQ(true, g.has_edge("A", "3"));
+    ASSERT_EQ(true, g.has_edge("3", "2"));
+    ASSERT_EQ(false, g.has_edge("1", "A"));
+}
+
+TEST(Graph, add_edges_rejects_removed_ids)
+{
+    const std::vector<std::pair<int, int>> chain{{0, 1}, {1, 2}};
+    const std::vector<std::pair<int, int>> edges{{0, 1}};
+
+    impl::graph g(chain.begin(), chain.end());
+    ASSERT_EQ(true, g.remove_node("1"));
+    ASSERT_THROW(g.add_edges(edges.begin(), edges.end()), std::invalid_argument);
+    ASSERT_EQ(2u, g.size());
+    ASSERT_EQ(0u, g.num_of_edges());
+
+    g.compact();
+    g.add_edges(edges.begin(), edges.end());
+    ASSERT_EQ(true, g.has_edge("0", "2"));
+}
+
+TEST(Graph, in_edges_follow_edges)
+{
+    impl::graph g;
+    g.add_edge("A", "C", 1);
+    g.add_edge("B", "C", 2);
+    g.add_edge("C", "A", 3);
+
+    std::vector<std::pair<std::size_t, int>> incoming;
+    for (const auto [from, cost] : g.in_edges(g.get_node("C")->get_id())) {
+        incoming.emplace_back(from, cost);
+    }
+    ASSERT_EQ((std::vector<std::pair<std::size_t, int>>{{0, 1}, {2, 2}}), incoming);
+
+    ASSERT_EQ(true, g.remove_edge("A", "C"));
+    ASSERT_EQ(1u, g.get_node("C")->get_in_edges().size());
+    ASSERT_EQ(2u, (*g.in_edges(1).begin()).to);
+}
+
+TEST(Graph, remove_node_drops_incoming_edges)
+{
+    for (bool indexed : {true, false}) {
+        impl::graph g;
+        g.index_incoming_edges(indexed);
+        g.add_edge("A", "B", 1);
+        g.add_edge("B", "C", 1);
+        g.add_edge("C", "B", 1);
+        g.add_edge("B", "B", 1);
+        g.add_edge("A", "C", 1);
+
+        ASSERT_EQ(true, g.remove_node("B"));
+        ASSERT_EQ(false, g.has_edge("A", "B"));
+        ASSERT_EQ(1u, g.get_node("A")->degree());
+        ASSERT_EQ(0u, g.get_node("C")->degree());
+        if (indexed) {
+            ASSERT_EQ(1u, std::distance(g.begin_in_neighbors("C"), g.end_in_neighbors("C")));
+            ASSERT_EQ(g.get_node("A"), *g.begin_in_neighbors("C"));
+        } else {
+            ASSERT_EQ(g.begin_in_neighbors("C"), g.end_in_neighbors("C"));
+        }
+    }
+}
+
+TEST(Graph, index_incoming_edges_on_demand)
+{
+    impl::graph g;
+    g.index_incoming_edges(false);
+    g.add_edge("A", "C", 1);
+    g.add_edge("B", "C", 2);
+    ASSERT_EQ(true, g.in_edges(1).empty());
+    ASSERT_EQ(1, g.shortest_path(0, 1).cost);
+
+    g.index_incoming_edges(true);
+    std::vector<std::string> names;
+    for (auto it = g.cbegin_in_neighbors("C"); it != g.cend_in_neighbors("C"); ++it) {
+        names.emplace_back((*it)->get_name());
+    }
+    ASSERT_EQ((std::vector<std::string>{"A", "B"}), names);
+}
+
+TEST(Graph, hub_node_edges_are_indexed)
+{
+    // Star in both directions plus a parallel edge, well past the index threshold
+    constexpr int N = 3 * impl::node::EDGE_INDEX_THRESHOLD;
+    impl::graph g;
+    for (int i = 0; i < N; ++i) {
+        g.add_edge("hub", std::to_string(i), i);
+        g.add_edge(std::to_string(i), "hub", i);
+    }
+    g.add_edge("hub", "7", 100);
+    ASSERT_EQ(2u * N + 1, g.num_of_edges());
+    ASSERT_EQ(true, g.has_edge("hub", "0"));
+    ASSERT_EQ(false, g.has_edge("hub", "hub"));
+
+    // Parallel edges go one at a time
+    ASSERT_EQ(true, g.remove_edge("hub", "7"));
+    ASSERT_EQ(true, g.has_edge("hub", "7"));
+    ASSERT_EQ(true, g.remove_edge("hub", "7"));
+    ASSERT_EQ(false, g.has_edge("hub", "7"));
+    ASSERT_EQ(false, g.remove_edge("hub", "7"));
+
+    // Drop below the threshold, then the index goes away
+    for (int i = 0; i < N - 2; ++i) {
+        if (7 != i) {
+            ASSERT_EQ(true, g.remove_edge("hub", std::to_string(i)));
+        }
+        ASSERT_EQ(true, g.remove_edge(std::to_string(i), "hub"));
+        ASSERT_EQ(false, g.has_edge("hub", std::to_string(i)));
+        ASSERT_EQ(false, g.has_edge(std::to_string(i), "hub"));
+    }
+    ASSERT_EQ(2u, g.get_node("hub")->degree());
+    ASSERT_EQ(2u, g.get_node("hub")->get_in_edges().size());
+    ASSERT_EQ(true, g.has_edge("hub", std::to_string(N - 1)));
+    ASSERT_EQ(true, g.has_edge(std::to_string(N - 2), "hub"));
+    ASSERT_EQ(4u, g.num_of_edges());
+
+    // Removing a hub with indexed incoming edges
+    for (int i = 0; i < N; ++i) {
+        g.add_edge(std::to_string(i), "hub", 1);
+    }
+    ASSERT_EQ(true, g.remove_node("hub"));
+    ASSERT_EQ(0u, g.num_of_edges());
+    for (int i = 0; i < N; ++i) {
+        ASSERT_EQ(0u, g.get_node(std::to_string(i))->degree());
+        ASSERT_EQ(true, g.get_node(std::to_string(i))->get_in_edges().empty());
+    }
+}
+
+TEST(Graph, traversals_reuse_workspace)
+{
+    impl::graph g;
+    g.add_edge("A", "B");
+    g.add_edge("A", "C");
+    g.add_edge("B", "D");
+    g.add_edge("D", "E");
+    g.add_edge("C", "E");
+    g.add_edge("E", "C");
+    g.add_edge("C", "A");
+
+    auto names = [](auto first, auto last) {
+        std::string result;
+        for (; first != last; ++first) {
+            result += (*first).get_name();
+        }
+        return result;
+    };
+    const impl::graph& cg = g;
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ("CEABD", names(g.begin_BFS("C"), g.end_BFS()));
+        ASSERT_EQ("CABDE", names(g.begin_DFS("C"), g.end_DFS()));
+        ASSERT_EQ("CEABD", names(cg.cbegin_BFS("C"), cg.cend_BFS()));
+        ASSERT_EQ("CABDE", names(cg.cbegin_DFS("C"), cg.cend_DFS()));
+    }
+
+    // Finished traversals return the workspace, running ones keep theirs
+    const impl::traversal_workspace* first = g.borrow_workspace().get();
+    ASSERT_EQ(first, g.borrow_workspace().get());
+    auto it = g.begin_BFS("A");
+    ASSERT_NE(first, g.borrow_workspace().get());
+    auto copy = it++;
+    ASSERT_EQ("A", (*copy).get_name());
+    ASSERT_EQ("B", (*it).get_name());
+    ASSERT_EQ("C", (*++copy).get_name());
+
+    // Stamps of the previous traversal do not leak into the next one
+    g.add_edge("E", "F");
+    ASSERT_EQ("CEAFBD", names(g.begin_BFS("C"), g.end_BFS()));
+
+    // Incrementing an end iterator stays at the end
+    auto end = g.end_DFS();
+    ASSERT_EQ(g.end_DFS(), ++end);
+    auto cend = cg.cend_BFS();
+    ASSERT_EQ(cg.cend_BFS(), ++cend);
+    auto last = g.begin_DFS("F");
+    ASSERT_EQ(g.end_DFS(), ++last);
+    ASSERT_EQ(g.end_DFS(), ++last);
+}
+
+TEST(Graph, repeated_traversals_reuse_the_workspace)
+{
+    impl::graph g;
+    for (std::size_t i = 0; i + 1 < 200; ++i) {
+        g.add_edge(std::to_string(i), std::to_string(i + 1), 1);
+    }
+    g.add_edge("150", "100", 1);
+    g.add_edge("Root", "0", 1);
+    const impl::csr_graph csr = g.freeze();
+
+    auto traverse = [&]() {
+        (void)g.mother_node();
+        (void)g.is_cyclic();
+        (void)g.find_cycle();
+        (void)g.num_of_paths(g.get_node("0"), g.get_node("99"));
+        (void)g.dfs(0, impl::default_visitor{});
+        (void)csr.mother_node();
+        (void)csr.find_cycle();
+        (void)csr.dfs(0, impl::default_visitor{});
+    };
+    traverse();
+    const impl::traversal_workspace* workspace = g.borrow_workspace().get();
+    const impl::traversal_workspace* csrWorkspace = csr.borrow_workspace().get();
+    const std::size_t bytes = workspace->capacity_bytes();
+    const std::size_t csrBytes = csrWorkspace->capacity_bytes();
+    ASSERT_LT(0u, bytes);
+
+    // The same workspaces come back and their buffers, the DFS path included, do not grow
+    traverse();
+    ASSERT_EQ(workspace, g.borrow_workspace().get());
+    ASSERT_EQ(csrWorkspace, csr.borrow_workspace().get());
+    ASSERT_EQ(bytes, workspace->capacity_bytes());
+    ASSERT_EQ(csrBytes, csrWorkspace->capacity_bytes());
+}
@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <utility>
+
+TEST(IndexedHeap, matches_ordered_map)
+{
+    impl::indexed_heap<int> heap(100);
+    std::map<std::size_t, int> keys;
+    std::mt19937 rng{3};
+    std::uniform_int_distribution<std::size_t> pickId(0, 99);
+    std::uniform_int_distribution<int> pickKey(-1000, 1000);
+
+    for (int round = 0; round < 5000; ++round) {
+        if (round % 3 == 2 && !heap.empty()) {
+            std::pair<int, std::size_t> expected{keys.begin()->second, keys.begin()->first};
+            for (const auto& [id, key] : keys) {
+                expected = std::min(expected, std::pair<int, std::size_t>{key, id});
+            }
+            ASSERT_EQ(expected.first, heap.top().first);
+            keys.erase(heap.top().second);
+            heap.pop();
+        } else {
+            const std::size_t id = pickId(rng);
+            const int key = pickKey(rng);
+            auto it = keys.find(id);
+            const bool lowered = it == keys.end() || key < it->second;
+            ASSERT_EQ(lowered, heap.push_or_decrease(id, key));
+            if (lowered) {
+                keys[id] = key;
+            }
+        }
+        ASSERT_EQ(keys.size(), heap.size());
+        ASSERT_EQ(true, heap.empty() || heap.contains(heap.top().second));
+    }
+}
@@ -0,0 +1,17 @@
+// A second translation unit of the test binary, the header only library
+// must link when it is included more than once.
+#include "core/graph.hpp"
+
+namespace
+{
+
+[[maybe_unused]] void use_library()
+{
+    impl::graph g;
+    g.add_edge("A", "B", 1);
+    impl::thread_pool pool{1};
+    (void)g.freeze().delta_stepping(0, 1, pool);
+    (void)impl::csr_graph::map("graph.bin");
+}
+
+}
@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <unordered_map>
+
+TEST(NameTable, matches_unordered_map)
+{
+    impl::name_table table;
+    std::unordered_map<std::string, std::size_t> expected;
+
+    for (std::size_t i = 0; i < 2000; ++i) {
+        const std::string name = "node" + std::to_string(i * 7 % 1000);
+        const auto [entry, inserted] = table.emplace(name, i);
+        const auto [it, expectedInserted] = expected.emplace(name, i);
+        ASSERT_EQ(expectedInserted, inserted);
+        ASSERT_EQ(it->second, entry->id);
+        ASSERT_EQ(name, entry->name);
+    }
+    for (std::size_t i = 0; i < 1000; i += 3) {
+        const std::string name = "node" + std::to_string(i);
+        ASSERT_EQ(expected.erase(name) == 1, table.erase(name));
+    }
+
+    ASSERT_EQ(expected.size(), table.size());
+    for (std::size_t i = 0; i < 1000; ++i) {
+        const std::string name = "node" + std::to_string(i);
+        auto it = expected.find(name);
+        ASSERT_EQ(it == expected.end() ? impl::name_table::INVALID_ID : it->second, table.find(name));
+    }
+}
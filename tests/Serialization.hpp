@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+
+TEST(Serialization, binary_map_matches_freeze)
+{
+    impl::graph g;
+    g.add_edge("A", "B", 5);
+    g.add_edge("A", "C", 2);
+    g.add_edge("B", "D", 1);
+    g.add_edge("D", "E", 3);
+    g.add_edge("C", "E", 4);
+    g.add_node("Lonely");
+
+    const std::string fileName = testing::TempDir() + "graph.bin";
+    g.serialize_binary(fileName);
+
+    const impl::csr_graph mapped = impl::csr_graph::map(fileName);
+    const impl::csr_graph frozen = g.freeze();
+    ASSERT_EQ(frozen.size(), mapped.size());
+    ASSERT_EQ(frozen.num_of_edges(), mapped.num_of_edges());
+    for (impl::csr_graph::size_type i = 0; i < mapped.size(); ++i) {
+        ASSERT_EQ(frozen.get_name(i), mapped.get_name(i));
+        ASSERT_EQ(frozen.degree(i), mapped.degree(i));
+        auto it = frozen.out_edges(i).begin();
+        for (const auto [to, cost] : mapped.out_edges(i)) {
+            ASSERT_EQ((*it).to, to);
+            ASSERT_EQ((*it).cost, cost);
+            ++it;
+        }
+    }
+    ASSERT_EQ(g.dijkstra(0), mapped.dijkstra(0));
+}
+
+TEST(Serialization, binary_map_rejects_text)
+{
+    impl::graph g;
+    g.add_edge("A", "B", 5);
+
+    const std::string fileName = testing::TempDir() + "graph.txt";
+    g.serialize(fileName);
+
+    ASSERT_THROW((void)impl::csr_graph::map(fileName), impl::serialization_error);
+}
+
+TEST(Serialization, binary_map_rejects_wrapping_section_sizes)
+{
+    impl::graph g;
+    g.add_edge("A", "B", 5);
+
+    const std::string fileName = testing::TempDir() + "graph.bin";
+    g.serialize_binary(fileName);
+    {
+        // (numOfNodes + 1) * 8 wraps to 0 and would pass the size check
+        const std::uint64_t numOfNodes = (std::uint64_t{1} << 61) - 1;
+        std::fstream file{fileName, std::ios::binary | std::ios::in | std::ios::out};
+        file.seekp(offsetof(impl::detail::binary_header, numOfNodes));
+        file.write(reinterpret_cast<const char*>(&numOfNodes), sizeof(numOfNodes));
+    }
+
+    ASSERT_THROW((void)impl::csr_graph::map(fileName), impl::serialization_error);
+}
+
+TEST(Serialization, binary_map_rejects_corrupted_offsets_and_targets)
+{
+    impl::graph g;
+    g.add_edge("A", "B", 5);
+    g.add_edge("B", "C", 2);
+
+    const std::string fileName = testing::TempDir() + "graph.bin";
+    impl::detail::binary_header header{};
+    const auto corrupt = [&](std::uint64_t section, std::size_t index, std::size_t value) {
+        g.serialize_binary(fileName);
+        std::fstream file{fileName, std::ios::binary | std::ios::in | std::ios::out};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        const impl::detail::binary_layout layout(header, sizeof(header));
+        const std::uint64_t offsets[] = {layout.nameOffsets, layout.offsets, layout.targets};
+        file.seekp(static_cast<std::streamoff>(offsets[section] + index * sizeof(value)));
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    corrupt(1, 1, 5);
+    ASSERT_THROW((void)impl::csr_graph::map(fileName), impl::serialization_error);
+    corrupt(0, 2, 0);
+    ASSERT_THROW((void)impl::csr_graph::map(fileName), impl::serialization_error);
+    corrupt(2, 1, 3);
+    ASSERT_THROW((void)impl::csr_graph::map(fileName), impl::serialization_error);
+    ASSERT_EQ(3u, impl::csr_graph::map(fileName, false).size());
+    corrupt(2, 1, 2);
+    ASSERT_EQ(2u, impl::csr_graph::map(fileName).num_of_edges());
+}
+
+TEST(Serialization, binary_reports_write_errors)
+{
+    impl::graph g;
+    g.add_edge("A", "B", 5);
+
+    // Writes to /dev/full fail with ENOSPC, the open succeeds
+    if (!std::ifstream{"/dev/full"}) {
+        GTEST_SKIP() << "/dev/full is not available";
+    }
+    ASSERT_THROW(g.serialize_binary("/dev/full"), impl::serialization_error);
+}
+
+TEST(Serialization, text_roundtrip)
+{
+    impl::graph g;
+    g.add_edge("A", "B", 5);
+    g.add_edge("A", "C", -2);
+    g.add_edge("B", "C", 1);
+    g.add_edge("C", "A", 4);
+
+    const std::string fileName = testing::TempDir() + "roundtrip.txt";
+    g.serialize(fileName);
+
+    impl::graph g1;
+    g1.deserialize(fileName);
+    ASSERT_EQ(true, g.compare(&g1));
+    ASSERT_EQ(g.num_of_edges(), g1.num_of_edges());
+    ASSERT_EQ(2u, g1.get_node("C")->get_id());
+    ASSERT_EQ(true, g1.has_edge("C", "A"));
+}
+
+TEST(Serialization, text_error_reports_line)
+{
+    const std::string fileName = testing::TempDir() + "broken.txt";
+    {
+        std::ofstream os{fileName};
+        os << "3\nA 1 1 5\nB 1 7 1\nC 0\n";
+    }
+
+    impl::graph g;
+    try {
+        g.deserialize(fileName);
+        FAIL() << "Expected serialization_error";
+    } catch (const impl::serialization_error& e) {
+        ASSERT_EQ(3u, e.line());
+    }
+    ASSERT_EQ(true, g.empty());
+}
+
+TEST(Serialization, text_rejects_counts_beyond_the_file)
+{
+    const std::string fileName = testing::TempDir() + "huge_counts.txt";
+    for (const char* text : {"18446744073709551000\nA 0\n", "2\nA 0\nB 4000000000000000000 0 1\n"}) {
+        {
+            std::ofstream os{fileName};
+            os << text;
+        }
+        impl::graph g;
+        ASSERT_THROW(g.deserialize(fileName), impl::serialization_error);
+        ASSERT_EQ(true, g.empty());
+        ASSERT_THROW(g.deserialize(fileName, 2), impl::serialization_error);
+        ASSERT_EQ(true, g.empty());
+    }
+}
+
+TEST(Serialization, parallel_text_load_matches_serial)
+{
+    impl::graph g;
+    for (int i = 0; i < 200; ++i) {
+        g.add_edge(std::to_string(i), std::to_string((i * 7 + 3) % 200), i);
+        g.add_edge(std::to_string(i), std::to_string((i * 13 + 1) % 200), 2 * i);
+    }
+    g.add_node("Lonely");
+
+    const std::string fileName = testing::TempDir() + "parallel.txt";
+    g.serialize(fileName);
+
+    impl::graph serial;
+    serial.deserialize(fileName);
+    ASSERT_EQ(true, g.compare(&serial));
+    ASSERT_EQ(g.num_of_edges(), serial.num_of_edges());
+    for (impl::graph::size_type i = 0; i < g.size(); ++i) {
+        ASSERT_EQ(g.get_node(i)->get_in_edges().size(), serial.get_node(i)->get_in_edges().size());
+    }
+    for (impl::graph::size_type numOfThreads : {1u, 3u, 4u}) {
+        impl::graph parallel;
+        parallel.deserialize(fileName, numOfThreads);
+        ASSERT_EQ(true, serial.compare(&parallel));
+        ASSERT_EQ(serial.num_of_edges(), parallel.num_of_edges());
+        for (impl::graph::size_type i = 0; i < serial.size(); ++i) {
+            ASSERT_EQ(serial.get_node(i)->get_name(), parallel.get_node(i)->get_name());
+        }
+        ASSERT_EQ(serial.dijkstra(0), parallel.dijkstra(0));
+    }
+}
+
+TEST(Serialization, parallel_text_error_reports_line)
+{
+    const std::string fileName = testing::TempDir() + "broken_parallel.txt";
+    {
+        std::ofstream os{fileName};
+        os << "4\nA 1 1 5\nB 1 2 1\nC 1 0 x\nD 0\n";
+    }
+
+    impl::graph g;
+    try {
+        g.deserialize(fileName, 4);
+        FAIL() << "Expected serialization_error";
+    } catch (const impl::serialization_error& e) {
+        ASSERT_EQ(4u, e.line());
+    }
+    ASSERT_EQ(true, g.empty());
+
+    {
+        std::ofstream os{fileName};
+        os << "3\nA 0\nB 0\n";
+    }
+    ASSERT_THROW(g.deserialize(fileName, 2), impl::serialization_error);
+}
+
+TEST(Serialization, text_skips_removed_nodes)
+{
+    impl::graph g;
+    g.add_edge("A", "B", 1);
+    g.add_edge("B", "C", 2);
+    g.add_edge("A", "C", 3);
+    g.add_edge("C", "D", 4);
+    ASSERT_EQ(true, g.remove_node("B"));
+
+    const std::string fileName = testing::TempDir() + "removed.txt";
+    g.serialize(fileName);
+    impl::graph g1;
+    g1.deserialize(fileName);
+
+    g.compact();
+    ASSERT_EQ(g.size(), g1.size());
+    ASSERT_EQ(g.num_of_edges(), g1.num_of_edges());
+    ASSERT_EQ(g.dijkstra(0), g1.dijkstra(0));
+    ASSERT_EQ(1u, g1.get_node("C")->get_id());
+}